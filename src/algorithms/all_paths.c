@@ -201,6 +201,7 @@ AllPathsCtx *AllPathsCtx_New
 	ctx->dst            =  dst;
 	ctx->shortest_paths =  shortest_paths;
 	ctx->visited        =  NULL;
+	ctx->distances      =  NULL;
 
 	_AllPathsCtx_EnsureLevelArrayCap(ctx, 0, 1);
 	_AllPathsCtx_AddConnectionToLevel(ctx, 0, src, NULL);
@@ -305,6 +306,7 @@ void AllPathsCtx_Free(AllPathsCtx *ctx) {
 	Path_Free(ctx->path);
 	array_free(ctx->neighbors);
 	if(ctx->visited) GrB_Vector_free(&ctx->visited);
+	if(ctx->distances) GrB_Vector_free(&ctx->distances);
 	rm_free(ctx);
 	ctx = NULL;
 }
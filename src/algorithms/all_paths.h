@@ -43,6 +43,7 @@ typedef struct {
 	uint edge_idx;              // Record index of the edge alias, only used for edge filtering.
 	bool shortest_paths;        // Only collect shortest paths.
 	GrB_Vector visited;         // Visited nodes in shortest path.
+	GrB_Vector distances;       // Distance from source of nodes on shortest paths.
 } AllPathsCtx;
 
 // Create a new All paths context object.
@@ -5,10 +5,40 @@
  */
 
 #include "RG.h"
+#include "bidirectional_bfs.h"
 #include "all_shortest_paths.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
 
+// run a bidirectional BFS between `src` and `dest`
+// collecting the distance from `src` of every node on a shortest path
+// so it can be used later on in `AllShortestPaths_NextPath`
+static int _FindMinimumLengthBidirectional
+(
+	AllPathsCtx *ctx,   // context of the all shortest path
+	NodeID srcID,       // source node ID
+	NodeID destID       // destination node ID
+) {
+	BFSTraversal t = {
+		.g             = ctx->g,
+		.relationIDs   = ctx->relationIDs,
+		.relationCount = ctx->relationCount,
+		.dir           = ctx->dir,
+		.ft            = ctx->ft,
+		.r             = ctx->r,
+		.edge_idx      = ctx->edge_idx
+	};
+
+	// the source node is no longer needed on the first level
+	array_clear(ctx->levels[0]);
+
+	int64_t len = BidirectionalBFS(&t, srcID, destID, ctx->maxLen - 1,
+			&ctx->distances);
+
+	// switch from edge count to node count
+	return (len == -1) ? 0 : len + 1;
+}
+
 // run BFS from `src` until `dest` is reached
 // add all nodes visited during traversal except for nodes in
 // `dest` level, so it can be used later on in `AllShortestPaths_NextPath`
@@ -24,8 +54,14 @@ int AllShortestPaths_FindMinimumLength
 	ASSERT(ENTITY_GET_ID(&ctx->levels[0]->node) == ENTITY_GET_ID(src));
 
 	int    depth  = 0;
+	NodeID srcID  = ENTITY_GET_ID(src);
 	NodeID destID = ENTITY_GET_ID(dest);
 
+	// paths leading back to the source are found by a single sided BFS
+	if(srcID != destID) {
+		return _FindMinimumLengthBidirectional(ctx, srcID, destID);
+	}
+
 	GrB_Vector visited;       // all visited nodes
 	GrB_Vector newly_visited; // nodes visited in current level
 
@@ -128,15 +164,25 @@ Path *AllShortestPaths_NextPath
 	while (depth < ctx->maxLen) {
 		if (array_len(ctx->levels[depth]) > 0) {
 			// get a new node from the frontier
-			bool is_visited;
 			LevelConnection frontierConnection = array_pop(ctx->levels[depth]);
 			Node frontierNode = frontierConnection.node;
 			NodeID frontierID = ENTITY_GET_ID(&frontierNode);
-			GrB_Info info = GrB_Vector_extractElement_BOOL(&is_visited,
-					ctx->visited, frontierID);
 
-			// consider only previously discovered nodes
-			if(info == GrB_NO_VALUE) continue;
+			if(ctx->distances != NULL) {
+				// consider only nodes on a shortest path
+				// at the right distance from the source
+				uint64_t distance;
+				GrB_Info info = GrB_Vector_extractElement_UINT64(&distance,
+						ctx->distances, frontierID);
+				if(info == GrB_NO_VALUE) continue;
+				if(distance != ctx->minLen - depth - 1) continue;
+			} else {
+				// consider only previously discovered nodes
+				bool is_visited;
+				GrB_Info info = GrB_Vector_extractElement_BOOL(&is_visited,
+						ctx->visited, frontierID);
+				if(info == GrB_NO_VALUE) continue;
+			}
 
 			// if we reached to the end of the path and this node is not the
 			// dst node continue
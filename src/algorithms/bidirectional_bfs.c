@@ -0,0 +1,325 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "bidirectional_bfs.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/rg_matrix/rg_matrix_iter.h"
+
+// traversal from the source side
+#define SRC_SIDE 0
+// traversal from the destination side
+#define DEST_SIDE 1
+
+static inline GRAPH_EDGE_DIR _ReverseDir
+(
+	GRAPH_EDGE_DIR dir
+) {
+	switch(dir) {
+		case GRAPH_EDGE_DIR_OUTGOING:
+			return GRAPH_EDGE_DIR_INCOMING;
+		case GRAPH_EDGE_DIR_INCOMING:
+			return GRAPH_EDGE_DIR_OUTGOING;
+		default:
+			return dir;
+	}
+}
+
+// appends the column indices of row 'id' in each relationship matrix
+static void _MatrixNeighbors
+(
+	const BFSTraversal *t,
+	NodeID id,
+	bool transposed,
+	NodeID **neighbors
+) {
+	GrB_Index col;
+	RG_MatrixTupleIter it = {0};
+
+	for(int i = 0; i < t->relationCount; i++) {
+		RG_Matrix R = Graph_GetRelationMatrix(t->g, t->relationIDs[i],
+				transposed);
+
+		RG_MatrixTupleIter_attach(&it, R);
+		RG_MatrixTupleIter_iterate_row(&it, id);
+		while(RG_MatrixTupleIter_next_BOOL(&it, NULL, &col, NULL) ==
+				GrB_SUCCESS) {
+			array_append(*neighbors, col);
+		}
+		RG_MatrixTupleIter_detach(&it);
+	}
+}
+
+// appends the endpoints of edges passing the traversal's filters
+static void _FilteredNeighbors
+(
+	const BFSTraversal *t,
+	NodeID id,
+	GRAPH_EDGE_DIR dir,
+	NodeID **neighbors
+) {
+	Node n = GE_NEW_NODE();
+	Graph_GetNode(t->g, id, &n);
+
+	Edge *edges = array_new(Edge, 0);
+	for(int i = 0; i < t->relationCount; i++) {
+		Graph_GetNodeEdges(t->g, &n, dir, t->relationIDs[i], &edges);
+	}
+
+	uint edge_count = array_len(edges);
+	for(uint i = 0; i < edge_count; i++) {
+		Edge *e = edges + i;
+
+		// update the record with the current edge
+		Record_AddEdge(t->r, t->edge_idx, *e);
+		if(FilterTree_applyFilters(t->ft, t->r) != FILTER_PASS) continue;
+
+		NodeID src_id  = Edge_GetSrcNodeID(e);
+		NodeID dest_id = Edge_GetDestNodeID(e);
+		NodeID other   = (src_id == id) ? dest_id : src_id;
+		if(dir == GRAPH_EDGE_DIR_OUTGOING) other = dest_id;
+		if(dir == GRAPH_EDGE_DIR_INCOMING) other = src_id;
+
+		array_append(*neighbors, other);
+	}
+
+	array_free(edges);
+}
+
+void BidirectionalBFS_Neighbors
+(
+	const BFSTraversal *t,
+	NodeID id,
+	bool reverse,
+	NodeID **neighbors
+) {
+	ASSERT(t         != NULL);
+	ASSERT(neighbors != NULL);
+
+	GRAPH_EDGE_DIR dir = reverse ? _ReverseDir(t->dir) : t->dir;
+
+	if(t->ft != NULL) {
+		_FilteredNeighbors(t, id, dir, neighbors);
+		return;
+	}
+
+	// incoming edges are found in the transposed matrices
+	if(dir != GRAPH_EDGE_DIR_INCOMING) _MatrixNeighbors(t, id, false, neighbors);
+	if(dir != GRAPH_EDGE_DIR_OUTGOING) _MatrixNeighbors(t, id, true, neighbors);
+}
+
+static GrB_Vector _NewDistanceVector
+(
+	const Graph *g
+) {
+	GrB_Vector v;
+	GrB_Info info = GrB_Vector_new(&v, GrB_UINT64,
+			Graph_UncompactedNodeCount(g));
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GxB_set(v, GxB_SPARSITY_CONTROL, GxB_BITMAP);
+	ASSERT(info == GrB_SUCCESS);
+
+	return v;
+}
+
+static inline bool _GetDistance
+(
+	GrB_Vector v,
+	NodeID id,
+	uint64_t *d
+) {
+	return GrB_Vector_extractElement_UINT64(d, v, id) == GrB_SUCCESS;
+}
+
+// collects nodes one level further away from 'side' which lie on
+// shortest paths, starting from 'from' the on-path nodes at 'level'
+// 'dist' holds the distances computed by the opposite side
+static NodeID *_PropagateLevel
+(
+	const BFSTraversal *t,
+	NodeID *from,
+	bool reverse,
+	GrB_Vector dist,
+	uint64_t expected,
+	uint64_t level,
+	GrB_Vector distances,
+	NodeID **neighbors
+) {
+	NodeID *next = array_new(NodeID, 0);
+
+	uint n = array_len(from);
+	for(uint i = 0; i < n; i++) {
+		array_clear(*neighbors);
+		BidirectionalBFS_Neighbors(t, from[i], reverse, neighbors);
+
+		uint neighbor_count = array_len(*neighbors);
+		for(uint j = 0; j < neighbor_count; j++) {
+			uint64_t d;
+			NodeID id = (*neighbors)[j];
+			if(!_GetDistance(dist, id, &d) || d != expected) continue;
+			// already collected
+			if(_GetDistance(distances, id, &d)) continue;
+
+			GrB_Vector_setElement_UINT64(distances, level, id);
+			array_append(next, id);
+		}
+	}
+
+	return next;
+}
+
+int64_t BidirectionalBFS
+(
+	const BFSTraversal *t,
+	NodeID src,
+	NodeID dest,
+	uint64_t max_len,
+	GrB_Vector *distances
+) {
+	ASSERT(t         != NULL);
+	ASSERT(distances != NULL);
+
+	*distances = _NewDistanceVector(t->g);
+
+	// zero length path
+	if(src == dest) {
+		GrB_Vector_setElement_UINT64(*distances, 0, src);
+		return 0;
+	}
+
+	int64_t   len        = -1;
+	NodeID   *neighbors  = array_new(NodeID, 32);
+	GrB_Vector dist[2];    // distance of visited nodes from each end
+	NodeID    **levels[2]; // nodes discovered at each distance from each end
+
+	dist[SRC_SIDE]  = _NewDistanceVector(t->g);
+	dist[DEST_SIDE] = _NewDistanceVector(t->g);
+	GrB_Vector_setElement_UINT64(dist[SRC_SIDE], 0, src);
+	GrB_Vector_setElement_UINT64(dist[DEST_SIDE], 0, dest);
+
+	levels[SRC_SIDE]  = array_new(NodeID *, 1);
+	levels[DEST_SIDE] = array_new(NodeID *, 1);
+	array_append(levels[SRC_SIDE], array_new(NodeID, 1));
+	array_append(levels[DEST_SIDE], array_new(NodeID, 1));
+	array_append(levels[SRC_SIDE][0], src);
+	array_append(levels[DEST_SIDE][0], dest);
+
+	//--------------------------------------------------------------------------
+	// expand frontiers until they meet
+	//--------------------------------------------------------------------------
+
+	while(true) {
+		uint64_t src_depth  = array_len(levels[SRC_SIDE]) - 1;
+		uint64_t dest_depth = array_len(levels[DEST_SIDE]) - 1;
+
+		// paths discovered from here on would be too long
+		if(src_depth + dest_depth >= max_len) break;
+
+		// advance the smaller frontier
+		NodeID *src_frontier  = levels[SRC_SIDE][src_depth];
+		NodeID *dest_frontier = levels[DEST_SIDE][dest_depth];
+		int side  = (array_len(src_frontier) <= array_len(dest_frontier)) ?
+			SRC_SIDE : DEST_SIDE;
+		int other = 1 - side;
+
+		NodeID  *frontier = (side == SRC_SIDE) ? src_frontier : dest_frontier;
+		uint64_t level    = ((side == SRC_SIDE) ? src_depth : dest_depth) + 1;
+		NodeID  *next     = array_new(NodeID, 0);
+
+		uint n = array_len(frontier);
+		for(uint i = 0; i < n; i++) {
+			array_clear(neighbors);
+			BidirectionalBFS_Neighbors(t, frontier[i], side == DEST_SIDE,
+					&neighbors);
+
+			uint neighbor_count = array_len(neighbors);
+			for(uint j = 0; j < neighbor_count; j++) {
+				uint64_t d;
+				NodeID id = neighbors[j];
+				if(_GetDistance(dist[side], id, &d)) continue;
+
+				GrB_Vector_setElement_UINT64(dist[side], level, id);
+				array_append(next, id);
+
+				// frontiers meet
+				if(_GetDistance(dist[other], id, &d)) {
+					int64_t l = level + d;
+					if(len == -1 || l < len) len = l;
+				}
+			}
+		}
+
+		array_append(levels[side], next);
+
+		// either frontiers met or one of them is depleted
+		if(len != -1 || array_len(next) == 0) break;
+	}
+
+	//--------------------------------------------------------------------------
+	// collect nodes on shortest paths
+	//--------------------------------------------------------------------------
+
+	if(len != -1) {
+		// every shortest path crosses the source side's level 'k'
+		// at a node whose distance from the destination is 'len - k'
+		// both distances are known for such nodes
+		uint64_t src_depth  = array_len(levels[SRC_SIDE]) - 1;
+		uint64_t dest_depth = array_len(levels[DEST_SIDE]) - 1;
+		uint64_t k = (len > dest_depth) ? len - dest_depth : 0;
+		ASSERT(k <= src_depth);
+		UNUSED(src_depth);
+
+		NodeID *cut = array_new(NodeID, 0);
+		NodeID *candidates = levels[SRC_SIDE][k];
+		uint n = array_len(candidates);
+		for(uint i = 0; i < n; i++) {
+			uint64_t d;
+			NodeID id = candidates[i];
+			if(_GetDistance(dist[DEST_SIDE], id, &d) && d == len - k) {
+				GrB_Vector_setElement_UINT64(*distances, k, id);
+				array_append(cut, id);
+			}
+		}
+
+		// walk back towards the source
+		NodeID *nodes = cut;
+		for(uint64_t i = k; i > 0; i--) {
+			NodeID *prev = _PropagateLevel(t, nodes, true, dist[SRC_SIDE],
+					i - 1, i - 1, *distances, &neighbors);
+			if(nodes != cut) array_free(nodes);
+			nodes = prev;
+		}
+		if(nodes != cut) array_free(nodes);
+
+		// walk forward towards the destination
+		nodes = cut;
+		for(uint64_t i = k + 1; i <= (uint64_t)len; i++) {
+			NodeID *next = _PropagateLevel(t, nodes, false, dist[DEST_SIDE],
+					len - i, i, *distances, &neighbors);
+			if(nodes != cut) array_free(nodes);
+			nodes = next;
+		}
+		if(nodes != cut) array_free(nodes);
+
+		array_free(cut);
+	} else {
+		GrB_free(distances);
+		*distances = NULL;
+	}
+
+	// clean up
+	for(int side = 0; side < 2; side++) {
+		uint level_count = array_len(levels[side]);
+		for(uint i = 0; i < level_count; i++) array_free(levels[side][i]);
+		array_free(levels[side]);
+		GrB_free(dist + side);
+	}
+	array_free(neighbors);
+
+	return len;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../graph/graph.h"
+#include "../execution_plan/record.h"
+#include "../filter_tree/filter_tree.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// bidirectional BFS
+// finds the length of the shortest paths connecting two nodes by expanding
+// a frontier from each end, always advancing the smaller of the two
+// until the frontiers meet
+//
+// once the length is known, the nodes lying on shortest paths are
+// collected together with their distance from the source, allowing
+// shortest paths to be reconstructed without exploring dead ends
+//
+// unfiltered traversals iterate the relationship matrices, using their
+// transposes when traversing from the destination, filtered traversals
+// inspect each edge
+
+typedef struct {
+	Graph *g;                 // graph to traverse
+	const int *relationIDs;   // relationship type(s) to traverse
+	int relationCount;        // number of relationship types
+	GRAPH_EDGE_DIR dir;       // traversal direction from source to destination
+	FT_FilterNode *ft;        // edge filters, NULL if edges aren't filtered
+	Record r;                 // record edge filters are evaluated against
+	uint edge_idx;            // record index of the filtered edge
+} BFSTraversal;
+
+// computes the number of edges on the shortest paths from 'src' to 'dest'
+// returns -1 if 'dest' can't be reached by a path of at most 'max_len' edges
+// otherwise 'distances' maps each node on a shortest path to its
+// distance from 'src', the caller is responsible for freeing it
+int64_t BidirectionalBFS
+(
+	const BFSTraversal *t,  // traversal
+	NodeID src,             // source node
+	NodeID dest,            // destination node
+	uint64_t max_len,       // maximum number of edges on path
+	GrB_Vector *distances   // [output] distance from 'src' of on-path nodes
+);
+
+// appends the neighbors of 'id' reached by a single hop to 'neighbors'
+// if 'reverse' is set edges are followed from destination to source
+void BidirectionalBFS_Neighbors
+(
+	const BFSTraversal *t,  // traversal
+	NodeID id,              // node to expand
+	bool reverse,           // follow edges in reverse
+	NodeID **neighbors      // [output] neighbor IDs
+);
@@ -100,6 +100,54 @@ void Avg_Finalize
 	}
 }
 
+// current average of an avarage context
+static inline long double _Avg_Mean
+(
+	const AvgCtx *avg_ctx
+) {
+	// when using the incremental algorithm 'total' is the average
+	if(avg_ctx->overflow) return avg_ctx->total;
+	return avg_ctx->total / avg_ctx->count;
+}
+
+// merge partial averages
+void Avg_Merge
+(
+	void *dest,
+	void *src
+) {
+	AvgCtx *dest_ctx = ((AggregateCtx*)dest)->private_data;
+	AvgCtx *src_ctx  = ((AggregateCtx*)src)->private_data;
+
+	if(src_ctx == NULL || src_ctx->count == 0) return;
+
+	if(dest_ctx == NULL) {
+		dest_ctx = ((AggregateCtx*)dest)->private_data =
+			rm_calloc(1, sizeof(AvgCtx));
+	}
+
+	if(dest_ctx->count == 0) {
+		*dest_ctx = *src_ctx;
+		return;
+	}
+
+	size_t count = dest_ctx->count + src_ctx->count;
+
+	if(!dest_ctx->overflow && !src_ctx->overflow &&
+	   !ABOUT_TO_OVERFLOW(dest_ctx->total, src_ctx->total)) {
+		dest_ctx->total += src_ctx->total;
+	} else {
+		// weighted average of both partial averages
+		long double dest_w = (long double)dest_ctx->count / count;
+		long double src_w  = (long double)src_ctx->count / count;
+		dest_ctx->total = _Avg_Mean(dest_ctx) * dest_w +
+			_Avg_Mean(src_ctx) * src_w;
+		dest_ctx->overflow = true;
+	}
+
+	dest_ctx->count = count;
+}
+
 AggregateCtx *Avg_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -119,7 +167,7 @@ void Register_AVG(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("avg", AGG_AVG, 1, 1, types, ret_type,
-			rm_free, Avg_Finalize, Avg_PrivateData);
+			rm_free, Avg_Finalize, Avg_Merge, Avg_PrivateData);
 
 	AR_RegFunc(func_desc);
 }
@@ -45,8 +45,10 @@ void Register_COLLECT(void) {
 	types = array_new(SIType, 2);
 	array_append(types, SI_ALL);
 	ret_type = T_NULL | T_ARRAY;
+	// collect is order sensitive, partial collections aren't merged
+	// as doing so wouldn't preserve the order in which values were consumed
 	func_desc = AR_AggFuncDescNew("collect", AGG_COLLECT, 1, 1, types, ret_type,
-			NULL, NULL, Collect_PrivateData);
+			NULL, NULL, NULL, Collect_PrivateData);
 	AR_RegFunc(func_desc);
 }
 
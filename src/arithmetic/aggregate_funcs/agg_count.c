@@ -25,6 +25,14 @@ AggregateResult AGG_COUNT(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+// merge partial counts
+void Count_Merge(void *dest, void *src) {
+	AggregateCtx *dest_ctx = dest;
+	AggregateCtx *src_ctx = src;
+
+	dest_ctx->result.longval += src_ctx->result.longval;
+}
+
 AggregateCtx *Count_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -44,7 +52,7 @@ void Register_COUNT(void) {
 	array_append(types, SI_ALL);
 	ret_type = T_INT64;
 	func_desc = AR_AggFuncDescNew("count", AGG_COUNT, 1, 1, types, ret_type,
-			NULL, NULL, Count_PrivateData);
+			NULL, NULL, Count_Merge, Count_PrivateData);
 	AR_RegFunc(func_desc);
 }
 
@@ -20,6 +20,7 @@ AR_FuncDesc *AR_AggFuncDescNew
 	SIType ret_type,                    // return type
 	AR_Func_Free free,                  // free aggregation callback
 	AR_Func_Finalize finalize,          // finalize aggregation callback
+	AR_Func_Merge merge,                // merge partial aggregations callback
 	AR_Func_PrivateData private_data    // generate private data
 ) {
 	AR_FuncDesc *desc = rm_calloc(1, sizeof(AR_FuncDesc));
@@ -35,6 +36,7 @@ AR_FuncDesc *AR_AggFuncDescNew
 	desc->reducible               =  false;
 	desc->callbacks.free          =  free;
 	desc->callbacks.finalize      =  finalize;
+	desc->callbacks.merge         =  merge;
 	desc->callbacks.private_data  =  private_data;
 
 	return desc;
@@ -59,6 +61,21 @@ void Aggregate_SetResult
 	ctx->result = result;
 }
 
+// merge partial aggregation src into dest
+void Aggregate_Merge
+(
+	AR_FuncDesc *func_desc,
+	AggregateCtx *dest,
+	AggregateCtx *src
+) {
+	ASSERT(src != NULL);
+	ASSERT(dest != NULL);
+	ASSERT(func_desc != NULL);
+	ASSERT(func_desc->callbacks.merge != NULL);
+
+	func_desc->callbacks.merge(dest, src);
+}
+
 void Aggregate_Finalize
 (
 	AR_FuncDesc *func_desc,
@@ -24,6 +24,7 @@ AR_FuncDesc *AR_AggFuncDescNew
 	SIType ret_type,                    // return type
 	AR_Func_Free free,                  // free aggregation callback
 	AR_Func_Finalize finalize,          // finalize aggregation callback
+	AR_Func_Merge merge,                // merge partial aggregations callback
 	AR_Func_PrivateData private_data    // generate private data
 );
 
@@ -43,6 +44,15 @@ void Aggregate_SetResult
 	SIValue result
 );
 
+// merge partial aggregation src into dest
+// both contexts must be produced by the same aggregation function
+void Aggregate_Merge
+(
+	AR_FuncDesc *func_desc,
+	AggregateCtx *dest,
+	AggregateCtx *src
+);
+
 void Aggregate_Finalize
 (
 	AR_FuncDesc *func_desc,
@@ -29,6 +29,12 @@ AggregateResult AGG_MAX(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+// merge partial maximum, src's result is aggregated into dest
+void Max_Merge(void *dest, void *src) {
+	AggregateCtx *src_ctx = src;
+	AGG_MAX(&src_ctx->result, 1, dest);
+}
+
 AggregateCtx *Max_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -48,7 +54,7 @@ void Register_MAX(void) {
 	array_append(types, SI_ALL);
 	ret_type = SI_ALL;
 	func_desc = AR_AggFuncDescNew("max", AGG_MAX, 1, 1, types, ret_type, NULL,
-			NULL, Max_PrivateData);
+			NULL, Max_Merge, Max_PrivateData);
 	AR_RegFunc(func_desc);
 }
 
@@ -29,6 +29,12 @@ AggregateResult AGG_MIN(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+// merge partial minimum, src's result is aggregated into dest
+void Min_Merge(void *dest, void *src) {
+	AggregateCtx *src_ctx = src;
+	AGG_MIN(&src_ctx->result, 1, dest);
+}
+
 AggregateCtx *Min_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -48,7 +54,7 @@ void Register_MIN(void) {
 	array_append(types, SI_ALL);
 	ret_type = SI_ALL;
 	func_desc = AR_AggFuncDescNew("min", AGG_MIN, 1, 1, types, ret_type, NULL,
-			NULL, Min_PrivateData);
+			NULL, Min_Merge, Min_PrivateData);
 	AR_RegFunc(func_desc);
 }
 
@@ -122,6 +122,27 @@ void Percentile_Free(void *pdata) {
 	rm_free(ctx);
 }
 
+// merge partial percentile contexts, concatenating their values
+void Percentile_Merge(void *dest, void *src) {
+	_agg_PercCtx *dest_ctx = ((AggregateCtx *)dest)->private_data;
+	_agg_PercCtx *src_ctx = ((AggregateCtx *)src)->private_data;
+
+	if(src_ctx->values == NULL) return;
+
+	if(dest_ctx->values == NULL) {
+		// dest didn't aggregate any value, take over src's values
+		dest_ctx->percentile = src_ctx->percentile;
+		dest_ctx->values = src_ctx->values;
+		src_ctx->values = NULL;
+		return;
+	}
+
+	uint count = array_len(src_ctx->values);
+	for(uint i = 0; i < count; i++) {
+		array_append(dest_ctx->values, src_ctx->values[i]);
+	}
+}
+
 AggregateCtx *Precentile_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -148,7 +169,7 @@ void Register_PRECENTILE(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("percentileDisc", AGG_PERC, 2, 2, types, ret_type,
-			Percentile_Free, PercDiscFinalize, Precentile_PrivateData);
+			Percentile_Free, PercDiscFinalize, Percentile_Merge, Precentile_PrivateData);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 3);
@@ -156,7 +177,7 @@ void Register_PRECENTILE(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("percentileCont", AGG_PERC, 2, 2, types, ret_type,
-			Percentile_Free, PercContFinalize, Precentile_PrivateData);
+			Percentile_Free, PercContFinalize, Percentile_Merge, Precentile_PrivateData);
 	AR_RegFunc(func_desc);
 }
 
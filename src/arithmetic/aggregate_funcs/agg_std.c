@@ -81,6 +81,28 @@ void StDev_Free(void *pdata) {
 	rm_free(pdata);
 }
 
+// merge partial standard deviation contexts, concatenating their values
+void StDev_Merge(void *dest, void *src) {
+	_agg_StDevCtx *dest_ctx = ((AggregateCtx *)dest)->private_data;
+	_agg_StDevCtx *src_ctx = ((AggregateCtx *)src)->private_data;
+
+	if(src_ctx->values == NULL) return;
+
+	if(dest_ctx->values == NULL) {
+		// dest didn't aggregate any value, take over src's values
+		dest_ctx->total = src_ctx->total;
+		dest_ctx->values = src_ctx->values;
+		src_ctx->values = NULL;
+		return;
+	}
+
+	uint count = array_len(src_ctx->values);
+	for(uint i = 0; i < count; i++) {
+		array_append(dest_ctx->values, src_ctx->values[i]);
+	}
+	dest_ctx->total += src_ctx->total;
+}
+
 AggregateCtx *STD_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -106,14 +128,14 @@ void Register_STD(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("stDev", AGG_STDEV, 1, 1, types, ret_type,
-			StDev_Free, StDevFinalize, STD_PrivateData);
+			StDev_Free, StDevFinalize, StDev_Merge, STD_PrivateData);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 2);
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("stDevP", AGG_STDEV, 1, 1, types, ret_type,
-			StDev_Free, StDevPFinalize, STD_PrivateData);
+			StDev_Free, StDevPFinalize, StDev_Merge, STD_PrivateData);
 	AR_RegFunc(func_desc);
 }
 
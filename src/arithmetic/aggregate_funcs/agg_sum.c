@@ -25,6 +25,14 @@ AggregateResult AGG_SUM(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
+// merge partial sums
+void SUM_Merge(void *dest, void *src) {
+	AggregateCtx *dest_ctx = dest;
+	AggregateCtx *src_ctx = src;
+
+	dest_ctx->result.doubleval += src_ctx->result.doubleval;
+}
+
 AggregateCtx *SUM_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -44,7 +52,7 @@ void Register_SUM(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("sum", AGG_SUM, 1, 1, types, ret_type, NULL,
-			NULL, SUM_PrivateData);
+			NULL, SUM_Merge, SUM_PrivateData);
 	AR_RegFunc(func_desc);
 }
 
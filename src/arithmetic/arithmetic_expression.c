@@ -729,6 +729,25 @@ SIValue AR_EXP_FinalizeAggregations
 	return AR_EXP_Evaluate(root, r);
 }
 
+void AR_EXP_MergeAggregations(AR_ExpNode *dest, AR_ExpNode *src) {
+	ASSERT(src  != NULL);
+	ASSERT(dest != NULL);
+
+	if(AGGREGATION_NODE(dest)) {
+		ASSERT(AGGREGATION_NODE(src));
+		ASSERT(dest->op.f == src->op.f);
+		Aggregate_Merge(dest->op.f, dest->op.private_data, src->op.private_data);
+		return;
+	}
+
+	if(AR_EXP_IsOperation(dest)) {
+		ASSERT(NODE_CHILD_COUNT(dest) == NODE_CHILD_COUNT(src));
+		for(int i = 0; i < NODE_CHILD_COUNT(dest); i++) {
+			AR_EXP_MergeAggregations(NODE_CHILD(dest, i), NODE_CHILD(src, i));
+		}
+	}
+}
+
 void AR_EXP_CollectEntities(AR_ExpNode *root, rax *aliases) {
 	if(AR_EXP_IsOperation(root)) {
 		for(int i = 0; i < root->op.child_count; i ++) {
@@ -773,6 +792,22 @@ bool AR_EXP_ContainsAggregation(AR_ExpNode *root) {
 	return false;
 }
 
+bool AR_EXP_MergeableAggregation(AR_ExpNode *root) {
+	if(AGGREGATION_NODE(root)) {
+		return (root->op.f->callbacks.merge != NULL &&
+				!AR_EXP_PerformsDistinct(root));
+	}
+
+	if(AR_EXP_IsOperation(root)) {
+		for(int i = 0; i < root->op.child_count; i++) {
+			AR_ExpNode *child = root->op.children[i];
+			if(!AR_EXP_MergeableAggregation(child)) return false;
+		}
+	}
+
+	return true;
+}
+
 bool AR_EXP_ContainsFunc(const AR_ExpNode *root, const char *func) {
 	if(root == NULL) return false;
 	if(AR_EXP_IsOperation(root)) {
@@ -118,6 +118,10 @@ void AR_EXP_Aggregate(AR_ExpNode *root, const Record r);
 // and evaluates the expression
 SIValue AR_EXP_FinalizeAggregations(AR_ExpNode *root, const Record r);
 
+// merge partial aggregations of src into dest
+// both expressions must be clones of the same expression
+void AR_EXP_MergeAggregations(AR_ExpNode *dest, AR_ExpNode *src);
+
 //------------------------------------------------------------------------------
 // Utility functions
 //------------------------------------------------------------------------------
@@ -134,6 +138,10 @@ void AR_EXP_CollectAttributes(AR_ExpNode *root, rax *attributes);
 // please note an expression tree can't contain nested aggregation nodes
 bool AR_EXP_ContainsAggregation(AR_ExpNode *root);
 
+// returns true if every aggregation within the expression tree supports
+// merging partial aggregations, distinct aggregations can't be merged
+bool AR_EXP_MergeableAggregation(AR_ExpNode *root);
+
 // constructs string representation of arithmetic expression tree
 void AR_EXP_ToString(const AR_ExpNode *root, char **str);
 
@@ -586,13 +586,12 @@ static AR_ExpNode *_AR_ExpFromShortestPath
 
 	// Instantiate a context struct with traversal details.
 	ShortestPathCtx *ctx = rm_malloc(sizeof(ShortestPathCtx));
-	ctx->R              =  GrB_NULL;
 	ctx->minHops        =  start;
 	ctx->maxHops        =  end;
 	ctx->reltypes       =  NULL;
 	ctx->reltype_names  =  reltype_names;
 	ctx->reltype_count  =  array_len(reltype_names);
-	ctx->free_matrices  =  false;
+	ctx->resolved       =  false;
 
 	AR_SetPrivateData(op, ctx);
 	AR_ExpNode *src;
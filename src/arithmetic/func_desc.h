@@ -28,6 +28,9 @@ typedef void (*AR_Func_Finalize)(void *ctx);
 // AR_Func_Free - function pointer to a routine for freeing a function's private data
 typedef void (*AR_Func_Free)(void *ctx);
 
+// AR_Func_Merge - function pointer to a routine for merging a partial aggregation into another
+typedef void (*AR_Func_Merge)(void *dest, void *src);
+
 // AR_Func_Clone - function pointer to a routine for cloning a function's private data
 typedef void *(*AR_Func_Clone)(void *orig);
 
@@ -39,6 +42,7 @@ typedef struct {
 	AR_Func_Free free;                  // [optional] function pointer to cleanup routine
 	AR_Func_Clone clone;                // [optional] function pointer to clone routine
 	AR_Func_Finalize finalize;          // [optional] function pointer to finalizing aggregate value routine
+	AR_Func_Merge merge;                // [optional] function pointer to merging partial aggregations routine
 	AR_Func_PrivateData private_data;   // function pointer to private data generator
 } AR_FuncCBs;
 
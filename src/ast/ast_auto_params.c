@@ -0,0 +1,349 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "ast_auto_params.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <strings.h>
+
+// maximum nesting depth of square brackets tracked while scanning
+#define MAX_BRACKET_DEPTH 64
+
+// a literal lifted out of the query
+typedef struct {
+	size_t start;  // literal offset within the query
+	size_t len;    // literal length
+	SIValue v;     // literal value
+} Literal;
+
+static inline bool _IdentChar
+(
+	char c
+) {
+	return isalnum((unsigned char)c) || c == '_' || (unsigned char)c >= 0x80;
+}
+
+static inline bool _IsKeyword
+(
+	const char *token,  // token to inspect
+	size_t len,         // token length
+	const char *kw      // keyword
+) {
+	return strlen(kw) == len && strncasecmp(token, kw, len) == 0;
+}
+
+// returns true if params contains a parameter with the auto param prefix
+static bool _HasAutoParam
+(
+	rax *params
+) {
+	size_t prefix_len = strlen(AUTO_PARAM_PREFIX);
+
+	raxIterator it;
+	raxStart(&it, params);
+	raxSeek(&it, ">=", (unsigned char *)AUTO_PARAM_PREFIX, prefix_len);
+	bool found = raxNext(&it) && it.key_len >= prefix_len &&
+		memcmp(it.key, AUTO_PARAM_PREFIX, prefix_len) == 0;
+	raxStop(&it);
+
+	return found;
+}
+
+static void _FreeLiterals
+(
+	Literal *literals
+) {
+	uint n = array_len(literals);
+	for(uint i = 0; i < n; i++) SIValue_Free(literals[i].v);
+	array_free(literals);
+}
+
+bool AST_ScanNumber
+(
+	const char *query,  // query
+	size_t *i,          // literal offset
+	SIValue *v          // [output] literal value
+) {
+	size_t start = *i;
+	size_t j = start;
+	bool is_float = false;
+
+	while(isdigit((unsigned char)query[j])) j++;
+	if(query[j] == '.' && isdigit((unsigned char)query[j + 1])) {
+		is_float = true;
+		j++;
+		while(isdigit((unsigned char)query[j])) j++;
+	}
+
+	// hexadecimal, exponent and malformed numbers are left to the parser
+	if(_IdentChar(query[j])) {
+		bool exponent = (query[j] == 'e' || query[j] == 'E');
+		while(_IdentChar(query[j])) j++;
+		if(exponent && (query[j] == '+' || query[j] == '-')) {
+			j++;
+			while(_IdentChar(query[j])) j++;
+		}
+		*i = j;
+		return false;
+	}
+
+	*i = j;
+
+	char buf[64];
+	size_t len = j - start;
+	if(len >= sizeof(buf)) return false;
+	memcpy(buf, query + start, len);
+	buf[len] = '\0';
+
+	if(is_float) {
+		*v = SI_DoubleVal(strtod(buf, NULL));
+		return true;
+	}
+
+	// integers with a leading zero are interpreted as octal
+	if(len > 1 && buf[0] == '0') return false;
+
+	// leave overflowing integers for the parser to report
+	errno = 0;
+	long long l = strtoll(buf, NULL, 10);
+	if(errno == ERANGE) return false;
+
+	*v = SI_LongVal(l);
+	return true;
+}
+
+char *AST_AutoParameterize
+(
+	const char *query,  // query body, excluding the CYPHER parameters prefix
+	rax *params         // query parameters, lifted literals are added to it
+) {
+	ASSERT(query  != NULL);
+	ASSERT(params != NULL);
+
+	// synthetic parameters must not collide with the query's own
+	if(strstr(query, AUTO_PARAM_PREFIX) != NULL || _HasAutoParam(params)) {
+		return NULL;
+	}
+
+	Literal  *literals     = array_new(Literal, 0);
+	uint64_t rel_brackets = 0;      // bitmap of open relationship brackets
+	uint     depth        = 0;      // square brackets nesting depth
+	uint     rel_open     = 0;      // number of open relationship brackets
+	bool     projecting   = false;  // scanning a RETURN clause
+	bool     keep_next    = false;  // following literal must not be lifted
+	char     prev         = '\0';   // last scanned token character
+
+	size_t i = 0;
+	while(query[i] != '\0') {
+		char c = query[i];
+
+		if(isspace((unsigned char)c)) {
+			i++;
+			continue;
+		}
+
+		//----------------------------------------------------------------------
+		// comments
+		//----------------------------------------------------------------------
+
+		if(c == '/' && query[i + 1] == '/') {
+			while(query[i] != '\0' && query[i] != '\n') i++;
+			continue;
+		}
+
+		if(c == '/' && query[i + 1] == '*') {
+			const char *end = strstr(query + i + 2, "*/");
+			if(end == NULL) goto invalid;
+			i = end - query + 2;
+			continue;
+		}
+
+		//----------------------------------------------------------------------
+		// escaped identifiers e.g. `my label`
+		//----------------------------------------------------------------------
+
+		if(c == '`') {
+			const char *end = strchr(query + i + 1, '`');
+			if(end == NULL) goto invalid;
+			i = end - query + 1;
+			prev = c;
+			keep_next = false;
+			continue;
+		}
+
+		//----------------------------------------------------------------------
+		// parameters e.g. $name
+		//----------------------------------------------------------------------
+
+		if(c == '$') {
+			i++;
+			while(_IdentChar(query[i])) i++;
+			prev = c;
+			keep_next = false;
+			continue;
+		}
+
+		//----------------------------------------------------------------------
+		// identifiers and keywords
+		//----------------------------------------------------------------------
+
+		if(isalpha((unsigned char)c) || c == '_' || (unsigned char)c >= 0x80) {
+			size_t start = i;
+			while(_IdentChar(query[i])) i++;
+			size_t len = i - start;
+
+			keep_next = false;
+			// attribute names and labels are not keywords e.g. n.limit
+			if(prev != '.' && prev != ':') {
+				const char *token = query + start;
+				if(_IsKeyword(token, len, "RETURN")) {
+					// projected literals name their columns
+					projecting = true;
+				} else if(_IsKeyword(token, len, "UNION")) {
+					projecting = false;
+				} else if(_IsKeyword(token, len, "SKIP") ||
+						_IsKeyword(token, len, "LIMIT")) {
+					// SKIP and LIMIT values are validated at compile time
+					keep_next = true;
+				}
+			}
+
+			prev = 'a';
+			continue;
+		}
+
+		//----------------------------------------------------------------------
+		// numeric literals
+		//----------------------------------------------------------------------
+
+		if(isdigit((unsigned char)c)) {
+			size_t  start = i;
+			SIValue v;
+			bool    lift = AST_ScanNumber(query, &i, &v);
+
+			// numbers within relationship brackets might be traversal bounds
+			// e.g. -[*1..3]->
+			// numbers following a dot are range bounds e.g. list[1..3]
+			lift &= !projecting && !keep_next && rel_open == 0 && prev != '.' &&
+				array_len(literals) < AUTO_PARAM_MAX;
+
+			if(lift) {
+				Literal l = {.start = start, .len = i - start, .v = v};
+				array_append(literals, l);
+			}
+
+			prev = '0';
+			keep_next = false;
+			continue;
+		}
+
+		//----------------------------------------------------------------------
+		// string literals
+		//----------------------------------------------------------------------
+
+		if(c == '\'' || c == '"') {
+			size_t start = i++;
+			bool escaped = false;
+
+			while(query[i] != c) {
+				if(query[i] == '\0') goto invalid;
+				if(query[i] == '\\') {
+					escaped = true;
+					i++;
+					if(query[i] == '\0') goto invalid;
+				}
+				i++;
+			}
+			i++;  // skip closing quote
+
+			// escape sequences are left for the parser to interpret
+			if(!escaped && !projecting && !keep_next &&
+					array_len(literals) < AUTO_PARAM_MAX) {
+				char *s = rm_strndup(query + start + 1, i - start - 2);
+				Literal l = {.start = start, .len = i - start,
+					.v = SI_TransferStringVal(s)};
+				array_append(literals, l);
+			}
+
+			prev = c;
+			keep_next = false;
+			continue;
+		}
+
+		//----------------------------------------------------------------------
+		// punctuation
+		//----------------------------------------------------------------------
+
+		if(c == '[') {
+			if(depth == MAX_BRACKET_DEPTH) goto invalid;
+			// '[' following '-' opens a relationship pattern e.g. -[:R]->
+			if(prev == '-') {
+				rel_brackets |= (1ULL << depth);
+				rel_open++;
+			} else {
+				rel_brackets &= ~(1ULL << depth);
+			}
+			depth++;
+		} else if(c == ']' && depth > 0) {
+			depth--;
+			if(rel_brackets & (1ULL << depth)) rel_open--;
+		}
+
+		prev = c;
+		keep_next = false;
+		i++;
+	}
+
+	uint n = array_len(literals);
+	if(n == 0) {
+		array_free(literals);
+		return NULL;
+	}
+
+	//--------------------------------------------------------------------------
+	// build normalized query
+	//--------------------------------------------------------------------------
+
+	// each literal is replaced by '$' AUTO_PARAM_PREFIX <index>
+	size_t query_len = i;
+	char *normalized = rm_malloc(query_len +
+			n * (sizeof(AUTO_PARAM_PREFIX) + 4) + 1);
+
+	char   *out    = normalized;
+	size_t  offset = 0;
+	for(uint j = 0; j < n; j++) {
+		Literal *l = literals + j;
+
+		memcpy(out, query + offset, l->start - offset);
+		out += l->start - offset;
+		offset = l->start + l->len;
+
+		char name[32];
+		int name_len = snprintf(name, sizeof(name), AUTO_PARAM_PREFIX "%u", j);
+		*out++ = '$';
+		memcpy(out, name, name_len);
+		out += name_len;
+
+		// params take ownership over the literal's value
+		SIValue *v = rm_malloc(sizeof(SIValue));
+		*v = l->v;
+		raxInsert(params, (unsigned char *)name, name_len, v, NULL);
+	}
+	memcpy(out, query + offset, query_len - offset + 1);
+
+	array_free(literals);
+	return normalized;
+
+invalid:
+	_FreeLiterals(literals);
+	return NULL;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "rax.h"
+#include "../value.h"
+
+// prefix of parameters introduced by AST_AutoParameterize
+#define AUTO_PARAM_PREFIX "__lit"
+
+// maximum number of literals lifted out of a single query
+#define AUTO_PARAM_MAX 256
+
+// normalizes query by lifting its literals into synthetic parameters
+// e.g. MATCH (n:User {id: 17}) RETURN n
+// is rewritten as:
+// MATCH (n:User {id: $__lit0}) RETURN n
+// and parameter '__lit0' is added to 'params' with the value 17
+//
+// queries differing only by their literals share the same normalized form
+// and as a result the same cached execution plan
+//
+// literals which the query relies on at compile time are left as is:
+// projected literals naming columns, variable length traversal bounds,
+// SKIP and LIMIT values
+//
+// returns normalized query, NULL if no literal was lifted
+// caller is responsible for freeing the returned string
+char *AST_AutoParameterize
+(
+	const char *query,  // query body, excluding the CYPHER parameters prefix
+	rax *params         // query parameters, lifted literals are added to it
+);
+
+// scans the unsigned decimal literal starting at offset 'i' of 'query'
+// advancing 'i' past it
+// returns true and sets 'v' if the literal is an integer or a float
+// hexadecimal, octal, exponent, out of range and malformed numbers
+// are left for the parser to interpret, in which case false is returned
+bool AST_ScanNumber
+(
+	const char *query,  // query
+	size_t *i,          // [input/output] literal offset
+	SIValue *v          // [output] literal value
+);
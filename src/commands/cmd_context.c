@@ -7,6 +7,7 @@
 #include "cmd_context.h"
 #include "RG.h"
 #include "../query_ctx.h"
+#include "../util/arr.h"
 #include "../util/rmalloc.h"
 #include "../util/thpool/pools.h"
 #include "../slow_log/slow_log.h"
@@ -36,11 +37,16 @@ CommandCtx *CommandCtx_New
 	context->query              = NULL;
 	context->thread             = thread;
 	context->compact            = compact;
+	context->binary             = false;
 	context->timeout            = timeout;
 	context->graph_ctx          = graph_ctx;
 	context->command_name       = NULL;
 	context->timeout_rw         = timeout_rw;
 	context->replicated_command = replicated_command;
+	context->statement          = -1;
+	context->params             = NULL;
+	context->cursor             = 0;
+	context->deny_write         = false;
 
 	if(cmd_name) {
 		// Make a copy of command name.
@@ -145,6 +151,9 @@ void CommandCtx_Free(CommandCtx *command_ctx) {
 	CommandCtx_UntrackCtx(command_ctx);
 
 	if(command_ctx->query) rm_free(command_ctx->query);
+	if(command_ctx->params) {
+		array_free_cb(command_ctx->params, rm_free);
+	}
 	rm_free(command_ctx->command_name);
 	rm_free(command_ctx);
 }
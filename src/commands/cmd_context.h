@@ -26,9 +26,14 @@ typedef struct {
 	RedisModuleBlockedClient *bc;   // Blocked client.
 	bool replicated_command;        // Whether this instance was spawned by a replication command.
 	bool compact;                   // Whether this query was issued with the compact flag.
+	bool binary;                    // Whether this query was issued with the binary flag.
 	ExecutorThread thread;          // Which thread executes this command
 	long long timeout;              // The query timeout, if specified.
 	bool timeout_rw;                // Apply timeout on both read and write queries.
+	int64_t statement;              // Prepared statement handle, -1 if none.
+	char **params;                  // Prepared statement parameters, name value pairs.
+	long long cursor;               // Rows per cursor read, 0 if no cursor is used.
+	bool deny_write;                // Reject write queries, readonly command on a replica or out of memory.
 } CommandCtx;
 
 // Create a new command context.
@@ -0,0 +1,175 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "cursors.h"
+#include "commands.h"
+#include "cmd_context.h"
+#include "../errors.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../slow_log/slow_log.h"
+#include "../util/thpool/pools.h"
+#include "../util/blocked_client.h"
+
+// cursor command arguments
+typedef struct {
+	CommandCtx *command_ctx;  // command context
+	uint64_t id;              // cursor id
+	uint64_t count;           // number of rows to read, 0 for cursor's default
+	bool del;                 // delete cursor
+} CursorCommandCtx;
+
+// reads from or deletes a cursor
+static void _Graph_Cursor
+(
+	void *args
+) {
+	CursorCommandCtx *cursor_ctx  = (CursorCommandCtx *)args;
+	CommandCtx       *command_ctx = cursor_ctx->command_ctx;
+	RedisModuleCtx   *ctx         = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext     *gc          = CommandCtx_GetGraphContext(command_ctx);
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	// take the cursor, making it unavailable to other commands
+	Cursor *cursor = Cursor_Resume(cursor_ctx->id, command_ctx);
+	if(cursor == NULL) {
+		RedisModule_ReplyWithError(ctx, "Cursor not found");
+		goto cleanup;
+	}
+
+	if(cursor_ctx->del) {
+		Cursor_Free(cursor);
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+		goto cleanup;
+	}
+
+	QueryCtx_BeginTimer(); // start read timing
+
+	Graph_AcquireReadLock(gc->g);
+
+	// set policy after lock acquisition,
+	// avoid resetting policies between readers and writers
+	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
+
+	// the suspended query can't resume once the graph was modified
+	bool depleted = true;
+	if(Cursor_Valid(cursor)) {
+		depleted = Cursor_Read(cursor, ctx, cursor_ctx->count);
+	} else {
+		RedisModule_ReplyWithError(ctx,
+				"Cursor invalidated, graph was modified since the last read");
+	}
+
+	// log read to slowlog
+	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
+	SlowLog_Add(slowlog, command_ctx->command_name, cursor->query,
+				QueryCtx_GetExecutionTime(), NULL);
+
+	if(!depleted) Cursor_Suspend(cursor);
+
+	Graph_ReleaseLock(gc->g);
+
+	if(depleted) Cursor_Free(cursor);
+
+cleanup:
+	GraphContext_DecreaseRefCount(gc);
+	CommandCtx_Free(command_ctx);
+	ErrorCtx_Clear();
+	rm_free(cursor_ctx);
+}
+
+// usage:
+// GRAPH.CURSOR READ <graph> <cursor id> [COUNT <count>]
+// GRAPH.CURSOR DEL <graph> <cursor id>
+int Graph_Cursor
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+) {
+	//--------------------------------------------------------------------------
+	// validations
+	//--------------------------------------------------------------------------
+
+	ASSERT(ctx  != NULL);
+	ASSERT(argv != NULL);
+	if(argc != 4 && argc != 6) return RedisModule_WrongArity(ctx);
+
+	const char *sub_cmd = RedisModule_StringPtrLen(argv[1], NULL);
+	bool del = strcasecmp(sub_cmd, "del") == 0;
+	if(!del && strcasecmp(sub_cmd, "read") != 0) {
+		RedisModule_ReplyWithError(ctx, "Unknown subcommand");
+		return REDISMODULE_OK;
+	}
+	if(del && argc != 4) return RedisModule_WrongArity(ctx);
+
+	long long id;
+	if(RedisModule_StringToLongLong(argv[3], &id) != REDISMODULE_OK ||
+	   id <= 0) {
+		RedisModule_ReplyWithError(ctx, "Invalid cursor id");
+		return REDISMODULE_OK;
+	}
+
+	long long count = 0;
+	if(argc == 6) {
+		const char *arg = RedisModule_StringPtrLen(argv[4], NULL);
+		if(strcasecmp(arg, "count") != 0 ||
+		   RedisModule_StringToLongLong(argv[5], &count) != REDISMODULE_OK ||
+		   count <= 0) {
+			RedisModule_ReplyWithError(ctx, "Failed to parse cursor count value");
+			return REDISMODULE_OK;
+		}
+	}
+
+	// get a hold of the graph key
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[2], true, false);
+	if(gc == NULL) {
+		// if GraphContext is null, key access failed and an error been emitted
+		return REDISMODULE_OK;
+	}
+
+	//--------------------------------------------------------------------------
+	// dispatch
+	//--------------------------------------------------------------------------
+
+	// commands issued within a LUA script or multi exec block must
+	// run on Redis main thread, others run on a reader thread
+	int flags = RedisModule_GetContextFlags(ctx);
+	bool main_thread = flags & (REDISMODULE_CTX_FLAGS_MULTI |
+			REDISMODULE_CTX_FLAGS_LUA                       |
+			REDISMODULE_CTX_FLAGS_DENY_BLOCKING             |
+			REDISMODULE_CTX_FLAGS_LOADING);
+
+	CursorCommandCtx *cursor_ctx = rm_malloc(sizeof(CursorCommandCtx));
+	cursor_ctx->id    = id;
+	cursor_ctx->del   = del;
+	cursor_ctx->count = count;
+
+	if(main_thread) {
+		cursor_ctx->command_ctx = CommandCtx_New(ctx, NULL, argv[0], argv[3],
+				gc, EXEC_THREAD_MAIN, false, false, 0, false);
+		_Graph_Cursor(cursor_ctx);
+	} else {
+		RedisModuleBlockedClient *bc = RedisGraph_BlockClient(ctx);
+		cursor_ctx->command_ctx = CommandCtx_New(NULL, bc, argv[0], argv[3],
+				gc, EXEC_THREAD_READER, false, false, 0, false);
+
+		if(ThreadPools_AddWorkReader(_Graph_Cursor, cursor_ctx) ==
+				THPOOL_QUEUE_FULL) {
+			// report an error once our workers thread pool internal queue
+			// is full, this error usually happens when the server is
+			// under heavy load and is unable to catch up
+			RedisModule_ReplyWithError(ctx, "Max pending queries exceeded");
+			GraphContext_DecreaseRefCount(gc);
+			CommandCtx_Free(cursor_ctx->command_ctx);
+			rm_free(cursor_ctx);
+		}
+	}
+
+	return REDISMODULE_OK;
+}
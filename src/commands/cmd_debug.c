@@ -7,6 +7,7 @@
 #include "../util/arr.h"
 #include "../redismodule.h"
 #include "../graph/graphcontext.h"
+#include "../graph/graph_defrag.h"
 #include "../module_event_handlers.h"
 
 void ModuleEventHandler_AUXBeforeKeyspaceEvent(void);
@@ -28,13 +29,162 @@ static void Debug_AUX(RedisModuleString **argv, int argc) {
 	}
 }
 
+// applies a replicated defragmentation step
+// GRAPH.DEBUG DEFRAG <graph> NODES <n>
+// GRAPH.DEBUG DEFRAG <graph> EDGES <relation> <lo> <hi>
+// GRAPH.DEBUG DEFRAG <graph> SHRINK
+// returns false if the step is malformed or couldn't be applied
+static bool Debug_DefragStep(RedisModuleCtx *ctx, GraphContext *gc,
+		RedisModuleString **argv, int argc) {
+	bool res = true;
+	Graph *g = gc->g;
+	const char *step = RedisModule_StringPtrLen(argv[0], NULL);
+
+	if(strcmp(step, "NODES") == 0) {
+		long long n;
+		if(argc != 2 ||
+		   RedisModule_StringToLongLong(argv[1], &n) != REDISMODULE_OK ||
+		   n < 0) {
+			return false;
+		}
+
+		Graph_AcquireWriteLock(g);
+		// the step moved 'n' nodes when it was first applied
+		// moving fewer implies the graph has diverged
+		uint64_t moved = GraphDefrag_MoveNodes(gc, n);
+		res = (moved == (uint64_t)n);
+		Graph_ReleaseLock(g);
+	} else if(strcmp(step, "EDGES") == 0) {
+		long long r;
+		long long lo;
+		long long hi;
+		if(argc != 4 ||
+		   RedisModule_StringToLongLong(argv[1], &r)  != REDISMODULE_OK ||
+		   RedisModule_StringToLongLong(argv[2], &lo) != REDISMODULE_OK ||
+		   RedisModule_StringToLongLong(argv[3], &hi) != REDISMODULE_OK ||
+		   r < 0 || r >= Graph_RelationTypeCount(g) || lo < 0 || hi < lo) {
+			return false;
+		}
+
+		Graph_AcquireWriteLock(g);
+		GraphDefrag_MoveEdges(gc, r, lo, hi);
+		Graph_ReleaseLock(g);
+	} else if(strcmp(step, "SHRINK") == 0) {
+		if(argc != 1) return false;
+
+		Graph_AcquireWriteLock(g);
+		GraphDefrag_Shrink(gc);
+		Graph_ReleaseLock(g);
+	} else {
+		return false;
+	}
+
+	if(!res) {
+		RedisModule_Log(ctx, "warning",
+				"graph '%s' diverged while applying a defragmentation step",
+				GraphContext_GetName(gc));
+	}
+
+	return res;
+}
+
+// GRAPH.DEBUG DEFRAG <graph>
+// schedules an online defragmentation of the graph
+static void Debug_Defrag(RedisModuleCtx *ctx, RedisModuleString **argv,
+		int argc) {
+	if(argc < 2) {
+		RedisModule_WrongArity(ctx);
+		return;
+	}
+
+	// GRAPH.DEBUG is registered as a read only command without keys
+	// such that its other subcommands are available on replicas
+	// steps are only accepted from the primary or while loading the AOF
+	// and defragmentation can only be scheduled on the primary
+	int flags = RedisModule_GetContextFlags(ctx);
+	if(argc > 2) {
+		if(!(flags & (REDISMODULE_CTX_FLAGS_REPLICATED |
+					  REDISMODULE_CTX_FLAGS_LOADING))) {
+			RedisModule_ReplyWithError(ctx,
+					"Graph defragmentation steps are reserved for replication");
+			return;
+		}
+	} else if(flags & REDISMODULE_CTX_FLAGS_SLAVE) {
+		RedisModule_ReplyWithError(ctx,
+				"Graph defragmentation can only be scheduled on the primary");
+		return;
+	}
+
+	// GraphContext_Retrieve replies with an error if graph doesn't exist
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], false, false);
+	if(gc == NULL) return;
+
+	if(argc > 2) {
+		// replicated step, applied synchronously
+		if(Debug_DefragStep(ctx, gc, argv + 2, argc - 2)) {
+			RedisModule_ReplicateVerbatim(ctx);
+			RedisModule_ReplyWithSimpleString(ctx, "OK");
+		} else {
+			RedisModule_ReplyWithError(ctx, "Failed to apply graph defragmentation step");
+		}
+	} else if(GraphDefrag_Schedule(gc, RedisModule_GetSelectedDb(ctx))) {
+		// steps are replicated individually as they're applied
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		RedisModule_ReplyWithError(ctx, "Failed to schedule graph defragmentation");
+	}
+
+	GraphContext_DecreaseRefCount(gc);
+}
+
+// GRAPH.DEBUG CACHE <graph>
+// reports the graph's execution plan cache statistics
+static void Debug_Cache(RedisModuleCtx *ctx, RedisModuleString **argv,
+		int argc) {
+	if(argc < 2) {
+		RedisModule_WrongArity(ctx);
+		return;
+	}
+
+	// GraphContext_Retrieve replies with an error if graph doesn't exist
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	if(gc == NULL) return;
+
+	uint     size;
+	uint64_t hits;
+	uint64_t misses;
+	Cache_GetStats(GraphContext_GetCache(gc), &hits, &misses, &size);
+
+	RedisModule_ReplyWithArray(ctx, 6);
+	RedisModule_ReplyWithStringBuffer(ctx, "hits", 4);
+	RedisModule_ReplyWithLongLong(ctx, hits);
+	RedisModule_ReplyWithStringBuffer(ctx, "misses", 6);
+	RedisModule_ReplyWithLongLong(ctx, misses);
+	RedisModule_ReplyWithStringBuffer(ctx, "size", 4);
+	RedisModule_ReplyWithLongLong(ctx, size);
+
+	GraphContext_DecreaseRefCount(gc);
+}
+
 int Graph_Debug(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	ASSERT(ctx != NULL);
 	ASSERT(graphs_in_keyspace != NULL);
-	RedisModule_ReplicateVerbatim(ctx);
+	if(argc < 2) return RedisModule_WrongArity(ctx);
+
+	const char *arg = RedisModule_StringPtrLen(argv[1], NULL);
+	if(strcmp(arg, "DEFRAG") == 0) {
+		Debug_Defrag(ctx, argv + 1, argc - 1);
+		return REDISMODULE_OK;
+	}
+
+	if(strcmp(arg, "CACHE") == 0) {
+		Debug_Cache(ctx, argv + 1, argc - 1);
+		return REDISMODULE_OK;
+	}
 
-	if(strcmp(RedisModule_StringPtrLen(argv[1], NULL), "AUX") == 0) {
+	if(strcmp(arg, "AUX") == 0) {
 		Debug_AUX(argv + 1, argc - 1);
+		RedisModule_ReplicateVerbatim(ctx);
 	}
 
 	RedisModule_ReplyWithLongLong(ctx, aux_field_counter);
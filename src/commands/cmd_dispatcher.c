@@ -8,6 +8,8 @@
 #include "commands.h"
 #include "cmd_context.h"
 #include "../util/thpool/pools.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
 #include "../util/blocked_client.h"
 #include "../configuration/config.h"
 
@@ -23,9 +25,11 @@ static int _read_flags
 	RedisModuleString **argv,   // commands arguments
   	int argc,                   // number of arguments
   	bool *compact,              // compact result-set format
+  	bool *binary,               // binary columnar result-set format
   	long long *timeout,         // query level timeout 
   	bool *timeout_rw,           // apply timeout on both read and write queries
   	uint *graph_version,        // graph version [UNUSED]
+  	long long *cursor,          // rows per cursor read, 0 if no cursor
   	char **errmsg               // reported error message
 ) {
 	ASSERT(compact != NULL);
@@ -34,7 +38,9 @@ static int _read_flags
 	long long max_timeout;
 
 	// set defaults
+	*cursor  = 0;      // no cursor
 	*compact = false;  // verbose
+	*binary  = false;  // row oriented
 	*graph_version = GRAPH_VERSION_MISSING;
 	Config_Option_get(Config_TIMEOUT_DEFAULT, timeout);
 	Config_Option_get(Config_TIMEOUT_MAX, &max_timeout);
@@ -61,6 +67,9 @@ static int _read_flags
 		if(!strcasecmp(arg, "--compact")) {
 			// compact result-set
 			*compact = true;
+		} else if(!strcasecmp(arg, "--binary")) {
+			// binary columnar result-set
+			*binary = true;
 		} else if(!strcasecmp(arg, "timeout")) {
 			// query timeout
 			int err = REDISMODULE_ERR;
@@ -106,11 +115,76 @@ static int _read_flags
 			}
 
 			continue;
+		} else if(!strcasecmp(arg, "cursor")) {
+			// stream results through a cursor
+			int err = REDISMODULE_ERR;
+			if(i < argc - 1) {
+				i++; // Set the current argument to the cursor count value.
+				err = RedisModule_StringToLongLong(argv[i], cursor);
+			}
+
+			// Emit error on missing, non-positive, or non-numeric count values.
+			if(err != REDISMODULE_OK || *cursor <= 0) {
+				int rc __attribute__((unused));
+				rc = asprintf(errmsg, "Failed to parse cursor count value");
+				return REDISMODULE_ERR;
+			}
 		}
 	}
 	return REDISMODULE_OK;
 }
 
+// GRAPH.EXECUTE <GRAPH_KEY> <HANDLE> [flags] [PARAMS <name> <value> ...]
+// collects the prepared statement handle and its parameters
+// returning REDISMODULE_ERR if parsing failed
+static int _read_statement
+(
+	RedisModuleString **argv,  // commands arguments
+	int *argc,                 // [input/output] number of arguments, set to
+	                           // the number of arguments preceding PARAMS
+	int64_t *statement,        // prepared statement handle
+	char ***params,            // prepared statement parameters
+	char **errmsg              // reported error message
+) {
+	long long handle;
+	if(RedisModule_StringToLongLong(argv[2], &handle) != REDISMODULE_OK ||
+	   handle < 0) {
+		int rc __attribute__((unused));
+		rc = asprintf(errmsg, "Invalid prepared statement handle");
+		return REDISMODULE_ERR;
+	}
+	*statement = handle;
+
+	// locate PARAMS
+	int i = 3;
+	for(; i < *argc; i++) {
+		const char *arg = RedisModule_StringPtrLen(argv[i], NULL);
+		if(!strcasecmp(arg, "params")) break;
+	}
+
+	// no parameters
+	if(i == *argc) return REDISMODULE_OK;
+
+	int nparams = *argc - i - 1;
+
+	// expecting name value pairs
+	if(nparams == 0 || nparams % 2 != 0) {
+		int rc __attribute__((unused));
+		rc = asprintf(errmsg, "PARAMS expects name value pairs");
+		return REDISMODULE_ERR;
+	}
+
+	*params = array_new(char *, nparams);
+	for(int j = i + 1; j < *argc; j++) {
+		const char *arg = RedisModule_StringPtrLen(argv[j], NULL);
+		array_append(*params, rm_strdup(arg));
+	}
+
+	// flags precede PARAMS
+	*argc = i;
+	return REDISMODULE_OK;
+}
+
 // Returns false if client provided a graph version
 // which mismatch the current graph version
 static bool _verifyGraphVersion(GraphContext *gc, uint version) {
@@ -133,7 +207,14 @@ static inline bool _validate_command_arity(GRAPH_Commands cmd, int arity) {
 		case CMD_EXPLAIN:
 		case CMD_PROFILE:
 			// Expect a command, graph name, a query, and optional config flags.
-			return arity >= 3 && arity <= 8;
+			return arity >= 3 && arity <= 10;
+		case CMD_PREPARE:
+			// Expect a command, graph name and a query.
+			return arity == 3;
+		case CMD_EXECUTE:
+			// Expect a command, graph name, a statement handle,
+			// optional config flags and parameters.
+			return arity >= 3;
 		default:
 			ASSERT("encountered unhandled query type" && false);
 			return false;
@@ -150,6 +231,10 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 			return Graph_Explain;
 		case CMD_PROFILE:
 			return Graph_Profile;
+		case CMD_PREPARE:
+			return Graph_Prepare;
+		case CMD_EXECUTE:
+			return Graph_Execute;
 		default:
 			ASSERT(false);
 	}
@@ -162,6 +247,8 @@ static GRAPH_Commands determine_command(const char *cmd_name) {
 	if(strcasecmp(cmd_name, "graph.RO_QUERY") == 0) return CMD_RO_QUERY;
 	if(strcasecmp(cmd_name, "graph.EXPLAIN")  == 0) return CMD_EXPLAIN;
 	if(strcasecmp(cmd_name, "graph.PROFILE")  == 0) return CMD_PROFILE;
+	if(strcasecmp(cmd_name, "graph.PREPARE")  == 0) return CMD_PREPARE;
+	if(strcasecmp(cmd_name, "graph.EXECUTE")  == 0) return CMD_EXECUTE;
 
 	// we shouldn't reach this point
 	ASSERT(false);
@@ -175,6 +262,8 @@ static bool should_command_create_graph(GRAPH_Commands cmd) {
 			return true;
 		case CMD_EXPLAIN:
 		case CMD_RO_QUERY:
+		case CMD_PREPARE:  // not replicated, mustn't introduce a key
+		case CMD_EXECUTE:
 			return false;
 		default:
 			ASSERT(false);
@@ -185,8 +274,10 @@ static bool should_command_create_graph(GRAPH_Commands cmd) {
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	char *errmsg;
 	uint version;
+	bool binary;
 	bool compact;
 	bool timeout_rw;
+	long long cursor;
 	long long timeout;
 	CommandCtx *context = NULL;
 
@@ -197,13 +288,28 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 
 	if(_validate_command_arity(cmd, argc) == false) return RedisModule_WrongArity(ctx);
 
+	// parse prepared statement handle and parameters
+	int res;
+	char **params = NULL;
+	int64_t statement = -1;
+	int flags_argc = argc;
+	if(cmd == CMD_EXECUTE) {
+		res = _read_statement(argv, &flags_argc, &statement, &params, &errmsg);
+		if(res == REDISMODULE_ERR) {
+			RedisModule_ReplyWithError(ctx, errmsg);
+			free(errmsg);
+			return REDISMODULE_OK;
+		}
+	}
+
 	// parse additional arguments
-	int res = _read_flags(argv, argc, &compact, &timeout, &timeout_rw, &version,
-		&errmsg);
+	res = _read_flags(argv, flags_argc, &compact, &binary, &timeout,
+			&timeout_rw, &version, &cursor, &errmsg);
 	if(res == REDISMODULE_ERR) {
 		// emit error and exit if argument parsing failed
 		RedisModule_ReplyWithError(ctx, errmsg);
 		free(errmsg);
+		if(params != NULL) array_free_cb(params, rm_free);
 		// the API reference dictates that registered functions should always return OK
 		return REDISMODULE_OK;
 	}
@@ -211,7 +317,10 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	bool shouldCreate = should_command_create_graph(cmd);
 	GraphContext *gc = GraphContext_Retrieve(ctx, graph_name, true, shouldCreate);
 	// if GraphContext is null, key access failed and an error been emitted
-	if(!gc) return REDISMODULE_ERR;
+	if(!gc) {
+		if(params != NULL) array_free_cb(params, rm_free);
+		return REDISMODULE_ERR;
+	}
 
 	// return incase caller provided a mismatched graph version
 	if(!_verifyGraphVersion(gc, version)) {
@@ -219,6 +328,7 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 		// Release the GraphContext, as we increased its reference count
 		// when retrieving it.
 		GraphContext_DecreaseRefCount(gc);
+		if(params != NULL) array_free_cb(params, rm_free);
 		return REDISMODULE_OK;
 	}
 
@@ -235,17 +345,32 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 				REDISMODULE_CTX_FLAGS_LOADING)));
 	ExecutorThread exec_thread =  main_thread ? EXEC_THREAD_MAIN : EXEC_THREAD_READER;
 
+	// GRAPH.EXECUTE is registered readonly, as such Redis doesn't reject it on
+	// a replica nor when out of memory, its write statements are rejected instead
+	bool deny_write = (cmd == CMD_EXECUTE) && !is_replicated &&
+		(flags & (REDISMODULE_CTX_FLAGS_SLAVE | REDISMODULE_CTX_FLAGS_OOM));
+
 	Command_Handler handler = get_command_handler(cmd);
 	if(exec_thread == EXEC_THREAD_MAIN) {
 		// run query on Redis main thread
 		context = CommandCtx_New(ctx, NULL, argv[0], query, gc, exec_thread,
 								 is_replicated, compact, timeout, timeout_rw);
+		context->statement  = statement;
+		context->params     = params;
+		context->cursor     = cursor;
+		context->binary     = binary;
+		context->deny_write = deny_write;
 		handler(context);
 	} else {
 		// run query on a dedicated thread
 		RedisModuleBlockedClient *bc = RedisGraph_BlockClient(ctx);
 		context = CommandCtx_New(NULL, bc, argv[0], query, gc, exec_thread,
 								 is_replicated, compact, timeout, timeout_rw);
+		context->statement  = statement;
+		context->params     = params;
+		context->cursor     = cursor;
+		context->binary     = binary;
+		context->deny_write = deny_write;
 
 		if(ThreadPools_AddWorkReader(handler, context) == THPOOL_QUEUE_FULL) {
 			// report an error once our workers thread pool internal queue
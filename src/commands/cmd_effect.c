@@ -0,0 +1,81 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "commands.h"
+#include "../query_ctx.h"
+#include "../effects/effects.h"
+#include "../undo_log/undo_log.h"
+
+// usage:
+// GRAPH.EFFECT <graph> <effects>
+// applies effects replicated by the primary in place of a write query
+// effects are only accepted from the primary or while loading the AOF
+int Graph_Effect
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+) {
+	ASSERT(ctx  != NULL);
+	ASSERT(argv != NULL);
+	if(argc != 3) return RedisModule_WrongArity(ctx);
+
+	int flags = RedisModule_GetContextFlags(ctx);
+	if(!(flags & (REDISMODULE_CTX_FLAGS_REPLICATED |
+				  REDISMODULE_CTX_FLAGS_LOADING))) {
+		RedisModule_ReplyWithError(ctx,
+				"GRAPH.EFFECT is reserved for replication");
+		return REDISMODULE_OK;
+	}
+
+	// get a hold of the graph key, effects may introduce a new graph
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], false, true);
+	if(gc == NULL) {
+		// if GraphContext is null, key access failed and an error been emitted
+		return REDISMODULE_OK;
+	}
+
+	size_t len;
+	const char *effects = RedisModule_StringPtrLen(argv[2], &len);
+
+	// modifications are tracked by the undo log
+	// such that partially applied effects can be rolled back
+	QueryCtx_SetGraphCtx(gc);
+	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+
+	// executing on Redis main thread, GIL is already held
+	Graph_AcquireWriteLock(gc->g);
+
+	bool applied = Effects_Apply(gc, (const unsigned char *)effects, len);
+	if(!applied) UndoLog_Rollback(query_ctx->undo_log);
+
+	// hand accumulated delta changes to the background compaction
+	// while the write lock is still held
+	GraphContext_ScheduleCompaction(gc);
+	GraphContext_VacuumStrings(gc);
+
+	Graph_ReleaseLock(gc->g);
+
+	if(applied) {
+		GraphContext_MarkWriter(ctx, gc);
+		RedisModule_ReplicateVerbatim(ctx);
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		// the primary committed these modifications, failing to apply them
+		// means this replica no longer mirrors the primary
+		RedisModule_Log(ctx, "warning", "Failed to apply effects to graph %s, "
+				"graph diverged from the primary and requires a full resync",
+				GraphContext_GetName(gc));
+		RedisModule_ReplyWithError(ctx, "Failed to apply effects");
+		ASSERT(false && "failed to apply replicated effects");
+	}
+
+	GraphContext_DecreaseRefCount(gc);
+	QueryCtx_Free(); // reset the QueryCtx and free its allocations
+
+	return REDISMODULE_OK;
+}
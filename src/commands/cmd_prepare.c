@@ -0,0 +1,85 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "../errors.h"
+#include "cmd_context.h"
+#include "../query_ctx.h"
+#include "execution_ctx.h"
+#include "../util/rmalloc.h"
+#include "prepared_statements.h"
+
+/* Builds an execution plan and registers it as a prepared statement
+ * replies with the statement's handle, to be used by GRAPH.EXECUTE
+ * Args:
+ * argv[1] graph name
+ * argv[2] query */
+void Graph_Prepare(void *args) {
+	CommandCtx     *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx         = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext   *gc          = CommandCtx_GetGraphContext(command_ctx);
+	PreparedStatements *ps      = GraphContext_GetPreparedStatements(gc);
+
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+	CommandCtx_TrackCtx(command_ctx);
+
+	if(strcmp(command_ctx->query, "") == 0) {
+		ErrorCtx_SetError("Error: empty query.");
+		goto cleanup;
+	}
+
+	// preparing the same query twice yields the same handle
+	int64_t handle = PreparedStatements_Lookup(ps, command_ctx->query);
+	if(handle == -1) {
+		const char *body;
+		ExecutionCtx *exec_ctx = ExecutionCtx_Prepare(command_ctx->query, &body);
+		if(exec_ctx == NULL) goto cleanup;
+
+		handle = PreparedStatements_Add(ps, command_ctx->query, body, exec_ctx);
+		if(handle == -1) {
+			ErrorCtx_SetError("Max prepared statements (%d) exceeded",
+					PREPARED_STATEMENTS_MAX);
+			goto cleanup;
+		}
+	}
+
+	RedisModule_ReplyWithLongLong(ctx, handle);
+
+cleanup:
+	if(ErrorCtx_EncounteredError()) ErrorCtx_EmitException();
+	GraphContext_DecreaseRefCount(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+	ErrorCtx_Clear();
+}
+
+/* Removes a prepared statement, its handle becomes unknown
+ * Args:
+ * argv[1] graph name
+ * argv[2] statement handle */
+int Graph_Deallocate(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 3) return RedisModule_WrongArity(ctx);
+
+	long long handle;
+	if(RedisModule_StringToLongLong(argv[2], &handle) != REDISMODULE_OK ||
+	   handle < 0) {
+		RedisModule_ReplyWithError(ctx, "Invalid prepared statement handle");
+		return REDISMODULE_OK;
+	}
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	// if GraphContext is null, key access failed and an error been emitted
+	if(!gc) return REDISMODULE_ERR;
+
+	PreparedStatements *ps = GraphContext_GetPreparedStatements(gc);
+	if(PreparedStatements_Remove(ps, handle)) {
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		RedisModule_ReplyWithError(ctx, "Unknown prepared statement");
+	}
+
+	GraphContext_DecreaseRefCount(gc);
+	return REDISMODULE_OK;
+}
@@ -8,6 +8,7 @@
 #include "../errors.h"
 #include "cmd_context.h"
 #include "../ast/ast.h"
+#include "../ast/ast_auto_params.h"
 #include "../util/arr.h"
 #include "../util/cron.h"
 #include "../query_ctx.h"
@@ -15,9 +16,15 @@
 #include "../index/indexer.h"
 #include "../util/rmalloc.h"
 #include "../util/cache/cache.h"
+#include "../util/sds/sds.h"
 #include "../util/thpool/pools.h"
 #include "../execution_plan/execution_plan.h"
 #include "execution_ctx.h"
+#include "cursors.h"
+#include "prepared_statements.h"
+
+#include <ctype.h>
+#include <errno.h>
 
 // GraphQueryCtx stores the allocations required to execute a query.
 typedef struct {
@@ -251,6 +258,62 @@ inline static bool _readonly_cmd_mode(CommandCtx *ctx) {
 	return strcasecmp(CommandCtx_GetCommandName(ctx), "graph.RO_QUERY") == 0;
 }
 
+// determine resultset format according to the command's flags
+static ResultSetFormatterType _resultset_format
+(
+	const CommandCtx *command_ctx,
+	bool profile
+) {
+	// replicated command don't need to return result
+	if(profile || command_ctx->replicated_command) return FORMATTER_NOP;
+	if(command_ctx->binary)  return FORMATTER_BINARY;
+	if(command_ctx->compact) return FORMATTER_COMPACT;
+	return FORMATTER_VERBOSE;
+}
+
+// executes the first read of a cursor query
+// the query is either suspended by a new cursor or freed once depleted
+static void _ExecuteCursorQuery
+(
+	GraphQueryCtx *gq_ctx
+) {
+	GraphContext    *gc           =  gq_ctx->graph_ctx;
+	RedisModuleCtx  *rm_ctx       =  gq_ctx->rm_ctx;
+	ExecutionCtx    *exec_ctx     =  gq_ctx->exec_ctx;
+	CommandCtx      *command_ctx  =  gq_ctx->command_ctx;
+
+	ResultSetFormatterType resultset_format =
+		_resultset_format(command_ctx, false);
+	ResultSet *result_set = NewResultSet(rm_ctx, resultset_format);
+	QueryCtx_SetResultSet(result_set);
+
+	Graph_AcquireReadLock(gc->g);
+
+	// set policy after lock acquisition,
+	// avoid resetting policies between readers and writers
+	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
+	ExecutionPlan_PreparePlan(exec_ctx->plan);
+
+	// the cursor takes ownership over the query
+	Cursor *cursor = Cursor_New(command_ctx, exec_ctx, result_set);
+	bool depleted = Cursor_Read(cursor, rm_ctx, 0);
+
+	// log query to slowlog
+	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
+	SlowLog_Add(slowlog, command_ctx->command_name, command_ctx->query,
+				QueryCtx_GetExecutionTime(), NULL);
+
+	if(!depleted) Cursor_Suspend(cursor);
+
+	Graph_ReleaseLock(gc->g);
+
+	// clean up
+	if(depleted) Cursor_Free(cursor);
+	CommandCtx_Free(command_ctx);
+	ErrorCtx_Clear();
+	GraphQueryCtx_Free(gq_ctx);
+}
+
 // _ExecuteQuery accepts a GraphQeuryCtx as an argument
 // it may be called directly by a reader thread or the Redis main thread,
 // or dispatched as a worker thread job
@@ -276,15 +339,15 @@ static void _ExecuteQuery(void *args) {
 		CommandCtx_TrackCtx(command_ctx);
 	}
 
+	// read only queries streaming their results through a cursor
+	if(command_ctx->cursor > 0) {
+		_ExecuteCursorQuery(gq_ctx);
+		return;
+	}
+
 	// instantiate the query ResultSet
-	bool compact = command_ctx->compact;
-	// replicated command don't need to return result
-	ResultSetFormatterType resultset_format = 
-		profile || command_ctx->replicated_command
-		? FORMATTER_NOP 
-		: (compact) 
-			? FORMATTER_COMPACT 
-			: FORMATTER_VERBOSE;
+	ResultSetFormatterType resultset_format =
+		_resultset_format(command_ctx, profile);
 	ResultSet *result_set = NewResultSet(rm_ctx, resultset_format);
 	if(exec_ctx->cached) ResultSet_CachedExecution(result_set); // indicate a cached execution
 
@@ -392,6 +455,233 @@ static void _DelegateWriter(GraphQueryCtx *gq_ctx) {
 	ASSERT(res == 0);
 }
 
+//------------------------------------------------------------------------------
+// Prepared statements
+//------------------------------------------------------------------------------
+
+// returns true if 'name' is a valid parameter name
+static bool _valid_param_name
+(
+	const char *name
+) {
+	if(!isalpha((unsigned char)name[0]) && name[0] != '_') return false;
+
+	for(const char *c = name + 1; *c != '\0'; c++) {
+		if(!isalnum((unsigned char)*c) && *c != '_') return false;
+	}
+
+	return true;
+}
+
+// converts a scalar cypher literal: number, string without escape sequences,
+// boolean or null
+// returns false if 'literal' isn't such a scalar
+static bool _scalar_param
+(
+	const char *literal,  // parameter value
+	SIValue *v            // [output] converted value
+) {
+	size_t len = strlen(literal);
+	if(len == 0) return false;
+
+	// strings
+	char quote = literal[0];
+	if(quote == '\'' || quote == '"') {
+		if(len < 2 || literal[len - 1] != quote) return false;
+		// escape sequences are left for the parser to interpret
+		if(memchr(literal + 1, '\\', len - 2) != NULL) return false;
+		if(memchr(literal + 1, quote, len - 2) != NULL) return false;
+		*v = SI_TransferStringVal(rm_strndup(literal + 1, len - 2));
+		return true;
+	}
+
+	if(strcasecmp(literal, "true") == 0) {
+		*v = SI_BoolVal(true);
+		return true;
+	}
+
+	if(strcasecmp(literal, "false") == 0) {
+		*v = SI_BoolVal(false);
+		return true;
+	}
+
+	if(strcasecmp(literal, "null") == 0) {
+		*v = SI_NullVal();
+		return true;
+	}
+
+	// numbers, optionally negated
+	bool negate = (literal[0] == '-');
+	size_t i = negate ? 1 : 0;
+	if(!isdigit((unsigned char)literal[i])) return false;
+	if(!AST_ScanNumber(literal, &i, v)) return false;
+
+	// trailing characters are left for the parser to report
+	if(literal[i] != '\0') return false;
+
+	if(negate) {
+		*v = (SI_TYPE(*v) == T_DOUBLE) ? SI_DoubleVal(-v->doubleval) :
+			SI_LongVal(-v->longval);
+	}
+
+	return true;
+}
+
+// sets the query parameters from the name value pairs given to GRAPH.EXECUTE
+// values are cypher literals, scalars are converted directly
+// while lists and maps are handed to the parameters parser
+// if 'prefix' isn't NULL it is set to the parameters as a CYPHER prefix
+static bool _set_statement_params
+(
+	char **params,  // name value pairs
+	sds *prefix     // [optional output] CYPHER prefix
+) {
+	uint n = array_len(params);
+
+	// nothing to set, also avoids zero length arrays
+	if(n == 0) return true;
+
+	bool     res      = true;
+	sds      compound = sdsempty();  // parameters requiring the parser
+	SIValue  values[n / 2];          // converted scalars
+	bool     scalar[n / 2];
+
+	for(uint i = 0; i < n; i += 2) {
+		const char *name  = params[i];
+		const char *value = params[i + 1];
+
+		scalar[i / 2] = false;
+		if(!_valid_param_name(name)) {
+			ErrorCtx_SetError("Invalid parameter name '%s'", name);
+			res = false;
+			continue;
+		}
+
+		scalar[i / 2] = _scalar_param(value, values + i / 2);
+		if(!scalar[i / 2]) {
+			compound = sdscatprintf(compound, "%s=%s ", name, value);
+		}
+
+		if(prefix != NULL) {
+			*prefix = sdscatprintf(*prefix, "%s=%s ", name, value);
+		}
+	}
+
+	// parse lists, maps and any other expression
+	// parse_params sets the query parameters
+	if(res && sdslen(compound) > 0) {
+		const char *body;
+		sds q = sdscatsds(sdsnew("CYPHER "), compound);
+		cypher_parse_result_t *parse_result = parse_params(q, &body);
+
+		if(parse_result == NULL) {
+			if(!ErrorCtx_EncounteredError()) {
+				ErrorCtx_SetError("Failed to parse parameters");
+			}
+			res = false;
+		} else {
+			// values can't smuggle in a query
+			if(strlen(body) != 0) {
+				ErrorCtx_SetError("Invalid parameter value");
+				res = false;
+			}
+			parse_result_free(parse_result);
+		}
+
+		sdsfree(q);
+	}
+
+	rax *query_params = QueryCtx_GetParams();
+	if(query_params == NULL) {
+		query_params = raxNew();
+		QueryCtx_SetParams(query_params);
+	}
+
+	for(uint i = 0; i < n; i += 2) {
+		if(!scalar[i / 2]) continue;
+
+		const char *name = params[i];
+		SIValue *v = rm_malloc(sizeof(SIValue));
+		*v = values[i / 2];
+
+		if(!raxTryInsert(query_params, (unsigned char *)name, strlen(name), v,
+					NULL)) {
+			if(res) ErrorCtx_SetError("Duplicated parameter: %s", name);
+			SIValue_Free(*v);
+			rm_free(v);
+			res = false;
+		}
+	}
+
+	sdsfree(compound);
+	return res;
+}
+
+// resolves the execution-ctx of a GRAPH.EXECUTE command
+static ExecutionCtx *_ExecutionCtx_FromStatement
+(
+	CommandCtx *command_ctx
+) {
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	PreparedStatements *ps = GraphContext_GetPreparedStatements(gc);
+
+	char *body;
+	ExecutionCtx *exec_ctx = PreparedStatements_Get(ps, command_ctx->statement,
+			&body);
+
+	if(exec_ctx == NULL) {
+		ErrorCtx_SetError("Unknown prepared statement %" PRId64,
+				command_ctx->statement);
+		return NULL;
+	}
+
+	// skipped parsing and cache lookup altogether
+	exec_ctx->cached = true;
+
+	// GRAPH.EXECUTE is a readonly command
+	// write statements are rejected on replicas and when out of memory
+	bool readonly = AST_ReadOnly(exec_ctx->ast->root);
+	if(!readonly && command_ctx->deny_write) {
+		ErrorCtx_SetError("Write statements can't be executed on a replica or when out of memory");
+		ExecutionCtx_Free(exec_ctx);
+		rm_free(body);
+		return NULL;
+	}
+
+	// replicas are unaware of prepared statements
+	// write statements are replicated as GRAPH.QUERY
+	sds prefix = readonly ? NULL : sdsempty();
+
+	if(command_ctx->params != NULL &&
+	   !_set_statement_params(command_ctx->params, readonly ? NULL : &prefix)) {
+		if(prefix != NULL) sdsfree(prefix);
+		ExecutionCtx_Free(exec_ctx);
+		rm_free(body);
+		return NULL;
+	}
+
+	// report the statement's query instead of its handle
+	rm_free(command_ctx->query);
+	if(readonly) {
+		command_ctx->query = body;
+	} else {
+		sds q = (sdslen(prefix) > 0) ?
+			sdscatprintf(sdsempty(), "CYPHER %s%s", prefix, body) :
+			sdsnew(body);
+		command_ctx->query = rm_strdup(q);
+		sdsfree(q);
+		sdsfree(prefix);
+		rm_free(body);
+
+		rm_free(command_ctx->command_name);
+		command_ctx->command_name = rm_strdup("graph.QUERY");
+	}
+
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+
+	return exec_ctx;
+}
+
 void _query(bool profile, void *args) {
 	CommandCtx     *command_ctx = (CommandCtx *)args;
 	RedisModuleCtx *ctx         = CommandCtx_GetRedisCtx(command_ctx);
@@ -408,8 +698,11 @@ void _query(bool profile, void *args) {
 
 	QueryCtx_BeginTimer(); // start query timing
 
-	// parse query parameters and build an execution plan or retrieve it from the cache
-	exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	// parse query parameters and build an execution plan or retrieve it from
+	// the cache, prepared statements skip both
+	exec_ctx = (command_ctx->statement != -1) ?
+		_ExecutionCtx_FromStatement(command_ctx) :
+		ExecutionCtx_FromQuery(command_ctx->query);
 	if(exec_ctx == NULL) goto cleanup;
 
 	ExecutionType exec_type = exec_ctx->exec_type;
@@ -428,14 +721,21 @@ void _query(bool profile, void *args) {
 		goto cleanup;
 	}
 
+	// cursors suspend read only queries between reads
+	if(command_ctx->cursor > 0 && (profile || index_op || !readonly)) {
+		ErrorCtx_SetError("CURSOR is supported for read only queries only");
+		goto cleanup;
+	}
+
 	CronTaskHandle timeout_task = 0;
 
 	// enforce specified timeout when query is readonly
 	// or timeout applies to both read and write
+	// cursors enforce timeout on each read individually
 	bool enforce_timeout = command_ctx->timeout != 0 && !index_op &&
 		(readonly || command_ctx->timeout_rw) &&
 		!command_ctx->replicated_command;
-	if(enforce_timeout) {
+	if(enforce_timeout && command_ctx->cursor == 0) {
 		timeout_task = Query_SetTimeOut(command_ctx->timeout, exec_ctx->plan);
 	}
 
@@ -473,3 +773,7 @@ void Graph_Profile(void *args) {
 void Graph_Query(void *args) {
 	_query(false, args);
 }
+
+void Graph_Execute(void *args) {
+	_query(false, args);
+}
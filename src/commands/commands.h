@@ -9,6 +9,7 @@
 #include "../query_ctx.h"
 #include "execution_ctx.h"
 #include "cmd_bulk_insert.h"
+#include "../util/cron.h"
 
 //------------------------------------------------------------------------------
 // Module Commands
@@ -24,7 +25,12 @@ typedef enum {
 	CMD_PROFILE        = 6,
 	CMD_BULK_INSERT    = 7,
 	CMD_SLOWLOG        = 8,
-	CMD_LIST           = 9
+	CMD_LIST           = 9,
+	CMD_PREPARE        = 10,
+	CMD_EXECUTE        = 11,
+	CMD_CURSOR         = 12,
+	CMD_EFFECT         = 13,
+	CMD_DEALLOCATE     = 14
 } GRAPH_Commands;
 
 //------------------------------------------------------------------------------
@@ -34,10 +40,21 @@ typedef enum {
 void Graph_Query(void *args);
 void Graph_Profile(void *args);
 void Graph_Explain(void *args);
+void Graph_Prepare(void *args);
+void Graph_Execute(void *args);
+int Graph_Deallocate(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_List(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Debug(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Delete(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Config(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Slowlog(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Cursor(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Effect(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 
+//------------------------------------------------------------------------------
+// query timeout
+//------------------------------------------------------------------------------
+
+// set timeout for query execution
+CronTaskHandle Query_SetTimeOut(uint timeout, ExecutionPlan *plan);
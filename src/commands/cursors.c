@@ -0,0 +1,271 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "cursors.h"
+#include "commands.h"
+#include "../errors.h"
+#include "../util/arr.h"
+#include "../util/cron.h"
+#include "../util/rmalloc.h"
+#include "../execution_plan/execution_plan.h"
+#include "../execution_plan/ops/op_gather.h"
+#include "../execution_plan/execution_plan_build/execution_plan_modify.h"
+
+#include <time.h>
+#include <pthread.h>
+
+// registry of suspended cursors, cursors being read are removed from the
+// registry for the duration of the read
+static rax *cursors = NULL;
+static uint64_t last_cursor_id = 0;
+static bool sweep_scheduled = false;
+static pthread_mutex_t cursors_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t _Cursor_Now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// free cursor, caller must not hold the cursors lock
+static void _Cursor_Free
+(
+	Cursor *cursor
+) {
+	Graph *g = cursor->gc->g;
+
+	// free the query while holding the graph's read lock
+	// such that writers won't modify the structures its operations reference
+	QueryCtx_SetTLS(cursor->query_ctx);
+	Graph_AcquireReadLock(g);
+	{
+		ExecutionCtx_Free(cursor->exec_ctx);
+		ResultSet_Free(cursor->result_set);
+	}
+	Graph_ReleaseLock(g);
+	QueryCtx_Free();  // reset the QueryCtx and free its allocations
+
+	// the query no longer references the graph's matrices
+	if(cursor->pinned) Graph_Unpin(g);
+
+	GraphContext_DecreaseRefCount(cursor->gc);
+	rm_free(cursor->query);
+	rm_free(cursor->query_no_params);
+	rm_free(cursor->command_name);
+	rm_free(cursor);
+}
+
+// CRON task, frees cursors left idle for CURSOR_MAX_IDLE ms
+static void _Cursors_Sweep
+(
+	void *pdata
+) {
+	uint64_t now = _Cursor_Now();
+	Cursor **expired = array_new(Cursor *, 0);
+
+	pthread_mutex_lock(&cursors_lock);
+	{
+		raxIterator it;
+		raxStart(&it, cursors);
+		raxSeek(&it, "^", NULL, 0);
+		while(raxNext(&it)) {
+			Cursor *cursor = it.data;
+			if(now - cursor->last_access >= CURSOR_MAX_IDLE) {
+				array_append(expired, cursor);
+			}
+		}
+		raxStop(&it);
+
+		for(uint i = 0; i < array_len(expired); i++) {
+			uint64_t id = expired[i]->id;
+			raxRemove(cursors, (unsigned char *)&id, sizeof(id), NULL);
+		}
+
+		// keep sweeping as long as there are suspended cursors
+		sweep_scheduled = raxSize(cursors) > 0;
+		if(sweep_scheduled) {
+			Cron_AddTask(CURSOR_MAX_IDLE, _Cursors_Sweep, NULL);
+		}
+	}
+	pthread_mutex_unlock(&cursors_lock);
+
+	for(uint i = 0; i < array_len(expired); i++) {
+		_Cursor_Free(expired[i]);
+	}
+	array_free(expired);
+}
+
+// create a new cursor over the current thread's query
+Cursor *Cursor_New
+(
+	CommandCtx *command_ctx,  // command creating the cursor
+	ExecutionCtx *exec_ctx,   // execution context of the query
+	ResultSet *result_set     // query's resultset
+) {
+	ASSERT(exec_ctx    != NULL);
+	ASSERT(result_set  != NULL);
+	ASSERT(command_ctx != NULL);
+	ASSERT(command_ctx->cursor > 0);
+
+	Cursor *cursor = rm_calloc(1, sizeof(Cursor));
+
+	cursor->gc           = CommandCtx_GetGraphContext(command_ctx);
+	cursor->count        = command_ctx->cursor;
+	cursor->query        = rm_strdup(command_ctx->query);
+	cursor->timeout      = command_ctx->timeout;
+	cursor->exec_ctx     = exec_ctx;
+	cursor->query_ctx    = QueryCtx_GetQueryCtx();
+	cursor->result_set   = result_set;
+	cursor->command_name = rm_strdup(command_ctx->command_name);
+	cursor->id           = __atomic_add_fetch(&last_cursor_id, 1,
+			__ATOMIC_RELAXED);
+
+	return cursor;
+}
+
+// executes the cursor's query until 'count' rows been accumulated
+// replies with the accumulated rows followed by the cursor id
+bool Cursor_Read
+(
+	Cursor *cursor,       // cursor to read from
+	RedisModuleCtx *ctx,  // redis module context to reply with
+	uint64_t count        // number of rows to read, 0 for cursor's default
+) {
+	ASSERT(ctx    != NULL);
+	ASSERT(cursor != NULL);
+
+	ExecutionPlan *plan = cursor->exec_ctx->plan;
+	if(count == 0) count = cursor->count;
+
+	// rows and statistics are reported per read
+	cursor->result_set->ctx = ctx;
+	ResultSet_Clear(cursor->result_set);
+	if(cursor->exec_ctx->cached) ResultSet_CachedExecution(cursor->result_set);
+
+	// timeout applies to each read individually
+	CronTaskHandle timeout_task = 0;
+	if(cursor->timeout != 0) {
+		timeout_task = Query_SetTimeOut(cursor->timeout, plan);
+	}
+
+	bool depleted = ExecutionPlan_ExecuteRows(plan, count);
+
+	if(timeout_task != 0) Cron_AbortTask(timeout_task);
+	if(ExecutionPlan_Drained(plan)) ErrorCtx_SetError("Query timed out");
+
+	depleted |= ErrorCtx_EncounteredError();
+	ResultSet_ReplyWithCursor(cursor->result_set, depleted ? 0 : cursor->id);
+
+	return depleted;
+}
+
+// returns false if the cursor's graph was modified since it was suspended
+bool Cursor_Valid
+(
+	const Cursor *cursor
+) {
+	ASSERT(cursor != NULL);
+	return Graph_WriteCount(cursor->gc->g) == cursor->write_count;
+}
+
+// suspends the cursor's query, making the cursor available for reads
+void Cursor_Suspend
+(
+	Cursor *cursor
+) {
+	ASSERT(cursor != NULL);
+
+	QueryCtx *query_ctx = cursor->query_ctx;
+	QueryCtx_QueryData *query_data = &query_ctx->query_data;
+
+	// strings owned by the command are about to be freed
+	// repoint them to the cursor's copies
+	if(cursor->query_no_params == NULL &&
+	   query_data->query_no_params != NULL &&
+	   query_data->query_no_params != query_data->query_normalized) {
+		cursor->query_no_params = rm_strdup(query_data->query_no_params);
+		query_data->query_no_params = cursor->query_no_params;
+	}
+	query_data->query = cursor->query;
+	query_ctx->global_exec_ctx.bc = NULL;
+	query_ctx->global_exec_ctx.redis_ctx = NULL;
+	query_ctx->global_exec_ctx.command_name = cursor->command_name;
+	cursor->result_set->ctx = NULL;
+
+	// parallel scan workers must not run once the read lock is released
+	OpBase **gathers = ExecutionPlan_CollectOps(cursor->exec_ctx->plan->root,
+			OPType_GATHER);
+	for(uint i = 0; i < array_len(gathers); i++) Gather_Pause(gathers[i]);
+	array_free(gathers);
+
+	// keep the matrices referenced by the query's iterators in place
+	if(!cursor->pinned) {
+		Graph_Pin(cursor->gc->g);
+		cursor->pinned = true;
+	}
+
+	cursor->write_count = Graph_WriteCount(cursor->gc->g);
+	cursor->last_access = _Cursor_Now();
+
+	QueryCtx_RemoveFromTLS();
+
+	pthread_mutex_lock(&cursors_lock);
+	{
+		if(cursors == NULL) cursors = raxNew();
+		raxInsert(cursors, (unsigned char *)&cursor->id, sizeof(cursor->id),
+				cursor, NULL);
+
+		if(!sweep_scheduled) {
+			sweep_scheduled = true;
+			Cron_AddTask(CURSOR_MAX_IDLE, _Cursors_Sweep, NULL);
+		}
+	}
+	pthread_mutex_unlock(&cursors_lock);
+}
+
+// retrieves and resumes a suspended cursor
+Cursor *Cursor_Resume
+(
+	uint64_t id,             // cursor id
+	CommandCtx *command_ctx  // command resuming the cursor
+) {
+	ASSERT(command_ctx != NULL);
+
+	Cursor *cursor = NULL;
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	pthread_mutex_lock(&cursors_lock);
+	{
+		if(cursors != NULL) {
+			cursor = raxFind(cursors, (unsigned char *)&id, sizeof(id));
+			if(cursor == raxNotFound || cursor->gc != gc) {
+				cursor = NULL;
+			} else {
+				raxRemove(cursors, (unsigned char *)&id, sizeof(id), NULL);
+			}
+		}
+	}
+	pthread_mutex_unlock(&cursors_lock);
+
+	if(cursor == NULL) return NULL;
+
+	QueryCtx *query_ctx = cursor->query_ctx;
+	query_ctx->global_exec_ctx.bc = CommandCtx_GetBlockingClient(command_ctx);
+	query_ctx->global_exec_ctx.redis_ctx = CommandCtx_GetRedisCtx(command_ctx);
+	QueryCtx_SetTLS(query_ctx);
+
+	return cursor;
+}
+
+// free cursor along with its query
+void Cursor_Free
+(
+	Cursor *cursor
+) {
+	ASSERT(cursor != NULL);
+	_Cursor_Free(cursor);
+}
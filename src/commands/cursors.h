@@ -0,0 +1,88 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "cmd_context.h"
+#include "execution_ctx.h"
+#include "../query_ctx.h"
+#include "../resultset/resultset.h"
+
+// cursors expire once left idle for CURSOR_MAX_IDLE ms
+#define CURSOR_MAX_IDLE 300000
+
+// cursor over a read only query issued with GRAPH.QUERY ... CURSOR <count>
+// the query's execution plan is suspended between reads holding no lock,
+// otherwise a client which stops reading would block all writers to the graph
+// until the cursor expires, as such a cursor is invalidated once its graph is
+// modified, while the graph is pinned to defer compaction of its matrices
+typedef struct {
+	uint64_t id;             // cursor id
+	GraphContext *gc;        // graph queried
+	QueryCtx *query_ctx;     // query context of the suspended query
+	ExecutionCtx *exec_ctx;  // execution context of the suspended query
+	ResultSet *result_set;   // accumulates the rows of a single read
+	char *query;             // query string
+	char *query_no_params;   // query string without parameters part
+	char *command_name;      // command which created the cursor
+	uint64_t count;          // default number of rows per read
+	long long timeout;       // timeout of a single read, 0 if none
+	uint64_t write_count;    // graph's write count when suspended
+	uint64_t last_access;    // time of last read in ms
+	bool pinned;             // cursor pinned its graph
+} Cursor;
+
+// create a new cursor over the current thread's query
+// the cursor takes ownership over the thread's QueryCtx, 'exec_ctx',
+// 'result_set' and the command's graph context reference
+Cursor *Cursor_New
+(
+	CommandCtx *command_ctx,  // command creating the cursor
+	ExecutionCtx *exec_ctx,   // execution context of the query
+	ResultSet *result_set     // query's resultset
+);
+
+// executes the cursor's query until 'count' rows been accumulated
+// replies with the accumulated rows followed by the cursor id
+// caller is expected to hold the graph's read lock
+// returns true once the query is depleted or failed
+bool Cursor_Read
+(
+	Cursor *cursor,       // cursor to read from
+	RedisModuleCtx *ctx,  // redis module context to reply with
+	uint64_t count        // number of rows to read, 0 for cursor's default
+);
+
+// returns false if the cursor's graph was modified since it was suspended
+// caller is expected to hold the graph's read lock
+bool Cursor_Valid
+(
+	const Cursor *cursor
+);
+
+// suspends the cursor's query, making the cursor available for reads
+// parallel scans are paused until the next read
+// caller is expected to hold the graph's read lock
+void Cursor_Suspend
+(
+	Cursor *cursor
+);
+
+// retrieves and resumes a suspended cursor
+// the cursor is unavailable for other reads until it is suspended again
+// returns NULL if the cursor doesn't exist, is in use
+// or belongs to a different graph
+Cursor *Cursor_Resume
+(
+	uint64_t id,             // cursor id
+	CommandCtx *command_ctx  // command resuming the cursor
+);
+
+// free cursor along with its query
+void Cursor_Free
+(
+	Cursor *cursor
+);
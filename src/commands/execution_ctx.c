@@ -8,6 +8,7 @@
 #include "RG.h"
 #include "../errors.h"
 #include "../query_ctx.h"
+#include "../ast/ast_auto_params.h"
 #include "../execution_plan/execution_plan_clone.h"
 
 static ExecutionType _GetExecutionTypeFromAST
@@ -123,15 +124,30 @@ ExecutionCtx *ExecutionCtx_FromQuery
 		return NULL;
 	}
 
-	// update query context with the query without params
+	// lift literals into parameters, such that queries which differ only
+	// by their literals share the same cached execution-ctx
 	QueryCtx *ctx = QueryCtx_GetQueryCtx();
-	ctx->query_data.query_no_params = q_str;
+	rax *params = QueryCtx_GetParams();
+	if(params == NULL) {
+		params = raxNew();
+		QueryCtx_SetParams(params);
+	}
+
+	const char *key = q_str;  // cache key
+	char *normalized = AST_AutoParameterize(q_str, params);
+	if(normalized != NULL) {
+		ctx->query_data.query_normalized = normalized;
+		key = normalized;
+	}
+
+	// update query context with the query without params
+	ctx->query_data.query_no_params = key;
 
 	// get cache
 	Cache *cache = GraphContext_GetCache(QueryCtx_GetGraphCtx());
 
 	// see if we already have a cached execution-ctx for given query
-	ret = Cache_GetValue(cache, q_str);
+	ret = Cache_GetValue(cache, key);
 
 	//--------------------------------------------------------------------------
 	// cache hit
@@ -148,7 +164,16 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	//--------------------------------------------------------------------------
 
 	// try to parse the query
-	AST *ast = _ExecutionCtx_ParseAST(q_str);
+	AST *ast = _ExecutionCtx_ParseAST(key);
+
+	// the normalized query was rejected
+	// fallback to the original query, reporting errors against it
+	if(ast == NULL && key != q_str) {
+		ErrorCtx_Clear();
+		key = q_str;
+		ctx->query_data.query_no_params = q_str;
+		ast = _ExecutionCtx_ParseAST(q_str);
+	}
 
 	// parser failed
 	if(ast == NULL) {
@@ -186,7 +211,7 @@ ExecutionCtx *ExecutionCtx_FromQuery
 		}
 
 		ExecutionCtx *exec_ctx = _ExecutionCtx_New(ast, plan, exec_type);
-		ret = Cache_SetGetValue(cache, q_str, exec_ctx);
+		ret = Cache_SetGetValue(cache, key, exec_ctx);
 	} else {
 		ret = _ExecutionCtx_New(ast, NULL, exec_type);
 	}
@@ -194,6 +219,63 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	return ret;
 }
 
+// builds the execution-ctx of a query prepared via GRAPH.PREPARE
+// bypassing the execution plan cache
+// parameters given at preparation time are used only while building the plan
+// returns NULL if the query contains errors or isn't a plain query
+ExecutionCtx *ExecutionCtx_Prepare
+(
+	const char *q,     // string representing the query
+	const char **body  // [output] query excluding parameters
+) {
+	ASSERT(q    != NULL);
+	ASSERT(body != NULL);
+
+	const char *q_str;  // query string excluding query parameters
+
+	cypher_parse_result_t *params_parse_result = parse_params(q, &q_str);
+	if(params_parse_result == NULL) {
+		return NULL;
+	}
+
+	if(unlikely(strlen(q_str) == 0)) {
+		parse_result_free(params_parse_result);
+		ErrorCtx_SetError("Error: empty query.");
+		return NULL;
+	}
+
+	QueryCtx *ctx = QueryCtx_GetQueryCtx();
+	ctx->query_data.query_no_params = q_str;
+
+	AST *ast = _ExecutionCtx_ParseAST(q_str);
+	if(ast == NULL) {
+		parse_result_free(params_parse_result);
+		if(!ErrorCtx_EncounteredError()) {
+			ErrorCtx_SetError("Error: could not parse query");
+		}
+		return NULL;
+	}
+
+	// associate parameters with AST, 'q_str' lives as long as the AST
+	AST_SetParamsParseResult(ast, params_parse_result);
+
+	if(_GetExecutionTypeFromAST(ast) != EXECUTION_TYPE_QUERY) {
+		AST_Free(ast);
+		ErrorCtx_SetError("Error: index operations can't be prepared.");
+		return NULL;
+	}
+
+	ExecutionPlan *plan = NewExecutionPlan();
+	if(ErrorCtx_EncounteredError()) {
+		AST_Free(ast);
+		ExecutionPlan_Free(plan);
+		return NULL;
+	}
+
+	*body = q_str;
+	return _ExecutionCtx_New(ast, plan, EXECUTION_TYPE_QUERY);
+}
+
 // free an ExecutionCTX struct and its inner fields
 void ExecutionCtx_Free
 (
@@ -34,6 +34,16 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	const char *q  // string representing the query
 );
 
+// builds the execution-ctx of a query prepared via GRAPH.PREPARE
+// bypassing the execution plan cache
+// parameters given at preparation time are used only while building the plan
+// returns NULL if the query contains errors or isn't a plain query
+ExecutionCtx *ExecutionCtx_Prepare
+(
+	const char *q,     // string representing the query
+	const char **body  // [output] query excluding parameters
+);
+
 // clone the execution ctx and return a shallow copy for the ast
 // deep copy for the execution plan
 ExecutionCtx *ExecutionCtx_Clone
@@ -0,0 +1,185 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "rax.h"
+#include "prepared_statements.h"
+#include "../util/rmalloc.h"
+
+#include <pthread.h>
+
+// a prepared query
+typedef struct {
+	char *query;             // query as given to GRAPH.PREPARE
+	char *body;              // query excluding parameters
+	ExecutionCtx *exec_ctx;  // execution-ctx, cloned on every execution
+} PreparedStatement;
+
+struct PreparedStatements {
+	rax *lookup;              // query to statement handle
+	rax *statements;          // statement handle to statement
+	int64_t next_handle;      // handle of the next statement
+	pthread_rwlock_t rwlock;  // protects lookup and statements
+};
+
+static void _PreparedStatement_Free
+(
+	PreparedStatement *stmt
+) {
+	ExecutionCtx_Free(stmt->exec_ctx);
+	rm_free(stmt->query);
+	rm_free(stmt->body);
+	rm_free(stmt);
+}
+
+PreparedStatements *PreparedStatements_New(void) {
+	PreparedStatements *ps = rm_malloc(sizeof(PreparedStatements));
+
+	ps->lookup      = raxNew();
+	ps->statements  = raxNew();
+	ps->next_handle = 0;
+
+	int res = pthread_rwlock_init(&ps->rwlock, NULL);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	return ps;
+}
+
+int64_t PreparedStatements_Lookup
+(
+	PreparedStatements *ps,
+	const char *query
+) {
+	ASSERT(ps    != NULL);
+	ASSERT(query != NULL);
+
+	int64_t handle = -1;
+
+	pthread_rwlock_rdlock(&ps->rwlock);
+
+	void *h = raxFind(ps->lookup, (unsigned char *)query, strlen(query));
+	if(h != raxNotFound) handle = (int64_t)(intptr_t)h;
+
+	pthread_rwlock_unlock(&ps->rwlock);
+
+	return handle;
+}
+
+int64_t PreparedStatements_Add
+(
+	PreparedStatements *ps,
+	const char *query,
+	const char *body,
+	ExecutionCtx *exec_ctx
+) {
+	ASSERT(ps       != NULL);
+	ASSERT(body     != NULL);
+	ASSERT(query    != NULL);
+	ASSERT(exec_ctx != NULL);
+
+	int64_t handle;
+	size_t  query_len = strlen(query);
+
+	pthread_rwlock_wrlock(&ps->rwlock);
+
+	// query might have been prepared concurrently
+	void *h = raxFind(ps->lookup, (unsigned char *)query, query_len);
+	if(h != raxNotFound) {
+		handle = (int64_t)(intptr_t)h;
+		ExecutionCtx_Free(exec_ctx);
+		goto cleanup;
+	}
+
+	if(raxSize(ps->statements) == PREPARED_STATEMENTS_MAX) {
+		handle = -1;
+		ExecutionCtx_Free(exec_ctx);
+		goto cleanup;
+	}
+
+	PreparedStatement *stmt = rm_malloc(sizeof(PreparedStatement));
+	stmt->query    = rm_strdup(query);
+	stmt->body     = rm_strdup(body);
+	stmt->exec_ctx = exec_ctx;
+
+	// handles aren't reused, a deallocated handle stays unknown
+	handle = ps->next_handle++;
+	raxInsert(ps->statements, (unsigned char *)&handle, sizeof(handle), stmt,
+			NULL);
+	raxInsert(ps->lookup, (unsigned char *)query, query_len,
+			(void *)(intptr_t)handle, NULL);
+
+cleanup:
+	pthread_rwlock_unlock(&ps->rwlock);
+	return handle;
+}
+
+ExecutionCtx *PreparedStatements_Get
+(
+	PreparedStatements *ps,
+	int64_t handle,
+	char **body
+) {
+	ASSERT(ps   != NULL);
+	ASSERT(body != NULL);
+
+	ExecutionCtx *exec_ctx = NULL;
+
+	pthread_rwlock_rdlock(&ps->rwlock);
+
+	PreparedStatement *stmt = raxFind(ps->statements, (unsigned char *)&handle,
+			sizeof(handle));
+	if(stmt != raxNotFound) {
+		// statement might be deallocated once the lock is released
+		*body    = rm_strdup(stmt->body);
+		exec_ctx = ExecutionCtx_Clone(stmt->exec_ctx);
+	}
+
+	pthread_rwlock_unlock(&ps->rwlock);
+
+	return exec_ctx;
+}
+
+bool PreparedStatements_Remove
+(
+	PreparedStatements *ps,
+	int64_t handle
+) {
+	ASSERT(ps != NULL);
+
+	PreparedStatement *stmt = NULL;
+
+	pthread_rwlock_wrlock(&ps->rwlock);
+
+	if(raxRemove(ps->statements, (unsigned char *)&handle, sizeof(handle),
+				(void **)&stmt)) {
+		raxRemove(ps->lookup, (unsigned char *)stmt->query,
+				strlen(stmt->query), NULL);
+	}
+
+	pthread_rwlock_unlock(&ps->rwlock);
+
+	if(stmt == NULL) return false;
+
+	_PreparedStatement_Free(stmt);
+	return true;
+}
+
+void PreparedStatements_Free
+(
+	PreparedStatements *ps
+) {
+	ASSERT(ps != NULL);
+
+	raxFreeWithCallback(ps->statements, (void (*)(void *))_PreparedStatement_Free);
+	raxFree(ps->lookup);
+
+	int res = pthread_rwlock_destroy(&ps->rwlock);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	rm_free(ps);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "execution_ctx.h"
+
+// maximum number of prepared statements per graph
+#define PREPARED_STATEMENTS_MAX 4096
+
+// registry of queries prepared via GRAPH.PREPARE
+// each statement is identified by a handle, handles are never reused
+// statements live until deallocated via GRAPH.DEALLOCATE or until their graph
+// is freed, executing a statement clones its execution-ctx, skipping query
+// parsing and cache lookup altogether
+typedef struct PreparedStatements PreparedStatements;
+
+// create a new prepared statements registry
+PreparedStatements *PreparedStatements_New(void);
+
+// returns the handle of a previously prepared query, -1 if query isn't prepared
+int64_t PreparedStatements_Lookup
+(
+	PreparedStatements *ps,  // prepared statements
+	const char *query        // query as given to GRAPH.PREPARE
+);
+
+// registers a prepared statement, returning its handle
+// in case query has already been prepared the existing handle is returned
+// and 'exec_ctx' is freed
+// returns -1 if the registry is full
+int64_t PreparedStatements_Add
+(
+	PreparedStatements *ps,  // prepared statements
+	const char *query,       // query as given to GRAPH.PREPARE
+	const char *body,        // query excluding parameters
+	ExecutionCtx *exec_ctx   // execution-ctx of the prepared query
+);
+
+// returns a copy of the statement's execution-ctx, NULL if handle is unknown
+// 'body' is set to a copy of the statement's query excluding parameters
+// which the caller should free
+ExecutionCtx *PreparedStatements_Get
+(
+	PreparedStatements *ps,  // prepared statements
+	int64_t handle,          // statement handle
+	char **body              // [output] statement query
+);
+
+// removes a prepared statement
+// returns false if handle is unknown
+bool PreparedStatements_Remove
+(
+	PreparedStatements *ps,  // prepared statements
+	int64_t handle           // statement handle
+);
+
+// free prepared statements registry
+void PreparedStatements_Free
+(
+	PreparedStatements *ps  // prepared statements
+);
@@ -55,6 +55,18 @@
 // size of node creation buffer
 #define NODE_CREATION_BUFFER "NODE_CREATION_BUFFER"
 
+// whether delta matrices are merged on a background thread
+#define DELTA_BACKGROUND_COMPACTION "DELTA_BACKGROUND_COMPACTION"
+
+// ms of inactivity before delta matrices are compacted
+#define DELTA_IDLE_COMPACTION_DELAY "DELTA_IDLE_COMPACTION_DELAY"
+
+// share a single copy of equal string attributes
+#define STRING_INTERNING "STRING_INTERNING"
+
+// replicate write queries as effects
+#define REPLICATE_EFFECTS "REPLICATE_EFFECTS"
+
 //------------------------------------------------------------------------------
 // Configuration defaults
 //------------------------------------------------------------------------------
@@ -78,6 +90,10 @@ typedef struct {
 	int64_t query_mem_capacity;        // Max mem(bytes) that query/thread can utilize at any given time
 	uint64_t node_creation_buffer;     // Number of extra node creations to buffer as margin in matrices
 	int64_t delta_max_pending_changes; // number of pending changed befor RG_Matrix flushed
+	bool delta_background_compaction;  // merge delta matrices on a background thread
+	uint64_t delta_idle_compaction_delay; // ms of inactivity before delta matrices are compacted
+	bool string_interning;             // share a single copy of equal string attributes
+	bool replicate_effects;            // replicate write queries as effects
 	Config_on_change cb;               // callback function which being called when config param changed
 } RG_Config;
 
@@ -376,6 +392,66 @@ static uint64_t Config_node_creation_buffer_get(void) {
 	return config.node_creation_buffer;
 }
 
+//------------------------------------------------------------------------------
+// delta background compaction
+//------------------------------------------------------------------------------
+
+static void Config_delta_background_compaction_set
+(
+	bool background_compaction
+) {
+	config.delta_background_compaction = background_compaction;
+}
+
+static bool Config_delta_background_compaction_get(void) {
+	return config.delta_background_compaction;
+}
+
+//------------------------------------------------------------------------------
+// delta idle compaction delay
+//------------------------------------------------------------------------------
+
+static void Config_delta_idle_compaction_delay_set
+(
+	uint64_t delta_idle_compaction_delay
+) {
+	config.delta_idle_compaction_delay = delta_idle_compaction_delay;
+}
+
+static uint64_t Config_delta_idle_compaction_delay_get(void) {
+	return config.delta_idle_compaction_delay;
+}
+
+//------------------------------------------------------------------------------
+// string interning
+//------------------------------------------------------------------------------
+
+static void Config_string_interning_set
+(
+	bool string_interning
+) {
+	config.string_interning = string_interning;
+}
+
+static bool Config_string_interning_get(void) {
+	return config.string_interning;
+}
+
+//------------------------------------------------------------------------------
+// effects replication
+//------------------------------------------------------------------------------
+
+static void Config_replicate_effects_set
+(
+	bool replicate_effects
+) {
+	config.replicate_effects = replicate_effects;
+}
+
+static bool Config_replicate_effects_get(void) {
+	return config.replicate_effects;
+}
+
 bool Config_Contains_field
 (
 	const char *field_str,
@@ -409,6 +485,14 @@ bool Config_Contains_field
 		f = Config_DELTA_MAX_PENDING_CHANGES;
 	} else if(!(strcasecmp(field_str, NODE_CREATION_BUFFER))) {
 		f = Config_NODE_CREATION_BUFFER;
+	} else if(!(strcasecmp(field_str, DELTA_BACKGROUND_COMPACTION))) {
+		f = Config_DELTA_BACKGROUND_COMPACTION;
+	} else if(!(strcasecmp(field_str, DELTA_IDLE_COMPACTION_DELAY))) {
+		f = Config_DELTA_IDLE_COMPACTION_DELAY;
+	} else if(!(strcasecmp(field_str, STRING_INTERNING))) {
+		f = Config_STRING_INTERNING;
+	} else if(!(strcasecmp(field_str, REPLICATE_EFFECTS))) {
+		f = Config_REPLICATE_EFFECTS;
 	} else {
 		return false;
 	}
@@ -475,6 +559,22 @@ const char *Config_Field_name
 			name = NODE_CREATION_BUFFER;
 			break;
 
+		case Config_DELTA_BACKGROUND_COMPACTION:
+			name = DELTA_BACKGROUND_COMPACTION;
+			break;
+
+		case Config_DELTA_IDLE_COMPACTION_DELAY:
+			name = DELTA_IDLE_COMPACTION_DELAY;
+			break;
+
+		case Config_STRING_INTERNING:
+			name = STRING_INTERNING;
+			break;
+
+		case Config_REPLICATE_EFFECTS:
+			name = REPLICATE_EFFECTS;
+			break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -533,6 +633,18 @@ static void _Config_SetToDefaults(void) {
 
 	// the amount of empty space to reserve for node creations in matrices
 	config.node_creation_buffer = NODE_CREATION_BUFFER_DEFAULT;
+
+	// delta matrices are merged inline by default
+	config.delta_background_compaction = false;
+
+	// idle matrices aren't compacted by default
+	config.delta_idle_compaction_delay = 0;
+
+	// intern string attributes by default
+	config.string_interning = true;
+
+	// write queries are replicated as is by default
+	config.replicate_effects = false;
 }
 
 int Config_Init
@@ -798,6 +910,62 @@ bool Config_Option_get
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// merge delta matrices on a background thread
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_BACKGROUND_COMPACTION: {
+			va_start(ap, field);
+			bool *background_compaction = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(background_compaction != NULL);
+			(*background_compaction) = Config_delta_background_compaction_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// ms of inactivity before delta matrices are compacted
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_IDLE_COMPACTION_DELAY: {
+			va_start(ap, field);
+			uint64_t *delta_idle_compaction_delay = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(delta_idle_compaction_delay != NULL);
+			(*delta_idle_compaction_delay) = Config_delta_idle_compaction_delay_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// share a single copy of equal string attributes
+		//----------------------------------------------------------------------
+
+		case Config_STRING_INTERNING: {
+			va_start(ap, field);
+			bool *string_interning = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(string_interning != NULL);
+			(*string_interning) = Config_string_interning_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// replicate write queries as effects
+		//----------------------------------------------------------------------
+
+		case Config_REPLICATE_EFFECTS: {
+			va_start(ap, field);
+			bool *replicate_effects = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(replicate_effects != NULL);
+			(*replicate_effects) = Config_replicate_effects_get();
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -998,6 +1166,54 @@ bool Config_Option_set
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// merge delta matrices on a background thread
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_BACKGROUND_COMPACTION: {
+			bool background_compaction;
+			if(!_Config_ParseYesNo(val, &background_compaction)) return false;
+
+			Config_delta_background_compaction_set(background_compaction);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// ms of inactivity before delta matrices are compacted
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_IDLE_COMPACTION_DELAY: {
+			long long delta_idle_compaction_delay;
+			if(!_Config_ParseNonNegativeInteger(val, &delta_idle_compaction_delay)) return false;
+
+			Config_delta_idle_compaction_delay_set(delta_idle_compaction_delay);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// share a single copy of equal string attributes
+		//----------------------------------------------------------------------
+
+		case Config_STRING_INTERNING: {
+			bool string_interning;
+			if(!_Config_ParseYesNo(val, &string_interning)) return false;
+
+			Config_string_interning_set(string_interning);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// replicate write queries as effects
+		//----------------------------------------------------------------------
+
+		case Config_REPLICATE_EFFECTS: {
+			bool replicate_effects;
+			if(!_Config_ParseYesNo(val, &replicate_effects)) return false;
+
+			Config_replicate_effects_set(replicate_effects);
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
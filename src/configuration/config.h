@@ -16,21 +16,29 @@
 #define NODE_CREATION_BUFFER_DEFAULT       16384
 #define DELTA_MAX_PENDING_CHANGES_DEFAULT  10000
 
+// with background compaction enabled, RG_Matrix is flushed inline only once
+// its pending changes exceed DELTA_MAX_PENDING_CHANGES by this factor
+#define DELTA_BACKGROUND_COMPACTION_HARD_LIMIT 4
+
 typedef enum {
-	Config_TIMEOUT                   = 0,   // timeout value for queries
-	Config_TIMEOUT_DEFAULT           = 1,   // default timeout for read and write queries
-	Config_TIMEOUT_MAX               = 2,   // max timeout that can be enforced
-	Config_CACHE_SIZE                = 3,   // number of entries in cache
-	Config_ASYNC_DELETE              = 4,   // delete graph asynchronously
-	Config_OPENMP_NTHREAD            = 5,   // max number of OpenMP threads to use
-	Config_THREAD_POOL_SIZE          = 6,   // number of threads in thread pool
-	Config_RESULTSET_MAX_SIZE        = 7,   // max number of records in result-set
-	Config_VKEY_MAX_ENTITY_COUNT     = 8,   // max number of elements in vkey
-	Config_MAX_QUEUED_QUERIES        = 9,   // max number of queued queries
-	Config_QUERY_MEM_CAPACITY        = 10,  // max mem(bytes) that query/thread can utilize at any given time
-	Config_DELTA_MAX_PENDING_CHANGES = 11,  // number of pending changes before RG_Matrix flushed
-	Config_NODE_CREATION_BUFFER      = 12,  // size of buffer to maintain as margin in matrices
-	Config_END_MARKER                = 13
+	Config_TIMEOUT                     = 0,   // timeout value for queries
+	Config_TIMEOUT_DEFAULT             = 1,   // default timeout for read and write queries
+	Config_TIMEOUT_MAX                 = 2,   // max timeout that can be enforced
+	Config_CACHE_SIZE                  = 3,   // number of entries in cache
+	Config_ASYNC_DELETE                = 4,   // delete graph asynchronously
+	Config_OPENMP_NTHREAD              = 5,   // max number of OpenMP threads to use
+	Config_THREAD_POOL_SIZE            = 6,   // number of threads in thread pool
+	Config_RESULTSET_MAX_SIZE          = 7,   // max number of records in result-set
+	Config_VKEY_MAX_ENTITY_COUNT       = 8,   // max number of elements in vkey
+	Config_MAX_QUEUED_QUERIES          = 9,   // max number of queued queries
+	Config_QUERY_MEM_CAPACITY          = 10,  // max mem(bytes) that query/thread can utilize at any given time
+	Config_DELTA_MAX_PENDING_CHANGES   = 11,  // number of pending changes before RG_Matrix flushed
+	Config_NODE_CREATION_BUFFER        = 12,  // size of buffer to maintain as margin in matrices
+	Config_DELTA_BACKGROUND_COMPACTION = 13,  // merge delta matrices on a background thread
+	Config_DELTA_IDLE_COMPACTION_DELAY = 14,  // ms of inactivity before delta matrices are compacted
+	Config_STRING_INTERNING            = 15,  // share a single copy of equal string attributes
+	Config_REPLICATE_EFFECTS           = 16,  // replicate write queries as effects
+	Config_END_MARKER                  = 17
 } Config_Option_Field;
 
 // callback function, invoked once configuration changes as a result of
@@ -38,7 +46,7 @@ typedef enum {
 typedef void (*Config_on_change)(Config_Option_Field type);
 
 // Run-time configurable fields
-#define RUNTIME_CONFIG_COUNT 8
+#define RUNTIME_CONFIG_COUNT 12
 static const Config_Option_Field RUNTIME_CONFIGS[] = {
 	Config_TIMEOUT,
 	Config_TIMEOUT_MAX,
@@ -47,7 +55,11 @@ static const Config_Option_Field RUNTIME_CONFIGS[] = {
 	Config_MAX_QUEUED_QUERIES,
 	Config_QUERY_MEM_CAPACITY,
 	Config_VKEY_MAX_ENTITY_COUNT,
-	Config_DELTA_MAX_PENDING_CHANGES
+	Config_DELTA_MAX_PENDING_CHANGES,
+	Config_DELTA_BACKGROUND_COMPACTION,
+	Config_DELTA_IDLE_COMPACTION_DELAY,
+	Config_STRING_INTERNING,
+	Config_REPLICATE_EFFECTS
 };
 
 // Set module-level configurations to defaults or to user arguments where provided.
@@ -0,0 +1,845 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "effects.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graph_hub.h"
+#include "../datatypes/array.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+// encoding
+//------------------------------------------------------------------------------
+
+// append 'n' bytes to effects buffer
+static inline void _Write
+(
+	unsigned char **buf,  // effects buffer
+	const void *src,      // bytes to append
+	size_t n              // number of bytes to append
+) {
+	array_ensure_append(*buf, src, n, unsigned char);
+}
+
+#define _WRITE(buf, v) _Write((buf), &(v), sizeof(v))
+
+static void _WriteString
+(
+	unsigned char **buf,
+	const char *s
+) {
+	uint32_t len = strlen(s);
+	_WRITE(buf, len);
+	_Write(buf, s, len);
+}
+
+// encode value, returns false if value can't be encoded
+static bool _WriteValue
+(
+	unsigned char **buf,
+	SIValue v
+) {
+	uint32_t t = SI_TYPE(v);
+	_WRITE(buf, t);
+
+	switch(SI_TYPE(v)) {
+		case T_NULL:
+			return true;
+		case T_BOOL:
+		case T_INT64:
+			_WRITE(buf, v.longval);
+			return true;
+		case T_DOUBLE:
+			_WRITE(buf, v.doubleval);
+			return true;
+		case T_STRING:
+			_WriteString(buf, v.stringval);
+			return true;
+		case T_POINT:
+			_WRITE(buf, v.point.latitude);
+			_WRITE(buf, v.point.longitude);
+			return true;
+		case T_ARRAY: {
+			uint32_t len = SIArray_Length(v);
+			_WRITE(buf, len);
+			for(uint32_t i = 0; i < len; i++) {
+				if(!_WriteValue(buf, SIArray_Get(v, i))) return false;
+			}
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+static void _WriteLabels
+(
+	unsigned char **buf,
+	const LabelID *labels,
+	uint16_t label_count
+) {
+	_WRITE(buf, label_count);
+	for(uint16_t i = 0; i < label_count; i++) {
+		int32_t l = labels[i];
+		_WRITE(buf, l);
+	}
+}
+
+static bool _WriteAttributes
+(
+	unsigned char **buf,
+	const AttributeSet set
+) {
+	uint16_t attr_count = ATTRIBUTE_SET_COUNT(set);
+	_WRITE(buf, attr_count);
+
+	for(uint16_t i = 0; i < attr_count; i++) {
+		Attribute_ID attr_id;
+		SIValue v = AttributeSet_GetIdx(set, i, &attr_id);
+		_WRITE(buf, attr_id);
+		if(!_WriteValue(buf, v)) return false;
+	}
+
+	return true;
+}
+
+static void _WriteEdgeHeader
+(
+	unsigned char **buf,
+	EffectType t,
+	EntityID id,
+	int relation,
+	NodeID src,
+	NodeID dest
+) {
+	uint8_t  _t = t;
+	int32_t  r  = relation;
+	uint64_t _id   = id;
+	uint64_t _src  = src;
+	uint64_t _dest = dest;
+
+	_WRITE(buf, _t);
+	_WRITE(buf, _id);
+	_WRITE(buf, r);
+	_WRITE(buf, _src);
+	_WRITE(buf, _dest);
+}
+
+static void _WriteNodeHeader
+(
+	unsigned char **buf,
+	EffectType t,
+	EntityID id
+) {
+	uint8_t  _t  = t;
+	uint64_t _id = id;
+
+	_WRITE(buf, _t);
+	_WRITE(buf, _id);
+}
+
+// created nodes carry the labels and attributes they hold once the query
+// committed, a node deleted by the query is created bare
+static bool _EncodeCreateNode
+(
+	unsigned char **buf,
+	Graph *g,
+	const Node *created
+) {
+	Node n;
+	EntityID id = ENTITY_GET_ID(created);
+	_WriteNodeHeader(buf, EFFECT_CREATE_NODE, id);
+
+	if(!Graph_GetNode(g, id, &n)) {
+		_WriteLabels(buf, NULL, 0);
+		return _WriteAttributes(buf, NULL);
+	}
+
+	uint label_count;
+	NODE_GET_LABELS(g, &n, label_count);
+	_WriteLabels(buf, labels, label_count);
+	return _WriteAttributes(buf, *n.attributes);
+}
+
+static bool _EncodeCreateEdge
+(
+	unsigned char **buf,
+	Graph *g,
+	const Edge *created
+) {
+	Edge e;
+	EntityID id = ENTITY_GET_ID(created);
+	_WriteEdgeHeader(buf, EFFECT_CREATE_EDGE, id, created->relationID,
+			created->srcNodeID, created->destNodeID);
+
+	if(!Graph_GetEdge(g, id, &e)) return _WriteAttributes(buf, NULL);
+	return _WriteAttributes(buf, *e.attributes);
+}
+
+// encode consecutive updates of the same entity as a single effect
+// carrying each updated attribute's value once the query committed
+// advances 'i' to the last update consumed
+static bool _EncodeUpdate
+(
+	unsigned char **buf,
+	Graph *g,
+	const UndoLog log,
+	uint *i
+) {
+	const UndoUpdateOp *op = &log[*i].update_op;
+	GraphEntityType     t  = op->entity_type;
+	EntityID            id = (t == GETYPE_NODE) ? op->n.id : op->e.id;
+
+	// collect attributes updated by consecutive updates of the entity
+	uint j = *i;
+	uint count = array_len(log);
+	Attribute_ID *attrs = array_new(Attribute_ID, 1);
+	for(; j < count; j++) {
+		const UndoUpdateOp *next = &log[j].update_op;
+		if(log[j].type != UNDO_UPDATE || next->entity_type != t) break;
+		if(((t == GETYPE_NODE) ? next->n.id : next->e.id) != id) break;
+
+		bool seen = false;
+		for(uint k = 0; k < array_len(attrs) && !seen; k++) {
+			seen = attrs[k] == next->attr_id;
+		}
+		if(!seen) array_append(attrs, next->attr_id);
+	}
+	*i = j - 1;
+
+	// entity was deleted by the query, its updates are irrelevant
+	Node n;
+	Edge e;
+	GraphEntity *ge;
+	if(t == GETYPE_NODE) {
+		if(!Graph_GetNode(g, id, &n)) goto cleanup;
+		_WriteNodeHeader(buf, EFFECT_UPDATE_NODE, id);
+		ge = (GraphEntity *)&n;
+	} else {
+		if(!Graph_GetEdge(g, id, &e)) goto cleanup;
+		Edge updated = op->e;
+		_WriteEdgeHeader(buf, EFFECT_UPDATE_EDGE, id,
+				EDGE_GET_RELATION_ID(&updated, g), updated.srcNodeID,
+				updated.destNodeID);
+		ge = (GraphEntity *)&e;
+	}
+
+	uint16_t attr_count = array_len(attrs);
+	_WRITE(buf, attr_count);
+	for(uint16_t k = 0; k < attr_count; k++) {
+		// a removed attribute is encoded as NULL
+		SIValue *v = GraphEntity_GetProperty(ge, attrs[k]);
+		SIValue value = (v == ATTRIBUTE_NOTFOUND) ? SI_NullVal() : *v;
+
+		_WRITE(buf, attrs[k]);
+		if(!_WriteValue(buf, value)) {
+			array_free(attrs);
+			return false;
+		}
+	}
+
+cleanup:
+	array_free(attrs);
+	return true;
+}
+
+static void _EncodeDeleteEdge
+(
+	unsigned char **buf,
+	const UndoDeleteEdgeOp *op
+) {
+	_WriteEdgeHeader(buf, EFFECT_DELETE_EDGE, op->id, op->relationID,
+			op->srcNodeID, op->destNodeID);
+}
+
+static void _EncodeLabels
+(
+	unsigned char **buf,
+	EffectType t,
+	const UndoLabelsOp *op
+) {
+	_WriteNodeHeader(buf, t, ENTITY_GET_ID(&op->node));
+	_WriteLabels(buf, op->label_lds, op->labels_count);
+}
+
+static void _EncodeAddSchema
+(
+	unsigned char **buf,
+	GraphContext *gc,
+	const UndoAddSchemaOp *op
+) {
+	uint8_t  t  = EFFECT_ADD_SCHEMA;
+	uint8_t  st = op->t;
+	int32_t  id = op->schema_id;
+	Schema  *s  = GraphContext_GetSchemaByID(gc, op->schema_id, op->t);
+	ASSERT(s != NULL);
+
+	_WRITE(buf, t);
+	_WRITE(buf, id);
+	_WRITE(buf, st);
+	_WriteString(buf, Schema_GetName(s));
+}
+
+static void _EncodeAddAttribute
+(
+	unsigned char **buf,
+	GraphContext *gc,
+	const UndoAddAttributeOp *op
+) {
+	uint8_t      t  = EFFECT_ADD_ATTRIBUTE;
+	Attribute_ID id = op->attribute_id;
+
+	_WRITE(buf, t);
+	_WRITE(buf, id);
+	_WriteString(buf, GraphContext_GetAttributeString(gc, id));
+}
+
+unsigned char *Effects_FromUndoLog
+(
+	GraphContext *gc,
+	const UndoLog log,
+	size_t *len
+) {
+	ASSERT(gc  != NULL);
+	ASSERT(log != NULL);
+	ASSERT(len != NULL);
+
+	Graph *g = gc->g;
+	bool ok = true;
+	uint count = array_len(log);
+	uint8_t version = EFFECTS_VERSION;
+	unsigned char *buf = array_new(unsigned char, 64 * (count + 1));
+
+	_WRITE(&buf, version);
+
+	// schema and attribute additions are encoded first
+	// created entities carry the labels and attributes they hold once the
+	// query committed, which may refer to schemas and attributes introduced
+	// by the query after the entity was created
+	for(uint i = 0; i < count; i++) {
+		const UndoOp *op = log + i;
+		if(op->type == UNDO_ADD_SCHEMA) {
+			_EncodeAddSchema(&buf, gc, &op->schema_op);
+		} else if(op->type == UNDO_ADD_ATTRIBUTE) {
+			_EncodeAddAttribute(&buf, gc, &op->attribute_op);
+		}
+	}
+
+	for(uint i = 0; i < count && ok; i++) {
+		const UndoOp *op = log + i;
+		switch(op->type) {
+			case UNDO_CREATE_NODE:
+				ok = _EncodeCreateNode(&buf, g, &op->create_op.n);
+				break;
+			case UNDO_CREATE_EDGE:
+				ok = _EncodeCreateEdge(&buf, g, &op->create_op.e);
+				break;
+			case UNDO_DELETE_NODE:
+				_WriteNodeHeader(&buf, EFFECT_DELETE_NODE, op->delete_node_op.id);
+				break;
+			case UNDO_DELETE_EDGE:
+				_EncodeDeleteEdge(&buf, &op->delete_edge_op);
+				break;
+			case UNDO_UPDATE:
+				ok = _EncodeUpdate(&buf, g, log, &i);
+				break;
+			case UNDO_SET_LABELS:
+				_EncodeLabels(&buf, EFFECT_SET_LABELS, &op->labels_op);
+				break;
+			case UNDO_REMOVE_LABELS:
+				_EncodeLabels(&buf, EFFECT_REMOVE_LABELS, &op->labels_op);
+				break;
+			case UNDO_ADD_SCHEMA:
+			case UNDO_ADD_ATTRIBUTE:
+				// already encoded
+				break;
+			default:
+				ASSERT(false);
+				ok = false;
+		}
+	}
+
+	if(!ok) {
+		array_free(buf);
+		return NULL;
+	}
+
+	*len = array_len(buf);
+	return buf;
+}
+
+//------------------------------------------------------------------------------
+// decoding
+//------------------------------------------------------------------------------
+
+typedef struct {
+	const unsigned char *buf;  // effects buffer
+	size_t len;                // length of effects buffer
+	size_t offset;             // read offset
+} EffectsReader;
+
+// read 'n' bytes from effects buffer
+// returns false if the buffer holds less than 'n' unread bytes
+static inline bool _Read
+(
+	EffectsReader *r,  // effects reader
+	void *dst,         // read bytes destination
+	size_t n           // number of bytes to read
+) {
+	if(r->len - r->offset < n) return false;
+
+	memcpy(dst, r->buf + r->offset, n);
+	r->offset += n;
+	return true;
+}
+
+#define _READ(r, v) _Read((r), &(v), sizeof(v))
+
+static bool _ReadString
+(
+	EffectsReader *r,
+	char **s
+) {
+	uint32_t len;
+	if(!_READ(r, len) || r->len - r->offset < len) return false;
+
+	*s = rm_strndup((const char *)r->buf + r->offset, len);
+	r->offset += len;
+	return true;
+}
+
+static bool _ReadValue
+(
+	EffectsReader *r,
+	SIValue *v
+) {
+	uint32_t t;
+	if(!_READ(r, t)) return false;
+
+	switch(t) {
+		case T_NULL:
+			*v = SI_NullVal();
+			return true;
+		case T_BOOL:
+		case T_INT64: {
+			int64_t l;
+			if(!_READ(r, l)) return false;
+			*v = (t == T_BOOL) ? SI_BoolVal(l) : SI_LongVal(l);
+			return true;
+		}
+		case T_DOUBLE: {
+			double d;
+			if(!_READ(r, d)) return false;
+			*v = SI_DoubleVal(d);
+			return true;
+		}
+		case T_STRING: {
+			char *s;
+			if(!_ReadString(r, &s)) return false;
+			*v = SI_TransferStringVal(s);
+			return true;
+		}
+		case T_POINT: {
+			float lat;
+			float lon;
+			if(!_READ(r, lat) || !_READ(r, lon)) return false;
+			*v = SI_Point(lat, lon);
+			return true;
+		}
+		case T_ARRAY: {
+			uint32_t len;
+			// each element takes at least 4 bytes
+			if(!_READ(r, len) || len > (r->len - r->offset) / 4) return false;
+
+			*v = SI_Array(len);
+			for(uint32_t i = 0; i < len; i++) {
+				SIValue elem;
+				if(!_ReadValue(r, &elem)) {
+					SIValue_Free(*v);
+					return false;
+				}
+				SIArray_Append(v, elem);
+				SIValue_Free(elem);
+			}
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+// read labels, validating each label exists
+static bool _ReadLabels
+(
+	EffectsReader *r,
+	GraphContext *gc,
+	LabelID **labels  // [output] labels array
+) {
+	uint16_t label_count;
+	if(!_READ(r, label_count)) return false;
+
+	*labels = array_new(LabelID, label_count);
+	int schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+
+	for(uint16_t i = 0; i < label_count; i++) {
+		int32_t l;
+		if(!_READ(r, l) || l < 0 || l >= schema_count) return false;
+		array_append(*labels, l);
+	}
+
+	return true;
+}
+
+// read attributes, validating each attribute exists
+// NULL values are only accepted if 'allow_null' is set
+static bool _ReadAttributes
+(
+	EffectsReader *r,
+	GraphContext *gc,
+	AttributeSet *set,  // [output] attributes
+	bool allow_null     // accept NULL values
+) {
+	uint16_t attr_count;
+	if(!_READ(r, attr_count)) return false;
+
+	uint known_attrs = GraphContext_AttributeCount(gc);
+
+	for(uint16_t i = 0; i < attr_count; i++) {
+		SIValue v;
+		Attribute_ID attr_id;
+		if(!_READ(r, attr_id) || attr_id >= known_attrs) return false;
+		if(!_ReadValue(r, &v)) return false;
+
+		if(SIValue_IsNull(v) && !allow_null) return false;
+		if(!(SI_TYPE(v) & (SI_VALID_PROPERTY_VALUE | T_NULL))) {
+			SIValue_Free(v);
+			return false;
+		}
+
+		AttributeSet_Set_Allow_Null(set, attr_id, v);
+		SIValue_Free(v);
+	}
+
+	return true;
+}
+
+static bool _ReadEdgeHeader
+(
+	EffectsReader *r,
+	GraphContext *gc,
+	uint64_t *id,
+	int32_t *relation,
+	uint64_t *src,
+	uint64_t *dest
+) {
+	if(!_READ(r, *id) || !_READ(r, *relation) || !_READ(r, *src) ||
+	   !_READ(r, *dest)) {
+		return false;
+	}
+
+	return *relation >= 0 &&
+		*relation < GraphContext_SchemaCount(gc, SCHEMA_EDGE);
+}
+
+static bool _ApplyCreateNode
+(
+	EffectsReader *r,
+	GraphContext *gc
+) {
+	uint64_t     id;
+	bool         res    = false;
+	LabelID      *labels = NULL;
+	AttributeSet set    = NULL;
+
+	if(!_READ(r, id) || !_ReadLabels(r, gc, &labels) ||
+	   !_ReadAttributes(r, gc, &set, false)) {
+		AttributeSet_Free(&set);
+		goto cleanup;
+	}
+
+	Node n = GE_NEW_NODE();
+	CreateNode(gc, &n, labels, array_len(labels), set);
+
+	// node ids are deterministic, a different id indicates divergence
+	res = ENTITY_GET_ID(&n) == id;
+
+cleanup:
+	if(labels != NULL) array_free(labels);
+	return res;
+}
+
+static bool _ApplyCreateEdge
+(
+	EffectsReader *r,
+	GraphContext *gc
+) {
+	Node         n;
+	uint64_t     id;
+	uint64_t     src;
+	uint64_t     dest;
+	int32_t      relation;
+	AttributeSet set = NULL;
+	Graph        *g  = gc->g;
+
+	if(!_ReadEdgeHeader(r, gc, &id, &relation, &src, &dest) ||
+	   !_ReadAttributes(r, gc, &set, false) ||
+	   !Graph_GetNode(g, src, &n) || !Graph_GetNode(g, dest, &n)) {
+		AttributeSet_Free(&set);
+		return false;
+	}
+
+	Schema *s = GraphContext_GetSchemaByID(gc, relation, SCHEMA_EDGE);
+	Edge e = GE_NEW_LABELED_EDGE(Schema_GetName(s), relation);
+	CreateEdge(gc, &e, src, dest, relation, set);
+
+	// edge ids are deterministic, a different id indicates divergence
+	return ENTITY_GET_ID(&e) == id;
+}
+
+static bool _ApplyDeleteNode
+(
+	EffectsReader *r,
+	GraphContext *gc
+) {
+	Node     n;
+	uint64_t id;
+
+	if(!_READ(r, id) || !Graph_GetNode(gc->g, id, &n)) return false;
+
+	// the node's edges were deleted by preceding effects
+	DeleteNode(gc, &n);
+	return true;
+}
+
+// edge deletions are batched, the batch is applied once a different effect
+// is encountered
+static bool _ApplyDeleteEdge
+(
+	EffectsReader *r,
+	GraphContext *gc,
+	Edge **deleted_edges
+) {
+	Edge     e;
+	uint64_t id;
+	uint64_t src;
+	uint64_t dest;
+	int32_t  relation;
+
+	if(!_ReadEdgeHeader(r, gc, &id, &relation, &src, &dest) ||
+	   !Graph_GetEdge(gc->g, id, &e)) {
+		return false;
+	}
+
+	e.relationID = relation;
+	e.srcNodeID  = src;
+	e.destNodeID = dest;
+	array_append(*deleted_edges, e);
+
+	return true;
+}
+
+static bool _ApplyUpdate
+(
+	EffectsReader *r,
+	GraphContext *gc,
+	GraphEntityType t
+) {
+	Node         n;
+	Edge         e;
+	uint64_t     id;
+	GraphEntity  *ge;
+	AttributeSet set = NULL;
+	bool         res = false;
+
+	if(t == GETYPE_NODE) {
+		if(!_READ(r, id) || !Graph_GetNode(gc->g, id, &n)) return false;
+		ge = (GraphEntity *)&n;
+	} else {
+		uint64_t src;
+		uint64_t dest;
+		int32_t  relation;
+		if(!_ReadEdgeHeader(r, gc, &id, &relation, &src, &dest) ||
+		   !Graph_GetEdge(gc->g, id, &e)) {
+			return false;
+		}
+		e.relationID = relation;
+		e.srcNodeID  = src;
+		e.destNodeID = dest;
+		ge = (GraphEntity *)&e;
+	}
+
+	if(_ReadAttributes(r, gc, &set, true)) {
+		uint props_set;
+		uint props_removed;
+		UpdateEntityProperties(gc, ge, set, t, &props_set, &props_removed);
+		res = true;
+	}
+
+	AttributeSet_Free(&set);
+	return res;
+}
+
+static bool _ApplyLabels
+(
+	EffectsReader *r,
+	GraphContext *gc,
+	bool add
+) {
+	Node        n;
+	uint64_t    id;
+	bool        res    = false;
+	LabelID     *labels = NULL;
+	const char **names  = NULL;
+
+	if(!_READ(r, id) || !_ReadLabels(r, gc, &labels) ||
+	   !Graph_GetNode(gc->g, id, &n)) {
+		goto cleanup;
+	}
+
+	uint label_count = array_len(labels);
+	names = array_new(const char *, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		// a created node already holds the labels it was left with
+		// skip removal of labels it doesn't hold
+		if(!add && !Graph_IsNodeLabeled(gc->g, id, labels[i])) continue;
+
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		array_append(names, Schema_GetName(s));
+	}
+
+	uint labels_added   = 0;
+	uint labels_removed = 0;
+	UpdateNodeLabels(gc, &n, add ? names : NULL, add ? NULL : names,
+			&labels_added, &labels_removed);
+	res = true;
+
+cleanup:
+	if(names  != NULL) array_free(names);
+	if(labels != NULL) array_free(labels);
+	return res;
+}
+
+static bool _ApplyAddSchema
+(
+	EffectsReader *r,
+	GraphContext *gc
+) {
+	int32_t id;
+	uint8_t t;
+	char    *name = NULL;
+	bool    res   = false;
+
+	if(!_READ(r, id) || !_READ(r, t) || (t != SCHEMA_NODE && t != SCHEMA_EDGE)
+	   || !_ReadString(r, &name)) {
+		goto cleanup;
+	}
+
+	if(GraphContext_GetSchema(gc, name, t) != NULL) goto cleanup;
+
+	// schema ids are deterministic, a different id indicates divergence
+	Schema *s = AddSchema(gc, name, t);
+	res = s->id == id;
+
+cleanup:
+	if(name != NULL) rm_free(name);
+	return res;
+}
+
+static bool _ApplyAddAttribute
+(
+	EffectsReader *r,
+	GraphContext *gc
+) {
+	Attribute_ID id;
+	char         *name = NULL;
+
+	if(!_READ(r, id) || !_ReadString(r, &name)) return false;
+
+	// attribute ids are deterministic, a different id indicates divergence
+	bool res = FindOrAddAttribute(gc, name) == id;
+
+	rm_free(name);
+	return res;
+}
+
+bool Effects_Apply
+(
+	GraphContext *gc,
+	const unsigned char *buf,
+	size_t len
+) {
+	ASSERT(gc  != NULL);
+	ASSERT(buf != NULL);
+
+	EffectsReader r = {.buf = buf, .len = len, .offset = 0};
+
+	uint8_t version;
+	if(!_READ(&r, version) || version != EFFECTS_VERSION) return false;
+
+	bool  ok            = true;
+	Graph *g            = gc->g;
+	Edge  *deleted_edges = array_new(Edge, 0);
+
+	// effects only modify the graph, matrices are resized but not synced
+	MATRIX_POLICY policy = Graph_GetMatrixPolicy(g);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+
+	while(ok && r.offset < r.len) {
+		uint8_t t;
+		_READ(&r, t);
+
+		// apply pending edge deletions
+		if(t != EFFECT_DELETE_EDGE && array_len(deleted_edges) > 0) {
+			DeleteEdges(gc, deleted_edges);
+			array_clear(deleted_edges);
+		}
+
+		switch(t) {
+			case EFFECT_CREATE_NODE:
+				ok = _ApplyCreateNode(&r, gc);
+				break;
+			case EFFECT_CREATE_EDGE:
+				ok = _ApplyCreateEdge(&r, gc);
+				break;
+			case EFFECT_DELETE_NODE:
+				ok = _ApplyDeleteNode(&r, gc);
+				break;
+			case EFFECT_DELETE_EDGE:
+				ok = _ApplyDeleteEdge(&r, gc, &deleted_edges);
+				break;
+			case EFFECT_UPDATE_NODE:
+				ok = _ApplyUpdate(&r, gc, GETYPE_NODE);
+				break;
+			case EFFECT_UPDATE_EDGE:
+				ok = _ApplyUpdate(&r, gc, GETYPE_EDGE);
+				break;
+			case EFFECT_SET_LABELS:
+				ok = _ApplyLabels(&r, gc, true);
+				break;
+			case EFFECT_REMOVE_LABELS:
+				ok = _ApplyLabels(&r, gc, false);
+				break;
+			case EFFECT_ADD_SCHEMA:
+				ok = _ApplyAddSchema(&r, gc);
+				break;
+			case EFFECT_ADD_ATTRIBUTE:
+				ok = _ApplyAddAttribute(&r, gc);
+				break;
+			default:
+				ok = false;
+		}
+	}
+
+	if(ok && array_len(deleted_edges) > 0) DeleteEdges(gc, deleted_edges);
+	array_free(deleted_edges);
+
+	Graph_SetMatrixPolicy(g, policy);
+
+	return ok;
+}
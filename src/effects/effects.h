@@ -0,0 +1,89 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../graph/graphcontext.h"
+#include "../undo_log/undo_log.h"
+
+// Effects
+// a compact binary changelog of the modifications performed by a write query
+// effects are derived from the query's undo log and replicated in place of
+// the query itself, such that replicas and the AOF apply the modifications
+// directly rather than re-executing the query
+//
+// effects buffer layout, values are encoded in native byte order
+//
+// uint8   effects version
+// followed by a sequence of effects, each an uint8 EffectType followed by:
+//
+// EFFECT_CREATE_NODE     uint64 id, labels, attributes
+// EFFECT_CREATE_EDGE     uint64 id, int32 relation, uint64 src, uint64 dest,
+//                        attributes
+// EFFECT_DELETE_NODE     uint64 id
+// EFFECT_DELETE_EDGE     uint64 id, int32 relation, uint64 src, uint64 dest
+// EFFECT_UPDATE_NODE     uint64 id, attributes
+// EFFECT_UPDATE_EDGE     uint64 id, int32 relation, uint64 src, uint64 dest,
+//                        attributes
+// EFFECT_SET_LABELS      uint64 id, labels
+// EFFECT_REMOVE_LABELS   uint64 id, labels
+// EFFECT_ADD_SCHEMA      int32 id, uint8 SchemaType, string name
+// EFFECT_ADD_ATTRIBUTE   uint16 id, string name
+//
+// labels      uint16 label count followed by an int32 per label
+// attributes  uint16 attribute count followed by an uint16 attribute id
+//             and a value per attribute, a NULL value removes the attribute
+// value       uint32 SIType followed by
+//             int64 for booleans and integers, double for doubles,
+//             string for strings, uint32 length followed by each element
+//             for arrays, float latitude and float longitude for points
+// string      uint32 length followed by the string's bytes
+//
+// schema and attribute additions precede all other effects
+// created entities carry the attributes and labels they hold once the query
+// committed, entity ids are deterministic, replicas verify each created
+// entity and schema is assigned the same id it was assigned by the primary
+
+// effects encoding version
+#define EFFECTS_VERSION 1
+
+// effect types
+typedef enum {
+	EFFECT_UNKNOWN = 0,    // unknown effect
+	EFFECT_CREATE_NODE,    // node creation
+	EFFECT_CREATE_EDGE,    // edge creation
+	EFFECT_DELETE_NODE,    // node deletion
+	EFFECT_DELETE_EDGE,    // edge deletion
+	EFFECT_UPDATE_NODE,    // node attributes update
+	EFFECT_UPDATE_EDGE,    // edge attributes update
+	EFFECT_SET_LABELS,     // labels added to node
+	EFFECT_REMOVE_LABELS,  // labels removed from node
+	EFFECT_ADD_SCHEMA,     // schema addition
+	EFFECT_ADD_ATTRIBUTE   // attribute addition
+} EffectType;
+
+// encode the modifications recorded by an undo log as effects
+// caller is expected to hold the graph's write lock
+// returns NULL if the modifications can't be expressed as effects
+// otherwise the effects buffer, an array of 'len' bytes freed by array_free
+unsigned char *Effects_FromUndoLog
+(
+	GraphContext *gc,  // modified graph
+	const UndoLog log, // undo log of the modifying query
+	size_t *len        // [output] length of effects buffer
+);
+
+// apply effects to graph
+// modifications are tracked by the current thread's undo log
+// caller is expected to hold the graph's write lock
+// returns false if the buffer is malformed or diverges from the graph
+// in which case the caller is expected to rollback the undo log
+bool Effects_Apply
+(
+	GraphContext *gc,          // graph to modify
+	const unsigned char *buf,  // effects buffer
+	size_t len                 // length of effects buffer
+);
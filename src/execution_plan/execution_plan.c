@@ -422,13 +422,37 @@ ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 
 	ExecutionPlan_Init(plan);
 
-	Record r = NULL;
-	// Execute the root operation and free the processed Record until the data stream is depleted.
-	while((r = OpBase_Consume(plan->root)) != NULL) ExecutionPlan_ReturnRecord(r->owner, r);
+	// Execute the root operation and free the processed Records until the data stream is depleted.
+	RecordBatch *batch = plan->batch;
+	if(batch == NULL) batch = plan->batch = RecordBatch_New();
+	while(OpBase_ConsumeBatch(plan->root, batch) > 0) RecordBatch_Release(batch);
 
 	return QueryCtx_GetResultSet();
 }
 
+bool ExecutionPlan_ExecuteRows(ExecutionPlan *plan, uint64_t rows) {
+	ASSERT(plan->prepared)
+	int encountered_error = SET_EXCEPTION_HANDLER();
+
+	// Encountered a run-time error - return immediately.
+	if(encountered_error) return true;
+
+	// Initialize the plan's operations on first invocation,
+	// the record pool is created by the plan's initialization.
+	if(plan->record_pool == NULL) ExecutionPlan_Init(plan);
+
+	// Execute the root operation a record at a time until exactly 'rows'
+	// rows been accumulated, a batch might overshoot the requested count.
+	Record r;
+	ResultSet *set = QueryCtx_GetResultSet();
+	while(ResultSet_RowCount(set) < rows) {
+		if((r = OpBase_Consume(plan->root)) == NULL) return true;
+		OpBase_DeleteRecord(r);
+	}
+
+	return false;
+}
+
 //------------------------------------------------------------------------------
 // Execution plan draining
 //------------------------------------------------------------------------------
@@ -448,6 +472,7 @@ bool ExecutionPlan_Drained(ExecutionPlan *plan) {
 
 static void _ExecutionPlan_Drain(OpBase *root) {
 	root->consume = deplete_consume;
+	root->consumeBatch = NULL;
 	for(int i = 0; i < root->childCount; i++) {
 		_ExecutionPlan_Drain(root->children[i]);
 	}
@@ -548,6 +573,13 @@ static ExecutionPlan *_ExecutionPlan_FreeOpTree(OpBase *op) {
 void ExecutionPlan_Free(ExecutionPlan *plan) {
 	if(plan == NULL) return;
 
+	// release records held by an interrupted execution
+	// prior to freeing the record pools they were allocated from
+	if(plan->batch) {
+		RecordBatch_Free(plan->batch);
+		plan->batch = NULL;
+	}
+
 	// Free all ops and ExecutionPlan segments.
 	_ExecutionPlan_FreeOpTree(plan->root);
 
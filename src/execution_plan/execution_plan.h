@@ -21,6 +21,7 @@ struct ExecutionPlan {
 	QueryGraph *query_graph;            // QueryGraph representing all graph entities in this segment.
 	QueryGraph **connected_components;  // Array of all connected components in this segment.
 	ObjectPool *record_pool;
+	RecordBatch *batch;                 // Batch of records consumed from root during execution.
 	bool prepared;                      // Indicates if the execution plan is ready for execute.
 };
 
@@ -58,6 +59,11 @@ void ExecutionPlan_Init(ExecutionPlan *plan);
 /* Executes plan */
 ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan);
 
+/* Executes plan until its result set holds exactly 'rows' rows,
+ * subsequent calls resume execution where the previous call stopped.
+ * Returns true once the plan is depleted or a run-time error was encountered. */
+bool ExecutionPlan_ExecuteRows(ExecutionPlan *plan, uint64_t rows);
+
 /* Checks if execution plan been drained */
 bool ExecutionPlan_Drained(ExecutionPlan *plan);
 
@@ -14,6 +14,45 @@
 #include "../optimizations/optimizations.h"
 #include "../../ast/ast_build_filter_tree.h"
 
+// returns true if connected component 'cc' should be resolved
+// by a single leapfrog join rather than by a chain of traversals
+// the component must be cyclic and span at least three nodes
+// in addition, the join only binds nodes, as such:
+// 1. all edges must be single hop edges which aren't referenced
+// 2. all nodes must be referenced or highly connected, such that a chain
+//    of traversals would have bound each one of them as well
+static bool _LeapfrogJoinApplicable
+(
+	const QueryGraph *cc
+) {
+	AST *ast = QueryCtx_GetAST();
+	uint node_count = QueryGraph_NodeCount(cc);
+	uint edge_count = QueryGraph_EdgeCount(cc);
+
+	// a connected graph is cyclic if it has at least as many edges as nodes
+	if(node_count < 3 || edge_count < node_count) return false;
+
+	for(uint i = 0; i < edge_count; i++) {
+		QGEdge *e = cc->edges[i];
+		if(!QGEdge_SingleHop(e)        ||
+		   QGEdge_IsShortestPath(e)    ||
+		   e->src == e->dest           ||
+		   AST_AliasIsReferenced(ast, e->alias)) {
+			return false;
+		}
+	}
+
+	for(uint i = 0; i < node_count; i++) {
+		QGNode *n = cc->nodes[i];
+		if(!QGNode_HighlyConnected(n) &&
+		   !AST_AliasIsReferenced(ast, n->alias)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 static void _ExecutionPlan_ProcessQueryGraph
 (
 	ExecutionPlan *plan,
@@ -96,6 +135,20 @@ static void _ExecutionPlan_ProcessQueryGraph
 			}
 		}
 
+		// cyclic patterns are resolved by a single worst-case optimal join
+		// extending the scanned node, rather than by a chain of traversals
+		// materializing every path before closing the cycle
+		if(_LeapfrogJoinApplicable(cc)) {
+			for(uint j = 0; j < expCount; j++) {
+				if(exps[j] != NULL) AlgebraicExpression_Free(exps[j]);
+			}
+			expCount = 0;
+
+			root = NewLeapfrogJoinOp(plan, gc->g, cc, src->alias);
+			ExecutionPlan_AddOp(root, tail);
+			tail = root;
+		}
+
 		// for each expression, build the appropriate traversal operation
 		for(int j = 0; j < expCount; j++) {
 			AlgebraicExpression *exp = exps[j];
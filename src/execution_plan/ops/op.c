@@ -48,6 +48,8 @@ void OpBase_Init
 	op->profile  = NULL;
 	op->consume  = consume;
 	op->toString = toString;
+
+	op->consumeBatch = NULL;
 }
 
 inline Record OpBase_Consume
@@ -57,6 +59,30 @@ inline Record OpBase_Consume
 	return op->consume(op);
 }
 
+uint OpBase_ConsumeBatch
+(
+	OpBase *op,
+	RecordBatch *batch
+) {
+	ASSERT(RecordBatch_Size(batch) == 0);
+
+	// profiled operations are consumed record at a time
+	// such that their statistics are maintained
+	if(op->consumeBatch != NULL && op->stats == NULL) {
+		return op->consumeBatch(op, batch);
+	}
+
+	// records may share values owned by the producing operation which are
+	// only valid until its next consume, persist them as they're buffered
+	Record r;
+	while(!RecordBatch_Full(batch) && (r = OpBase_Consume(op)) != NULL) {
+		Record_PersistScalars(r);
+		RecordBatch_Add(batch, r);
+	}
+
+	return RecordBatch_Size(batch);
+}
+
 // mark alias as being modified by operation
 // returns the ID associated with alias
 int OpBase_Modifies
@@ -205,6 +231,15 @@ void OpBase_UpdateConsume
 	else op->consume = consume;
 }
 
+void OpBase_UpdateConsumeBatch
+(
+	OpBase *op,
+	fpConsumeBatch consumeBatch
+) {
+	ASSERT(op != NULL);
+	op->consumeBatch = consumeBatch;
+}
+
 inline Record OpBase_CreateRecord
 (
 	const OpBase *op
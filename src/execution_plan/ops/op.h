@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../record.h"
+#include "../record_batch.h"
 #include "../../util/arr.h"
 #include "../../redismodule.h"
 #include "../../schema/schema.h"
@@ -54,6 +55,8 @@ typedef enum {
 	OPType_OR_APPLY_MULTIPLEXER,
 	OPType_AND_APPLY_MULTIPLEXER,
 	OPType_OPTIONAL,
+	OPType_GATHER,
+	OPType_LEAPFROG_JOIN,
 } OPType;
 
 typedef enum {
@@ -109,6 +112,7 @@ struct ExecutionPlan;
 typedef void (*fpFree)(struct OpBase *);
 typedef OpResult(*fpInit)(struct OpBase *);
 typedef Record(*fpConsume)(struct OpBase *);
+typedef uint(*fpConsumeBatch)(struct OpBase *, RecordBatch *);
 typedef OpResult(*fpReset)(struct OpBase *);
 typedef void (*fpToString)(const struct OpBase *, sds *);
 typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpBase *);
@@ -126,6 +130,7 @@ struct OpBase {
 	fpReset reset;              // Reset operation state.
 	fpClone clone;              // Operation clone.
 	fpConsume consume;          // Produce next record.
+	fpConsumeBatch consumeBatch;// Produce next batch of records, NULL if not supported.
 	fpConsume profile;          // Profiled version of consume.
 	fpToString toString;        // Operation string representation.
 	const char *name;           // Operation name.
@@ -168,6 +173,16 @@ Record OpBase_Consume
 	OpBase *op
 );
 
+// consume a batch of records from op
+// ops which do not support batch consumption are consumed record at a time
+// 'batch' must be empty, returns number of records in batch,
+// 0 once op is depleted
+uint OpBase_ConsumeBatch
+(
+	OpBase *op,
+	RecordBatch *batch
+);
+
 // profile op
 Record OpBase_Profile
 (
@@ -246,6 +261,13 @@ void OpBase_UpdateConsume
 	fpConsume consume
 );
 
+// update operation batch consume function
+void OpBase_UpdateConsumeBatch
+(
+	OpBase *op,
+	fpConsumeBatch consumeBatch
+);
+
 // creates a new record that will be populated during execution
 Record OpBase_CreateRecord
 (
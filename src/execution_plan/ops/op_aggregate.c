@@ -7,9 +7,13 @@
 #include "op_aggregate.h"
 #include "RG.h"
 #include "op_sort.h"
+#include "../../errors.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
 #include "../../util/rmalloc.h"
+#include "../../util/thpool/pools.h"
+
+#include <pthread.h>
 
 // forward declarations
 static Record AggregateConsume(OpBase *opBase);
@@ -61,18 +65,25 @@ static void _migrate_expressions
 
 	op->key_count       = array_len(op->key_exps);
 	op->aggregate_count = array_len(op->aggregate_exps);
+
+	// determine if partial aggregations can be merged
+	op->mergeable = true;
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		op->mergeable &= AR_EXP_MergeableAggregation(op->aggregate_exps[i]);
+	}
 }
 
 // clone all aggregate expression templates to associate with a new group
 static inline AR_ExpNode **_build_aggregate_exps
 (
-	OpAggregate *op
+	AR_ExpNode **aggregate_exps
 ) {
+	uint aggregate_count = array_len(aggregate_exps);
 	AR_ExpNode **agg_exps =
-		rm_malloc(op->aggregate_count * sizeof(AR_ExpNode *));
+		rm_malloc(aggregate_count * sizeof(AR_ExpNode *));
 
-	for(uint i = 0; i < op->aggregate_count; i++) {
-		agg_exps[i] = AR_EXP_Clone(op->aggregate_exps[i]);
+	for(uint i = 0; i < aggregate_count; i++) {
+		agg_exps[i] = AR_EXP_Clone(aggregate_exps[i]);
 	}
 
 	return agg_exps;
@@ -98,22 +109,26 @@ static inline SIValue *_build_group_key
 
 static Group *_CreateGroup
 (
-	OpAggregate *op,
+	AR_ExpNode **key_exps,
+	AR_ExpNode **aggregate_exps,
 	SIValue *keys
 ) {
+	uint key_count       = array_len(key_exps);
+	uint aggregate_count = array_len(aggregate_exps);
+
 	// create a new group, clone group keys
-	SIValue *group_keys = _build_group_key(keys, op->key_count);
+	SIValue *group_keys = _build_group_key(keys, key_count);
 
 	// get a fresh copy of aggregation functions
-	AR_ExpNode **agg_exps = _build_aggregate_exps(op);
+	AR_ExpNode **agg_exps = _build_aggregate_exps(aggregate_exps);
 
-	return Group_New(group_keys, op->key_count, agg_exps, op->aggregate_count);
+	return Group_New(group_keys, key_count, agg_exps, aggregate_count);
 }
 
 static XXH64_hash_t _ComputeGroupKey
 (
 	SIValue *keys,
-	OpAggregate *op,
+	AR_ExpNode **key_exps,
 	Record r
 ) {
 	// initialize the hash state
@@ -121,8 +136,9 @@ static XXH64_hash_t _ComputeGroupKey
 	XXH_errorcode res = XXH64_reset(&state, 0);
 	ASSERT(res != XXH_ERROR);
 
-	for(uint i = 0; i < op->key_count; i++) {
-		AR_ExpNode *exp = op->key_exps[i];
+	uint key_count = array_len(key_exps);
+	for(uint i = 0; i < key_count; i++) {
+		AR_ExpNode *exp = key_exps[i];
 		// note if AR_EXP_Evaluate throws a runtime exception we will leak
 		keys[i] = AR_EXP_Evaluate(exp, r);
 		// update the hash state with the current value.
@@ -137,25 +153,28 @@ static XXH64_hash_t _ComputeGroupKey
 // creates group if it doesn't exists
 static Group *_GetGroup
 (
-	OpAggregate *op,
-	Record r
+	dict *groups,                 // groups table
+	AR_ExpNode **key_exps,        // group key expressions
+	AR_ExpNode **aggregate_exps,  // aggregate expressions templates
+	Record r                      // record to get group for
 ) {
 	// construct group key
 	// evaluate non-aggregated fields
 
-	SIValue keys[op->key_count];
-	XXH64_hash_t hash = _ComputeGroupKey(keys, op, r);
+	uint key_count = array_len(key_exps);
+	SIValue keys[key_count];
+	XXH64_hash_t hash = _ComputeGroupKey(keys, key_exps, r);
 
 	// lookup group by hashed key
 	Group *g;
 	dictEntry *existing;
-	dictEntry *entry = HashTableAddRaw(op->groups, (void *)hash, &existing);
+	dictEntry *entry = HashTableAddRaw(groups, (void *)hash, &existing);
 	if(entry == NULL) {
 		// group exists
 		ASSERT(existing != NULL);
 
 		// free computed keys
-		for(uint i = 0; i < op->key_count; i++) {
+		for(uint i = 0; i < key_count; i++) {
 			SIValue_Free(keys[i]);
 		}
 
@@ -163,31 +182,371 @@ static Group *_GetGroup
 	} else {
 		// entry missing
 		// group does not exists, create it
-		g = _CreateGroup(op, keys);
-		HashTableSetVal(op->groups, entry, g);
+		g = _CreateGroup(key_exps, aggregate_exps, keys);
+		HashTableSetVal(groups, entry, g);
 	}
 
 	return g;
 }
 
-static void _aggregateRecord
+// aggregate record into its group
+static inline void _aggregate
 (
-	OpAggregate *op,
-	Record r
+	dict *groups,                 // groups table
+	AR_ExpNode **key_exps,        // group key expressions
+	AR_ExpNode **aggregate_exps,  // aggregate expressions templates
+	Record r                      // record to aggregate
 ) {
 	// get group
-	Group *g = _GetGroup(op, r);
+	Group *g = _GetGroup(groups, key_exps, aggregate_exps, r);
 	ASSERT(g != NULL);
 
 	// aggregate group exps
-	for(uint i = 0; i < op->aggregate_count; i++) {
+	for(uint i = 0; i < g->func_count; i++) {
 		AR_ExpNode *exp = g->agg[i];
 		AR_EXP_Aggregate(exp, r);
 	}
+}
 
+static void _aggregateRecord
+(
+	OpAggregate *op,
+	Record r
+) {
+	_aggregate(op->groups, op->key_exps, op->aggregate_exps, r);
 	OpBase_DeleteRecord(r);
 }
 
+//------------------------------------------------------------------------------
+// parallel aggregation
+//------------------------------------------------------------------------------
+
+// a partial group table populated by a single worker at a time
+typedef struct {
+	dict *groups;                 // partial groups
+	AR_ExpNode **key_exps;        // private copy of key expressions
+	AR_ExpNode **aggregate_exps;  // private copy of aggregate expressions
+} AggregatePartial;
+
+// state shared between the aggregate operation and its workers
+typedef struct AggregatePool {
+	QueryCtx *query_ctx;          // query context of the executing query
+	AggregatePartial *partials;   // partial group tables
+	AggregatePartial **idle;      // partial tables not in use
+	RecordBatch **batches;        // all batches
+	RecordBatch **free;           // batches ready to be filled
+	RecordBatch **processed;      // aggregated batches pending release
+	uint in_flight;               // number of batches handed to workers
+	char *error;                  // first error encountered by workers
+	pthread_mutex_t lock;         // protects pool state
+	pthread_cond_t cond;          // signaled when a batch is processed
+} AggregatePool;
+
+// worker task
+typedef struct {
+	AggregatePool *pool;  // shared state
+	RecordBatch *batch;   // batch to aggregate
+} AggregateTask;
+
+// aggregate a batch into one of the idle partial tables
+static void _AggregateBatchTask
+(
+	void *arg
+) {
+	AggregateTask *task = (AggregateTask *)arg;
+	AggregatePool *pool = task->pool;
+	RecordBatch *batch  = task->batch;
+	rm_free(task);
+
+	// expressions are evaluated within the query's context
+	QueryCtx_SetTLS(pool->query_ctx);
+
+	// there are at least as many partials as batches in flight
+	pthread_mutex_lock(&pool->lock);
+	ASSERT(array_len(pool->idle) > 0);
+	AggregatePartial *partial = array_pop(pool->idle);
+	bool cancelled = (pool->error != NULL);
+	pthread_mutex_unlock(&pool->lock);
+
+	// skip aggregation once an error was encountered
+	if(!cancelled) {
+		// capture run-time errors raised by expressions
+		if(SET_EXCEPTION_HANDLER() == 0) {
+			uint n = RecordBatch_Size(batch);
+			for(uint i = 0; i < n; i++) {
+				_aggregate(partial->groups, partial->key_exps,
+						partial->aggregate_exps, RecordBatch_Get(batch, i));
+			}
+		}
+	}
+
+	// errors are allocated by vasprintf
+	char *error = NULL;
+	if(ErrorCtx_EncounteredError()) {
+		ErrorCtx *err_ctx = ErrorCtx_Get();
+		error = err_ctx->error;
+		err_ctx->error = NULL;
+	}
+
+	ErrorCtx_Clear();
+	QueryCtx_RemoveFromTLS();
+
+	// hand batch back for its records to be released
+	pthread_mutex_lock(&pool->lock);
+
+	if(error != NULL) {
+		if(pool->error == NULL) pool->error = error;
+		else free(error);
+	}
+
+	array_append(pool->idle, partial);
+	array_append(pool->processed, batch);
+	pool->in_flight--;
+
+	pthread_cond_broadcast(&pool->cond);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+// returns true if aggregation can be performed in parallel
+static bool _ParallelAggregation
+(
+	OpAggregate *op
+) {
+	// profiled operations report their own record counts
+	if(!op->mergeable || op->op.stats != NULL) return false;
+
+	// parallelism requires at least two workers
+	if(ThreadPools_WorkersCount() < 2) return false;
+
+	// write queries might modify the graph while records are aggregated
+	AST *ast = QueryCtx_GetAST();
+	return (ast != NULL && AST_ReadOnly(ast->root));
+}
+
+static AggregatePool *_AggregatePool_New
+(
+	OpAggregate *op
+) {
+	uint worker_count = ThreadPools_WorkersCount();
+	AggregatePool *pool = rm_calloc(1, sizeof(AggregatePool));
+
+	pool->query_ctx = QueryCtx_GetQueryCtx();
+	pool->partials  = array_new(AggregatePartial, worker_count);
+	pool->idle      = array_new(AggregatePartial *, worker_count);
+	pool->batches   = array_new(RecordBatch *, worker_count + 1);
+	pool->free      = array_new(RecordBatch *, worker_count + 1);
+	pool->processed = array_new(RecordBatch *, worker_count + 1);
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->cond, NULL);
+
+	for(uint i = 0; i < worker_count; i++) {
+		AggregatePartial partial;
+
+		partial.groups         = HashTableCreate(&dt);
+		partial.key_exps       = array_new(AR_ExpNode *, op->key_count);
+		partial.aggregate_exps = array_new(AR_ExpNode *, op->aggregate_count);
+
+		for(uint j = 0; j < op->key_count; j++) {
+			array_append(partial.key_exps, AR_EXP_Clone(op->key_exps[j]));
+		}
+		for(uint j = 0; j < op->aggregate_count; j++) {
+			array_append(partial.aggregate_exps,
+					AR_EXP_Clone(op->aggregate_exps[j]));
+		}
+
+		array_append(pool->partials, partial);
+	}
+
+	// partials array is fully populated, safe to reference its elements
+	for(uint i = 0; i < worker_count; i++) {
+		array_append(pool->idle, pool->partials + i);
+	}
+
+	return pool;
+}
+
+// release records of aggregated batches, making batches available for reuse
+// expects pool's lock to be held
+static void _AggregatePool_ReleaseProcessed
+(
+	AggregatePool *pool
+) {
+	while(array_len(pool->processed) > 0) {
+		RecordBatch *batch = array_pop(pool->processed);
+		RecordBatch_Release(batch);
+		array_append(pool->free, batch);
+	}
+}
+
+// wait for all batches in flight to be aggregated
+static void _AggregatePool_Wait
+(
+	AggregatePool *pool
+) {
+	pthread_mutex_lock(&pool->lock);
+	while(pool->in_flight > 0) pthread_cond_wait(&pool->cond, &pool->lock);
+	_AggregatePool_ReleaseProcessed(pool);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+// get an empty batch, waits for workers if all batches are in flight
+static RecordBatch *_AggregatePool_AcquireBatch
+(
+	AggregatePool *pool
+) {
+	RecordBatch *batch = NULL;
+	uint max_batches = array_len(pool->partials) + 1;
+
+	pthread_mutex_lock(&pool->lock);
+
+	while(true) {
+		_AggregatePool_ReleaseProcessed(pool);
+
+		if(array_len(pool->free) > 0) {
+			batch = array_pop(pool->free);
+			break;
+		}
+
+		// a batch is filled while the rest are aggregated
+		if(array_len(pool->batches) < max_batches) {
+			batch = RecordBatch_New();
+			array_append(pool->batches, batch);
+			break;
+		}
+
+		pthread_cond_wait(&pool->cond, &pool->lock);
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+
+	return batch;
+}
+
+// hand batch over to a worker
+static void _AggregatePool_Submit
+(
+	AggregatePool *pool,
+	RecordBatch *batch
+) {
+	AggregateTask *task = rm_malloc(sizeof(AggregateTask));
+	task->pool  = pool;
+	task->batch = batch;
+
+	pthread_mutex_lock(&pool->lock);
+	pool->in_flight++;
+	pthread_mutex_unlock(&pool->lock);
+
+	int res = ThreadPools_AddWorkWorker(_AggregateBatchTask, task);
+	ASSERT(res == 0);
+	UNUSED(res);
+}
+
+static void _AggregatePool_Free
+(
+	AggregatePool *pool
+) {
+	// workers must finish before the graph's lock is released
+	_AggregatePool_Wait(pool);
+
+	uint n = array_len(pool->partials);
+	for(uint i = 0; i < n; i++) {
+		AggregatePartial *partial = pool->partials + i;
+		HashTableRelease(partial->groups);
+		for(uint j = 0; j < array_len(partial->key_exps); j++) {
+			AR_EXP_Free(partial->key_exps[j]);
+		}
+		for(uint j = 0; j < array_len(partial->aggregate_exps); j++) {
+			AR_EXP_Free(partial->aggregate_exps[j]);
+		}
+		array_free(partial->key_exps);
+		array_free(partial->aggregate_exps);
+	}
+
+	// a batch interrupted while being filled still holds its records
+	n = array_len(pool->batches);
+	for(uint i = 0; i < n; i++) RecordBatch_Free(pool->batches[i]);
+
+	// errors are allocated by vasprintf
+	if(pool->error != NULL) free(pool->error);
+
+	array_free(pool->partials);
+	array_free(pool->idle);
+	array_free(pool->batches);
+	array_free(pool->free);
+	array_free(pool->processed);
+	pthread_cond_destroy(&pool->cond);
+	pthread_mutex_destroy(&pool->lock);
+	rm_free(pool);
+}
+
+// merge partial groups into the operation's groups
+static void _AggregatePool_Merge
+(
+	OpAggregate *op
+) {
+	AggregatePool *pool = op->pool;
+
+	uint n = array_len(pool->partials);
+	for(uint i = 0; i < n; i++) {
+		dict *groups = pool->partials[i].groups;
+		dictEntry *entry;
+		dictIterator *it = HashTableGetIterator(groups);
+
+		while((entry = HashTableNext(it)) != NULL) {
+			Group *g = HashTableGetVal(entry);
+
+			dictEntry *existing;
+			dictEntry *dest = HashTableAddRaw(op->groups,
+					HashTableGetKey(entry), &existing);
+
+			if(dest != NULL) {
+				// group is missing, migrate it
+				HashTableSetVal(op->groups, dest, g);
+				HashTableSetVal(groups, entry, NULL);
+			} else {
+				Group_Merge(HashTableGetVal(existing), g);
+			}
+		}
+
+		HashTableReleaseIterator(it);
+	}
+}
+
+// aggregate child's remaining records in parallel
+static void _AggregateParallel
+(
+	OpAggregate *op
+) {
+	ASSERT(op->pool == NULL);
+
+	OpBase *child = op->op.children[0];
+	AggregatePool *pool = op->pool = _AggregatePool_New(op);
+
+	while(__atomic_load_n(&pool->error, __ATOMIC_ACQUIRE) == NULL) {
+		RecordBatch *batch = _AggregatePool_AcquireBatch(pool);
+		if(OpBase_ConsumeBatch(child, batch) == 0) {
+			// child depleted
+			pthread_mutex_lock(&pool->lock);
+			array_append(pool->free, batch);
+			pthread_mutex_unlock(&pool->lock);
+			break;
+		}
+
+		_AggregatePool_Submit(pool, batch);
+	}
+
+	_AggregatePool_Wait(pool);
+
+	// re-raise worker's error on the calling thread
+	if(pool->error != NULL) {
+		ErrorCtx_RaiseRuntimeException("%s", pool->error);
+		return;
+	}
+
+	_AggregatePool_Merge(op);
+}
+
 // returns a record populated with group data
 static Record _handoff
 (
@@ -231,6 +590,8 @@ OpBase *NewAggregateOp
 
 	op->groups               = HashTableCreate(&dt);
 	op->group_iter           = NULL;
+	op->batch                = NULL;
+	op->pool                 = NULL;
 
 	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", NULL,
 			AggregateConsume, AggregateReset, NULL, AggregateClone,
@@ -281,9 +642,26 @@ static Record AggregateConsume
 		_aggregateRecord(op, r);
 	} else {
 		OpBase *child = op->op.children[0];
+		if(op->batch == NULL) op->batch = RecordBatch_New();
+
 		// eager consumption!
-		while((r = OpBase_Consume(child))) {
-			_aggregateRecord(op, r);
+		// large inputs are aggregated in parallel once a number of full
+		// batches were aggregated serially
+		uint n;
+		uint full_batches = 0;
+		bool parallel = _ParallelAggregation(op);
+		while((n = OpBase_ConsumeBatch(child, op->batch)) > 0) {
+			bool full = RecordBatch_Full(op->batch);
+			for(uint i = 0; i < n; i++) {
+				_aggregateRecord(op, RecordBatch_Take(op->batch, i));
+			}
+			RecordBatch_Clear(op->batch);
+
+			if(parallel && full &&
+			   ++full_batches == AGGREGATE_PARALLEL_THRESHOLD) {
+				_AggregateParallel(op);
+				break;
+			}
 		}
 	}
 
@@ -309,7 +687,7 @@ static Record AggregateConsume
 		r = OpBase_CreateRecord(child);
 
 		// get group
-		_GetGroup(op, r);
+		_GetGroup(op->groups, op->key_exps, op->aggregate_exps, r);
 
 		// free record
 		OpBase_DeleteRecord(r);
@@ -332,6 +710,11 @@ static OpResult AggregateReset
 		op->group_iter = NULL;
 	}
 
+	if(op->pool != NULL) {
+		_AggregatePool_Free(op->pool);
+		op->pool = NULL;
+	}
+
 	// re-create hashtable
 	unsigned long elem_count = HashTableElemCount(op->groups);
 	HashTableRelease(op->groups);
@@ -382,6 +765,11 @@ static void AggregateFree
 		op->group_iter = NULL;
 	}
 
+	if(op->pool) {
+		_AggregatePool_Free(op->pool);
+		op->pool = NULL;
+	}
+
 	if(op->key_exps) {
 		for(uint i = 0; i < op->key_count; i++) {
 			AR_EXP_Free(op->key_exps[i]);
@@ -407,5 +795,10 @@ static void AggregateFree
 		array_free(op->record_offsets);
 		op->record_offsets = NULL;
 	}
+
+	if(op->batch) {
+		RecordBatch_Free(op->batch);
+		op->batch = NULL;
+	}
 }
 
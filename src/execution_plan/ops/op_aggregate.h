@@ -12,6 +12,21 @@
 #include "../../grouping/group.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+// number of full batches aggregated serially before switching to
+// parallel aggregation
+#define AGGREGATE_PARALLEL_THRESHOLD 8
+
+struct AggregatePool;
+
+// Aggregate
+// groups records by the values of key expressions, aggregating each group
+//
+// large inputs of read-only queries are aggregated in parallel,
+// batches consumed from the child are handed to worker threads, each
+// aggregating into its own partial group table
+// once the child is depleted partial groups are merged
+// parallel aggregation requires every aggregation function to support
+// merging partial aggregations, e.g. count(DISTINCT x) can't be merged
 typedef struct {
 	OpBase op;
 	uint *record_offsets;         // record IDs for key and aggregate exps
@@ -19,8 +34,11 @@ typedef struct {
 	AR_ExpNode **aggregate_exps;  // array of expressions that aggregate data for each key
 	dict *groups;                 // map of all groups built by this operation
 	dictIterator *group_iter;     // iterator for walking all groups
+	RecordBatch *batch;           // batch of records consumed from child
 	uint key_count;               // number of key expressions
 	uint aggregate_count;         // number of aggregating expressions
+	bool mergeable;               // aggregations support merging partial groups
+	struct AggregatePool *pool;   // parallel aggregation state
 } OpAggregate;
 
 OpBase *NewAggregateOp
@@ -12,6 +12,7 @@
 static OpResult AllNodeScanInit(OpBase *opBase);
 static Record AllNodeScanConsume(OpBase *opBase);
 static Record AllNodeScanConsumeFromChild(OpBase *opBase);
+static uint AllNodeScanConsumeBatch(OpBase *opBase, RecordBatch *batch);
 static OpResult AllNodeScanReset(OpBase *opBase);
 static OpBase *AllNodeScanClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void AllNodeScanFree(OpBase *opBase);
@@ -36,8 +37,12 @@ OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias) {
 
 static OpResult AllNodeScanInit(OpBase *opBase) {
 	AllNodeScan *op = (AllNodeScan *)opBase;
-	if(opBase->childCount > 0) OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
-	else op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+	if(opBase->childCount > 0) {
+		OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
+	} else {
+		op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+		OpBase_UpdateConsumeBatch(opBase, AllNodeScanConsumeBatch);
+	}
 	return OP_OK;
 }
 
@@ -89,6 +94,32 @@ static Record AllNodeScanConsume(OpBase *opBase) {
 	return r;
 }
 
+static uint AllNodeScanConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	AllNodeScan *op = (AllNodeScan *)opBase;
+	size_t item_size = DataBlockIterator_ItemSize(op->iter);
+
+	// consume runs of consecutive nodes, skipping deleted nodes in bulk
+	while(!RecordBatch_Full(batch)) {
+		NodeID id;
+		void *item;
+		uint64_t len = DataBlockIterator_NextRun(op->iter,
+				RECORD_BATCH_CAP - batch->count, &id, &item);
+		if(len == 0) break;
+
+		for(uint64_t i = 0; i < len; i++) {
+			Node n = GE_NEW_NODE();
+			n.id = id + i;
+			n.attributes = (AttributeSet *)((unsigned char *)item + i * item_size);
+
+			Record r = OpBase_CreateRecord(opBase);
+			Record_AddNode(r, op->nodeRecIdx, n);
+			RecordBatch_Add(batch, r);
+		}
+	}
+
+	return RecordBatch_Size(batch);
+}
+
 static OpResult AllNodeScanReset(OpBase *op) {
 	AllNodeScan *allNodeScan = (AllNodeScan *)op;
 	if(allNodeScan->iter) DataBlockIterator_Reset(allNodeScan->iter);
@@ -8,13 +8,25 @@
 #include "RG.h"
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
+#include "../../util/arr.h"
+#include "../../arithmetic/algebraic_expression/utils.h"
 
 // default number of records to accumulate before traversing
 #define BATCH_SIZE 16
 
+// the number of records accumulated doubles each time a batch fills up
+// up to MAX_BATCH_SIZE records
+#define MAX_BATCH_SIZE 1024
+
+// batches of at most ROW_TRAVERSE_THRESHOLD records are traversed by
+// iterating matrix rows directly, rather than building a filter matrix
+// and evaluating the expression via matrix multiplication
+#define ROW_TRAVERSE_THRESHOLD 8
+
 /* Forward declarations. */
 static OpResult CondTraverseInit(OpBase *opBase);
 static Record CondTraverseConsume(OpBase *opBase);
+static uint CondTraverseConsumeBatch(OpBase *opBase, RecordBatch *batch);
 static OpResult CondTraverseReset(OpBase *opBase);
 static OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void CondTraverseFree(OpBase *opBase);
@@ -39,6 +51,179 @@ static void _populate_filter_matrix(OpCondTraverse *op) {
 	}
 }
 
+static int _NodeID_cmp
+(
+	const void *a,
+	const void *b
+) {
+	NodeID x = *(const NodeID *)a;
+	NodeID y = *(const NodeID *)b;
+	return (x > y) - (x < y);
+}
+
+// sorts and removes duplicates from 'ids'
+static void _sort_unique
+(
+	NodeID *ids
+) {
+	uint n = array_len(ids);
+	if(n < 2) return;
+
+	qsort(ids, n, sizeof(NodeID), _NodeID_cmp);
+
+	uint j = 1;
+	for(uint i = 1; i < n; i++) {
+		if(ids[j - 1] != ids[i]) ids[j++] = ids[i];
+	}
+	array_hdr(ids)->len = j;
+}
+
+// returns true if 'term' is a multiplication of operands
+// with the filter matrix as its leftmost operand
+static bool _row_traversable_term
+(
+	const AlgebraicExpression *term,
+	RG_Matrix F
+) {
+	if(term->type != AL_OPERATION || term->operation.op != AL_EXP_MUL) {
+		return false;
+	}
+
+	uint child_count = AlgebraicExpression_ChildCount(term);
+	for(uint i = 0; i < child_count; i++) {
+		const AlgebraicExpression *c = CHILD_AT(term, i);
+		if(c->type != AL_OPERAND) return false;
+		if((i == 0) != (c->operand.matrix == F)) return false;
+	}
+
+	return true;
+}
+
+// returns true if the optimized expression can be evaluated row by row
+// that is, it is either a single multiplication term
+// or the sum of multiplication terms e.g. F * A * R + F * A * R'
+static bool _row_traversable
+(
+	const AlgebraicExpression *ae,
+	RG_Matrix F
+) {
+	if(ae->type == AL_OPERATION && ae->operation.op == AL_EXP_ADD) {
+		uint child_count = AlgebraicExpression_ChildCount(ae);
+		for(uint i = 0; i < child_count; i++) {
+			if(!_row_traversable_term(CHILD_AT(ae, i), F)) return false;
+		}
+		return true;
+	}
+
+	return _row_traversable_term(ae, F);
+}
+
+// evaluates a multiplication term for a single source node
+// appending reachable destinations to 'pairs'
+static void _traverse_row
+(
+	OpCondTraverse *op,
+	const AlgebraicExpression *term,
+	uint record_idx,
+	NodeID src
+) {
+	RG_MatrixTupleIter it = {0};
+
+	array_clear(op->frontier);
+	array_append(op->frontier, src);
+
+	// skip the filter matrix
+	uint child_count = AlgebraicExpression_ChildCount(term);
+	for(uint i = 1; i < child_count && array_len(op->frontier) > 0; i++) {
+		const AlgebraicExpression *operand = CHILD_AT(term, i);
+		RG_Matrix m = operand->operand.matrix;
+		if(m == IDENTITY_MATRIX) continue;
+
+		uint n = array_len(op->frontier);
+
+		if(operand->operand.diagonal) {
+			// keep frontier nodes present on the diagonal
+			uint j = 0;
+			for(uint k = 0; k < n; k++) {
+				bool x;
+				NodeID id = op->frontier[k];
+				if(RG_Matrix_extractElement_BOOL(&x, m, id, id) == GrB_SUCCESS) {
+					op->frontier[j++] = id;
+				}
+			}
+			array_hdr(op->frontier)->len = j;
+			continue;
+		}
+
+		// expand frontier by each of its nodes' rows
+		array_clear(op->next_frontier);
+		RG_MatrixTupleIter_attach(&it, m);
+		for(uint k = 0; k < n; k++) {
+			GrB_Index col;
+			RG_MatrixTupleIter_iterate_row(&it, op->frontier[k]);
+			while(RG_MatrixTupleIter_next_BOOL(&it, NULL, &col, NULL) ==
+					GrB_SUCCESS) {
+				array_append(op->next_frontier, col);
+			}
+		}
+		RG_MatrixTupleIter_detach(&it);
+
+		// rows aren't sorted when the matrix holds pending additions
+		_sort_unique(op->next_frontier);
+
+		NodeID *tmp       = op->frontier;
+		op->frontier      = op->next_frontier;
+		op->next_frontier = tmp;
+	}
+
+	uint n = array_len(op->frontier);
+	for(uint k = 0; k < n; k++) {
+		TraversePair pair = {.src = record_idx, .dest = op->frontier[k]};
+		array_append(op->pairs, pair);
+	}
+}
+
+// traverses a small batch by iterating matrix rows
+// producing the same pairs as evaluating F * exp, in the same order
+static void _traverse_rows
+(
+	OpCondTraverse *op
+) {
+	op->row_batch = true;
+	op->pair_idx  = 0;
+	array_clear(op->pairs);
+
+	const AlgebraicExpression *ae = op->ae;
+	bool sum = (ae->type == AL_OPERATION && ae->operation.op == AL_EXP_ADD);
+	uint term_count = sum ? AlgebraicExpression_ChildCount(ae) : 1;
+
+	for(uint i = 0; i < op->record_count; i++) {
+		Node *n = Record_GetNode(op->records[i], op->srcNodeIdx);
+		NodeID src = ENTITY_GET_ID(n);
+
+		uint start = array_len(op->pairs);
+		for(uint j = 0; j < term_count; j++) {
+			_traverse_row(op, sum ? CHILD_AT(ae, j) : ae, i, src);
+		}
+		if(term_count == 1) continue;
+
+		// a destination may be reached by multiple terms
+		array_clear(op->frontier);
+		uint end = array_len(op->pairs);
+		for(uint k = start; k < end; k++) {
+			array_append(op->frontier, op->pairs[k].dest);
+		}
+		_sort_unique(op->frontier);
+
+		array_hdr(op->pairs)->len = start;
+		uint n_dests = array_len(op->frontier);
+		for(uint k = 0; k < n_dests; k++) {
+			TraversePair pair = {.src = i, .dest = op->frontier[k]};
+			array_append(op->pairs, pair);
+		}
+	}
+}
+
 // evaluate algebraic expression:
 // prepends filter matrix as the left most operand
 // perform multiplications
@@ -49,17 +234,28 @@ void _traverse(OpCondTraverse *op) {
 	// if op->F is null, this is the first time we are traversing
 	if(op->F == NULL) {
 		// create both filter and result matrices
+		// sized to accommodate the largest batch
 		size_t required_dim = Graph_RequiredMatrixDim(op->graph);
-		RG_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
-		RG_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
+		RG_Matrix_new(&op->M, GrB_BOOL, op->max_record_cap, required_dim);
+		RG_Matrix_new(&op->F, GrB_BOOL, op->max_record_cap, required_dim);
 
 		// prepend filter matrix to algebraic expression as the leftmost operand
 		AlgebraicExpression_MultiplyToTheLeft(&op->ae, op->F);
 
 		// optimize the expression tree
 		AlgebraicExpression_Optimize(&op->ae);
+
+		op->row_traversable = _row_traversable(op->ae, op->F);
 	}
 
+	// small batches are traversed one row at a time
+	if(op->row_traversable && op->record_count <= ROW_TRAVERSE_THRESHOLD) {
+		_traverse_rows(op);
+		return;
+	}
+
+	op->row_batch = false;
+
 	// populate filter matrix
 	_populate_filter_matrix(op);
 
@@ -69,6 +265,37 @@ void _traverse(OpCondTraverse *op) {
 	RG_MatrixTupleIter_attach(&op->iter, op->M);
 }
 
+// retrieves the next traversed pair
+// returns false once the current batch is depleted
+static inline bool _next_pair
+(
+	OpCondTraverse *op,
+	NodeID *src_id,
+	NodeID *dest_id
+) {
+	if(op->row_batch) {
+		if(op->pair_idx == array_len(op->pairs)) return false;
+		TraversePair pair = op->pairs[op->pair_idx++];
+		*src_id  = pair.src;
+		*dest_id = pair.dest;
+		return true;
+	}
+
+	return (RG_MatrixTupleIter_next_UINT64(&op->iter, src_id, dest_id, NULL)
+			== GrB_SUCCESS);
+}
+
+// doubles the number of records accumulated per batch
+static void _grow_batch
+(
+	OpCondTraverse *op
+) {
+	if(op->record_cap >= op->max_record_cap) return;
+
+	op->record_cap = MIN(op->record_cap * 2, op->max_record_cap);
+	op->records = rm_realloc(op->records, sizeof(Record) * op->record_cap);
+}
+
 OpBase *NewCondTraverseOp
 (
 	const ExecutionPlan *plan,
@@ -77,15 +304,19 @@ OpBase *NewCondTraverseOp
 ) {
 	OpCondTraverse *op = rm_calloc(sizeof(OpCondTraverse), 1);
 
-	op->ae         = ae;
-	op->graph      = g;
-	op->record_cap = BATCH_SIZE;
+	op->ae            = ae;
+	op->graph         = g;
+	op->record_cap    = MAX_BATCH_SIZE;
+	op->pairs         = array_new(TraversePair, 0);
+	op->frontier      = array_new(NodeID, 1);
+	op->next_frontier = array_new(NodeID, 0);
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_CONDITIONAL_TRAVERSE,
 			"Conditional Traverse", CondTraverseInit, CondTraverseConsume,
 			CondTraverseReset, CondTraverseToString, CondTraverseClone,
 			CondTraverseFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, CondTraverseConsumeBatch);
 
 	bool aware = OpBase_Aware((OpBase *)op, AlgebraicExpression_Src(ae),
 			&op->srcNodeIdx);
@@ -111,9 +342,10 @@ static OpResult CondTraverseInit(OpBase *opBase) {
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
 	// Create 'records' with this Init function as 'record_cap'
 	// might be set during optimization time (applyLimit)
-	// If cap greater than BATCH_SIZE is specified,
-	// use BATCH_SIZE as the value.
-	if(op->record_cap > BATCH_SIZE) op->record_cap = BATCH_SIZE;
+	// batches start at BATCH_SIZE records and grow up to
+	// the smaller of the imposed cap and MAX_BATCH_SIZE
+	op->max_record_cap = MIN(op->record_cap, MAX_BATCH_SIZE);
+	op->record_cap     = MIN(op->max_record_cap, BATCH_SIZE);
 	op->records = rm_calloc(op->record_cap, sizeof(Record));
 
 	return OP_OK;
@@ -138,10 +370,8 @@ static Record CondTraverseConsume(OpBase *opBase) {
 	NodeID dest_id = INVALID_ENTITY_ID;
 
 	while(true) {
-		GrB_Info info = RG_MatrixTupleIter_next_UINT64(&op->iter, &src_id, &dest_id, NULL);
-
 		// Managed to get a tuple, break.
-		if(info == GrB_SUCCESS) break;
+		if(_next_pair(op, &src_id, &dest_id)) break;
 
 		/* Run out of tuples, try to get new data.
 		 * Free old records. */
@@ -150,6 +380,9 @@ static Record CondTraverseConsume(OpBase *opBase) {
 			OpBase_DeleteRecord(op->records[i]);
 		}
 
+		// previous batch was full, accumulate more records this time
+		if(op->record_count == op->record_cap) _grow_batch(op);
+
 		// Ask child operations for data.
 		for(op->record_count = 0; op->record_count < op->record_cap; op->record_count++) {
 			Record childRecord = OpBase_Consume(child);
@@ -192,6 +425,18 @@ static Record CondTraverseConsume(OpBase *opBase) {
 	return OpBase_CloneRecord(op->r);
 }
 
+// fills batch with traversal results
+// input records are still accumulated 'record_cap' at a time, such that
+// a limit imposed on the number of records to process is respected
+static uint CondTraverseConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	Record r;
+	while(!RecordBatch_Full(batch) && (r = CondTraverseConsume(opBase)) != NULL) {
+		RecordBatch_Add(batch, r);
+	}
+
+	return RecordBatch_Size(batch);
+}
+
 static OpResult CondTraverseReset(OpBase *ctx) {
 	OpCondTraverse *op = (OpCondTraverse *)ctx;
 
@@ -201,6 +446,15 @@ static OpResult CondTraverseReset(OpBase *ctx) {
 	for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
 	op->record_count = 0;
 
+	// start over with small batches
+	if(op->records != NULL) {
+		op->record_cap = MIN(op->max_record_cap, BATCH_SIZE);
+	}
+
+	op->row_batch = false;
+	op->pair_idx  = 0;
+	array_clear(op->pairs);
+
 	if(op->edge_ctx) EdgeTraverseCtx_Reset(op->edge_ctx);
 
 	GrB_Info info = RG_MatrixTupleIter_detach(&op->iter);
@@ -243,6 +497,21 @@ static void CondTraverseFree(OpBase *ctx) {
 		op->edge_ctx = NULL;
 	}
 
+	if(op->pairs) {
+		array_free(op->pairs);
+		op->pairs = NULL;
+	}
+
+	if(op->frontier) {
+		array_free(op->frontier);
+		op->frontier = NULL;
+	}
+
+	if(op->next_frontier) {
+		array_free(op->next_frontier);
+		op->next_frontier = NULL;
+	}
+
 	if(op->records) {
 		for(uint i = 0; i < op->record_count; i++) {
 			OpBase_DeleteRecord(op->records[i]);
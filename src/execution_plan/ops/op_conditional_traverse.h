@@ -13,6 +13,12 @@
 #include "../../arithmetic/algebraic_expression.h"
 #include "../../../deps/GraphBLAS/Include/GraphBLAS.h"
 
+// a source record and a destination node reached from it
+typedef struct {
+	uint src;           // index of source record
+	NodeID dest;        // destination node ID
+} TraversePair;
+
 /* OP Traverse */
 typedef struct {
 	OpBase op;
@@ -26,8 +32,15 @@ typedef struct {
 	int destNodeIdx;            // Destination node index into record.
 	uint record_count;          // Number of held records.
 	uint record_cap;            // Max number of records to process.
+	uint max_record_cap;        // Upper bound record_cap may grow to.
 	Record *records;            // Array of records.
 	Record r;                   // Currently selected record.
+	bool row_traversable;       // Expression can be evaluated one row at a time.
+	bool row_batch;             // Current batch was traversed row by row.
+	TraversePair *pairs;        // Row by row traversal results.
+	uint pair_idx;              // Next traversal result to emit.
+	NodeID *frontier;           // Nodes reached by a row by row traversal.
+	NodeID *next_frontier;      // Scratch space for expanding frontier.
 } OpCondTraverse;
 
 /* Creates a new Traverse operation */
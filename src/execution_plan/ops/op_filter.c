@@ -8,21 +8,40 @@
 #include "RG.h"
 
 /* Forward declarations. */
+static OpResult FilterInit(OpBase *opBase);
 static Record FilterConsume(OpBase *opBase);
+static uint FilterConsumeBatch(OpBase *opBase, RecordBatch *batch);
 static OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void FilterFree(OpBase *opBase);
 
 OpBase *NewFilterOp(const ExecutionPlan *plan, FT_FilterNode *filterTree) {
 	OpFilter *op = rm_malloc(sizeof(OpFilter));
 	op->filterTree = filterTree;
+	op->program = NULL;
 
 	// Set our Op operations
-	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", NULL, FilterConsume,
+	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", FilterInit, FilterConsume,
 				NULL, NULL, FilterClone, FilterFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, FilterConsumeBatch);
 
 	return (OpBase *)op;
 }
 
+/* Compiles the filter tree, by now optimizations are done modifying it
+ * and query parameters are bound. */
+static OpResult FilterInit(OpBase *opBase) {
+	OpFilter *filter = (OpFilter *)opBase;
+	if(filter->program == NULL && filter->filterTree != NULL) {
+		filter->program = FT_Program_Compile(filter->filterTree);
+	}
+	return OP_OK;
+}
+
+static inline FT_Result _applyFilter(OpFilter *filter, Record r) {
+	if(filter->program) return FT_Program_Apply(filter->program, r);
+	return FilterTree_applyFilters(filter->filterTree, r);
+}
+
 /* FilterConsume next operation
  * returns OP_OK when graph passes filter tree. */
 static Record FilterConsume(OpBase *opBase) {
@@ -35,13 +54,45 @@ static Record FilterConsume(OpBase *opBase) {
 		if(!r) break;
 
 		/* Pass record through filter tree */
-		if(FilterTree_applyFilters(filter->filterTree, r) == FILTER_PASS) break;
+		if(_applyFilter(filter, r) == FILTER_PASS) break;
 		else OpBase_DeleteRecord(r);
 	}
 
 	return r;
 }
 
+static uint FilterConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	OpFilter *filter = (OpFilter *)opBase;
+	OpBase *child = filter->op.children[0];
+
+	// pull batches until at least one record passes or child is depleted
+	while(OpBase_ConsumeBatch(child, batch) > 0) {
+		uint n = RecordBatch_Size(batch);
+
+		/* Pass records through filter tree, releasing filtered records */
+		for(uint i = 0; i < n; i++) {
+			Record r = RecordBatch_Get(batch, i);
+			if(_applyFilter(filter, r) != FILTER_PASS) {
+				OpBase_DeleteRecord(RecordBatch_Take(batch, i));
+			}
+		}
+
+		// compact selection vector
+		uint selected = 0;
+		for(uint i = 0; i < n; i++) {
+			if(RecordBatch_Get(batch, i) != NULL) {
+				batch->sel[selected++] = batch->sel[i];
+			}
+		}
+		batch->size = selected;
+
+		if(selected > 0) return selected;
+		RecordBatch_Clear(batch);
+	}
+
+	return 0;
+}
+
 static inline OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_FILTER);
 	OpFilter *op = (OpFilter *)opBase;
@@ -51,6 +102,10 @@ static inline OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBas
 /* Frees OpFilter*/
 static void FilterFree(OpBase *ctx) {
 	OpFilter *filter = (OpFilter *)ctx;
+	if(filter->program) {
+		FT_Program_Free(filter->program);
+		filter->program = NULL;
+	}
 	if(filter->filterTree) {
 		FilterTree_Free(filter->filterTree);
 		filter->filterTree = NULL;
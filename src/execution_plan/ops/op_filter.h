@@ -9,12 +9,14 @@
 #include "op.h"
 #include "../execution_plan.h"
 #include "../../filter_tree/filter_tree.h"
+#include "../../filter_tree/ft_program.h"
 
 /* Filter
  * filters graph according to where cluase */
 typedef struct {
 	OpBase op;
 	FT_FilterNode *filterTree;
+	FT_Program *program;        // Compiled filter tree, set on init.
 } OpFilter;
 
 /* Creates a new Filter operation */
@@ -0,0 +1,671 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "op_gather.h"
+#include "op_filter.h"
+#include "op_all_node_scan.h"
+#include "op_node_by_label_scan.h"
+#include "../../errors.h"
+#include "../../query_ctx.h"
+#include "../../util/arr.h"
+#include "../../util/thpool/pools.h"
+
+#include <pthread.h>
+
+// a range of node IDs processed by a single thread
+typedef struct {
+	NodeID *ids;  // IDs of nodes passing all filters
+	char *error;  // error encountered while processing morsel
+	bool done;    // morsel processed
+} Morsel;
+
+// state shared between the gather operation and its workers
+typedef struct GatherCtx {
+	Graph *g;                    // scanned graph
+	QueryCtx *query_ctx;         // query context of the executing query
+	rax *mapping;                // record mapping
+	uint nodeRecIdx;             // scanned node record index
+	RG_Matrix L;                 // scanned label matrix, NULL for all nodes scan
+	NodeID min_id;               // first ID in scanned range
+	NodeID max_id;               // last ID in scanned range
+	Morsel *morsels;             // morsels
+	uint64_t morsel_count;       // number of morsels
+	uint64_t next;               // next morsel to process
+	uint64_t consumed;           // morsel consumed by the gather operation
+	uint64_t window;             // max number of morsels claimed ahead
+	uint active;                 // number of running or queued workers
+	bool cancelled;              // stop processing morsels
+	bool failed;                 // a worker encountered an error
+	bool paused;                 // workers stopped until the next consume
+	Record r;                    // record used for filtering by the calling thread
+	pthread_mutex_t lock;        // protects active count and morsels state
+	pthread_cond_t cond;         // signaled when a morsel is done or a worker exits
+} GatherCtx;
+
+// worker task
+typedef struct {
+	GatherCtx *ctx;            // shared state
+	FT_FilterNode **filters;   // worker's private copy of the filters
+	QueryCtx query_ctx;        // worker's private view of the query context
+} GatherTask;
+
+// forward declarations
+static OpResult GatherInit(OpBase *opBase);
+static Record GatherConsume(OpBase *opBase);
+static uint GatherConsumeBatch(OpBase *opBase, RecordBatch *batch);
+static Record GatherConsumeFromChild(OpBase *opBase);
+static uint GatherConsumeBatchFromChild(OpBase *opBase, RecordBatch *batch);
+static OpResult GatherReset(OpBase *opBase);
+static OpBase *GatherClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void GatherFree(OpBase *opBase);
+
+OpBase *NewGatherOp
+(
+	const ExecutionPlan *plan
+) {
+	OpGather *op = rm_calloc(1, sizeof(OpGather));
+	op->g = QueryCtx_GetGraph();
+
+	// set our Op operations
+	OpBase_Init((OpBase *)op, OPType_GATHER, "Gather", GatherInit,
+			GatherConsume, GatherReset, NULL, GatherClone, GatherFree, false,
+			plan);
+
+	OpBase_UpdateConsumeBatch((OpBase *)op, GatherConsumeBatch);
+
+	return (OpBase *)op;
+}
+
+//------------------------------------------------------------------------------
+// morsel processing
+//------------------------------------------------------------------------------
+
+// returns true if node passes all filters
+static inline bool _PassFilters
+(
+	GatherCtx *ctx,
+	FT_FilterNode **filters,
+	Record r,
+	NodeID id
+) {
+	Node n = GE_NEW_NODE();
+	if(!Graph_GetNode(ctx->g, id, &n)) return false;
+
+	Record_AddNode(r, ctx->nodeRecIdx, n);
+
+	// filters are collected top down, apply them bottom up
+	for(int i = array_len(filters) - 1; i >= 0; i--) {
+		if(FilterTree_applyFilters(filters[i], r) != FILTER_PASS) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// collect IDs of nodes within morsel passing all filters
+// IDs are collected directly into the morsel, such that they're released
+// along with the gather context in case a filter raises an error
+static void _ProcessMorsel
+(
+	GatherCtx *ctx,
+	FT_FilterNode **filters,
+	Record r,
+	uint64_t m
+) {
+	NodeID lo = ctx->min_id + m * GATHER_MORSEL_SIZE;
+	NodeID hi = MIN(lo + GATHER_MORSEL_SIZE - 1, ctx->max_id);
+	Morsel *morsel = ctx->morsels + m;
+
+	ASSERT(morsel->ids == NULL);
+	morsel->ids = array_new(NodeID, 64);
+
+	if(ctx->L != NULL) {
+		NodeID id;
+		RG_MatrixTupleIter it = {0};
+		GrB_Info info = RG_MatrixTupleIter_AttachRange(&it, ctx->L, lo, hi);
+		ASSERT(info == GrB_SUCCESS);
+
+		while(RG_MatrixTupleIter_next_BOOL(&it, &id, NULL, NULL) == GrB_SUCCESS) {
+			if(_PassFilters(ctx, filters, r, id)) array_append(morsel->ids, id);
+		}
+
+		RG_MatrixTupleIter_detach(&it);
+	} else {
+		for(NodeID id = lo; id <= hi; id++) {
+			if(_PassFilters(ctx, filters, r, id)) array_append(morsel->ids, id);
+		}
+	}
+}
+
+// claim the next unprocessed morsel
+// morsels are claimed at most 'window' morsels ahead of the consumed morsel
+// such that the scan doesn't run far ahead of its consumer, e.g. under LIMIT
+// workers stop claiming once cancelled
+// returns false if there's no morsel to claim
+static bool _ClaimMorsel
+(
+	GatherCtx *ctx,
+	uint64_t *m,
+	bool worker
+) {
+	bool claimed = false;
+
+	pthread_mutex_lock(&ctx->lock);
+	if(!(worker && ctx->cancelled) &&
+	   ctx->next < ctx->morsel_count &&
+	   ctx->next < ctx->consumed + ctx->window) {
+		*m = ctx->next++;
+		claimed = true;
+	}
+	pthread_mutex_unlock(&ctx->lock);
+
+	return claimed;
+}
+
+// mark morsel as done and wake up the waiting gather operation
+static void _MorselDone
+(
+	GatherCtx *ctx,
+	uint64_t m,
+	char *error
+) {
+	pthread_mutex_lock(&ctx->lock);
+
+	ctx->morsels[m].error = error;
+	__atomic_store_n(&ctx->morsels[m].done, true, __ATOMIC_RELEASE);
+
+	pthread_cond_broadcast(&ctx->cond);
+	pthread_mutex_unlock(&ctx->lock);
+}
+
+static void _GatherWorker
+(
+	void *arg
+) {
+	GatherTask *task        = (GatherTask *)arg;
+	GatherCtx  *ctx         = task->ctx;
+	FT_FilterNode **filters = task->filters;
+
+	// filters are evaluated within the worker's view of the query's context
+	QueryCtx_SetTLS(&task->query_ctx);
+
+	Record r = Record_New(ctx->mapping);
+	volatile uint64_t m = ctx->morsel_count;
+
+	// capture run-time errors raised by filters
+	// worker returns to the pool once no morsel within the window is left
+	// the gather operation re-enqueues workers as it advances
+	if(SET_EXCEPTION_HANDLER() == 0) {
+		uint64_t claimed;
+		while(_ClaimMorsel(ctx, &claimed, true)) {
+			m = claimed;
+			_ProcessMorsel(ctx, filters, r, m);
+			if(ErrorCtx_EncounteredError()) break;
+
+			_MorselDone(ctx, m, NULL);
+		}
+	}
+
+	if(ErrorCtx_EncounteredError()) {
+		// hand error over to the gather operation and stop all workers
+		// the morsel's IDs are freed along with the gather context
+		ErrorCtx *err_ctx = ErrorCtx_Get();
+		char *error = err_ctx->error;
+		err_ctx->error = NULL;
+
+		pthread_mutex_lock(&ctx->lock);
+		ctx->failed    = true;
+		ctx->cancelled = true;
+		pthread_mutex_unlock(&ctx->lock);
+
+		ASSERT(m < ctx->morsel_count);
+		_MorselDone(ctx, m, error);
+	}
+
+	// clean up
+	ErrorCtx_Clear();
+	QueryCtx_RemoveFromTLS();
+
+	Record_Free(r);
+	for(uint i = 0; i < array_len(filters); i++) FilterTree_Free(filters[i]);
+	array_free(filters);
+	rm_free(task);
+
+	// gather ctx might be freed once the last worker exits
+	pthread_mutex_lock(&ctx->lock);
+	ctx->active--;
+	pthread_cond_broadcast(&ctx->cond);
+	pthread_mutex_unlock(&ctx->lock);
+}
+
+//------------------------------------------------------------------------------
+// gather
+//------------------------------------------------------------------------------
+
+// determine the scanned ID range and number of scanned nodes
+// returns false if the scan should not be parallelized
+static bool _ScannedRange
+(
+	OpGather *op,
+	RG_Matrix *L,
+	NodeID *min_id,
+	NodeID *max_id
+) {
+	uint64_t node_count;
+
+	if(op->scan->type == OPType_ALL_NODE_SCAN) {
+		uint64_t n = Graph_UncompactedNodeCount(op->g);
+		if(n == 0) return false;
+
+		*L         = NULL;
+		*min_id    = 0;
+		*max_id    = n - 1;
+		node_count = Graph_NodeCount(op->g);
+	} else {
+		NodeByLabelScan *scan = (NodeByLabelScan *)op->scan;
+		int label_id = scan->n.label_id;
+		if(label_id == GRAPH_UNKNOWN_LABEL) return false;
+
+		// scan's range is restricted to its label matrix dimensions
+		// by the time the scan is initialized
+		UnsignedRange *range = scan->id_range;
+		if(!UnsignedRange_IsValid(range)) return false;
+
+		*L         = Graph_GetLabelMatrix(op->g, label_id);
+		*min_id    = range->include_min ? range->min : range->min + 1;
+		*max_id    = range->include_max ? range->max : range->max - 1;
+		node_count = Graph_LabeledNodeCount(op->g, label_id);
+		if(*min_id > *max_id) return false;
+	}
+
+	return node_count >= GATHER_MIN_NODE_COUNT;
+}
+
+// workers share the query's parameters, AST and graph, which are read only
+// during the scan, members mutated throughout execution are left out
+static void _WorkerQueryCtx
+(
+	QueryCtx *worker_ctx,
+	const QueryCtx *query_ctx
+) {
+	memset(worker_ctx, 0, sizeof(QueryCtx));
+	worker_ctx->query_data = query_ctx->query_data;
+	worker_ctx->gc         = query_ctx->gc;
+	worker_ctx->global_exec_ctx.command_name =
+		query_ctx->global_exec_ctx.command_name;
+}
+
+// enqueue workers for the unclaimed morsels within the window
+// the calling thread processes morsels as well
+static void _GatherSpawnWorkers
+(
+	OpGather *op
+) {
+	GatherCtx *ctx = op->ctx;
+	uint max_workers = ThreadPools_WorkersCount();
+
+	pthread_mutex_lock(&ctx->lock);
+
+	uint64_t reach = MIN(ctx->morsel_count, ctx->consumed + ctx->window);
+	uint64_t unclaimed = (reach > ctx->next) ? reach - ctx->next : 0;
+
+	// leave a morsel to the calling thread
+	uint workers = 0;
+	if(!ctx->cancelled && ctx->active < max_workers && unclaimed > 1) {
+		workers = MIN(max_workers - ctx->active, unclaimed - 1);
+		ctx->active += workers;
+	}
+
+	pthread_mutex_unlock(&ctx->lock);
+
+	for(uint i = 0; i < workers; i++) {
+		// each worker evaluates its own copy of the filters
+		// as expressions may be modified during evaluation
+		GatherTask *task = rm_malloc(sizeof(GatherTask));
+		uint n = array_len(op->filters);
+		task->ctx = ctx;
+		task->filters = array_new(FT_FilterNode *, n);
+		for(uint j = 0; j < n; j++) {
+			array_append(task->filters, FilterTree_Clone(op->filters[j]));
+		}
+		_WorkerQueryCtx(&task->query_ctx, ctx->query_ctx);
+
+		if(ThreadPools_AddWorkWorker(_GatherWorker, task) != 0) {
+			// release the reservation of the workers which weren't enqueued
+			pthread_mutex_lock(&ctx->lock);
+			ctx->active -= workers - i;
+			pthread_cond_broadcast(&ctx->cond);
+			pthread_mutex_unlock(&ctx->lock);
+
+			for(uint j = 0; j < n; j++) FilterTree_Free(task->filters[j]);
+			array_free(task->filters);
+			rm_free(task);
+			break;
+		}
+	}
+}
+
+// start a parallel scan
+// returns false if the scan should be performed by the child operation
+static bool _GatherStart
+(
+	OpGather *op
+) {
+	ASSERT(op->ctx == NULL);
+
+	RG_Matrix L;
+	NodeID min_id;
+	NodeID max_id;
+	if(!_ScannedRange(op, &L, &min_id, &max_id)) return false;
+
+	GatherCtx *ctx = rm_calloc(1, sizeof(GatherCtx));
+
+	ctx->g            = op->g;
+	ctx->L            = L;
+	ctx->min_id       = min_id;
+	ctx->max_id       = max_id;
+	ctx->mapping      = ExecutionPlan_GetMappings(op->op.plan);
+	ctx->nodeRecIdx   = op->nodeRecIdx;
+	ctx->query_ctx    = QueryCtx_GetQueryCtx();
+	ctx->morsel_count = (max_id - min_id) / GATHER_MORSEL_SIZE + 1;
+	ctx->morsels      = rm_calloc(ctx->morsel_count, sizeof(Morsel));
+	ctx->window       = 2 * ThreadPools_WorkersCount();
+	ctx->r            = Record_New(ctx->mapping);
+
+	pthread_mutex_init(&ctx->lock, NULL);
+	pthread_cond_init(&ctx->cond, NULL);
+
+	op->ctx    = ctx;
+	op->morsel = 0;
+	op->offset = 0;
+
+	_GatherSpawnWorkers(op);
+
+	return true;
+}
+
+// stop processing morsels and wait for all workers to exit
+static void _GatherCancel
+(
+	GatherCtx *ctx
+) {
+	pthread_mutex_lock(&ctx->lock);
+
+	// workers stop claiming morsels
+	ctx->cancelled = true;
+
+	while(ctx->active > 0) pthread_cond_wait(&ctx->cond, &ctx->lock);
+	pthread_mutex_unlock(&ctx->lock);
+}
+
+// cancel parallel scan, waiting for all workers to exit
+static void _GatherStop
+(
+	OpGather *op
+) {
+	GatherCtx *ctx = op->ctx;
+	if(ctx == NULL) return;
+
+	_GatherCancel(ctx);
+
+	for(uint64_t i = 0; i < ctx->morsel_count; i++) {
+		Morsel *m = ctx->morsels + i;
+		if(m->ids != NULL) array_free(m->ids);
+		// errors are allocated by vasprintf
+		if(m->error != NULL) free(m->error);
+	}
+
+	Record_Free(ctx->r);
+	pthread_cond_destroy(&ctx->cond);
+	pthread_mutex_destroy(&ctx->lock);
+	rm_free(ctx->morsels);
+	rm_free(ctx);
+
+	op->ctx = NULL;
+}
+
+// wait for morsel to be processed
+// helps processing outstanding morsels while waiting
+static Morsel *_WaitForMorsel
+(
+	OpGather *op,
+	uint64_t m
+) {
+	GatherCtx *ctx = op->ctx;
+	Morsel *morsel = ctx->morsels + m;
+
+	while(!__atomic_load_n(&morsel->done, __ATOMIC_ACQUIRE)) {
+		uint64_t i;
+		if(_ClaimMorsel(ctx, &i, false)) {
+			// errors raised on the calling thread propagate as usual
+			_ProcessMorsel(ctx, op->filters, ctx->r, i);
+			_MorselDone(ctx, i, NULL);
+			continue;
+		}
+
+		// all morsels within reach are claimed, wait for workers
+		pthread_mutex_lock(&ctx->lock);
+		while(!morsel->done) pthread_cond_wait(&ctx->cond, &ctx->lock);
+		pthread_mutex_unlock(&ctx->lock);
+	}
+
+	// re-raise worker's error on the calling thread
+	if(morsel->error != NULL) {
+		ErrorCtx_RaiseRuntimeException("%s", morsel->error);
+	}
+
+	return morsel;
+}
+
+// get the next node ID passing all filters
+// returns false once all morsels are depleted
+static bool _GatherNext
+(
+	OpGather *op,
+	NodeID *id
+) {
+	GatherCtx *ctx = op->ctx;
+
+	// resume paused scan, a failed scan is left to the calling thread
+	// which re-raises the error once it reaches the failed morsel
+	if(ctx->paused) {
+		ctx->paused = false;
+		if(!ctx->failed) {
+			ctx->cancelled = false;
+			_GatherSpawnWorkers(op);
+		}
+	}
+
+	while(op->morsel < ctx->morsel_count) {
+		Morsel *m = _WaitForMorsel(op, op->morsel);
+		if(op->offset < array_len(m->ids)) {
+			*id = m->ids[op->offset++];
+			return true;
+		}
+
+		// morsel depleted, move to the next one
+		array_free(m->ids);
+		m->ids = NULL;
+		op->morsel++;
+		op->offset = 0;
+
+		// let workers claim further morsels
+		pthread_mutex_lock(&ctx->lock);
+		ctx->consumed = op->morsel;
+		pthread_mutex_unlock(&ctx->lock);
+
+		// re-enqueue workers which returned to the pool on a full window
+		_GatherSpawnWorkers(op);
+	}
+
+	return false;
+}
+
+static inline Record _CreateRecord
+(
+	OpGather *op,
+	NodeID id
+) {
+	Node n = GE_NEW_NODE();
+	Graph_GetNode(op->g, id, &n);
+
+	Record r = OpBase_CreateRecord((OpBase *)op);
+	Record_AddNode(r, op->nodeRecIdx, n);
+
+	return r;
+}
+
+// returns true if the scan is performed in parallel
+// the decision is made on the first consume, once the scan is initialized
+static inline bool _GatherParallel
+(
+	OpGather *op
+) {
+	if(op->ctx != NULL) return true;
+	if(op->serial) return false;
+
+	op->serial = !_GatherStart(op);
+	return !op->serial;
+}
+
+// pause a parallel scan, waiting for all workers to exit
+void Gather_Pause
+(
+	OpBase *opBase
+) {
+	ASSERT(opBase->type == OPType_GATHER);
+
+	OpGather *op = (OpGather *)opBase;
+	GatherCtx *ctx = op->ctx;
+	if(ctx == NULL || ctx->paused) return;
+
+	_GatherCancel(ctx);
+	ctx->paused = true;
+}
+
+static OpResult GatherInit
+(
+	OpBase *opBase
+) {
+	OpGather *op = (OpGather *)opBase;
+
+	// collect filters on the way down to the scan
+	op->filters = array_new(FT_FilterNode *, 1);
+	OpBase *child = opBase->children[0];
+	while(child->type == OPType_FILTER) {
+		array_append(op->filters, ((OpFilter *)child)->filterTree);
+		child = child->children[0];
+	}
+
+	ASSERT(child->type == OPType_ALL_NODE_SCAN ||
+		   child->type == OPType_NODE_BY_LABEL_SCAN ||
+		   child->type == OPType_NODE_BY_LABEL_AND_ID_SCAN);
+	ASSERT(child->childCount == 0);
+
+	op->scan = child;
+	op->nodeRecIdx = (child->type == OPType_ALL_NODE_SCAN) ?
+		((AllNodeScan *)child)->nodeRecIdx :
+		((NodeByLabelScan *)child)->nodeRecIdx;
+
+	// profiled operations report their own record counts
+	// run without parallelism to keep statistics accurate
+	if(opBase->stats != NULL || ThreadPools_WorkersCount() < 2) {
+		OpBase_UpdateConsume(opBase, GatherConsumeFromChild);
+		OpBase_UpdateConsumeBatch(opBase, GatherConsumeBatchFromChild);
+	}
+
+	return OP_OK;
+}
+
+static Record GatherConsume
+(
+	OpBase *opBase
+) {
+	OpGather *op = (OpGather *)opBase;
+
+	if(!_GatherParallel(op)) {
+		return OpBase_Consume(opBase->children[0]);
+	}
+
+	NodeID id;
+	if(!_GatherNext(op, &id)) return NULL;
+
+	return _CreateRecord(op, id);
+}
+
+static uint GatherConsumeBatch
+(
+	OpBase *opBase,
+	RecordBatch *batch
+) {
+	OpGather *op = (OpGather *)opBase;
+
+	if(!_GatherParallel(op)) {
+		return OpBase_ConsumeBatch(opBase->children[0], batch);
+	}
+
+	NodeID id;
+	while(!RecordBatch_Full(batch) && _GatherNext(op, &id)) {
+		RecordBatch_Add(batch, _CreateRecord(op, id));
+	}
+
+	return RecordBatch_Size(batch);
+}
+
+static Record GatherConsumeFromChild
+(
+	OpBase *opBase
+) {
+	return OpBase_Consume(opBase->children[0]);
+}
+
+static uint GatherConsumeBatchFromChild
+(
+	OpBase *opBase,
+	RecordBatch *batch
+) {
+	return OpBase_ConsumeBatch(opBase->children[0], batch);
+}
+
+static OpResult GatherReset
+(
+	OpBase *opBase
+) {
+	OpGather *op = (OpGather *)opBase;
+	_GatherStop(op);
+
+	// reconsider parallelism on the next consume
+	op->serial = false;
+
+	return OP_OK;
+}
+
+static OpBase *GatherClone
+(
+	const ExecutionPlan *plan,
+	const OpBase *opBase
+) {
+	ASSERT(opBase->type == OPType_GATHER);
+	return NewGatherOp(plan);
+}
+
+static void GatherFree
+(
+	OpBase *opBase
+) {
+	OpGather *op = (OpGather *)opBase;
+
+	// workers must exit before the graph's lock is released
+	_GatherStop(op);
+
+	if(op->filters != NULL) {
+		array_free(op->filters);
+		op->filters = NULL;
+	}
+}
+
@@ -0,0 +1,59 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../filter_tree/filter_tree.h"
+
+// number of node IDs in a single morsel
+#define GATHER_MORSEL_SIZE 16384
+
+// minimum number of scanned nodes for which the scan is parallelized
+#define GATHER_MIN_NODE_COUNT (2 * GATHER_MORSEL_SIZE)
+
+struct GatherCtx;
+
+// Gather
+// parallelizes a node scan and the filters applied on top of it
+// the scanned ID range is split into morsels, each morsel is processed
+// by a worker thread which collects the IDs of nodes passing all filters
+// morsels are emitted in order, producing the same records and order
+// as the sequential scan, workers stay within a fixed window of morsels
+// ahead of the emitted one, such that a LIMIT stops the scan early
+// a worker finding the window full returns to the pool, workers are
+// enqueued again as morsels are emitted
+//
+// gather's child is the scanned sub-tree: zero or more filters on top of
+// a node scan, when the scan is too small to benefit from parallelism
+// or the query is profiled, gather simply passes its child's records through
+typedef struct {
+	OpBase op;
+	Graph *g;
+	OpBase *scan;              // scan operation at the bottom of the sub-tree
+	FT_FilterNode **filters;   // filters applied on scanned nodes, not owned
+	uint nodeRecIdx;           // scanned node record index
+	struct GatherCtx *ctx;     // parallel scan state, NULL if not started
+	bool serial;               // records are passed through from child
+	uint morsel;               // current morsel
+	uint offset;               // position within current morsel
+} OpGather;
+
+OpBase *NewGatherOp
+(
+	const ExecutionPlan *plan
+);
+
+// pause a parallel scan, waiting for all workers to exit
+// processed morsels are kept and workers are respawned on the next consume
+// must be called before the graph's lock is released with the scan incomplete
+void Gather_Pause
+(
+	OpBase *op
+);
+
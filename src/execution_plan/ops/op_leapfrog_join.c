@@ -0,0 +1,735 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "op_leapfrog_join.h"
+#include "../../query_ctx.h"
+
+// forward declarations
+static OpResult LeapfrogJoinInit(OpBase *opBase);
+static Record LeapfrogJoinConsume(OpBase *opBase);
+static OpResult LeapfrogJoinReset(OpBase *opBase);
+static OpBase *LeapfrogJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void LeapfrogJoinFree(OpBase *opBase);
+
+// print variable, its labels are printed on its first appearance only
+static void _VarToString
+(
+	const OpLeapfrogJoin *op,
+	uint idx,
+	bool *printed,
+	sds *buf
+) {
+	const LeapfrogVar *v = op->vars + idx;
+
+	*buf = sdscatprintf(*buf, "(%s", v->alias);
+	if(!printed[idx]) {
+		uint label_count = array_len(v->labels);
+		for(uint i = 0; i < label_count; i++) {
+			*buf = sdscatprintf(*buf, ":%s", v->labels[i]);
+		}
+		printed[idx] = true;
+	}
+	*buf = sdscatprintf(*buf, ")");
+}
+
+// string representation of operation
+// lists the pattern's edges in the order their variables are joined
+static void LeapfrogJoinToString
+(
+	const OpBase *ctx,
+	sds *buf
+) {
+	const OpLeapfrogJoin *op = (const OpLeapfrogJoin *)ctx;
+
+	*buf = sdscatprintf(*buf, "%s | ", ctx->name);
+
+	uint var_count = array_len(op->vars);
+	bool printed[var_count];
+	memset(printed, 0, sizeof(printed));
+
+	bool first = true;
+	for(uint i = 1; i < var_count; i++) {
+		const LeapfrogVar *v = op->vars + i;
+		uint edge_count = array_len(v->edges);
+		for(uint j = 0; j < edge_count; j++) {
+			const LeapfrogEdge *e = v->edges + j;
+			if(!first) *buf = sdscatprintf(*buf, ", ");
+			first = false;
+
+			_VarToString(op, e->src, printed, buf);
+
+			sds rel = sdsempty();
+			uint reltype_count = array_len(e->reltypes);
+			for(uint k = 0; k < reltype_count; k++) {
+				rel = sdscatprintf(rel, "%s%s", k == 0 ? "[:" : "|",
+						e->reltypes[k]);
+			}
+			if(reltype_count > 0) rel = sdscat(rel, "]");
+
+			if(e->bidirectional) {
+				*buf = sdscatprintf(*buf, "-%s-", rel);
+			} else if(e->transposed) {
+				*buf = sdscatprintf(*buf, "<-%s-", rel);
+			} else {
+				*buf = sdscatprintf(*buf, "-%s->", rel);
+			}
+			sdsfree(rel);
+
+			_VarToString(op, i, printed, buf);
+		}
+	}
+}
+
+static int _NodeID_cmp
+(
+	const void *a,
+	const void *b
+) {
+	NodeID x = *(const NodeID *)a;
+	NodeID y = *(const NodeID *)b;
+	return (x > y) - (x < y);
+}
+
+// returns true if node 'id' carries all of the variable's labels
+static bool _Labeled
+(
+	const LeapfrogVar *v,
+	NodeID id
+) {
+	uint label_count = array_len(v->label_ms);
+	for(uint i = 0; i < label_count; i++) {
+		bool x;
+		if(RG_Matrix_extractElement_BOOL(&x, v->label_ms[i], id, id) !=
+				GrB_SUCCESS) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// returns true if 'src' is connected to 'id' via edge 'e'
+static bool _Connected
+(
+	const LeapfrogEdge *e,
+	NodeID src,
+	NodeID id
+) {
+	uint iter_count = array_len(e->iters);
+	for(uint i = 0; i < iter_count; i++) {
+		bool x;
+		if(RG_Matrix_extractElement_BOOL(&x, e->iters[i].A, src, id) ==
+				GrB_SUCCESS) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// load the neighbours of 'src' reachable via edge 'e' into e->row
+// the row is the union of the rows of all the edge's relationship matrices
+// sorted and free of duplicates
+static void _LoadRow
+(
+	LeapfrogEdge *e,
+	NodeID src
+) {
+	array_clear(e->row);
+	e->pos = 0;
+
+	// entries of a single matrix row are already sorted, unless
+	// the matrix holds pending additions
+	bool sorted = true;
+	uint iter_count = array_len(e->iters);
+	for(uint i = 0; i < iter_count; i++) {
+		GrB_Index col;
+		RG_MatrixTupleIter *it = e->iters + i;
+		RG_MatrixTupleIter_iterate_row(it, src);
+		while(RG_MatrixTupleIter_next_BOOL(it, NULL, &col, NULL) ==
+				GrB_SUCCESS) {
+			uint len = array_len(e->row);
+			if(len > 0 && e->row[len - 1] >= col) sorted = false;
+			array_append(e->row, col);
+		}
+	}
+
+	if(sorted) return;
+
+	uint len = array_len(e->row);
+	qsort(e->row, len, sizeof(NodeID), _NodeID_cmp);
+
+	// remove duplicates
+	uint j = 0;
+	for(uint i = 0; i < len; i++) {
+		if(j == 0 || e->row[j - 1] != e->row[i]) e->row[j++] = e->row[i];
+	}
+	array_hdr(e->row)->len = j;
+}
+
+// returns the first position at or after 'pos' holding a value >= x
+// gallops forward and completes with a binary search
+static uint _Seek
+(
+	const NodeID *row,
+	uint len,
+	uint pos,
+	NodeID x
+) {
+	uint lo   = pos;
+	uint hi   = pos;
+	uint step = 1;
+
+	while(hi < len && row[hi] < x) {
+		lo = hi + 1;
+		hi += step;
+		step <<= 1;
+	}
+	if(hi > len) hi = len;
+
+	while(lo < hi) {
+		uint mid = lo + (hi - lo) / 2;
+		if(row[mid] < x) lo = mid + 1;
+		else hi = mid;
+	}
+
+	return lo;
+}
+
+// compute the candidates of variable 'level' given the current assignment
+// of all preceding variables
+static void _ComputeCandidates
+(
+	OpLeapfrogJoin *op,
+	uint level
+) {
+	LeapfrogVar *v = op->vars + level;
+	LeapfrogEdge *edges = v->edges;
+	uint edge_count = array_len(edges);
+
+	array_clear(v->candidates);
+	v->pos = 0;
+
+	// bound variable, verify it is connected to its preceding neighbours
+	if(v->bound) {
+		NodeID id = op->ids[level];
+		for(uint i = 0; i < edge_count; i++) {
+			if(!_Connected(edges + i, op->ids[edges[i].src], id)) return;
+		}
+		array_append(v->candidates, id);
+		return;
+	}
+
+	for(uint i = 0; i < edge_count; i++) {
+		_LoadRow(edges + i, op->ids[edges[i].src]);
+		if(array_len(edges[i].row) == 0) return;
+	}
+
+	// leapfrog intersection of the sorted rows
+	// 'x' is the smallest value all rows may agree on, each row in turn
+	// seeks to 'x', a row landing past 'x' becomes the new 'x'
+	// once all rows agree on 'x' it is a candidate
+	NodeID x     = edges[0].row[0];
+	uint matched = 1;
+	uint i       = 1 % edge_count;
+
+	while(true) {
+		LeapfrogEdge *e = edges + i;
+		uint len = array_len(e->row);
+
+		if(matched < edge_count) {
+			e->pos = _Seek(e->row, len, e->pos, x);
+			if(e->pos == len) break;
+
+			NodeID y = e->row[e->pos];
+			if(y != x) {
+				x = y;
+				matched = 1;
+				i = (i + 1) % edge_count;
+				continue;
+			}
+			matched++;
+			if(matched < edge_count) {
+				i = (i + 1) % edge_count;
+				continue;
+			}
+		}
+
+		// all rows agree on x
+		if(_Labeled(v, x)) array_append(v->candidates, x);
+
+		// advance current row past x
+		e->pos++;
+		if(e->pos == len) break;
+		x = e->row[e->pos];
+		matched = 1;
+		i = (i + 1) % edge_count;
+	}
+}
+
+// bind the variables resolved by the child record
+// returns false if the record can't be extended
+static bool _Bind
+(
+	OpLeapfrogJoin *op,
+	Record r
+) {
+	uint var_count = array_len(op->vars);
+	for(uint i = 0; i < var_count; i++) {
+		LeapfrogVar *v = op->vars + i;
+		if(!v->bound) continue;
+
+		// the child record may not contain the node in scenarios like
+		// a failed OPTIONAL MATCH
+		Node *n = Record_GetNode(r, v->nodeRecIdx);
+		if(n == NULL) return false;
+
+		op->ids[i] = ENTITY_GET_ID(n);
+		if(!_Labeled(v, op->ids[i])) return false;
+	}
+
+	op->level = 1;
+	_ComputeCandidates(op, 1);
+
+	return true;
+}
+
+// advance to the next assignment satisfying the entire pattern
+// returns false once all assignments extending the current record
+// have been produced
+static bool _Next
+(
+	OpLeapfrogJoin *op
+) {
+	uint last  = array_len(op->vars) - 1;
+	uint level = op->level;
+
+	while(level > 0) {
+		LeapfrogVar *v = op->vars + level;
+
+		// candidates depleted, backtrack
+		if(v->pos == array_len(v->candidates)) {
+			level--;
+			continue;
+		}
+
+		op->ids[level] = v->candidates[v->pos++];
+		if(level == last) {
+			op->level = level;
+			return true;
+		}
+
+		level++;
+		_ComputeCandidates(op, level);
+	}
+
+	op->level = 0;
+	return false;
+}
+
+static OpLeapfrogJoin *_NewLeapfrogJoinOp
+(
+	const ExecutionPlan *plan,
+	Graph *g,
+	uint var_count
+) {
+	OpLeapfrogJoin *op = rm_calloc(1, sizeof(OpLeapfrogJoin));
+
+	op->g    = g;
+	op->vars = array_new(LeapfrogVar, var_count);
+
+	// set our Op operations
+	OpBase_Init((OpBase *)op, OPType_LEAPFROG_JOIN, "Leapfrog Join",
+			LeapfrogJoinInit, LeapfrogJoinConsume, LeapfrogJoinReset,
+			LeapfrogJoinToString, LeapfrogJoinClone, LeapfrogJoinFree, false,
+			plan);
+
+	return op;
+}
+
+// introduce a new variable to the end of the join order
+static LeapfrogVar *_AddVariable
+(
+	OpLeapfrogJoin *op,
+	const char *alias,
+	bool bound
+) {
+	LeapfrogVar v = {0};
+
+	v.alias  = alias;
+	v.bound  = bound;
+	v.labels = array_new(const char *, 0);
+	v.edges  = array_new(LeapfrogEdge, 1);
+
+	if(bound) {
+		bool aware = OpBase_Aware((OpBase *)op, alias, &v.nodeRecIdx);
+		UNUSED(aware);
+		ASSERT(aware);
+	} else {
+		v.nodeRecIdx = OpBase_Modifies((OpBase *)op, alias);
+	}
+
+	array_append(op->vars, v);
+	return op->vars + array_len(op->vars) - 1;
+}
+
+static void _AddEdge
+(
+	LeapfrogVar *v,
+	uint src,
+	bool transposed,
+	bool bidirectional,
+	const char **reltypes,
+	uint reltype_count
+) {
+	LeapfrogEdge e = {0};
+
+	e.src           = src;
+	e.transposed    = transposed;
+	e.bidirectional = bidirectional;
+	e.reltypes      = array_new(const char *, reltype_count);
+	for(uint i = 0; i < reltype_count; i++) {
+		array_append(e.reltypes, reltypes[i]);
+	}
+
+	array_append(v->edges, e);
+}
+
+// returns the position of node 'n' within 'order', -1 if missing
+static int _OrderPosition
+(
+	QGNode **order,
+	const QGNode *n
+) {
+	uint count = array_len(order);
+	for(uint i = 0; i < count; i++) {
+		if(order[i] == n) return i;
+	}
+	return -1;
+}
+
+// determine the order in which variables are joined
+// each variable is connected to at least one preceding variable
+// bound variables are joined as early as possible, as they admit a single
+// candidate, followed by variables connected to the most preceding ones
+static QGNode **_JoinOrder
+(
+	OpLeapfrogJoin *op,
+	const QueryGraph *qg,
+	const char *start
+) {
+	uint node_count = QueryGraph_NodeCount(qg);
+	uint edge_count = QueryGraph_EdgeCount(qg);
+	QGNode **order  = array_new(QGNode *, node_count);
+
+	array_append(order, QueryGraph_GetNodeByAlias(qg, start));
+	ASSERT(order[0] != NULL);
+
+	while(array_len(order) < node_count) {
+		QGNode *best    = NULL;
+		bool best_bound = false;
+		uint best_conn  = 0;
+
+		for(uint i = 0; i < node_count; i++) {
+			QGNode *n = qg->nodes[i];
+			if(_OrderPosition(order, n) != -1) continue;
+
+			// count edges connecting n to preceding variables
+			uint conn = 0;
+			for(uint j = 0; j < edge_count; j++) {
+				QGEdge *e = qg->edges[j];
+				if((e->src == n && _OrderPosition(order, e->dest) != -1) ||
+				   (e->dest == n && _OrderPosition(order, e->src) != -1)) {
+					conn++;
+				}
+			}
+			if(conn == 0) continue;
+
+			bool bound = OpBase_Aware((OpBase *)op, n->alias, NULL);
+			if(best == NULL                             ||
+			   (bound && !best_bound)                   ||
+			   (bound == best_bound && conn > best_conn)) {
+				best       = n;
+				best_bound = bound;
+				best_conn  = conn;
+			}
+		}
+
+		// component is connected
+		ASSERT(best != NULL);
+		array_append(order, best);
+	}
+
+	return order;
+}
+
+OpBase *NewLeapfrogJoinOp
+(
+	const ExecutionPlan *plan,
+	Graph *g,
+	const QueryGraph *qg,
+	const char *start
+) {
+	ASSERT(g     != NULL);
+	ASSERT(qg    != NULL);
+	ASSERT(plan  != NULL);
+	ASSERT(start != NULL);
+
+	uint node_count = QueryGraph_NodeCount(qg);
+	uint edge_count = QueryGraph_EdgeCount(qg);
+	OpLeapfrogJoin *op = _NewLeapfrogJoinOp(plan, g, node_count);
+
+	QGNode **order = _JoinOrder(op, qg, start);
+
+	// determine which variables are bound before introducing any
+	// modifications, the first variable is resolved by the child
+	bool bound[node_count];
+	for(uint i = 0; i < node_count; i++) {
+		bound[i] = OpBase_Aware((OpBase *)op, order[i]->alias, NULL);
+	}
+	ASSERT(bound[0]);
+
+	for(uint i = 0; i < node_count; i++) {
+		QGNode *n = order[i];
+		LeapfrogVar *v = _AddVariable(op, n->alias, bound[i]);
+
+		uint label_count = QGNode_LabelCount(n);
+		for(uint j = 0; j < label_count; j++) {
+			array_append(v->labels, QGNode_GetLabel(n, j));
+		}
+
+		// each edge constrains the later of its endpoints
+		for(uint j = 0; j < edge_count; j++) {
+			QGEdge *e = qg->edges[j];
+			int src  = _OrderPosition(order, e->src);
+			int dest = _OrderPosition(order, e->dest);
+			ASSERT(src != dest);
+
+			if(MAX(src, dest) != (int)i) continue;
+			_AddEdge(v, MIN(src, dest), dest < src, e->bidirectional,
+					e->reltypes, QGEdge_RelationCount(e));
+		}
+	}
+
+	array_free(order);
+	return (OpBase *)op;
+}
+
+// attach iterators over the rows of relationship 'relation'
+// for an edge leaving its preceding variable rows are read from R
+// for an edge entering it rows are read from R's transpose
+static void _AttachRelation
+(
+	OpLeapfrogJoin *op,
+	LeapfrogEdge *e,
+	int relation
+) {
+	RG_MatrixTupleIter it = {0};
+	RG_Matrix M = Graph_GetRelationMatrix(op->g, relation, e->transposed);
+	RG_MatrixTupleIter_attach(&it, M);
+	array_append(e->iters, it);
+
+	if(e->bidirectional) {
+		RG_MatrixTupleIter it = {0};
+		M = Graph_GetRelationMatrix(op->g, relation, !e->transposed);
+		RG_MatrixTupleIter_attach(&it, M);
+		array_append(e->iters, it);
+	}
+}
+
+static OpResult LeapfrogJoinInit
+(
+	OpBase *opBase
+) {
+	OpLeapfrogJoin *op = (OpLeapfrogJoin *)opBase;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	uint var_count = array_len(op->vars);
+	op->ids = rm_calloc(var_count, sizeof(NodeID));
+
+	// resolve labels and relationship types
+	// as they may have not been known when the plan was prepared
+	for(uint i = 0; i < var_count; i++) {
+		LeapfrogVar *v = op->vars + i;
+		uint label_count = array_len(v->labels);
+
+		v->candidates = array_new(NodeID, 0);
+		v->label_ms   = array_new(RG_Matrix, label_count);
+
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchema(gc, v->labels[j], SCHEMA_NODE);
+			if(s == NULL) {
+				// label doesn't exists, pattern can't be satisfied
+				op->empty = true;
+				continue;
+			}
+			array_append(v->label_ms,
+					Graph_GetLabelMatrix(op->g, Schema_GetID(s)));
+		}
+
+		uint edge_count = array_len(v->edges);
+		for(uint j = 0; j < edge_count; j++) {
+			LeapfrogEdge *e = v->edges + j;
+			uint reltype_count = array_len(e->reltypes);
+
+			e->row   = array_new(NodeID, 0);
+			e->iters = array_new(RG_MatrixTupleIter, 2);
+
+			if(reltype_count == 0) {
+				_AttachRelation(op, e, GRAPH_NO_RELATION);
+			}
+
+			// missing relationship types contribute no edges
+			for(uint k = 0; k < reltype_count; k++) {
+				Schema *s = GraphContext_GetSchema(gc, e->reltypes[k],
+						SCHEMA_EDGE);
+				if(s != NULL) _AttachRelation(op, e, Schema_GetID(s));
+			}
+
+			if(array_len(e->iters) == 0) op->empty = true;
+		}
+	}
+
+	return OP_OK;
+}
+
+static Record LeapfrogJoinConsume
+(
+	OpBase *opBase
+) {
+	OpLeapfrogJoin *op = (OpLeapfrogJoin *)opBase;
+	OpBase *child = op->op.children[0];
+
+	if(op->empty) return NULL;
+
+	while(true) {
+		if(op->r != NULL) {
+			if(_Next(op)) break;
+
+			// current record depleted
+			OpBase_DeleteRecord(op->r);
+			op->r = NULL;
+		}
+
+		Record r = OpBase_Consume(child);
+		if(r == NULL) return NULL;
+
+		if(!_Bind(op, r)) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
+
+		Record_PersistScalars(r);
+		op->r = r;
+	}
+
+	// populate the record with the current assignment
+	uint var_count = array_len(op->vars);
+	for(uint i = 1; i < var_count; i++) {
+		LeapfrogVar *v = op->vars + i;
+		if(v->bound) continue;
+
+		Node n = GE_NEW_NODE();
+		Graph_GetNode(op->g, op->ids[i], &n);
+		Record_AddNode(op->r, v->nodeRecIdx, n);
+	}
+
+	return OpBase_CloneRecord(op->r);
+}
+
+static OpResult LeapfrogJoinReset
+(
+	OpBase *ctx
+) {
+	OpLeapfrogJoin *op = (OpLeapfrogJoin *)ctx;
+
+	if(op->r != NULL) {
+		OpBase_DeleteRecord(op->r);
+		op->r = NULL;
+	}
+	op->level = 0;
+
+	return OP_OK;
+}
+
+static OpBase *LeapfrogJoinClone
+(
+	const ExecutionPlan *plan,
+	const OpBase *opBase
+) {
+	ASSERT(opBase->type == OPType_LEAPFROG_JOIN);
+
+	const OpLeapfrogJoin *op = (const OpLeapfrogJoin *)opBase;
+	uint var_count = array_len(op->vars);
+	OpLeapfrogJoin *clone = _NewLeapfrogJoinOp(plan, QueryCtx_GetGraph(),
+			var_count);
+
+	for(uint i = 0; i < var_count; i++) {
+		const LeapfrogVar *v = op->vars + i;
+		LeapfrogVar *cv = _AddVariable(clone, v->alias, v->bound);
+
+		uint label_count = array_len(v->labels);
+		for(uint j = 0; j < label_count; j++) {
+			array_append(cv->labels, v->labels[j]);
+		}
+
+		uint edge_count = array_len(v->edges);
+		for(uint j = 0; j < edge_count; j++) {
+			const LeapfrogEdge *e = v->edges + j;
+			_AddEdge(cv, e->src, e->transposed, e->bidirectional, e->reltypes,
+					array_len(e->reltypes));
+		}
+	}
+
+	return (OpBase *)clone;
+}
+
+static void LeapfrogJoinFree
+(
+	OpBase *ctx
+) {
+	OpLeapfrogJoin *op = (OpLeapfrogJoin *)ctx;
+
+	if(op->r != NULL) {
+		OpBase_DeleteRecord(op->r);
+		op->r = NULL;
+	}
+
+	if(op->vars != NULL) {
+		uint var_count = array_len(op->vars);
+		for(uint i = 0; i < var_count; i++) {
+			LeapfrogVar *v = op->vars + i;
+
+			uint edge_count = array_len(v->edges);
+			for(uint j = 0; j < edge_count; j++) {
+				LeapfrogEdge *e = v->edges + j;
+				if(e->iters != NULL) {
+					uint iter_count = array_len(e->iters);
+					for(uint k = 0; k < iter_count; k++) {
+						RG_MatrixTupleIter_detach(e->iters + k);
+					}
+					array_free(e->iters);
+				}
+				if(e->row != NULL) array_free(e->row);
+				array_free(e->reltypes);
+			}
+
+			array_free(v->edges);
+			array_free(v->labels);
+			if(v->label_ms   != NULL) array_free(v->label_ms);
+			if(v->candidates != NULL) array_free(v->candidates);
+		}
+
+		array_free(op->vars);
+		op->vars = NULL;
+	}
+
+	if(op->ids != NULL) {
+		rm_free(op->ids);
+		op->ids = NULL;
+	}
+}
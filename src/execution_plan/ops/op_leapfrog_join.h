@@ -0,0 +1,67 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../graph/query_graph.h"
+#include "../../graph/rg_matrix/rg_matrix_iter.h"
+
+// edge connecting a join variable to a variable preceding it
+// in the join order
+typedef struct {
+	uint src;                   // index of the preceding variable
+	bool transposed;            // edge points into the preceding variable
+	bool bidirectional;         // edge has no direction
+	const char **reltypes;      // relationship types, empty for any type
+	RG_MatrixTupleIter *iters;  // iterators over relationship matrices
+	NodeID *row;                // sorted neighbours of the preceding variable
+	uint pos;                   // position within row
+} LeapfrogEdge;
+
+// a node variable of the joined pattern
+typedef struct {
+	const char *alias;      // node alias
+	const char **labels;    // node labels
+	bool bound;             // node is resolved by the child operation
+	int nodeRecIdx;         // node record index
+	LeapfrogEdge *edges;    // edges to preceding variables
+	RG_Matrix *label_ms;    // label matrices
+	NodeID *candidates;     // nodes satisfying all edges and labels
+	uint pos;               // current candidate
+} LeapfrogVar;
+
+// Leapfrog Join
+// a worst-case optimal join resolving a cyclic pattern
+// rather than traversing one edge at a time and materializing every path
+// before closing the cycle, nodes are bound one variable at a time
+// the candidates for a variable are the intersection of the sorted
+// adjacency rows of all its already bound neighbours
+//
+// the first variable is resolved by the child operation
+// each child record is extended with every assignment of the remaining
+// variables which satisfies all of the pattern's edges and labels
+typedef struct {
+	OpBase op;
+	Graph *g;
+	LeapfrogVar *vars;      // variables in join order
+	NodeID *ids;            // current assignment
+	uint level;             // deepest variable with computed candidates
+	bool empty;             // pattern can't be satisfied
+	Record r;               // current child record
+} OpLeapfrogJoin;
+
+// creates a new leapfrog join operation resolving the
+// connected component 'qg' starting at node 'start'
+OpBase *NewLeapfrogJoinOp
+(
+	const ExecutionPlan *plan,  // execution plan
+	Graph *g,                   // graph
+	const QueryGraph *qg,       // pattern to resolve
+	const char *start           // alias of the node resolved by the child
+);
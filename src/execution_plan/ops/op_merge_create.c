@@ -35,14 +35,15 @@ static void _IncrementalHashEntity(XXH64_state_t *state, const char **labels,
 		ASSERT(res != XXH_ERROR);
 
 		for(int i = 0; i < _set->attr_count; i++) {
-			Attribute *a = _set->attributes + i;
+			Attribute_ID attr_id;
+			SIValue value = AttributeSet_GetIdx(_set, i, &attr_id);
 
 			// update hash with attribute ID
-			res = XXH64_update(state, &a->id, sizeof(a->id));
+			res = XXH64_update(state, &attr_id, sizeof(attr_id));
 			ASSERT(res != XXH_ERROR);
 
 			// update hash with the hashval of the associated SIValue
-			XXH64_hash_t value_hash = SIValue_HashCode(a->value);
+			XXH64_hash_t value_hash = SIValue_HashCode(value);
 			res = XXH64_update(state, &value_hash, sizeof(value_hash));
 			ASSERT(res != XXH_ERROR);
 		}
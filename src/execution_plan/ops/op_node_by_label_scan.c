@@ -14,6 +14,7 @@
 static OpResult NodeByLabelScanInit(OpBase *opBase);
 static Record NodeByLabelScanConsume(OpBase *opBase);
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase);
+static uint NodeByLabelScanConsumeBatch(OpBase *opBase, RecordBatch *batch);
 static Record NodeByLabelScanNoOp(OpBase *opBase);
 static OpResult NodeByLabelScanReset(OpBase *opBase);
 static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opBase);
@@ -93,6 +94,7 @@ static GrB_Info _ConstructIterator(NodeByLabelScan *op) {
 static OpResult NodeByLabelScanInit(OpBase *opBase) {
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 	OpBase_UpdateConsume(opBase, NodeByLabelScanConsume); // Default consume function.
+	OpBase_UpdateConsumeBatch(opBase, NULL);
 
 	// Operation has children, consume from child.
 	if(opBase->childCount > 0) {
@@ -114,6 +116,7 @@ static OpResult NodeByLabelScanInit(OpBase *opBase) {
 		return OP_OK;
 	}
 
+	OpBase_UpdateConsumeBatch(opBase, NodeByLabelScanConsumeBatch);
 	return OP_OK;
 }
 
@@ -188,6 +191,24 @@ static Record NodeByLabelScanConsume(OpBase *opBase) {
 	return r;
 }
 
+static uint NodeByLabelScanConsumeBatch(OpBase *opBase, RecordBatch *batch) {
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+
+	GrB_Index nodeId;
+	while(!RecordBatch_Full(batch)) {
+		GrB_Info info = RG_MatrixTupleIter_next_BOOL(&op->iter, &nodeId, NULL, NULL);
+		if(info == GxB_EXHAUSTED) break;
+
+		ASSERT(info == GrB_SUCCESS);
+
+		Record r = OpBase_CreateRecord(opBase);
+		_UpdateRecord(op, r, nodeId);
+		RecordBatch_Add(batch, r);
+	}
+
+	return RecordBatch_Size(batch);
+}
+
 /* This function is invoked when the op has no children and no valid label is requested (either no label, or non existing label).
  * The op simply needs to return NULL */
 static Record NodeByLabelScanNoOp(OpBase *opBase) {
@@ -7,11 +7,16 @@
 #include "op_sort.h"
 #include "op_project.h"
 #include "op_aggregate.h"
+#include "../record_spill.h"
 #include "../../util/arr.h"
 #include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
+#include "../../util/thpool/pools.h"
 #include "../../query_ctx.h"
 
+#include <math.h>
+#include <pthread.h>
+
 // forward declarations
 static OpResult SortInit(OpBase *opBase);
 static Record SortConsume(OpBase *opBase);
@@ -19,6 +24,27 @@ static OpResult SortReset(OpBase *opBase);
 static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void SortFree(OpBase *opBase);
 
+// a sorted sequence of records
+// in-memory runs span the entries [pos, end) of op->buffer
+// spilled runs are read back from disk one record at a time
+typedef struct SortRun {
+	uint64_t pos;        // position of run's head within op->buffer
+	uint64_t end;        // end of in-memory run within op->buffer
+	RecordSpill *spill;  // spilled records, NULL for in-memory runs
+	SortEntry head;      // run's smallest remaining entry, NULL record if empty
+} SortRun;
+
+// state shared by threads sorting runs in parallel
+typedef struct {
+	OpSort *op;            // sort operation
+	SortRun **runs;        // runs to sort
+	uint n;                // number of runs
+	uint next;             // next run to sort
+	uint active;           // number of workers sorting runs
+	pthread_mutex_t lock;  // protects active
+	pthread_cond_t cond;   // signaled when a worker is done
+} SortTask;
+
 // function to compare two records on a subset of fields
 // return value similar to strcmp
 static int _record_cmp
@@ -40,13 +66,373 @@ static int _record_cmp
 	return 0;
 }
 
-static int _buffer_elem_cmp
+// compare two entries, falling back to a full comparison
+// only when their prefixes are equal
+static int _entry_cmp
+(
+	const SortEntry *a,
+	const SortEntry *b,
+	OpSort *op
+) {
+	if(a->prefix != b->prefix) return (a->prefix < b->prefix) ? -1 : 1;
+	return _record_cmp(a->r, b->r, op);
+}
+
+// merge heap compare function, the heap's top is its greatest element
+// as such runs are ordered in reverse
+static int _run_cmp
 (
-	const Record *a,
-	const Record *b,
+	const SortRun *a,
+	const SortRun *b,
 	OpSort *op
 ) {
-	return _record_cmp(*a, *b, op);
+	return _entry_cmp(&b->head, &a->head, op);
+}
+
+// computes an order preserving 64 bit encoding of v
+// for any two values a and b: prefix(a) < prefix(b) implies a < b
+// values sharing a prefix must be compared in full
+// the top 5 bits hold the position of the value's type within the
+// cross type ordering, the remaining bits hold the value's leading bits
+static uint64_t _prefix
+(
+	SIValue v
+) {
+	SIType t = SI_TYPE(v);
+	uint64_t bits = 0;
+
+	if(t & SI_NUMERIC) {
+		// integers and floating points are compared with one another
+		t = T_INT64;
+		double d = SI_GET_NUMERIC(v);
+		if(isnan(d)) {
+			// NaN is greater than any number
+			bits = UINT64_MAX;
+		} else {
+			if(d == 0) d = 0; // -0 equals 0
+			memcpy(&bits, &d, sizeof(bits));
+			// flip negatives entirely and positives' sign bit
+			bits = (bits & (1ULL << 63)) ? ~bits : bits | (1ULL << 63);
+		}
+	} else if(t == T_STRING) {
+		// leading 7 bytes of the string, big endian
+		const unsigned char *s = (const unsigned char *)v.stringval;
+		for(int i = 0; i < 7; i++) {
+			bits <<= 8;
+			if(*s) bits |= *s++;
+		}
+		bits <<= 8;
+	} else if(t == T_BOOL) {
+		bits = (uint64_t)v.longval << 63;
+	}
+
+	uint64_t rank = __builtin_ctz(t);
+	return (rank << 59) | (bits >> 5);
+}
+
+static SortEntry _entry
+(
+	OpSort *op,
+	Record r
+) {
+	SIValue v = Record_Get(r, op->record_offsets[0]);
+	uint64_t prefix = _prefix(v);
+	// flip prefix for descending order
+	if(op->directions[0] < 0) prefix = ~prefix;
+	return (SortEntry) { .prefix = prefix, .r = r };
+}
+
+//------------------------------------------------------------------------------
+// runs
+//------------------------------------------------------------------------------
+
+static SortRun *_NewMemRun
+(
+	uint64_t pos,
+	uint64_t end
+) {
+	SortRun *run = rm_malloc(sizeof(SortRun));
+
+	run->pos    = pos;
+	run->end    = end;
+	run->spill  = NULL;
+	run->head.r = NULL;
+
+	return run;
+}
+
+// load run's head entry
+static void _RunLoadHead
+(
+	OpSort *op,
+	SortRun *run
+) {
+	if(run->spill == NULL) {
+		if(run->pos < run->end) run->head = op->buffer[run->pos];
+		else run->head.r = NULL;
+		return;
+	}
+
+	Record r = OpBase_CreateRecord((OpBase *)op);
+	run->head.r = r;
+	if(RecordSpill_Read(run->spill, r)) {
+		run->head = _entry(op, r);
+	} else {
+		run->head.r = NULL;
+		OpBase_DeleteRecord(r);
+	}
+}
+
+// pops run's head record
+static Record _RunPop
+(
+	OpSort *op,
+	SortRun *run
+) {
+	Record r = run->head.r;
+	if(r == NULL) return NULL;
+
+	if(run->spill == NULL) run->pos++;
+	_RunLoadHead(op, run);
+
+	return r;
+}
+
+// frees run, in-memory run's records are owned by op->buffer
+static void _RunFree
+(
+	SortRun *run
+) {
+	if(run->spill != NULL) {
+		if(run->head.r != NULL) OpBase_DeleteRecord(run->head.r);
+		RecordSpill_Free(run->spill);
+	}
+	rm_free(run);
+}
+
+// frees runs along with their remaining records
+static void _RunsFree
+(
+	OpSort *op,
+	SortRun **runs
+) {
+	uint n = array_len(runs);
+	for(uint i = 0; i < n; i++) {
+		SortRun *run = runs[i];
+		if(run->spill == NULL) {
+			for(uint64_t j = run->pos; j < run->end; j++) {
+				OpBase_DeleteRecord(op->buffer[j].r);
+			}
+		}
+		_RunFree(run);
+	}
+	array_free(runs);
+}
+
+// creates a heap merging runs
+static heap_t *_MergeRuns
+(
+	OpSort *op,
+	SortRun **runs
+) {
+	heap_t *merge = Heap_new((heap_cmp)_run_cmp, op);
+	uint n = array_len(runs);
+	for(uint i = 0; i < n; i++) {
+		SortRun *run = runs[i];
+		if(run->head.r == NULL) _RunLoadHead(op, run);
+		if(run->head.r != NULL) Heap_offer(&merge, run);
+	}
+	return merge;
+}
+
+// pops the smallest record from merged runs
+static Record _MergePop
+(
+	OpSort *op,
+	heap_t *merge
+) {
+	if(Heap_count(merge) == 0) return NULL;
+
+	SortRun *run = Heap_poll(merge);
+	Record r = _RunPop(op, run);
+	if(run->head.r != NULL) Heap_offer(&merge, run);
+
+	return r;
+}
+
+//------------------------------------------------------------------------------
+// parallel run sort
+//------------------------------------------------------------------------------
+
+static void _SortRun
+(
+	OpSort *op,
+	SortRun *run
+) {
+	sort_r(op->buffer + run->pos, run->end - run->pos, sizeof(SortEntry),
+			(heap_cmp)_entry_cmp, op);
+}
+
+// sort runs until there are no more runs to claim
+static void _SortClaimedRuns
+(
+	SortTask *task
+) {
+	uint i;
+	while((i = __atomic_fetch_add(&task->next, 1, __ATOMIC_RELAXED)) < task->n) {
+		_SortRun(task->op, task->runs[i]);
+	}
+}
+
+static void _SortWorker
+(
+	void *arg
+) {
+	SortTask *task = (SortTask *)arg;
+
+	_SortClaimedRuns(task);
+
+	pthread_mutex_lock(&task->lock);
+	task->active--;
+	pthread_cond_signal(&task->cond);
+	pthread_mutex_unlock(&task->lock);
+}
+
+// sort runs, the calling thread sorts runs alongside the workers
+static void _SortRunsParallel
+(
+	OpSort *op,
+	SortRun **runs
+) {
+	SortTask task;
+
+	task.op     = op;
+	task.runs   = runs;
+	task.n      = array_len(runs);
+	task.next   = 0;
+	task.active = 0;
+
+	pthread_mutex_init(&task.lock, NULL);
+	pthread_cond_init(&task.cond, NULL);
+
+	for(uint i = 1; i < task.n; i++) {
+		pthread_mutex_lock(&task.lock);
+		task.active++;
+		pthread_mutex_unlock(&task.lock);
+
+		if(ThreadPools_AddWorkWorker(_SortWorker, &task) != 0) {
+			pthread_mutex_lock(&task.lock);
+			task.active--;
+			pthread_mutex_unlock(&task.lock);
+			break;
+		}
+	}
+
+	_SortClaimedRuns(&task);
+
+	pthread_mutex_lock(&task.lock);
+	while(task.active > 0) pthread_cond_wait(&task.cond, &task.lock);
+	pthread_mutex_unlock(&task.lock);
+
+	pthread_cond_destroy(&task.cond);
+	pthread_mutex_destroy(&task.lock);
+}
+
+// sorts the buffered records [pos, end) into one or more in-memory runs
+static SortRun **_SortBuffer
+(
+	OpSort *op,
+	uint64_t pos,
+	uint64_t end
+) {
+	uint64_t n = end - pos;
+	uint64_t run_count = 1;
+
+	// split large buffers into runs sorted in parallel
+	if(op->parallel) {
+		uint64_t workers = ThreadPools_WorkersCount();
+		run_count = MIN(workers + 1, n / SORT_MIN_PARALLEL_RUN);
+		run_count = MAX(run_count, 1);
+	}
+
+	SortRun **runs = array_new(SortRun *, run_count);
+	uint64_t run_size = n / run_count;
+	for(uint64_t i = 0; i < run_count; i++) {
+		uint64_t run_end = (i == run_count - 1) ? end : pos + run_size;
+		array_append(runs, _NewMemRun(pos, run_end));
+		pos = run_end;
+	}
+
+	if(run_count > 1) {
+		_SortRunsParallel(op, runs);
+	} else {
+		_SortRun(op, runs[0]);
+	}
+
+	return runs;
+}
+
+//------------------------------------------------------------------------------
+// spill
+//------------------------------------------------------------------------------
+
+// returns true if the current run should be spilled to disk
+static inline bool _ShouldSpill
+(
+	OpSort *op
+) {
+	if(!op->spill) return false;
+	if(array_len(op->buffer) < SORT_MIN_SPILL_RUN) return false;
+
+	int64_t cap = rm_mem_capacity();
+	if(cap <= 0) return false;
+
+	return (rm_n_alloced() - op->mem_base) > (cap / SORT_SPILL_MEM_FRACTION);
+}
+
+// sorts the buffered records and writes them to disk as a single run
+// if the records can't be written, spilling is disabled and
+// the records remain buffered
+static void _SpillRun
+(
+	OpSort *op
+) {
+	RecordSpill *spill = RecordSpill_New(QueryCtx_GetGraph());
+	if(spill == NULL) {
+		op->spill = false;
+		return;
+	}
+
+	uint64_t n = array_len(op->buffer);
+	SortRun **runs = _SortBuffer(op, 0, n);
+	heap_t *merge = _MergeRuns(op, runs);
+
+	Record r;
+	bool written = true;
+	while(written && (r = _MergePop(op, merge))) {
+		written = RecordSpill_Write(spill, r);
+	}
+	written = written && RecordSpill_Rewind(spill);
+
+	Heap_free(merge);
+	for(uint i = 0; i < array_len(runs); i++) _RunFree(runs[i]);
+	array_free(runs);
+
+	if(!written) {
+		RecordSpill_Free(spill);
+		op->spill = false;
+		return;
+	}
+
+	// records are on disk, release them
+	for(uint64_t i = 0; i < n; i++) OpBase_DeleteRecord(op->buffer[i].r);
+	array_clear(op->buffer);
+
+	SortRun *run = _NewMemRun(0, 0);
+	run->spill = spill;
+	array_append(op->runs, run);
+
+	op->mem_base = rm_n_alloced();
 }
 
 static void _accumulate
@@ -56,7 +442,19 @@ static void _accumulate
 ) {
 	if(op->limit == UNLIMITED) {
 		// not using a heap and there's room for record
-		array_append(op->buffer, r);
+		array_append(op->buffer, _entry(op, r));
+
+		// comparing maps reorders their keys
+		// such values can't be compared concurrently
+		if(op->parallel) {
+			uint n = array_len(op->record_offsets);
+			for(uint i = 0; i < n; i++) {
+				SIValue v = Record_Get(r, op->record_offsets[i]);
+				if(SI_TYPE(v) & (T_MAP | T_ARRAY)) op->parallel = false;
+			}
+		}
+
+		if(_ShouldSpill(op)) _SpillRun(op);
 		return;
 	}
 
@@ -75,10 +473,49 @@ static void _accumulate
 	}
 }
 
-static inline Record _handoff(OpSort *op) {
-	if(op->record_idx < array_len(op->buffer)) {
-		return op->buffer[op->record_idx++];
+// sort accumulated records into runs and prepare them for merging
+static void _finalize
+(
+	OpSort *op
+) {
+	if(op->heap) {
+		// heap
+		int records_count = Heap_count(op->heap);
+		array_clear(op->buffer);
+		op->buffer = array_ensure_len(op->buffer, records_count);
+		for(int i = records_count-1; i >= 0 ; i--) {
+			Record r = Heap_poll(op->heap);
+			op->buffer[i] = (SortEntry) { .prefix = 0, .r = r };
+		}
+		SortRun *run = _NewMemRun(0, records_count);
+		_RunLoadHead(op, run);
+		array_append(op->runs, run);
+		return;
 	}
+
+	uint64_t n = array_len(op->buffer);
+	if(n > 0) {
+		SortRun **runs = _SortBuffer(op, 0, n);
+		for(uint i = 0; i < array_len(runs); i++) {
+			_RunLoadHead(op, runs[i]);
+			array_append(op->runs, runs[i]);
+		}
+		array_free(runs);
+	}
+
+	uint run_count = array_len(op->runs);
+	if(run_count > 1) {
+		// merge multiple runs
+		op->merge = _MergeRuns(op, op->runs);
+	} else if(run_count == 1 && op->runs[0]->spill != NULL) {
+		// a single spilled run
+		_RunLoadHead(op, op->runs[0]);
+	}
+}
+
+static inline Record _handoff(OpSort *op) {
+	if(op->merge) return _MergePop(op, op->merge);
+	if(array_len(op->runs) == 1) return _RunPop(op, op->runs[0]);
 	return NULL;
 }
 
@@ -93,9 +530,13 @@ OpBase *NewSortOp
 	op->exps       = exps;
 	op->heap       = NULL;
 	op->skip       = 0;
+	op->runs       = NULL;
+	op->spill      = false;
 	op->limit      = UNLIMITED;
+	op->merge      = NULL;
 	op->buffer     = NULL;
-	op->record_idx = 0;
+	op->parallel   = false;
+	op->mem_base   = 0;
 	op->directions = directions;
 
 	// set our Op operations
@@ -126,10 +567,20 @@ static OpResult SortInit(OpBase *opBase) {
 		// if a limit is specified, use heapsort to poll the top N
 		op->heap = Heap_new((heap_cmp)_record_cmp, op);
 	} else {
-		// if all records are being sorted, use quicksort
-		op->buffer = array_new(Record, 32);
+		// if all records are being sorted, sort runs of records,
+		// in parallel when there are enough workers
+		op->parallel = (ThreadPools_WorkersCount() >= 2);
+
+		// spilled records are re-fetched from the graph,
+		// which must not change while the query is running
+		AST *ast = QueryCtx_GetAST();
+		op->spill = (ast != NULL && AST_ReadOnly(ast->root));
+		op->mem_base = rm_n_alloced();
 	}
 
+	op->buffer = array_new(SortEntry, 32);
+	op->runs   = array_new(SortRun *, 1);
+
 	return OP_OK;
 }
 
@@ -148,45 +599,64 @@ static Record SortConsume(OpBase *opBase) {
 	}
 	if(!newData) return NULL;
 
-	if(op->buffer) {
-		sort_r(op->buffer, array_len(op->buffer), sizeof(Record),
-				(heap_cmp)_buffer_elem_cmp, op);
-	} else {
-		// heap
-		int records_count = Heap_count(op->heap);
-		op->buffer = array_newlen(Record, records_count);
-		for(int i = records_count-1; i >= 0 ; i--) {
-			op->buffer[i] = Heap_poll(op->heap);
-		}
-	}
+	_finalize(op);
 
 	// pass ordered records downward
 	return _handoff(op);
 }
 
-// restart iterator
-static OpResult SortReset(OpBase *ctx) {
-	OpSort *op = (OpSort *)ctx;
-	uint recordCount;
-
+// free buffered and sorted records
+static void _SortClear
+(
+	OpSort *op
+) {
 	if(op->heap) {
-		recordCount = Heap_count(op->heap);
+		uint recordCount = Heap_count(op->heap);
 		for(uint i = 0; i < recordCount; i++) {
 			Record r = (Record)Heap_poll(op->heap);
 			OpBase_DeleteRecord(r);
 		}
 	}
 
-	if(op->buffer) {
-		recordCount = array_len(op->buffer);
-		for(uint i = op->record_idx; i < recordCount; i++) {
-			Record r = op->buffer[i];
-			OpBase_DeleteRecord(r);
+	if(op->merge) {
+		Heap_free(op->merge);
+		op->merge = NULL;
+	}
+
+	if(op->runs) {
+		// once sorted, buffered records are owned by in-memory runs
+		bool sorted = false;
+		uint run_count = array_len(op->runs);
+		for(uint i = 0; i < run_count; i++) {
+			if(op->runs[i]->spill == NULL) sorted = true;
 		}
-		array_clear(op->buffer);
+
+		if(!sorted && op->buffer) {
+			uint64_t recordCount = array_len(op->buffer);
+			for(uint64_t i = 0; i < recordCount; i++) {
+				OpBase_DeleteRecord(op->buffer[i].r);
+			}
+		}
+
+		_RunsFree(op, op->runs);
+		op->runs = NULL;
 	}
 
-	op->record_idx = 0;
+	if(op->buffer) array_clear(op->buffer);
+}
+
+// restart iterator
+static OpResult SortReset(OpBase *ctx) {
+	OpSort *op = (OpSort *)ctx;
+
+	_SortClear(op);
+	op->runs = array_new(SortRun *, 1);
+
+	// re-evaluate whether runs can be sorted in parallel
+	if(op->limit == UNLIMITED) {
+		op->parallel = (ThreadPools_WorkersCount() >= 2);
+		op->mem_base = rm_n_alloced();
+	}
 
 	return OP_OK;
 }
@@ -205,22 +675,14 @@ static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase) {
 static void SortFree(OpBase *ctx) {
 	OpSort *op = (OpSort *)ctx;
 
+	_SortClear(op);
+
 	if(op->heap) {
-		uint recordCount = Heap_count(op->heap);
-		for(uint i = 0; i < recordCount; i++) {
-			Record r = (Record)Heap_poll(op->heap);
-			OpBase_DeleteRecord(r);
-		}
 		Heap_free(op->heap);
 		op->heap = NULL;
 	}
 
 	if(op->buffer) {
-		uint recordCount = array_len(op->buffer);
-		for(uint i = op->record_idx; i < recordCount; i++) {
-			Record r = op->buffer[i];
-			OpBase_DeleteRecord(r);
-		}
 		array_free(op->buffer);
 		op->buffer = NULL;
 	}
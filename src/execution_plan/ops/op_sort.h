@@ -11,15 +11,40 @@
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+// minimum number of records in a run sorted by a worker thread
+#define SORT_MIN_PARALLEL_RUN 16384
+
+// minimum number of buffered records before a run is spilled to disk
+#define SORT_MIN_SPILL_RUN 1024
+
+// a run is spilled to disk once the memory consumed while buffering it
+// exceeds 1/SORT_SPILL_MEM_FRACTION of the query memory capacity
+// leaving room for the operations above sort
+#define SORT_SPILL_MEM_FRACTION 4
+
+// a buffered record and its normalized leading sort key
+// entries with different prefixes are ordered by their prefixes alone
+// otherwise records are compared on all sort keys
+typedef struct {
+	uint64_t prefix;  // order preserving encoding of the first sort key
+	Record r;         // buffered record
+} SortEntry;
+
+struct SortRun;
+
 typedef struct {
 	OpBase op;
 	uint *record_offsets;       // All Record offsets containing values to sort by.
 	heap_t *heap;               // Holds top n records.
-	Record *buffer;             // Holds all records.
+	SortEntry *buffer;          // Holds all in-memory records.
+	struct SortRun **runs;      // Sorted runs, either in memory or spilled to disk.
+	heap_t *merge;              // Merges sorted runs, NULL if there's a single run.
 	uint skip;                  // Total number of records to skip
 	uint limit;                 // Total number of records to produce
 	int *directions;            // Array of sort directions(ascending / desending) for each item.
-	uint record_idx;            // index of current record to return
+	bool parallel;              // Runs can be sorted by worker threads.
+	bool spill;                 // Runs can be spilled to disk.
+	int64_t mem_base;           // Memory consumption when the current run began.
 	AR_ExpNode **exps;          // Projected expressons.
 } OpSort;
 
@@ -6,9 +6,15 @@
 
 #include "op_value_hash_join.h"
 #include "../../value.h"
+#include "../../errors.h"
+#include "../../query_ctx.h"
 #include "../../util/arr.h"
-#include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
+#include "../../datatypes/map.h"
+#include "../../datatypes/array.h"
+
+// marks an empty bucket and the end of a chain
+#define NO_RECORD UINT_MAX
 
 // forward declarations
 static Record ValueHashJoinConsume(OpBase *opBase);
@@ -16,159 +22,411 @@ static OpResult ValueHashJoinReset(OpBase *opBase);
 static OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ValueHashJoinFree(OpBase *opBase);
 
-// Determins order between two records by inspecting
-// element stored at postion idx
-static inline int _record_cmp
+//------------------------------------------------------------------------------
+// hashing
+//------------------------------------------------------------------------------
+
+// returns true if value is supported by SIValue_HashCode
+static bool _Hashable
 (
-	Record *l,
-	Record *r,
-	uint *_idx
+	SIValue v
 ) {
-	uint    idx = *_idx;
-	SIValue lv  = Record_Get(*l, idx);
-	SIValue rv  = Record_Get(*r, idx);
-	return SIValue_Compare(lv, rv, NULL);
+	switch(SI_TYPE(v)) {
+		case T_NULL:
+		case T_BOOL:
+		case T_INT64:
+		case T_DOUBLE:
+		case T_STRING:
+		case T_NODE:
+		case T_EDGE:
+		case T_PATH:
+			return true;
+		case T_ARRAY:
+		{
+			uint32_t len = SIArray_Length(v);
+			for(uint32_t i = 0; i < len; i++) {
+				if(!_Hashable(SIArray_Get(v, i))) return false;
+			}
+			return true;
+		}
+		case T_MAP:
+		{
+			uint len = Map_KeyCount(v);
+			for(uint i = 0; i < len; i++) {
+				SIValue key;
+				SIValue val;
+				Map_GetIdx(v, i, &key, &val);
+				if(!_Hashable(val)) return false;
+			}
+			return true;
+		}
+		default:
+			return false;
+	}
 }
 
-// performs binary search, returns the leftmost index of a match
-static bool _binarySearchLeftmost
+// hash joined value
+// values which can't be hashed (e.g. temporal values) are hashed by type
+// equality is always verified, such values merely share buckets
+static uint64_t _HashValue
 (
-	uint *idx,
-	Record *array,
-	uint array_len,
-	int join_key_idx,
 	SIValue v
 ) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(x, v, NULL) < 0) left = pos + 1;
-		else right = pos;
-	}
+	if(_Hashable(v)) return SIValue_HashCode(v);
 
-	// make sure value was found
-	*idx = left;
-
-	if(left == array_len) return false;
+	SIType t = SI_TYPE(v);
+	return XXH64(&t, sizeof(t), 0);
+}
 
-	x = Record_Get(array[*idx], join_key_idx);
-	// return false if the value wasn't found or evaluated to NULL
+// two joined values intersect if they're equal and non-null
+static inline bool _ValuesIntersect
+(
+	SIValue a,
+	SIValue b
+) {
 	int disjointOrNull = 0;
-	return (SIValue_Compare(x, v, &disjointOrNull) == 0 &&
+	return (SIValue_Compare(a, b, &disjointOrNull) == 0 &&
 			disjointOrNull != COMPARED_NULL);
 }
 
-// performs binary search, returns the rightmost index of a match
-// assuming 'v' exists in 'array'
-static bool _binarySearchRightmost
+// partitions are selected by the hash's high bits
+// as the hash table is addressed by its low bits
+static inline uint _PartitionOf
+(
+	uint64_t h
+) {
+	return (h >> 32) % VALUE_HASH_JOIN_PARTITIONS;
+}
+
+//------------------------------------------------------------------------------
+// bloom filter
+//------------------------------------------------------------------------------
+
+// builds a bloom filter over the hashes of all cached records
+// right hand side records which are rejected by the filter
+// are discarded without probing the hash table or being spilled
+static void _BloomBuild
+(
+	OpValueHashJoin *op,
+	const uint64_t *hashes,
+	uint n
+) {
+	// ~8 bits per value
+	uint64_t bits = 64;
+	while(bits < (uint64_t)n * 8) bits <<= 1;
+
+	op->bloom      = rm_calloc(bits / 64, sizeof(uint64_t));
+	op->bloom_mask = bits - 1;
+
+	for(uint i = 0; i < n; i++) {
+		uint64_t h  = hashes[i];
+		uint64_t b1 = h & op->bloom_mask;
+		uint64_t b2 = ((h >> 32) | (h << 32)) & op->bloom_mask;
+		op->bloom[b1 / 64] |= 1ULL << (b1 % 64);
+		op->bloom[b2 / 64] |= 1ULL << (b2 % 64);
+	}
+}
+
+static inline bool _BloomContains
+(
+	const OpValueHashJoin *op,
+	uint64_t h
+) {
+	uint64_t b1 = h & op->bloom_mask;
+	uint64_t b2 = ((h >> 32) | (h << 32)) & op->bloom_mask;
+	return (op->bloom[b1 / 64] & (1ULL << (b1 % 64))) &&
+		   (op->bloom[b2 / 64] & (1ULL << (b2 % 64)));
+}
+
+//------------------------------------------------------------------------------
+// hash table
+//------------------------------------------------------------------------------
+
+// locates the bucket holding 'v'
+// returns the first empty bucket in the probe sequence if 'v' is missing
+static HashJoinBucket *_Lookup
 (
-	uint *idx,
-	Record *array,
-	uint array_len,
-	int join_key_idx,
+	const OpValueHashJoin *op,
+	uint64_t h,
 	SIValue v
 ) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(v, x, NULL) < 0) right = pos;
-		else left = pos + 1;
+	uint64_t i = h & op->bucket_mask;
+	while(true) {
+		HashJoinBucket *b = op->buckets + i;
+		if(b->head == NO_RECORD) return b;
+
+		if(b->hash == h) {
+			Record r = op->cached_records[b->head];
+			if(_ValuesIntersect(Record_Get(r, op->join_value_rec_idx), v)) {
+				return b;
+			}
+		}
+
+		i = (i + 1) & op->bucket_mask;
 	}
+}
+
+// builds an open addressing hash table over the cached records
+// records holding the same value are chained in caching order
+// 'hashes' holds each record's hash, if NULL hashes are recomputed
+static void _BuildTable
+(
+	OpValueHashJoin *op,
+	const uint64_t *hashes
+) {
+	ASSERT(op->buckets == NULL);
+
+	uint n = array_len(op->cached_records);
+
+	// keep load factor at most 0.5
+	uint64_t bucket_count = 16;
+	while(bucket_count < (uint64_t)n * 2) bucket_count <<= 1;
+
+	op->bucket_mask = bucket_count - 1;
+	op->buckets     = rm_malloc(sizeof(HashJoinBucket) * bucket_count);
+	op->chain       = rm_malloc(sizeof(uint) * (n + 1));
 
-	*idx = right - 1;
-	return true;
+	for(uint64_t i = 0; i < bucket_count; i++) {
+		op->buckets[i].head = NO_RECORD;
+	}
+
+	// insert in reverse, so each chain follows caching order
+	for(uint i = n; i > 0; i--) {
+		uint idx = i - 1;
+		SIValue v = Record_Get(op->cached_records[idx], op->join_value_rec_idx);
+		uint64_t h = (hashes != NULL) ? hashes[idx] : _HashValue(v);
+
+		HashJoinBucket *b = _Lookup(op, h, v);
+		op->chain[idx] = b->head;
+		b->hash = h;
+		b->head = idx;
+	}
 }
 
-// retrive the next intersecting record
-// if such exists, otherwise returns NULL
-static Record _get_intersecting_record
+// frees cached records and hash table
+static void _ClearTable
 (
 	OpValueHashJoin *op
 ) {
-	// no more intersecting records
-	if(op->intersect_idx == -1 ||
-	   op->number_of_intersections == 0) return NULL;
+	if(op->cached_records != NULL) {
+		uint record_count = array_len(op->cached_records);
+		for(uint i = 0; i < record_count; i++) {
+			OpBase_DeleteRecord(op->cached_records[i]);
+		}
+		array_clear(op->cached_records);
+	}
 
-	Record cr = op->cached_records[op->intersect_idx];
+	if(op->buckets != NULL) {
+		rm_free(op->buckets);
+		op->buckets = NULL;
+	}
 
-	// update intersection trackers
-	op->intersect_idx++;
-	op->number_of_intersections--;
+	if(op->chain != NULL) {
+		rm_free(op->chain);
+		op->chain = NULL;
+	}
 
-	return cr;
+	op->intersect = NO_RECORD;
 }
 
-// look up first intersecting cached record CR position
-// returns false if no intersecting record is found
-static bool _set_intersection_idx
+//------------------------------------------------------------------------------
+// partitions
+//------------------------------------------------------------------------------
+
+// creates partitions, if 'spill' is set each partition is backed
+// by a spill file, returns NULL if a spill file could not be created
+static HashJoinPartition *_NewPartitions
 (
-	OpValueHashJoin *op,
-	SIValue v
+	bool spill
+) {
+	HashJoinPartition *partitions = rm_calloc(VALUE_HASH_JOIN_PARTITIONS,
+			sizeof(HashJoinPartition));
+
+	for(uint i = 0; i < VALUE_HASH_JOIN_PARTITIONS; i++) {
+		HashJoinPartition *p = partitions + i;
+		p->records  = array_new(Record, 0);
+		p->writable = spill;
+		if(!spill) continue;
+
+		p->spill = RecordSpill_New(QueryCtx_GetGraph());
+		if(p->spill == NULL) {
+			for(uint j = 0; j <= i; j++) {
+				if(partitions[j].spill != NULL) RecordSpill_Free(partitions[j].spill);
+				array_free(partitions[j].records);
+			}
+			rm_free(partitions);
+			return NULL;
+		}
+	}
+
+	return partitions;
+}
+
+static void _FreePartitions
+(
+	HashJoinPartition *partitions
+) {
+	for(uint i = 0; i < VALUE_HASH_JOIN_PARTITIONS; i++) {
+		HashJoinPartition *p = partitions + i;
+		if(p->spill != NULL) RecordSpill_Free(p->spill);
+
+		uint record_count = array_len(p->records);
+		for(uint j = 0; j < record_count; j++) {
+			OpBase_DeleteRecord(p->records[j]);
+		}
+		array_free(p->records);
+	}
+	rm_free(partitions);
+}
+
+// adds record to its partition
+// records which can't be written to disk are kept in memory
+static void _PartitionAdd
+(
+	HashJoinPartition *partitions,
+	uint64_t h,
+	Record r
+) {
+	HashJoinPartition *p = partitions + _PartitionOf(h);
+
+	// spilled records are read back into records owned by the same plan
+	if(p->writable && (p->owner == NULL || p->owner == r->owner)) {
+		if(RecordSpill_Write(p->spill, r)) {
+			p->owner = r->owner;
+			OpBase_DeleteRecord(r);
+			return;
+		}
+		// a partially written record can't be followed by other records
+		p->writable = false;
+	}
+
+	array_append(p->records, r);
+}
+
+// rewinds partition's spill file for reading
+// releases the file if it is empty
+static void _PartitionRewind
+(
+	HashJoinPartition *p
 ) {
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
-	uint record_count = array_len(op->cached_records);
+	if(p->spill == NULL) return;
+
+	p->writable = false;
+	if(RecordSpill_Count(p->spill) == 0) {
+		RecordSpill_Free(p->spill);
+		p->spill = NULL;
+	} else if(!RecordSpill_Rewind(p->spill)) {
+		ErrorCtx_RaiseRuntimeException("Failed to read spilled records");
+	}
+}
+
+// reads the next record from partition
+// returns NULL once the partition is depleted
+static Record _PartitionNext
+(
+	HashJoinPartition *p
+) {
+	if(p->spill != NULL) {
+		Record r = ExecutionPlan_BorrowRecord(p->owner);
+		if(RecordSpill_Read(p->spill, r)) return r;
+
+		OpBase_DeleteRecord(r);
+		RecordSpill_Free(p->spill);
+		p->spill = NULL;
+	}
+
+	if(array_len(p->records) > 0) return array_pop(p->records);
+	return NULL;
+}
+
+// loads the current left hand side partition into the hash table
+static void _LoadPartition
+(
+	OpValueHashJoin *op
+) {
+	HashJoinPartition *lhs = op->lhs_partitions + op->partition;
+	HashJoinPartition *rhs = op->rhs_partitions + op->partition;
+
+	_PartitionRewind(lhs);
+	_PartitionRewind(rhs);
+
+	Record r;
+	while((r = _PartitionNext(lhs))) array_append(op->cached_records, r);
+	_BuildTable(op, NULL);
+
+	// right hand side records can't intersect an empty partition
+	if(array_len(op->cached_records) == 0) {
+		while((r = _PartitionNext(rhs))) OpBase_DeleteRecord(r);
+	}
+}
+
+// returns true if cached records should be spilled to disk
+static inline bool _ShouldSpill
+(
+	OpValueHashJoin *op
+) {
+	if(!op->spill) return false;
+	if(array_len(op->cached_records) < VALUE_HASH_JOIN_MIN_SPILL) return false;
+
+	int64_t cap = rm_mem_capacity();
+	if(cap <= 0) return false;
+
+	return (rm_n_alloced() - op->mem_base) > (cap / VALUE_HASH_JOIN_SPILL_MEM_FRACTION);
+}
 
-	uint leftmost_idx  = 0;
-	uint rightmost_idx = 0;
+// partitions cached records by hash and writes them to disk
+// from here on both sides of the join are partitioned and
+// joined one partition at a time
+static void _SpillCachedRecords
+(
+	OpValueHashJoin *op,
+	const uint64_t *hashes
+) {
+	HashJoinPartition *partitions = _NewPartitions(true);
+	if(partitions == NULL) {
+		op->spill = false;
+		return;
+	}
 
-	if(!_binarySearchLeftmost(&leftmost_idx, op->cached_records,
-				array_len(op->cached_records), op->join_value_rec_idx, v)) {
-		return false;
+	uint n = array_len(op->cached_records);
+	for(uint i = 0; i < n; i++) {
+		_PartitionAdd(partitions, hashes[i], op->cached_records[i]);
 	}
+	array_clear(op->cached_records);
 
-	// value was found
-	// idx points to the first intersecting record
-	// update number_of_intersections to count how many
-	// records share the same value
-	op->intersect_idx = leftmost_idx;
-
-	// count how many records share the same node
-	// reduce search space by truncating left bound
-	bool found = _binarySearchRightmost(&rightmost_idx,
-			op->cached_records + leftmost_idx, record_count - leftmost_idx,
-			op->join_value_rec_idx, v);
-	UNUSED(found);
-	ASSERT(found == true);
-
-	// compensate index
-	rightmost_idx += leftmost_idx;
-	// +1 consider rightmost_idx == leftmost_idx
-	op->number_of_intersections = rightmost_idx - leftmost_idx + 1;
-	ASSERT(op->number_of_intersections > 0);
-
-	return true;
+	op->lhs_partitions = partitions;
+	op->rhs_partitions = _NewPartitions(true);
+	if(op->rhs_partitions == NULL) op->rhs_partitions = _NewPartitions(false);
 }
 
-// sorts cached records by joined value
-void _sort_cached_records
+// partitions all records coming from the right branch
+static void _PartitionProbeSide
 (
 	OpValueHashJoin *op
 ) {
-	uint idx = op->join_value_rec_idx;
-	sort_r(
-			op->cached_records,
-			array_len(op->cached_records),
-			sizeof(Record),
-			(int(*)(const void*, const void*, void*))_record_cmp,
-			&idx
-		);
+	OpBase *right_child = op->op.children[1];
+
+	Record r;
+	while((r = right_child->consume(right_child))) {
+		SIValue v = AR_EXP_Evaluate(op->rhs_exp, r);
+
+		uint64_t h = 0;
+		bool candidate = !SIValue_IsNull(v);
+		if(candidate) {
+			h = _HashValue(v);
+			candidate = _BloomContains(op, h);
+		}
+		SIValue_Free(v);
+
+		if(candidate) _PartitionAdd(op->rhs_partitions, h, r);
+		else OpBase_DeleteRecord(r);
+	}
 }
 
+//------------------------------------------------------------------------------
+// join
+//------------------------------------------------------------------------------
+
 // caches all records coming from left branch
 void _cache_records
 (
@@ -176,27 +434,112 @@ void _cache_records
 ) {
 	ASSERT(op->cached_records == NULL);
 
+	// spilled records are re-fetched from the graph,
+	// which must not change while the query runs
+	AST *ast = QueryCtx_GetAST();
+	op->spill    = (ast != NULL && AST_ReadOnly(ast->root));
+	op->mem_base = rm_n_alloced();
+
 	OpBase *left_child = op->op.children[0];
 	op->cached_records = array_new(Record, 32);
-
-	Record r = left_child->consume(left_child);
-	if(!r) return;
+	uint64_t *hashes   = array_new(uint64_t, 32);
 
 	// as long as there's data coming in from left branch
-	do {
+	Record r;
+	while((r = left_child->consume(left_child))) {
 		// evaluate joined expression
 		SIValue v = AR_EXP_Evaluate(op->lhs_exp, r);
 
 		// if the joined value is NULL
 		// it cannot be compared to other values - skip this record
-		if(SIValue_IsNull(v)) continue;
+		if(SIValue_IsNull(v)) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
 
 		// add joined value to record
 		Record_AddScalar(r, op->join_value_rec_idx, v);
 
+		uint64_t h = _HashValue(v);
+		array_append(hashes, h);
+
+		if(op->lhs_partitions != NULL) {
+			_PartitionAdd(op->lhs_partitions, h, r);
+			continue;
+		}
+
 		// cache the record
 		array_append(op->cached_records, r);
-	} while((r = left_child->consume(left_child)));
+		if(_ShouldSpill(op)) _SpillCachedRecords(op, hashes);
+	}
+
+	_BloomBuild(op, hashes, array_len(hashes));
+
+	if(op->lhs_partitions == NULL) {
+		_BuildTable(op, hashes);
+	} else {
+		_PartitionProbeSide(op);
+		_LoadPartition(op);
+	}
+
+	array_free(hashes);
+}
+
+// pulls the next right hand side record
+// either from the right branch or from the right hand side partitions
+static Record _NextProbeRecord
+(
+	OpValueHashJoin *op
+) {
+	if(op->rhs_partitions == NULL) {
+		OpBase *right_child = op->op.children[1];
+		return right_child->consume(right_child);
+	}
+
+	while(op->partition < VALUE_HASH_JOIN_PARTITIONS) {
+		Record r = _PartitionNext(op->rhs_partitions + op->partition);
+		if(r != NULL) return r;
+
+		// partition depleted, move on to the next partition
+		_ClearTable(op);
+		op->partition++;
+		if(op->partition < VALUE_HASH_JOIN_PARTITIONS) _LoadPartition(op);
+	}
+
+	return NULL;
+}
+
+// look up cached records intersecting with 'v'
+// returns false if no intersecting record is found
+static bool _set_intersection
+(
+	OpValueHashJoin *op,
+	SIValue v
+) {
+	op->intersect = NO_RECORD;
+	if(SIValue_IsNull(v)) return false;
+
+	uint64_t h = _HashValue(v);
+	if(!_BloomContains(op, h)) return false;
+
+	op->intersect = _Lookup(op, h, v)->head;
+	return op->intersect != NO_RECORD;
+}
+
+// merges the next intersecting cached record with the right hand side record
+static Record _next_intersection
+(
+	OpValueHashJoin *op
+) {
+	ASSERT(op->intersect != NO_RECORD);
+
+	Record l = op->cached_records[op->intersect];
+	op->intersect = op->chain[op->intersect];
+
+	// clone cached record before merging rhs
+	Record c = OpBase_CloneRecord(l);
+	Record_Merge(c, op->rhs_rec);
+	return c;
 }
 
 // string representation of operation
@@ -236,12 +579,21 @@ OpBase *NewValueHashJoin
 ) {
 	OpValueHashJoin *op = rm_malloc(sizeof(OpValueHashJoin));
 
-	op->rhs_rec                 = NULL;
-	op->lhs_exp                 = lhs_exp;
-	op->rhs_exp                 = rhs_exp;
-	op->intersect_idx           = -1;
-	op->cached_records          = NULL;
-	op->number_of_intersections = 0;
+	op->rhs_rec        = NULL;
+	op->lhs_exp        = lhs_exp;
+	op->rhs_exp        = rhs_exp;
+	op->cached_records = NULL;
+	op->chain          = NULL;
+	op->buckets        = NULL;
+	op->bucket_mask    = 0;
+	op->bloom          = NULL;
+	op->bloom_mask     = 0;
+	op->intersect      = NO_RECORD;
+	op->spill          = false;
+	op->mem_base       = 0;
+	op->lhs_partitions = NULL;
+	op->rhs_partitions = NULL;
+	op->partition      = 0;
 
 	// set our Op operations
 	OpBase_Init((OpBase *)op, OPType_VALUE_HASH_JOIN, "Value Hash Join",
@@ -261,14 +613,10 @@ static Record ValueHashJoinConsume
 	OpBase *opBase
 ) {
 	OpValueHashJoin *op = (OpValueHashJoin *)opBase;
-	OpBase *right_child = op->op.children[1];
 
 	// eager, pull from left branch until depleted
-	if(op->cached_records == NULL) {
-		_cache_records(op);
-		// sort cache on intersect node ID
-		_sort_cached_records(op);
-	}
+	// and build a hash table over the joined values
+	if(op->cached_records == NULL) _cache_records(op);
 
 	// try to produce a record:
 	// given a right hand side record R,
@@ -279,74 +627,80 @@ static Record ValueHashJoinConsume
 	// return merged record:
 	// X merged with R
 
-	Record l;
-	if(op->number_of_intersections > 0) {
-		while((l = _get_intersecting_record(op))) {
-			// clone cached record before merging rhs
-			Record c = OpBase_CloneRecord(l);
-			Record_Merge(c, op->rhs_rec);
-			return c;
-		}
-	}
+	if(op->intersect != NO_RECORD) return _next_intersection(op);
 
 	// if we're here there are no more
 	// left hand side records which intersect with R
 	// discard R
-	if(op->rhs_rec) OpBase_DeleteRecord(op->rhs_rec);
+	if(op->rhs_rec) {
+		OpBase_DeleteRecord(op->rhs_rec);
+		op->rhs_rec = NULL;
+	}
 
 	// try to get new right hand side record
 	// which intersect with a left hand side record
 	while(true) {
-		// pull from right branch
-		op->rhs_rec = right_child->consume(right_child);
+		op->rhs_rec = _NextProbeRecord(op);
 		if(!op->rhs_rec) return NULL;
 
 		// get value on which we're intersecting
 		SIValue v = AR_EXP_Evaluate(op->rhs_exp, op->rhs_rec);
 
-		bool found_intersection = _set_intersection_idx(op, v);
+		bool found_intersection = _set_intersection(op, v);
 		SIValue_Free(v);
+
 		// no intersection, discard R
 		if(!found_intersection) {
 			OpBase_DeleteRecord(op->rhs_rec);
+			op->rhs_rec = NULL;
 			continue;
 		}
 
 		// found atleast one intersecting record
-		l = _get_intersecting_record(op);
-
-		// clone cached record before merging rhs
-		Record c = OpBase_CloneRecord(l);
-		Record_Merge(c, op->rhs_rec);
-
-		return c;
+		return _next_intersection(op);
 	}
 }
 
-static OpResult ValueHashJoinReset
+// releases all cached and partitioned records
+static void _ReleaseRecords
 (
-	OpBase *ctx
+	OpValueHashJoin *op
 ) {
-	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
-
-	// clear cached records
 	if(op->rhs_rec) {
 		OpBase_DeleteRecord(op->rhs_rec);
 		op->rhs_rec = NULL;
 	}
 
+	_ClearTable(op);
 	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
 		array_free(op->cached_records);
 		op->cached_records = NULL;
 	}
 
+	if(op->bloom) {
+		rm_free(op->bloom);
+		op->bloom = NULL;
+	}
+
+	if(op->lhs_partitions) {
+		_FreePartitions(op->lhs_partitions);
+		op->lhs_partitions = NULL;
+	}
+
+	if(op->rhs_partitions) {
+		_FreePartitions(op->rhs_partitions);
+		op->rhs_partitions = NULL;
+	}
+
+	op->partition = 0;
+}
+
+static OpResult ValueHashJoinReset
+(
+	OpBase *ctx
+) {
+	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
+	_ReleaseRecords(op);
 	return OP_OK;
 }
 
@@ -364,21 +718,9 @@ static inline OpBase *ValueHashJoinClone
 // frees ValueHashJoin
 static void ValueHashJoinFree(OpBase *ctx) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	// free cached records
-	if(op->rhs_rec) {
-		OpBase_DeleteRecord(op->rhs_rec);
-		op->rhs_rec = NULL;
-	}
 
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	// free cached records
+	_ReleaseRecords(op);
 
 	if(op->lhs_exp) {
 		AR_EXP_Free(op->lhs_exp);
@@ -390,4 +732,3 @@ static void ValueHashJoinFree(OpBase *ctx) {
 		op->rhs_exp = NULL;
 	}
 }
-
@@ -7,18 +7,53 @@
 #pragma once
 
 #include "op.h"
+#include "../record_spill.h"
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+// number of partitions cached records are split into once spilled to disk
+#define VALUE_HASH_JOIN_PARTITIONS 16
+
+// minimum number of cached records before partitions are spilled to disk
+#define VALUE_HASH_JOIN_MIN_SPILL 1024
+
+// cached records are spilled once the memory consumed while caching them
+// exceeds 1/VALUE_HASH_JOIN_SPILL_MEM_FRACTION of the query memory capacity
+#define VALUE_HASH_JOIN_SPILL_MEM_FRACTION 4
+
+// hash table bucket, one per distinct joined value
+typedef struct {
+	uint64_t hash;  // joined value hash
+	uint head;      // first cached record holding the value
+} HashJoinBucket;
+
+// a partition of either side of the join
+// records which can't be written to disk remain in memory
+typedef struct {
+	RecordSpill *spill;  // records written to disk
+	void *owner;         // execution plan owning the spilled records
+	bool writable;       // records can be appended to the spill file
+	Record *records;     // in-memory records
+} HashJoinPartition;
+
 typedef struct {
 	OpBase op;
 	Record rhs_rec;                     // Right hand side record.
 	AR_ExpNode *lhs_exp;                // Left hand side expression to join on.
 	AR_ExpNode *rhs_exp;                // Right hand side expression to join on.
-	int64_t intersect_idx;              // Current intersection, < number_of_intersections
 	Record *cached_records;             // Cached left hand side records.
+	uint *chain;                        // Next cached record holding the same value.
+	HashJoinBucket *buckets;            // Open addressing table over cached records.
+	uint64_t bucket_mask;               // Number of buckets - 1.
+	uint64_t *bloom;                    // Bloom filter over all joined values.
+	uint64_t bloom_mask;                // Number of bloom filter bits - 1.
+	uint intersect;                     // Next intersecting cached record.
 	uint join_value_rec_idx;            // position on joined expression within record.
-	int64_t number_of_intersections;    // Number of intersections located.
+	bool spill;                         // Cached records can be spilled to disk.
+	int64_t mem_base;                   // Memory consumption when caching began.
+	HashJoinPartition *lhs_partitions;  // Left hand side partitions, NULL if in memory.
+	HashJoinPartition *rhs_partitions;  // Right hand side partitions.
+	uint partition;                     // Partition currently joined.
 } OpValueHashJoin;
 
 /* Creates a new ValueHashJoin operation */
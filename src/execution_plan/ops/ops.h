@@ -16,6 +16,7 @@
 #include "op_create.h"
 #include "op_delete.h"
 #include "op_filter.h"
+#include "op_gather.h"
 #include "op_update.h"
 #include "op_unwind.h"
 #include "op_results.h"
@@ -27,6 +28,7 @@
 #include "op_aggregate.h"
 #include "op_semi_apply.h"
 #include "op_expand_into.h"
+#include "op_leapfrog_join.h"
 #include "op_merge_create.h"
 #include "op_argument_list.h"
 #include "op_all_node_scan.h"
@@ -33,4 +33,5 @@ void reduceCount(ExecutionPlan *plan);
 void applyLimit(ExecutionPlan *plan);
 void applySkip(ExecutionPlan *plan);
 void optimizeLabelScan(ExecutionPlan *plan);
+void parallelizeScans(ExecutionPlan *plan);
 
@@ -74,6 +74,14 @@ static void _optimizeLabelScan(NodeByLabelScan *scan) {
 	// patch following traversal, skip filters
 	OpBase *parent = op->parent;
 	while(OpBase_Type(parent) == OPType_FILTER) parent = parent->parent;
+
+	// leapfrog join verifies all of the node's labels, no patching required
+	if(OpBase_Type(parent) == OPType_LEAPFROG_JOIN) {
+		scan->n.label    = min_label_str;
+		scan->n.label_id = min_label_id;
+		return;
+	}
+
 	ASSERT(OpBase_Type(parent) == OPType_CONDITIONAL_TRAVERSE);
 
 	OpCondTraverse *op_traverse = (OpCondTraverse*)parent;
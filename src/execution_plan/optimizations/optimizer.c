@@ -60,5 +60,8 @@ void optimizePlan(ExecutionPlan *plan) {
 
 	// let operations know about specified skip(s)
 	applySkip(plan);
+
+	// split scans followed by filters across worker threads
+	parallelizeScans(plan);
 }
 
@@ -0,0 +1,76 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "../../query_ctx.h"
+#include "../ops/op_gather.h"
+#include "../../util/thpool/pools.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+// this optimization parallelizes node scans followed by filters
+// e.g. MATCH (n:Person) WHERE n.age > 30 RETURN count(n)
+//
+// Aggregate
+//     Filter
+//         Node By Label Scan
+//
+// the scan and its filters are placed under a gather operation
+// which splits the scanned ID range into morsels processed by worker threads
+//
+// Aggregate
+//     Gather
+//         Filter
+//             Node By Label Scan
+//
+// only read-only queries are parallelized
+
+static void _parallelizeScan
+(
+	OpBase *scan
+) {
+	// scan must be a tap
+	if(scan->childCount > 0) return;
+
+	// locate the topmost filter applied on scanned nodes
+	OpBase *top = scan;
+	while(top->parent != NULL &&
+		  top->parent->type == OPType_FILTER &&
+		  top->parent->plan == scan->plan) {
+		top = top->parent;
+	}
+
+	// nothing to gain from parallelizing an unfiltered scan
+	if(top == scan) return;
+
+	OpBase *gather = NewGatherOp(scan->plan);
+	ExecutionPlan_PushBelow(top, gather);
+}
+
+void parallelizeScans
+(
+	ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	// parallelism requires at least two workers
+	if(ThreadPools_WorkersCount() < 2) return;
+
+	// write queries are executed as-is
+	AST *ast = QueryCtx_GetAST();
+	if(ast == NULL || !AST_ReadOnly(ast->root)) return;
+
+	OPType types[3] = {
+		OPType_ALL_NODE_SCAN,
+		OPType_NODE_BY_LABEL_SCAN,
+		OPType_NODE_BY_LABEL_AND_ID_SCAN
+	};
+	OpBase **scans = ExecutionPlan_CollectOpsMatchingType(plan->root, types, 3);
+
+	uint scan_count = array_len(scans);
+	for(uint i = 0; i < scan_count; i++) _parallelizeScan(scans[i]);
+
+	array_free(scans);
+}
@@ -4,9 +4,12 @@
  * the Server Side Public License v1 (SSPLv1).
  */
 
+#include "../../query_ctx.h"
+#include "../../util/arr.h"
 #include "../ops/op_filter.h"
 #include "../../filter_tree/filter_tree.h"
 #include "../../ast/ast_build_filter_tree.h"
+#include "../../filter_tree/filter_tree_selectivity.h"
 
 /* The reduce filters optimizer scans an execution plans for
  * consecutive filter operations, these can be reduced down into
@@ -14,11 +17,77 @@
  * Reducing the overall number of operations is expected to produce
  * faster execution time. */
 
+// estimate the fraction of records passing 'tree'
+// only filters applied to a single labeled node are estimated
+// all other filters are considered to pass every record
+static double _FilterSelectivity
+(
+	const OpBase *op,
+	const FT_FilterNode *tree
+) {
+	double sel = 1;
+	QueryGraph *qg = op->plan->query_graph;
+	if(qg == NULL) return sel;
+
+	rax *modified = FilterTree_CollectModified(tree);
+	if(raxSize(modified) == 1) {
+		raxIterator it;
+		raxStart(&it, modified);
+		raxSeek(&it, "^", NULL, 0);
+		raxNext(&it);
+
+		char alias[it.key_len + 1];
+		memcpy(alias, it.key, it.key_len);
+		alias[it.key_len] = '\0';
+		raxStop(&it);
+
+		QGNode *n = QueryGraph_GetNodeByAlias(qg, alias);
+		if(n != NULL) {
+			double estimate;
+			if(FilterTree_EstimateSelectivity(tree, alias,
+						QueryCtx_GetGraphCtx(), n->labels,
+						QGNode_LabelCount(n), &estimate)) {
+				sel = estimate;
+			}
+		}
+	}
+
+	raxFree(modified);
+	return sel;
+}
+
+// order filter trees such that the most selective trees are evaluated first
+// trees without an estimate retain their relative order
+static void _OrderFilters
+(
+	const OpBase *op,
+	FT_FilterNode **trees
+) {
+	uint count = array_len(trees);
+	double sel[count];
+	for(uint i = 0; i < count; i++) sel[i] = _FilterSelectivity(op, trees[i]);
+
+	// stable insertion sort, number of trees is small
+	for(uint i = 1; i < count; i++) {
+		double s = sel[i];
+		FT_FilterNode *t = trees[i];
+		int j = i - 1;
+		while(j >= 0 && sel[j] > s) {
+			sel[j + 1]   = sel[j];
+			trees[j + 1] = trees[j];
+			j--;
+		}
+		sel[j + 1]   = s;
+		trees[j + 1] = t;
+	}
+}
+
 void _reduceFilter(OpBase *op) {
 	OpBase *parent = op;
 	OpFilter *filter = (OpFilter *)parent;
-	FT_FilterNode *tree = filter->filterTree;
 	OpBase *child = NULL;
+	FT_FilterNode **trees = array_new(FT_FilterNode *, 1);
+	array_append(trees, filter->filterTree);
 
 	/* Filter operation is promised to have only one child. */
 	while(parent->childCount == 1) {
@@ -26,19 +95,27 @@ void _reduceFilter(OpBase *op) {
 		if(child->type != OPType_FILTER) break;
 
 		OpFilter *childFilter = (OpFilter *)child;
-
-		/* Create a new root for the tree, merge trees using an AND. */
-		FT_FilterNode *root = FilterTree_CreateConditionFilter(OP_AND);
-		FilterTree_AppendLeftChild(root, tree);
-		FilterTree_AppendRightChild(root, childFilter->filterTree);
-		tree = root;
+		array_append(trees, childFilter->filterTree);
 
 		// Proceed.
 		parent = child;
 	}
 
 	// Did we performed a reduction?
-	if(filter->filterTree != tree) {
+	uint tree_count = array_len(trees);
+	if(tree_count > 1) {
+		// evaluate the most selective filters first
+		_OrderFilters(op, trees);
+
+		/* Create a new root for the tree, merge trees using an AND. */
+		FT_FilterNode *tree = trees[0];
+		for(uint i = 1; i < tree_count; i++) {
+			FT_FilterNode *root = FilterTree_CreateConditionFilter(OP_AND);
+			FilterTree_AppendLeftChild(root, tree);
+			FilterTree_AppendRightChild(root, trees[i]);
+			tree = root;
+		}
+
 		filter->filterTree = tree;
 		// Remove intermidate filter ops.
 		OpBase *intermidateChild = child->parent;
@@ -56,6 +133,8 @@ void _reduceFilter(OpBase *op) {
 		child->parent = op;
 		op->children[0] = child;
 	}
+
+	array_free(trees);
 }
 
 void _reduceFilters(OpBase *op) {
@@ -7,8 +7,10 @@
 #include "RG.h"
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
+#include "../../query_ctx.h"
 #include "../../arithmetic/algebraic_expression/utils.h"
 #include "traverse_order_utils.h"
+#include "traverse_order_cost.h"
 
 #include <stdlib.h>
 
@@ -268,6 +270,14 @@ void orderExpressions
 		AlgebraicExpression_Transpose(exps);
 	}
 
+	// replace the heuristic arrangement if the cost model,
+	// based on the graph's statistics, finds a considerably cheaper one
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	if(TraverseOrder_CostBasedArrangement(exps, _exp_count, gc, qg, ft,
+				filtered_entities, bound_vars)) {
+		_resolve_winning_sequence(exps, _exp_count);
+	}
+
 	// remove redundent operands from expressions
 	// MATCH (a:A)-[:R]->(b:B), (a)-[:R]->(c:C), (a:A)-[:R]->(d:D)
 	// will result in 2 expressions:
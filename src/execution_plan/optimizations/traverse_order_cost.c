@@ -0,0 +1,470 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+#include "../../filter_tree/filter_tree_selectivity.h"
+#include "../../arithmetic/algebraic_expression/utils.h"
+#include "traverse_order_cost.h"
+
+#include <math.h>
+
+// maximum number of distinct nodes referenced by arranged expressions
+#define MAX_COST_NODES (2 * TRAVERSE_ORDER_MAX_COST_EXPS)
+
+typedef struct {
+	const GraphContext *gc;          // graph context
+	const QueryGraph *qg;            // query graph
+	const FT_FilterNode *ft;         // filters applied to the pattern
+	rax *filtered_entities;          // map of filtered entities
+	rax *bound_vars;                 // map of bounded entities
+	double N;                        // number of nodes in the graph
+	uint node_count;                 // number of distinct nodes
+	const char *nodes[MAX_COST_NODES];  // distinct node aliases
+	double card[MAX_COST_NODES];     // estimated number of matching nodes
+	double lcard[MAX_COST_NODES];    // number of nodes matching labels alone
+	double work[MAX_COST_NODES];     // number of nodes visited when resolved
+	uint src[TRAVERSE_ORDER_MAX_COST_EXPS];    // expression source node
+	uint dest[TRAVERSE_ORDER_MAX_COST_EXPS];   // expression destination node
+	double sel[TRAVERSE_ORDER_MAX_COST_EXPS];  // expression selectivity
+} CostModel;
+
+// returns the index of 'alias' within the model's nodes, adding it if missing
+static uint _CostModel_NodeIdx
+(
+	CostModel *m,
+	const char *alias
+) {
+	for(uint i = 0; i < m->node_count; i++) {
+		if(strcmp(m->nodes[i], alias) == 0) return i;
+	}
+
+	ASSERT(m->node_count < MAX_COST_NODES);
+	m->nodes[m->node_count] = alias;
+	return m->node_count++;
+}
+
+// fraction of entities expected to pass the filters applied to 'alias'
+// filters applied to a labeled node are estimated from the labels'
+// attribute statistics when available
+static double _FilterSelectivity
+(
+	const CostModel *m,
+	const char *alias,
+	const QGNode *n
+) {
+	if(m->filtered_entities == NULL) return 1;
+
+	void *frequency = raxFind(m->filtered_entities, (unsigned char *)alias,
+			strlen(alias));
+	if(frequency == raxNotFound) return 1;
+
+	// filtered only in combination with other entities
+	int64_t independent = (int64_t)frequency;
+	if(independent == 0) return TRAVERSE_ORDER_DEPENDENT_FILTER_SELECTIVITY;
+
+	double sel = 1;
+	if(n != NULL && QGNode_LabelCount(n) > 0 && m->ft != NULL) {
+		const FT_FilterNode **sub_trees = FilterTree_SubTrees(m->ft);
+		uint sub_tree_count = array_len(sub_trees);
+
+		for(uint i = 0; i < sub_tree_count; i++) {
+			const FT_FilterNode *t = sub_trees[i];
+
+			// consider filters applied solely to 'alias'
+			rax *modified = FilterTree_CollectModified(t);
+			bool independent_filter = raxSize(modified) == 1 &&
+				raxFind(modified, (unsigned char *)alias, strlen(alias))
+				!= raxNotFound;
+			raxFree(modified);
+			if(!independent_filter) continue;
+
+			double estimate;
+			if(FilterTree_EstimateSelectivity(t, alias, (GraphContext *)m->gc,
+						n->labels, QGNode_LabelCount(n), &estimate)) {
+				sel *= estimate;
+				independent--;
+			}
+		}
+
+		array_free(sub_trees);
+	}
+
+	return sel * pow(TRAVERSE_ORDER_FILTER_SELECTIVITY, MIN(independent, 3));
+}
+
+static double _LabelCount
+(
+	const CostModel *m,
+	const char *label
+) {
+	Schema *s = GraphContext_GetSchema(m->gc, label, SCHEMA_NODE);
+	if(s == NULL) return 0;
+	return Graph_LabeledNodeCount(m->gc->g, Schema_GetID(s));
+}
+
+static double _RelationCount
+(
+	const CostModel *m,
+	const char *relation
+) {
+	// no relationship type, traverse the adjacency matrix
+	if(relation == NULL) return Graph_EdgeCount(m->gc->g);
+
+	Schema *s = GraphContext_GetSchema(m->gc, relation, SCHEMA_EDGE);
+	if(s == NULL) return 0;
+	return Graph_RelationEdgeCount(m->gc->g, Schema_GetID(s));
+}
+
+// returns true if 'exp' is a diagonal operand
+static inline bool _Diagonal
+(
+	const AlgebraicExpression *exp
+) {
+	return (exp->type == AL_OPERAND && exp->operand.diagonal);
+}
+
+// estimate number of entries in the matrix computed by 'exp'
+// the product of two relation matrices with a and b entries is assumed to
+// hold a * b / N entries, i.e. each entry is extended by the average degree
+// relationship types usually connect specific labels, as such multiplying
+// a relation by a label operand keeps the relation's entries, bounded by
+// the number of entries the labeled rows (or columns) can hold
+static double _Entries
+(
+	const CostModel *m,
+	const AlgebraicExpression *exp
+) {
+	double N = m->N;
+
+	if(exp->type == AL_OPERAND) {
+		if(exp->operand.diagonal) {
+			// unlabeled diagonal operand is the identity matrix
+			const char *label = exp->operand.label;
+			return (label == NULL) ? N : _LabelCount(m, label);
+		}
+		return _RelationCount(m, exp->operand.label);
+	}
+
+	uint child_count = AlgebraicExpression_ChildCount(exp);
+	double entries = _Entries(m, CHILD_AT(exp, 0));
+
+	switch(exp->operation.op) {
+		case AL_EXP_MUL:
+		{
+			bool diagonal = _Diagonal(CHILD_AT(exp, 0));
+			for(uint i = 1; i < child_count; i++) {
+				AlgebraicExpression *child = CHILD_AT(exp, i);
+				double child_entries = _Entries(m, child);
+				if(diagonal && _Diagonal(child)) {
+					// labels are assumed to be independent of one another
+					entries = entries * child_entries / N;
+				} else if(_Diagonal(child)) {
+					entries = MIN(entries, child_entries * N);
+				} else if(diagonal) {
+					entries = MIN(child_entries, entries * N);
+				} else {
+					entries = entries * child_entries / N;
+				}
+				diagonal = diagonal && _Diagonal(child);
+			}
+			break;
+		}
+		case AL_EXP_ADD:
+			for(uint i = 1; i < child_count; i++) {
+				entries += _Entries(m, CHILD_AT(exp, i));
+			}
+			break;
+		default:
+			// transpose doesn't change the number of entries
+			break;
+	}
+
+	return MIN(entries, N * N);
+}
+
+// estimate number of paths computed by a variable length traversal
+// each hop from a node leads to 'degree' nodes on average
+static double _VarLenEntries
+(
+	const CostModel *m,
+	const AlgebraicExpression *exp,
+	const QGEdge *e
+) {
+	double N      = m->N;
+	double degree = _Entries(m, exp) / N;
+	uint   lo     = MAX(e->minHops, 1);
+	uint   hi     = MIN(e->maxHops, TRAVERSE_ORDER_MAX_VAR_LEN_HOPS);
+
+	// zero length paths lead back to the source node
+	double entries = (e->minHops == 0) ? N : 0;
+	for(uint k = lo; k <= hi; k++) entries += N * pow(degree, k);
+
+	return MIN(entries, N * N);
+}
+
+static void _CostModel_Init
+(
+	CostModel *m,
+	AlgebraicExpression **exps,
+	uint nexp
+) {
+	double N = m->N;
+	m->node_count = 0;
+
+	for(uint i = 0; i < nexp; i++) {
+		m->src[i]  = _CostModel_NodeIdx(m, AlgebraicExpression_Src(exps[i]));
+		m->dest[i] = _CostModel_NodeIdx(m, AlgebraicExpression_Dest(exps[i]));
+	}
+
+	// estimate the number of nodes matching each query node
+	// labels are assumed to be independent of one another
+	for(uint i = 0; i < m->node_count; i++) {
+		const char *alias = m->nodes[i];
+		QGNode *n = QueryGraph_GetNodeByAlias(m->qg, alias);
+		ASSERT(n != NULL);
+
+		double lcard = N;
+		uint label_count = QGNode_LabelCount(n);
+		for(uint j = 0; j < label_count; j++) {
+			lcard *= _LabelCount(m, QGNode_GetLabel(n, j)) / N;
+		}
+		lcard = MAX(lcard, 1);
+		m->lcard[i] = lcard;
+
+		// a bound node is resolved to a single node per record
+		// other nodes are all visited, filters reduce the number of
+		// nodes passed on
+		if(m->bound_vars != NULL &&
+		   raxFind(m->bound_vars, (unsigned char *)alias, strlen(alias))
+		   != raxNotFound) {
+			m->work[i] = 1;
+			m->card[i] = 1;
+		} else {
+			m->work[i] = lcard;
+			m->card[i] = MAX(lcard * _FilterSelectivity(m, alias, n), 1);
+		}
+	}
+
+	// estimate the fraction of (src, dest) pairs connected by each expression
+	for(uint i = 0; i < nexp; i++) {
+		AlgebraicExpression *exp = exps[i];
+		const char *edge = AlgebraicExpression_Edge(exp);
+		QGEdge *e = (edge != NULL) ? QueryGraph_GetEdgeByAlias(m->qg, edge) : NULL;
+
+		double sel;
+		if(e != NULL && QGEdge_VariableLength(e)) {
+			// variable length expressions don't include their endpoints' labels
+			sel = _VarLenEntries(m, exp, e) / (N * N);
+		} else if(edge == NULL && m->src[i] == m->dest[i]) {
+			// label expression, accounted for by its node's cardinality
+			sel = 1;
+		} else {
+			double src_card  = m->lcard[m->src[i]];
+			double dest_card = m->lcard[m->dest[i]];
+			sel = _Entries(m, exp) / (src_card * dest_card);
+		}
+
+		if(edge != NULL) sel *= _FilterSelectivity(m, edge, NULL);
+		m->sel[i] = sel;
+	}
+}
+
+// returns true if expression 'i' shares a node with the nodes in 'nodes'
+static inline bool _Connected
+(
+	const CostModel *m,
+	uint i,
+	uint64_t nodes
+) {
+	return (nodes & (1ULL << m->src[i])) || (nodes & (1ULL << m->dest[i]));
+}
+
+// evaluate expression 'i' on 'rows' records resolving 'nodes'
+// returns the number of records produced after applying filters
+// and sets 'work' to the number of records produced prior to filtering
+static inline double _Step
+(
+	const CostModel *m,
+	uint i,
+	uint64_t nodes,
+	double rows,
+	double *work
+) {
+	uint src  = m->src[i];
+	uint dest = m->dest[i];
+
+	rows  *= m->sel[i];
+	*work = rows;
+
+	if(!(nodes & (1ULL << src))) {
+		*work *= m->work[src];
+		rows  *= m->card[src];
+	}
+	if(dest != src && !(nodes & (1ULL << dest))) {
+		*work *= m->work[dest];
+		rows  *= m->card[dest];
+	}
+
+	return rows;
+}
+
+// cost of evaluating expression 'i' first, starting from node 'start'
+static inline double _Open
+(
+	const CostModel *m,
+	uint i,
+	uint start,
+	double *rows
+) {
+	double work;
+	*rows = _Step(m, i, 1ULL << start, m->card[start], &work);
+	return m->work[start] + work;
+}
+
+// estimated cost of evaluating expressions in order
+static double _ArrangementCost
+(
+	const CostModel *m,
+	uint nexp
+) {
+	// expressions are in model order
+	double rows;
+	double cost = _Open(m, 0, m->src[0], &rows);
+	uint64_t nodes = (1ULL << m->src[0]) | (1ULL << m->dest[0]);
+
+	for(uint i = 1; i < nexp; i++) {
+		double work;
+		rows = _Step(m, i, nodes, rows, &work);
+		nodes |= (1ULL << m->src[i]) | (1ULL << m->dest[i]);
+		cost += work;
+	}
+
+	return cost;
+}
+
+bool TraverseOrder_CostBasedArrangement
+(
+	AlgebraicExpression **exps,
+	uint nexp,
+	const GraphContext *gc,
+	const QueryGraph *qg,
+	const FT_FilterNode *ft,
+	rax *filtered_entities,
+	rax *bound_vars
+) {
+	ASSERT(gc   != NULL);
+	ASSERT(qg   != NULL);
+	ASSERT(exps != NULL);
+
+	if(nexp < 1 || nexp > TRAVERSE_ORDER_MAX_COST_EXPS) return false;
+
+	// statistics are meaningless for an empty graph
+	double N = Graph_NodeCount(gc->g);
+	if(N == 0) return false;
+
+	CostModel m;
+	m.N                 = N;
+	m.gc                = gc;
+	m.qg                = qg;
+	m.ft                = ft;
+	m.bound_vars        = bound_vars;
+	m.filtered_entities = filtered_entities;
+	_CostModel_Init(&m, exps, nexp);
+
+	// cost of the given arrangement
+	double given_cost = _ArrangementCost(&m, nexp);
+
+	//--------------------------------------------------------------------------
+	// dynamic programming over subsets of expressions
+	//--------------------------------------------------------------------------
+
+	// cost[S]  - minimal cost of evaluating the expressions in S
+	// rows[S]  - number of records produced by the expressions in S
+	// nodes[S] - nodes resolved by the expressions in S
+	// last[S]  - last expression evaluated in S's cheapest arrangement
+	uint64_t set_count = 1ULL << nexp;
+	double   *cost     = rm_malloc(sizeof(double) * set_count);
+	double   *rows     = rm_malloc(sizeof(double) * set_count);
+	uint64_t *nodes    = rm_malloc(sizeof(uint64_t) * set_count);
+	int      *last     = rm_malloc(sizeof(int) * set_count);
+
+	for(uint64_t s = 0; s < set_count; s++) {
+		cost[s] = INFINITY;
+		last[s] = -1;
+	}
+
+	// single expression sets, starting from the cheaper endpoint
+	for(uint i = 0; i < nexp; i++) {
+		uint64_t s = 1ULL << i;
+		double src_rows;
+		double dest_rows;
+		double src_cost  = _Open(&m, i, m.src[i], &src_rows);
+		double dest_cost = _Open(&m, i, m.dest[i], &dest_rows);
+
+		cost[s]  = MIN(src_cost, dest_cost);
+		rows[s]  = src_rows;
+		nodes[s] = (1ULL << m.src[i]) | (1ULL << m.dest[i]);
+		last[s]  = i;
+	}
+
+	// extend each reachable set by a connected expression
+	// subsets are visited before their supersets
+	for(uint64_t s = 1; s < set_count; s++) {
+		if(last[s] == -1) continue;
+		for(uint i = 0; i < nexp; i++) {
+			uint64_t bit = 1ULL << i;
+			if(s & bit) continue;
+			if(!_Connected(&m, i, nodes[s])) continue;
+
+			double work;
+			uint64_t t = s | bit;
+			double r = _Step(&m, i, nodes[s], rows[s], &work);
+			double c = cost[s] + work;
+			if(c < cost[t]) {
+				cost[t]  = c;
+				rows[t]  = r;
+				nodes[t] = nodes[s] | (1ULL << m.src[i]) | (1ULL << m.dest[i]);
+				last[t]  = i;
+			}
+		}
+	}
+
+	uint64_t full = set_count - 1;
+	bool rearrange = (last[full] != -1 &&
+			cost[full] < given_cost * TRAVERSE_ORDER_COST_RATIO);
+
+	if(rearrange) {
+		// reconstruct the cheapest arrangement backwards
+		int first = -1;
+		AlgebraicExpression *arrangement[nexp];
+		uint64_t s = full;
+		for(int pos = nexp - 1; pos >= 0; pos--) {
+			int i = last[s];
+			ASSERT(i != -1);
+			arrangement[pos] = exps[i];
+			s &= ~(1ULL << i);
+			first = i;
+		}
+		memcpy(exps, arrangement, nexp * sizeof(AlgebraicExpression *));
+
+		// start from the cheaper endpoint of the opening expression
+		double r;
+		if(_Open(&m, first, m.dest[first], &r) <
+		   _Open(&m, first, m.src[first], &r)) {
+			AlgebraicExpression_Transpose(exps);
+		}
+	}
+
+	rm_free(cost);
+	rm_free(rows);
+	rm_free(nodes);
+	rm_free(last);
+
+	return rearrange;
+}
+
@@ -0,0 +1,63 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../../graph/graphcontext.h"
+#include "../../graph/query_graph.h"
+#include "../../filter_tree/filter_tree.h"
+#include "../../arithmetic/algebraic_expression.h"
+#include "../../../deps/rax/rax.h"
+
+// maximum number of expressions arranged by the cost model
+// arrangements are enumerated over all 2^n subsets of expressions
+#define TRAVERSE_ORDER_MAX_COST_EXPS 12
+
+// the cost based arrangement replaces the given arrangement only if its
+// estimated cost is lower than TRAVERSE_ORDER_COST_RATIO of the given cost
+// as estimates are inaccurate, small differences are ignored
+#define TRAVERSE_ORDER_COST_RATIO 0.75
+
+// estimated fraction of entities passing a predicate applied
+// to a single entity, e.g. n.v = 1, when no statistics are available
+#define TRAVERSE_ORDER_FILTER_SELECTIVITY 0.1
+
+// estimated fraction of entities passing predicates which
+// depend on additional entities, e.g. n.v = m.v
+#define TRAVERSE_ORDER_DEPENDENT_FILTER_SELECTIVITY 0.5
+
+// maximum number of hops considered when estimating
+// the size of a variable length traversal
+#define TRAVERSE_ORDER_MAX_VAR_LEN_HOPS 3
+
+// rearranges expressions by a cost model
+// the cost of an arrangement is the sum of the estimated number of records
+// produced by each expression prior to filtering, starting with the number
+// of nodes scanned by the first expression
+//
+// the number of records produced by a set of expressions is independent of
+// the order in which they're evaluated, it is estimated from the number of
+// nodes with each label, the average degree of each relationship type,
+// the selectivity of filters and the presence of bound variables
+// filters are estimated from attribute statistics collected by
+// db.stats.analyze, falling back to a fixed selectivity per filter
+// the cheapest arrangement is found by dynamic programming over all
+// connected subsets of expressions
+//
+// 'exps' is rearranged and its first expression is transposed
+// if it is cheaper to start from its destination
+// returns true if 'exps' was modified
+bool TraverseOrder_CostBasedArrangement
+(
+	AlgebraicExpression **exps,  // expressions to arrange
+	uint nexp,                   // number of expressions
+	const GraphContext *gc,      // graph from which statistics are collected
+	const QueryGraph *qg,        // query graph
+	const FT_FilterNode *ft,     // filters applied to the pattern, optional
+	rax *filtered_entities,      // map of filtered entities
+	rax *bound_vars              // map of bounded entities
+);
+
@@ -20,10 +20,18 @@
 #include "../ops/op_conditional_traverse.h"
 #include "../../arithmetic/arithmetic_op.h"
 #include "../../filter_tree/filter_tree_utils.h"
+#include "../../filter_tree/filter_tree_selectivity.h"
 #include "../../arithmetic/algebraic_expression.h"
 #include "../../arithmetic/algebraic_expression/utils.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
+#include <math.h>
+
+// an index scan is not used if attribute statistics estimate its filters
+// to match more than this fraction of the label's nodes, in which case
+// scanning the label and filtering is cheaper
+#define INDEX_SCAN_MAX_SELECTIVITY 0.3
+
 //------------------------------------------------------------------------------
 // Filter normalization
 //------------------------------------------------------------------------------
@@ -299,9 +307,9 @@ void reduce_scan_op
 	QueryGraph   *qg  =  scan->op.plan->query_graph;
 
 	// find label with filtered indexed properties
-	// that has the minimum NNZ entries
+	// that has the minimum number of estimated matching entries
 	int         min_label_id;                 // tracks min label ID
-	uint64_t    min_nnz        = UINT64_MAX;  // tracks min entries
+	double      min_nnz        = INFINITY;    // tracks min entries
 	RSIndex     *rs_idx        = NULL;        // the index to be applied
 	OpFilter    **filters      = NULL;        // tracks indexed filters to apply
 	uint        filters_count  = 0;           // number of matching filters
@@ -315,7 +323,7 @@ void reduce_scan_op
 	uint label_count = QGNode_LabelCount(qn);
 	for(uint i = 0; i < label_count; i++) {
 		Index idx;
-		uint64_t nnz;
+		double nnz;
 		int label_id = QGNode_GetLabelID(qn, i);
 		const char *label = QGNode_GetLabel(qn, i);
 
@@ -334,9 +342,6 @@ void reduce_scan_op
 		// TODO switch to reusable array
 		OpFilter **cur_filters = _applicableFilters((OpBase *)scan, scan->n.alias, idx);
 
-		// TODO consider heuristic which combines max
-		// number / restrictiveness of applicable filters
-		// vs. the label's NNZ?
 		uint cur_filters_count = array_len(cur_filters);
 		if(cur_filters_count == 0) {
 			// no filters
@@ -344,7 +349,28 @@ void reduce_scan_op
 			continue;
 		}
 
-		nnz = Graph_LabeledNodeCount(g, label_id);
+		// estimate the fraction of the label's nodes matched by the filters
+		// unless the label's attributes were analyzed, filters are
+		// assumed to be equally restrictive
+		double sel = 1;
+		bool estimated = true;
+		for(uint j = 0; j < cur_filters_count; j++) {
+			double filter_sel;
+			if(FilterTree_EstimateSelectivity(cur_filters[j]->filterTree,
+						node_alias, gc, &label, 1, &filter_sel)) {
+				sel *= filter_sel;
+			} else {
+				estimated = false;
+			}
+		}
+
+		// the index is expected to match most of the label's nodes
+		if(estimated && sel > INDEX_SCAN_MAX_SELECTIVITY) {
+			array_free(cur_filters);
+			continue;
+		}
+
+		nnz = Graph_LabeledNodeCount(g, label_id) * sel;
 		if(min_nnz > nnz) {
 			rs_idx         =  cur_idx;
 			min_nnz        =  nnz;
@@ -356,6 +382,8 @@ void reduce_scan_op
 			array_free(filters);
 			filters = cur_filters;
 			filters_count = cur_filters_count;
+		} else {
+			array_free(cur_filters);
 		}
 	}
 
@@ -0,0 +1,67 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "record_batch.h"
+#include "../util/rmalloc.h"
+
+// forward declarations
+struct ExecutionPlan;
+void ExecutionPlan_ReturnRecord(struct ExecutionPlan *plan, Record r);
+
+RecordBatch *RecordBatch_New(void) {
+	RecordBatch *batch = rm_malloc(sizeof(RecordBatch));
+	RecordBatch_Clear(batch);
+	return batch;
+}
+
+void RecordBatch_Add
+(
+	RecordBatch *batch,
+	Record r
+) {
+	ASSERT(batch != NULL);
+	ASSERT(r != NULL);
+	ASSERT(!RecordBatch_Full(batch));
+
+	batch->records[batch->count] = r;
+	batch->sel[batch->size++] = batch->count++;
+}
+
+void RecordBatch_Clear
+(
+	RecordBatch *batch
+) {
+	ASSERT(batch != NULL);
+
+	batch->count = 0;
+	batch->size  = 0;
+}
+
+void RecordBatch_Release
+(
+	RecordBatch *batch
+) {
+	ASSERT(batch != NULL);
+
+	// deselected records were released by whoever deselected them
+	for(uint i = 0; i < batch->size; i++) {
+		Record r = RecordBatch_Get(batch, i);
+		if(r != NULL) ExecutionPlan_ReturnRecord(r->owner, r);
+	}
+
+	RecordBatch_Clear(batch);
+}
+
+void RecordBatch_Free
+(
+	RecordBatch *batch
+) {
+	ASSERT(batch != NULL);
+
+	RecordBatch_Release(batch);
+	rm_free(batch);
+}
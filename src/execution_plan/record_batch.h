@@ -0,0 +1,100 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "record.h"
+#include <stdint.h>
+
+// maximum number of records in a batch
+#define RECORD_BATCH_CAP 1024
+
+// a batch of records passed between operations
+// records are accessed through the batch's selection vector
+// which holds the positions of the batch's live records
+// an operation discarding records (e.g. filter) releases them and
+// shrinks the selection vector, leaving the remaining records in place
+typedef struct {
+	uint count;                         // number of records added to batch
+	uint size;                          // number of selected records
+	Record records[RECORD_BATCH_CAP];   // records
+	uint16_t sel[RECORD_BATCH_CAP];     // selection vector
+} RecordBatch;
+
+// create a new empty batch
+RecordBatch *RecordBatch_New(void);
+
+// returns number of selected records
+static inline uint RecordBatch_Size
+(
+	const RecordBatch *batch
+) {
+	return batch->size;
+}
+
+// returns true if no additional records can be added to batch
+static inline bool RecordBatch_Full
+(
+	const RecordBatch *batch
+) {
+	return batch->count == RECORD_BATCH_CAP;
+}
+
+// returns the i'th selected record
+static inline Record RecordBatch_Get
+(
+	const RecordBatch *batch,
+	uint i
+) {
+	return batch->records[batch->sel[i]];
+}
+
+// replace the i'th selected record
+static inline void RecordBatch_Set
+(
+	RecordBatch *batch,
+	uint i,
+	Record r
+) {
+	batch->records[batch->sel[i]] = r;
+}
+
+// removes the i'th selected record from batch, transferring its ownership
+// to the caller, the record remains selected but is no longer accessible
+static inline Record RecordBatch_Take
+(
+	RecordBatch *batch,
+	uint i
+) {
+	Record r = batch->records[batch->sel[i]];
+	batch->records[batch->sel[i]] = NULL;
+	return r;
+}
+
+// add record to batch, batch takes ownership over record
+void RecordBatch_Add
+(
+	RecordBatch *batch,
+	Record r
+);
+
+// empties batch without releasing its records
+void RecordBatch_Clear
+(
+	RecordBatch *batch
+);
+
+// release batch's records and empty it
+void RecordBatch_Release
+(
+	RecordBatch *batch
+);
+
+// free batch and its records
+void RecordBatch_Free
+(
+	RecordBatch *batch
+);
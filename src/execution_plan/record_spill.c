@@ -0,0 +1,470 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "record_spill.h"
+#include "../errors.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/map.h"
+#include "../datatypes/array.h"
+#include "../datatypes/path/path.h"
+#include "../datatypes/path/sipath.h"
+
+#include <stdio.h>
+
+struct RecordSpill {
+	FILE *f;             // temporary file
+	const Graph *g;      // graph from which entities are re-fetched
+	uint64_t count;      // number of records written
+	uint64_t remaining;  // number of records left to read
+};
+
+//------------------------------------------------------------------------------
+// write
+//------------------------------------------------------------------------------
+
+static inline bool _Write
+(
+	FILE *f,
+	const void *data,
+	size_t n
+) {
+	return fwrite(data, n, 1, f) == 1;
+}
+
+static inline bool _WriteU64
+(
+	FILE *f,
+	uint64_t v
+) {
+	return _Write(f, &v, sizeof(v));
+}
+
+static bool _WriteNode
+(
+	FILE *f,
+	const Node *n
+) {
+	return _WriteU64(f, ENTITY_GET_ID(n));
+}
+
+static bool _WriteEdge
+(
+	FILE *f,
+	const Edge *e
+) {
+	return _WriteU64(f, ENTITY_GET_ID(e))       &&
+		   _WriteU64(f, (int64_t)e->relationID) &&
+		   _WriteU64(f, e->srcNodeID)            &&
+		   _WriteU64(f, e->destNodeID);
+}
+
+static bool _WriteValue
+(
+	FILE *f,
+	SIValue v
+) {
+	if(!_WriteU64(f, v.type)) return false;
+
+	switch(v.type) {
+		case T_NULL:
+		case T_BOOL:
+		case T_INT64:
+		case T_DOUBLE:
+		case T_POINT:
+		case T_DATETIME:
+		case T_LOCALDATETIME:
+		case T_DATE:
+		case T_TIME:
+		case T_LOCALTIME:
+		case T_DURATION:
+			// value is stored inline
+			return _WriteU64(f, v.longval);
+		case T_STRING:
+		{
+			uint64_t len = strlen(v.stringval);
+			return _WriteU64(f, len) && _Write(f, v.stringval, len);
+		}
+		case T_NODE:
+			return _WriteNode(f, v.ptrval);
+		case T_EDGE:
+			return _WriteEdge(f, v.ptrval);
+		case T_ARRAY:
+		{
+			uint32_t len = SIArray_Length(v);
+			if(!_WriteU64(f, len)) return false;
+			for(uint32_t i = 0; i < len; i++) {
+				if(!_WriteValue(f, SIArray_Get(v, i))) return false;
+			}
+			return true;
+		}
+		case T_MAP:
+		{
+			uint len = Map_KeyCount(v);
+			if(!_WriteU64(f, len)) return false;
+			for(uint i = 0; i < len; i++) {
+				SIValue key;
+				SIValue val;
+				Map_GetIdx(v, i, &key, &val);
+				if(!_WriteValue(f, key) || !_WriteValue(f, val)) return false;
+			}
+			return true;
+		}
+		case T_PATH:
+		{
+			size_t node_count = SIPath_NodeCount(v);
+			size_t edge_count = SIPath_Length(v);
+			if(!_WriteU64(f, node_count) || !_WriteU64(f, edge_count)) {
+				return false;
+			}
+			for(size_t i = 0; i < node_count; i++) {
+				if(!_WriteNode(f, SIPath_GetNode(v, i).ptrval)) return false;
+			}
+			for(size_t i = 0; i < edge_count; i++) {
+				if(!_WriteEdge(f, SIPath_GetRelationship(v, i).ptrval)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		default:
+			// value can't be serialized
+			return false;
+	}
+}
+
+//------------------------------------------------------------------------------
+// read
+//------------------------------------------------------------------------------
+
+static inline bool _Read
+(
+	FILE *f,
+	void *data,
+	size_t n
+) {
+	return fread(data, n, 1, f) == 1;
+}
+
+static inline bool _ReadU64
+(
+	FILE *f,
+	uint64_t *v
+) {
+	return _Read(f, v, sizeof(*v));
+}
+
+static bool _ReadNode
+(
+	RecordSpill *spill,
+	Node *n
+) {
+	uint64_t id;
+	if(!_ReadU64(spill->f, &id)) return false;
+	return Graph_GetNode(spill->g, id, n);
+}
+
+static bool _ReadEdge
+(
+	RecordSpill *spill,
+	Edge *e
+) {
+	uint64_t id;
+	uint64_t relation;
+	uint64_t src;
+	uint64_t dest;
+
+	if(!_ReadU64(spill->f, &id)       ||
+	   !_ReadU64(spill->f, &relation) ||
+	   !_ReadU64(spill->f, &src)      ||
+	   !_ReadU64(spill->f, &dest)) {
+		return false;
+	}
+
+	*e = (Edge){0};
+	if(!Graph_GetEdge(spill->g, id, e)) return false;
+
+	e->relationID = (int)(int64_t)relation;
+	e->srcNodeID  = src;
+	e->destNodeID = dest;
+	return true;
+}
+
+// reads a value, heap allocated values are owned by the caller
+static bool _ReadValue
+(
+	RecordSpill *spill,
+	SIValue *v
+) {
+	FILE *f = spill->f;
+	uint64_t type;
+	if(!_ReadU64(f, &type)) return false;
+
+	switch(type) {
+		case T_NULL:
+		case T_BOOL:
+		case T_INT64:
+		case T_DOUBLE:
+		case T_POINT:
+		case T_DATETIME:
+		case T_LOCALDATETIME:
+		case T_DATE:
+		case T_TIME:
+		case T_LOCALTIME:
+		case T_DURATION:
+		{
+			uint64_t raw;
+			if(!_ReadU64(f, &raw)) return false;
+			v->longval    = raw;
+			v->type       = type;
+			v->allocation = M_NONE;
+			return true;
+		}
+		case T_STRING:
+		{
+			uint64_t len;
+			if(!_ReadU64(f, &len)) return false;
+			char *s = rm_malloc(len + 1);
+			if(len > 0 && !_Read(f, s, len)) {
+				rm_free(s);
+				return false;
+			}
+			s[len] = '\0';
+			*v = SI_TransferStringVal(s);
+			return true;
+		}
+		case T_NODE:
+		{
+			Node n;
+			if(!_ReadNode(spill, &n)) return false;
+			*v = SI_CloneValue(SI_Node(&n));
+			return true;
+		}
+		case T_EDGE:
+		{
+			Edge e;
+			if(!_ReadEdge(spill, &e)) return false;
+			*v = SI_CloneValue(SI_Edge(&e));
+			return true;
+		}
+		case T_ARRAY:
+		{
+			uint64_t len;
+			if(!_ReadU64(f, &len)) return false;
+			*v = SIArray_New(len);
+			for(uint64_t i = 0; i < len; i++) {
+				SIValue elem;
+				if(!_ReadValue(spill, &elem)) {
+					SIValue_Free(*v);
+					return false;
+				}
+				SIArray_Append(v, elem);
+				SIValue_Free(elem);
+			}
+			return true;
+		}
+		case T_MAP:
+		{
+			uint64_t len;
+			if(!_ReadU64(f, &len)) return false;
+			*v = Map_New(len);
+			for(uint64_t i = 0; i < len; i++) {
+				SIValue key;
+				SIValue val;
+				if(!_ReadValue(spill, &key)) {
+					SIValue_Free(*v);
+					return false;
+				}
+				if(!_ReadValue(spill, &val)) {
+					SIValue_Free(key);
+					SIValue_Free(*v);
+					return false;
+				}
+				Map_Add(v, key, val);
+				SIValue_Free(key);
+				SIValue_Free(val);
+			}
+			return true;
+		}
+		case T_PATH:
+		{
+			uint64_t node_count;
+			uint64_t edge_count;
+			if(!_ReadU64(f, &node_count) || !_ReadU64(f, &edge_count)) {
+				return false;
+			}
+
+			bool res = true;
+			Path *p = Path_New(node_count);
+			for(uint64_t i = 0; i < node_count && res; i++) {
+				Node n;
+				res = _ReadNode(spill, &n);
+				if(res) Path_AppendNode(p, n);
+			}
+			for(uint64_t i = 0; i < edge_count && res; i++) {
+				Edge e;
+				res = _ReadEdge(spill, &e);
+				if(res) Path_AppendEdge(p, e);
+			}
+
+			if(res) *v = SIPath_New(p);
+			Path_Free(p);
+			return res;
+		}
+		default:
+			return false;
+	}
+}
+
+//------------------------------------------------------------------------------
+// API
+//------------------------------------------------------------------------------
+
+RecordSpill *RecordSpill_New
+(
+	const Graph *g
+) {
+	ASSERT(g != NULL);
+
+	// the file is removed once closed
+	FILE *f = tmpfile();
+	if(f == NULL) return NULL;
+
+	RecordSpill *spill = rm_malloc(sizeof(RecordSpill));
+
+	spill->f         = f;
+	spill->g         = g;
+	spill->count     = 0;
+	spill->remaining = 0;
+
+	return spill;
+}
+
+bool RecordSpill_Write
+(
+	RecordSpill *spill,
+	const Record r
+) {
+	ASSERT(r     != NULL);
+	ASSERT(spill != NULL);
+
+	FILE *f = spill->f;
+	uint n = Record_length(r);
+
+	for(uint i = 0; i < n; i++) {
+		RecordEntryType t = Record_GetType(r, i);
+		if(!_WriteU64(f, t)) return false;
+
+		switch(t) {
+			case REC_TYPE_UNKNOWN:
+				break;
+			case REC_TYPE_NODE:
+				if(!_WriteNode(f, Record_GetNode(r, i))) return false;
+				break;
+			case REC_TYPE_EDGE:
+				if(!_WriteEdge(f, Record_GetEdge(r, i))) return false;
+				break;
+			case REC_TYPE_SCALAR:
+				if(!_WriteValue(f, Record_Get(r, i))) return false;
+				break;
+			default:
+				return false;
+		}
+	}
+
+	spill->count++;
+	return true;
+}
+
+bool RecordSpill_Rewind
+(
+	RecordSpill *spill
+) {
+	ASSERT(spill != NULL);
+
+	if(fflush(spill->f) != 0)           return false;
+	if(fseek(spill->f, 0, SEEK_SET) != 0) return false;
+
+	spill->remaining = spill->count;
+	return true;
+}
+
+bool RecordSpill_Read
+(
+	RecordSpill *spill,
+	Record r
+) {
+	ASSERT(r     != NULL);
+	ASSERT(spill != NULL);
+
+	if(spill->remaining == 0) return false;
+
+	FILE *f = spill->f;
+	uint n = Record_length(r);
+	bool res = true;
+
+	for(uint i = 0; i < n && res; i++) {
+		uint64_t t;
+		res = _ReadU64(f, &t);
+		if(!res) break;
+
+		switch(t) {
+			case REC_TYPE_UNKNOWN:
+				break;
+			case REC_TYPE_NODE:
+			{
+				Node node;
+				res = _ReadNode(spill, &node);
+				if(res) Record_AddNode(r, i, node);
+				break;
+			}
+			case REC_TYPE_EDGE:
+			{
+				Edge edge;
+				res = _ReadEdge(spill, &edge);
+				if(res) Record_AddEdge(r, i, edge);
+				break;
+			}
+			case REC_TYPE_SCALAR:
+			{
+				SIValue v;
+				res = _ReadValue(spill, &v);
+				if(res) Record_AddScalar(r, i, v);
+				break;
+			}
+			default:
+				res = false;
+				break;
+		}
+	}
+
+	if(!res) {
+		ErrorCtx_RaiseRuntimeException("Failed to read spilled records");
+		return false;
+	}
+
+	spill->remaining--;
+	return true;
+}
+
+uint64_t RecordSpill_Count
+(
+	const RecordSpill *spill
+) {
+	ASSERT(spill != NULL);
+	return spill->count;
+}
+
+void RecordSpill_Free
+(
+	RecordSpill *spill
+) {
+	ASSERT(spill != NULL);
+
+	fclose(spill->f);
+	rm_free(spill);
+}
+
@@ -0,0 +1,64 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "record.h"
+#include "../graph/graph.h"
+
+// record spill
+// a temporary file to which records are written and later read back in
+// the same order, allowing operations to offload buffered records
+// from memory
+//
+// graph entities are written by ID and re-fetched from the graph when read
+// as such the graph must not change between writing and reading a record
+// values which can't be serialized (e.g. pointers) fail the write
+typedef struct RecordSpill RecordSpill;
+
+// create a new empty spill file
+// returns NULL if a temporary file could not be created
+RecordSpill *RecordSpill_New
+(
+	const Graph *g  // graph from which spilled entities are re-fetched
+);
+
+// append record to spill file
+// returns false if record could not be written
+bool RecordSpill_Write
+(
+	RecordSpill *spill,  // spill file
+	const Record r       // record to write
+);
+
+// prepare spill file for reading
+// returns false on failure
+bool RecordSpill_Rewind
+(
+	RecordSpill *spill  // spill file
+);
+
+// reads the next record from spill file into 'r'
+// returns false if there are no more records to read
+// raises a runtime exception if the file could not be read
+bool RecordSpill_Read
+(
+	RecordSpill *spill,  // spill file
+	Record r             // [output] record to populate
+);
+
+// returns number of records written to spill file
+uint64_t RecordSpill_Count
+(
+	const RecordSpill *spill  // spill file
+);
+
+// free spill file, removing it from disk
+void RecordSpill_Free
+(
+	RecordSpill *spill  // spill file to free
+);
+
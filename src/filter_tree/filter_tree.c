@@ -210,7 +210,7 @@ const FT_FilterNode **FilterTree_SubTrees
 
 // applies a single filter to a single result
 // compares given values, tests if values maintain desired relation (op)
-FT_Result _applyFilter
+FT_Result FilterTree_ComparePredicate
 (
 	SIValue *aVal,
 	SIValue *bVal,
@@ -249,6 +249,30 @@ FT_Result _applyFilter
 	return 0;
 }
 
+FT_Result FilterTree_TruthValue
+(
+	SIValue v
+) {
+	FT_Result retval = FILTER_PASS;
+	if(SIValue_IsNull(v)) {
+		// expression evaluated to NULL should return NULL
+		retval = FILTER_NULL;
+	} else if(SI_TYPE(v) & T_BOOL) {
+		// return false if this boolean value is false
+		if(SIValue_IsFalse(v)) retval = FILTER_FAIL;
+	} else if(SI_TYPE(v) & T_ARRAY) {
+		// an empty array is falsey, all other arrays should return true
+		if(SIArray_Length(v) == 0) retval = FILTER_FAIL;
+	} else {
+		// if the expression node evaluated to an unexpected type:
+		// numeric, string, node or edge, emit an error
+		Error_SITypeMismatch(v, T_BOOL);
+		retval = FILTER_FAIL;
+	}
+
+	return retval;
+}
+
 FT_Result _applyPredicateFilters
 (
 	const FT_FilterNode *root,
@@ -260,7 +284,7 @@ FT_Result _applyPredicateFilters
 	SIValue lhs = AR_EXP_Evaluate(root->pred.lhs, r);
 	SIValue rhs = AR_EXP_Evaluate(root->pred.rhs, r);
 
-	FT_Result ret = _applyFilter(&lhs, &rhs, root->pred.op);
+	FT_Result ret = FilterTree_ComparePredicate(&lhs, &rhs, root->pred.op);
 
 	SIValue_Free(lhs);
 	SIValue_Free(rhs);
@@ -411,24 +435,8 @@ FT_Result FilterTree_applyFilters
 			return _applyPredicateFilters(root, r);
 		}
 		case FT_N_EXP: {
-			FT_Result retval = FILTER_PASS;
 			SIValue res = AR_EXP_Evaluate(root->exp.exp, r);
-			if(SIValue_IsNull(res)) {
-				// expression evaluated to NULL should return NULL
-				retval = FILTER_NULL;
-			} else if(SI_TYPE(res) & T_BOOL) {
-				// return false if this boolean value is false
-				if(SIValue_IsFalse(res)) retval = FILTER_FAIL;
-			} else if(SI_TYPE(res) & T_ARRAY) {
-				// an empty array is falsey, all other arrays should return true
-				if(SIArray_Length(res) == 0) retval = FILTER_FAIL;
-			} else {
-				// if the expression node evaluated to an unexpected type:
-				// numeric, string, node or edge, emit an error
-				Error_SITypeMismatch(res, T_BOOL);
-				retval = FILTER_FAIL;
-			}
-
+			FT_Result retval = FilterTree_TruthValue(res);
 			SIValue_Free(res); // if res was a heap allocation, free it
 			return retval;
 		}
@@ -982,7 +990,7 @@ static bool _FilterTree_Compact_Pred
 		SIValue lhs = AR_EXP_Evaluate(node->pred.lhs, NULL);
 		SIValue rhs = AR_EXP_Evaluate(node->pred.rhs, NULL);
 		// Evalute result.
-		FT_Result ret = _applyFilter(&lhs, &rhs, node->pred.op);
+		FT_Result ret = FilterTree_ComparePredicate(&lhs, &rhs, node->pred.op);
 		// Result can be NULL like WHERE null <> true otherwise it's bool
 		SIValue v = ret == FILTER_NULL ? SI_NullVal() : SI_BoolVal(ret);
 		// Free resources and do in place replacment.
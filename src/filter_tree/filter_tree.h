@@ -115,6 +115,21 @@ FT_Result FilterTree_applyFilters
 	const Record r
 );
 
+// compares two values using a predicate operator: [<, <=, =, <>, >, >=]
+FT_Result FilterTree_ComparePredicate
+(
+	SIValue *aVal,
+	SIValue *bVal,
+	AST_Operator op
+);
+
+// determines the filter result of a value produced by an expression node
+// raises a type mismatch error for non boolean and non array values
+FT_Result FilterTree_TruthValue
+(
+	SIValue v
+);
+
 // extract every modified record ID mentioned in the tree
 // without duplications
 rax *FilterTree_CollectModified
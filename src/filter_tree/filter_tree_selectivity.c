@@ -0,0 +1,199 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "filter_tree_utils.h"
+#include "filter_tree_selectivity.h"
+#include "../query_ctx.h"
+#include "../datatypes/array.h"
+#include "../arithmetic/arithmetic_op.h"
+#include "../schema/attribute_stats.h"
+
+// returns true if 'exp' accesses an attribute of 'alias'
+// e.g. n.v, sets 'attr' to the accessed attribute name
+static bool _AttributeOf
+(
+	const AR_ExpNode *exp,
+	const char *alias,
+	char **attr
+) {
+	if(!AR_EXP_IsAttribute(exp, attr)) return false;
+
+	const AR_ExpNode *entity = exp->op.children[0];
+	return (AR_EXP_IsVariadic(entity) &&
+			strcmp(entity->operand.variadic.entity_alias, alias) == 0);
+}
+
+// retrieves the constant value of 'exp'
+// parameters are looked up without modifying the expression
+static bool _ConstantValue
+(
+	AR_ExpNode *exp,
+	SIValue *v
+) {
+	if(AR_EXP_IsParameter(exp)) {
+		rax *params = QueryCtx_GetParams();
+		if(params == NULL) return false;
+
+		const char *name = exp->operand.param_name;
+		void *param = raxFind(params, (unsigned char *)name, strlen(name));
+		if(param == raxNotFound) return false;
+
+		*v = *(SIValue *)param;
+		return true;
+	}
+
+	return AR_EXP_ReduceToScalar(exp, false, v);
+}
+
+// estimate the selectivity of `alias.attr op v`
+// the most selective estimate among the node's labels is used
+static bool _AttributeSelectivity
+(
+	GraphContext *gc,
+	const char **labels,
+	uint label_count,
+	const char *attr,
+	AST_Operator op,
+	SIValue v,
+	double *selectivity
+) {
+	Attribute_ID attr_id = GraphContext_GetAttributeID(gc, attr);
+	if(attr_id == ATTRIBUTE_ID_NONE) return false;
+
+	bool estimated = false;
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchema(gc, labels[i], SCHEMA_NODE);
+		if(s == NULL) continue;
+
+		const AttributeStats *stats = Schema_GetAttributeStats(s, attr_id);
+		if(stats == NULL) continue;
+
+		double sel;
+		if(!AttributeStats_Selectivity(stats, op, v, &sel)) continue;
+
+		*selectivity = estimated ? MIN(*selectivity, sel) : sel;
+		estimated = true;
+	}
+
+	return estimated;
+}
+
+static bool _PredicateSelectivity
+(
+	const FT_FilterNode *filter,
+	const char *alias,
+	GraphContext *gc,
+	const char **labels,
+	uint label_count,
+	double *selectivity
+) {
+	char        *attr  =  NULL;
+	AR_ExpNode  *exp   =  NULL;
+	AST_Operator op    =  filter->pred.op;
+
+	// filter should be in the form of:
+	// alias.attr OP constant
+	// or
+	// constant OP alias.attr
+	if(_AttributeOf(filter->pred.lhs, alias, &attr)) {
+		exp = filter->pred.rhs;
+	} else if(_AttributeOf(filter->pred.rhs, alias, &attr)) {
+		exp = filter->pred.lhs;
+		op  = ArithmeticOp_ReverseOp(op);
+	} else {
+		return false;
+	}
+
+	SIValue v;
+	if(!_ConstantValue(exp, &v)) return false;
+
+	return _AttributeSelectivity(gc, labels, label_count, attr, op, v,
+			selectivity);
+}
+
+// estimate the selectivity of `alias.attr IN [v0, v1, ...]`
+static bool _InSelectivity
+(
+	const FT_FilterNode *filter,
+	const char *alias,
+	GraphContext *gc,
+	const char **labels,
+	uint label_count,
+	double *selectivity
+) {
+	AR_ExpNode *in = filter->exp.exp;
+	ASSERT(in->op.child_count == 2);
+
+	char *attr = NULL;
+	if(!_AttributeOf(in->op.children[0], alias, &attr)) return false;
+
+	SIValue list;
+	if(!_ConstantValue(in->op.children[1], &list)) return false;
+	if(SI_TYPE(list) != T_ARRAY) return false;
+
+	double sel = 0;
+	uint n = SIArray_Length(list);
+	for(uint i = 0; i < n; i++) {
+		double elem_sel;
+		if(!_AttributeSelectivity(gc, labels, label_count, attr, OP_EQUAL,
+					SIArray_Get(list, i), &elem_sel)) {
+			return false;
+		}
+		sel += elem_sel;
+	}
+
+	*selectivity = MIN(sel, 1);
+	return true;
+}
+
+bool FilterTree_EstimateSelectivity
+(
+	const FT_FilterNode *filter,
+	const char *alias,
+	GraphContext *gc,
+	const char **labels,
+	uint label_count,
+	double *selectivity
+) {
+	ASSERT(gc          != NULL);
+	ASSERT(alias       != NULL);
+	ASSERT(filter      != NULL);
+	ASSERT(selectivity != NULL);
+
+	if(label_count == 0) return false;
+
+	switch(filter->t) {
+		case FT_N_PRED:
+			return _PredicateSelectivity(filter, alias, gc, labels,
+					label_count, selectivity);
+		case FT_N_EXP:
+			if(!isInFilter(filter)) return false;
+			return _InSelectivity(filter, alias, gc, labels, label_count,
+					selectivity);
+		case FT_N_COND:
+		{
+			AST_Operator op = filter->cond.op;
+			if(op != OP_AND && op != OP_OR) return false;
+
+			double l;
+			double r;
+			if(!FilterTree_EstimateSelectivity(filter->cond.left, alias, gc,
+						labels, label_count, &l)) {
+				return false;
+			}
+			if(!FilterTree_EstimateSelectivity(filter->cond.right, alias, gc,
+						labels, label_count, &r)) {
+				return false;
+			}
+
+			*selectivity = (op == OP_AND) ? l * r : l + r - l * r;
+			return true;
+		}
+		default:
+			return false;
+	}
+}
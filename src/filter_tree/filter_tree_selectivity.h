@@ -0,0 +1,26 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "filter_tree.h"
+#include "../graph/graphcontext.h"
+
+// estimates the fraction of nodes aliased 'alias' passing 'filter'
+// using the attribute statistics collected for the node's labels
+// predicates under AND are assumed to be independent of one another
+//
+// returns false if 'filter' can't be estimated, e.g. it refers to additional
+// entities or to attributes which weren't analyzed
+bool FilterTree_EstimateSelectivity
+(
+	const FT_FilterNode *filter,  // filter to estimate
+	const char *alias,            // filtered node
+	GraphContext *gc,             // graph context
+	const char **labels,          // node's labels
+	uint label_count,             // number of labels
+	double *selectivity           // [output] estimated selectivity
+);
@@ -0,0 +1,439 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "ft_program.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+#include <math.h>
+
+// operands are either value registers or constants
+// constant operands are encoded as negative numbers
+#define CONST_OPERAND(i) (-(int)(i) - 1)
+#define IS_CONST_OPERAND(o) ((o) < 0)
+#define CONST_IDX(o) (-(o) - 1)
+
+typedef enum {
+	FT_INST_VAR,    // load a record entry into a value register
+	FT_INST_ATTR,   // load an entity's attribute into a value register
+	FT_INST_EVAL,   // evaluate an expression into a value register
+	FT_INST_CMP,    // compare two operands
+	FT_INST_TRUTH,  // determine the truth value of an operand
+	FT_INST_JUMP,   // skip a condition's right hand side
+	FT_INST_COND,   // combine the results of both sides of a condition
+	FT_INST_NOT,    // negate a result
+} FT_Opcode;
+
+typedef struct {
+	FT_Opcode opcode;   // instruction type
+	AST_Operator op;    // comparison or condition operator
+	uint dst;           // destination register
+	int lhs;            // left hand side operand or result register
+	int rhs;            // right hand side operand or result register
+	uint target;        // jump target
+	FT_Result skip;     // result on which to jump
+	AR_ExpNode *exp;    // expression to load or evaluate
+	AR_ExpNode *var;    // variable node holding the entity's record index
+	Attribute_ID attr;  // accessed attribute
+} FT_Instruction;
+
+struct FT_Program {
+	FT_Instruction *code;  // instructions
+	SIValue *constants;    // constant operands
+	SIValue *registers;    // value registers
+	FT_Result *results;    // result registers
+	uint result;           // register holding the program's result
+};
+
+//------------------------------------------------------------------------------
+// compilation
+//------------------------------------------------------------------------------
+
+static uint _NewRegister
+(
+	FT_Program *p
+) {
+	array_append(p->registers, SI_NullVal());
+	return array_len(p->registers) - 1;
+}
+
+static uint _NewResult
+(
+	FT_Program *p
+) {
+	array_append(p->results, FILTER_NULL);
+	return array_len(p->results) - 1;
+}
+
+static int _NewConstant
+(
+	FT_Program *p,
+	SIValue v
+) {
+	array_append(p->constants, SI_ShareValue(v));
+	return CONST_OPERAND(array_len(p->constants) - 1);
+}
+
+static uint _Emit
+(
+	FT_Program *p,
+	FT_Instruction inst
+) {
+	array_append(p->code, inst);
+	return array_len(p->code) - 1;
+}
+
+// returns true if 'exp' accesses an attribute of a variable
+// e.g. n.v
+static bool _VariableAttribute
+(
+	const AR_ExpNode *exp
+) {
+	if(!AR_EXP_IsAttribute(exp, NULL)) return false;
+	if(exp->op.child_count != 3) return false;
+
+	AR_ExpNode *entity = exp->op.children[0];
+	AR_ExpNode *idx    = exp->op.children[2];
+
+	return AR_EXP_IsVariadic(entity) &&
+		   AR_EXP_IsConstant(idx)    &&
+		   SI_TYPE(idx->operand.constant) == T_INT64;
+}
+
+// compiles expression into an operand
+static int _CompileValue
+(
+	FT_Program *p,
+	AR_ExpNode *exp
+) {
+	if(AR_EXP_IsConstant(exp)) {
+		return _NewConstant(p, exp->operand.constant);
+	}
+
+	if(AR_EXP_IsParameter(exp)) {
+		// parameters are bound for the duration of the query
+		rax *params = QueryCtx_GetParams();
+		if(params != NULL) {
+			const char *name = exp->operand.param_name;
+			void *param = raxFind(params, (unsigned char *)name, strlen(name));
+			if(param != raxNotFound) return _NewConstant(p, *(SIValue *)param);
+		}
+		// missing parameter, leave error reporting to evaluation
+	}
+
+	FT_Instruction inst = {.exp = exp, .dst = _NewRegister(p)};
+
+	if(AR_EXP_IsVariadic(exp)) {
+		inst.opcode = FT_INST_VAR;
+	} else if(_VariableAttribute(exp)) {
+		inst.opcode = FT_INST_ATTR;
+		inst.var    = exp->op.children[0];
+		inst.attr   = exp->op.children[2]->operand.constant.longval;
+	} else {
+		inst.opcode = FT_INST_EVAL;
+	}
+
+	_Emit(p, inst);
+	return inst.dst;
+}
+
+// compiles filter tree node, returns the register holding its result
+static uint _CompileFilter
+(
+	FT_Program *p,
+	const FT_FilterNode *node
+) {
+	switch(node->t) {
+		case FT_N_PRED: {
+			FT_Instruction inst = {.opcode = FT_INST_CMP, .op = node->pred.op};
+			inst.lhs = _CompileValue(p, node->pred.lhs);
+			inst.rhs = _CompileValue(p, node->pred.rhs);
+			inst.dst = _NewResult(p);
+			_Emit(p, inst);
+			return inst.dst;
+		}
+		case FT_N_EXP: {
+			FT_Instruction inst = {.opcode = FT_INST_TRUTH};
+			inst.lhs = _CompileValue(p, node->exp.exp);
+			inst.dst = _NewResult(p);
+			_Emit(p, inst);
+			return inst.dst;
+		}
+		case FT_N_COND: {
+			AST_Operator op = node->cond.op;
+			uint lhs = _CompileFilter(p, node->cond.left);
+
+			if(op == OP_NOT) {
+				FT_Instruction inst = {.opcode = FT_INST_NOT, .dst = lhs};
+				_Emit(p, inst);
+				return lhs;
+			}
+
+			// the left hand side result is final when
+			// AND ( F, ? ) == F
+			// OR  ( T, ? ) == T
+			// XOR ( NULL, ? ) == XNOR ( NULL, ? ) == NULL
+			FT_Result skip;
+			switch(op) {
+				case OP_AND:
+					skip = FILTER_FAIL;
+					break;
+				case OP_OR:
+					skip = FILTER_PASS;
+					break;
+				case OP_XOR:
+				case OP_XNOR:
+					skip = FILTER_NULL;
+					break;
+				default:
+					// unknown condition, result of left hand side
+					return lhs;
+			}
+
+			FT_Instruction jump = {.opcode = FT_INST_JUMP, .lhs = lhs,
+				.skip = skip};
+			uint jump_idx = _Emit(p, jump);
+
+			FT_Instruction inst = {.opcode = FT_INST_COND, .op = op, .dst = lhs};
+			inst.lhs = lhs;
+			inst.rhs = _CompileFilter(p, node->cond.right);
+			_Emit(p, inst);
+
+			// jump past the condition
+			p->code[jump_idx].target = array_len(p->code);
+			return lhs;
+		}
+		default:
+			ASSERT(false);
+			return 0;
+	}
+}
+
+FT_Program *FT_Program_Compile
+(
+	const FT_FilterNode *root
+) {
+	ASSERT(root != NULL);
+
+	FT_Program *p = rm_malloc(sizeof(FT_Program));
+
+	p->code      = array_new(FT_Instruction, 4);
+	p->constants = array_new(SIValue, 2);
+	p->registers = array_new(SIValue, 2);
+	p->results   = array_new(FT_Result, 2);
+	p->result    = _CompileFilter(p, root);
+
+	return p;
+}
+
+//------------------------------------------------------------------------------
+// execution
+//------------------------------------------------------------------------------
+
+static inline SIValue *_Operand
+(
+	FT_Program *p,
+	int o
+) {
+	return IS_CONST_OPERAND(o) ? p->constants + CONST_IDX(o) : p->registers + o;
+}
+
+// releases value held by register operand
+static inline void _ReleaseOperand
+(
+	FT_Program *p,
+	int o
+) {
+	if(!IS_CONST_OPERAND(o)) SIValue_Free(p->registers[o]);
+}
+
+static inline FT_Result _Relation
+(
+	int rel,
+	AST_Operator op
+) {
+	switch(op) {
+		case OP_EQUAL:
+			return rel == 0;
+		case OP_NEQUAL:
+			return rel != 0;
+		case OP_GT:
+			return rel > 0;
+		case OP_GE:
+			return rel >= 0;
+		case OP_LT:
+			return rel < 0;
+		case OP_LE:
+			return rel <= 0;
+		default:
+			// op should be enforced by AST
+			ASSERT(false);
+			return FILTER_FAIL;
+	}
+}
+
+// compares two values, numerics are compared directly
+// all other types are handed to FilterTree_ComparePredicate
+static inline FT_Result _Compare
+(
+	SIValue *a,
+	SIValue *b,
+	AST_Operator op
+) {
+	SIType ta = SI_TYPE(*a);
+	SIType tb = SI_TYPE(*b);
+
+	if(ta == T_INT64 && tb == T_INT64) {
+		int64_t x = a->longval;
+		int64_t y = b->longval;
+		return _Relation((x > y) - (x < y), op);
+	}
+
+	if((ta & SI_NUMERIC) && (tb & SI_NUMERIC)) {
+		double x = SI_GET_NUMERIC(*a);
+		double y = SI_GET_NUMERIC(*b);
+		// NaN is incomparable, only inequality holds
+		if(isnan(x) || isnan(y)) return (op == OP_NEQUAL);
+		return _Relation((x > y) - (x < y), op);
+	}
+
+	return FilterTree_ComparePredicate(a, b, op);
+}
+
+// loads the attribute of a record's entity
+static inline SIValue _LoadAttribute
+(
+	const FT_Instruction *inst,
+	const Record r
+) {
+	uint idx = inst->var->operand.variadic.entity_alias_idx;
+
+	// record index is resolved by the first evaluation
+	if(idx != IDENTIFIER_NOT_FOUND) {
+		RecordEntryType t = Record_GetType(r, idx);
+		if(t == REC_TYPE_NODE || t == REC_TYPE_EDGE) {
+			Attribute_ID attr = inst->attr;
+			if(attr == ATTRIBUTE_ID_NONE) {
+				// attribute might have been introduced after compilation
+				char *name;
+				AR_EXP_IsAttribute(inst->exp, &name);
+				attr = GraphContext_GetAttributeID(QueryCtx_GetGraphCtx(),
+						name);
+			}
+			GraphEntity *e = Record_GetGraphEntity(r, idx);
+			return SI_ConstValue(GraphEntity_GetProperty(e, attr));
+		}
+		// accessing the attribute of a missing entity yields NULL
+		if(t == REC_TYPE_UNKNOWN) return SI_NullVal();
+	}
+
+	// maps, points and unresolved variables
+	return AR_EXP_Evaluate(inst->exp, r);
+}
+
+static inline FT_Result _Condition
+(
+	FT_Result lhs,
+	FT_Result rhs,
+	AST_Operator op
+) {
+	// truth tables are documented in filter_tree.c
+	switch(op) {
+		case OP_AND:
+			if(lhs == FILTER_PASS && rhs == FILTER_PASS) return FILTER_PASS;
+			if(rhs == FILTER_FAIL) return FILTER_FAIL;
+			return FILTER_NULL;
+		case OP_OR:
+			if(rhs == FILTER_PASS) return FILTER_PASS;
+			if(lhs == FILTER_FAIL && rhs == FILTER_FAIL) return FILTER_FAIL;
+			return FILTER_NULL;
+		case OP_XOR:
+			if(rhs == FILTER_NULL) return FILTER_NULL;
+			return (lhs == rhs) ? FILTER_FAIL : FILTER_PASS;
+		case OP_XNOR:
+			if(rhs == FILTER_NULL) return FILTER_NULL;
+			return (lhs == rhs) ? FILTER_PASS : FILTER_FAIL;
+		default:
+			ASSERT(false);
+			return FILTER_NULL;
+	}
+}
+
+FT_Result FT_Program_Apply
+(
+	FT_Program *p,
+	const Record r
+) {
+	ASSERT(p != NULL);
+
+	SIValue   *regs  = p->registers;
+	FT_Result *res   = p->results;
+	uint       n     = array_len(p->code);
+
+	for(uint pc = 0; pc < n; pc++) {
+		const FT_Instruction *inst = p->code + pc;
+		switch(inst->opcode) {
+			case FT_INST_VAR: {
+				uint idx = inst->exp->operand.variadic.entity_alias_idx;
+				regs[inst->dst] = (idx != IDENTIFIER_NOT_FOUND) ?
+					SI_ShareValue(Record_Get(r, idx)) :
+					AR_EXP_Evaluate(inst->exp, r);
+				break;
+			}
+			case FT_INST_ATTR:
+				regs[inst->dst] = _LoadAttribute(inst, r);
+				break;
+			case FT_INST_EVAL:
+				regs[inst->dst] = AR_EXP_Evaluate(inst->exp, r);
+				break;
+			case FT_INST_CMP:
+				res[inst->dst] = _Compare(_Operand(p, inst->lhs),
+						_Operand(p, inst->rhs), inst->op);
+				_ReleaseOperand(p, inst->lhs);
+				_ReleaseOperand(p, inst->rhs);
+				break;
+			case FT_INST_TRUTH:
+				res[inst->dst] = FilterTree_TruthValue(*_Operand(p, inst->lhs));
+				_ReleaseOperand(p, inst->lhs);
+				break;
+			case FT_INST_JUMP:
+				// the loop's increment lands on the target
+				if(res[inst->lhs] == inst->skip) pc = inst->target - 1;
+				break;
+			case FT_INST_COND:
+				res[inst->dst] = _Condition(res[inst->lhs], res[inst->rhs],
+						inst->op);
+				break;
+			case FT_INST_NOT:
+				if(res[inst->dst] != FILTER_NULL) {
+					res[inst->dst] = (res[inst->dst] == FILTER_PASS) ?
+						FILTER_FAIL : FILTER_PASS;
+				}
+				break;
+			default:
+				ASSERT(false);
+				break;
+		}
+	}
+
+	return res[p->result];
+}
+
+void FT_Program_Free
+(
+	FT_Program *p
+) {
+	ASSERT(p != NULL);
+
+	array_free(p->code);
+	array_free(p->constants);
+	array_free(p->registers);
+	array_free(p->results);
+	rm_free(p);
+}
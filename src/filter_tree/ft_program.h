@@ -0,0 +1,47 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "filter_tree.h"
+
+// a filter tree compiled into a flat, register based program
+//
+// evaluating a filter tree walks it recursively, evaluating both sides of
+// every predicate through the generic function call machinery
+// a compiled program instead executes a linear sequence of instructions:
+//
+// constant and parameter operands are resolved once at compile time
+// attribute accesses load the property directly from the record's entity
+// integer and floating point comparisons bypass SIValue_Compare
+// conditions short-circuit by jumping over the instructions of their
+// right hand side
+//
+// any other expression is evaluated by AR_EXP_Evaluate
+// a program may only be used by a single thread at a time
+
+typedef struct FT_Program FT_Program;
+
+// compiles filter tree into a program
+// the program references the tree which must outlive it
+FT_Program *FT_Program_Compile
+(
+	const FT_FilterNode *root  // filter tree to compile
+);
+
+// runs record through the compiled filter tree
+// equivalent to FilterTree_applyFilters
+FT_Result FT_Program_Apply
+(
+	FT_Program *program,  // compiled filter tree
+	const Record r        // record to filter
+);
+
+// free program
+void FT_Program_Free
+(
+	FT_Program *program  // program to free
+);
@@ -5,13 +5,24 @@
  */
 
 #include <limits.h>
+#include <string.h>
 
 #include "RG.h"
 #include "attribute_set.h"
 #include "../../util/rmalloc.h"
 
-// compute size of attribute set in bytes
-#define ATTRIBUTESET_BYTE_SIZE(set) ((set) == NULL ? sizeof(_AttributeSet) : sizeof(_AttributeSet) + sizeof(Attribute) * (set)->attr_count)
+// offset in bytes of the values array within a set holding n attributes
+#define ATTRIBUTESET_VALUES_OFFSET(n)                                     \
+	((sizeof(_AttributeSet) + sizeof(Attribute_ID) * (n) +                \
+	  _Alignof(SIValue) - 1) & ~(_Alignof(SIValue) - 1))
+
+// compute size in bytes of an attribute set holding n attributes
+#define ATTRIBUTESET_BYTE_SIZE(n) \
+	(ATTRIBUTESET_VALUES_OFFSET(n) + sizeof(SIValue) * (n))
+
+// values array of a set holding n attributes
+#define ATTRIBUTESET_VALUES(set, n) \
+	((SIValue *)((char *)(set) + ATTRIBUTESET_VALUES_OFFSET(n)))
 
 // determine if set is empty
 #define ATTRIBUTESET_EMPTY(set) (set) == NULL
@@ -29,10 +40,11 @@ static bool _AttributeSet_Remove
 ) {
 	AttributeSet _set = *set;
 	int attr_count = _set->attr_count;
+	SIValue *values = ATTRIBUTESET_VALUES(_set, attr_count);
 
 	// locate attribute position
 	for(int i = 0; i < attr_count; i++) {
-		if(attr_id != _set->attributes[i].id) {
+		if(attr_id != _set->ids[i]) {
 			continue;
 		}
 
@@ -44,17 +56,24 @@ static bool _AttributeSet_Remove
 
 		// attribute located
 		// free attribute value
-		SIValue_Free(_set->attributes[i].value);
+		SIValue_Free(values[i]);
 
 		// overwrite deleted attribute with the last
 		// attribute and shrink set
-		_set->attributes[i] = _set->attributes[attr_count - 1];
+		_set->ids[i] = _set->ids[attr_count - 1];
+		values[i]    = values[attr_count - 1];
 
 		// update attribute count
 		_set->attr_count--;
 
+		// values array might need to shift towards the identifiers array
+		SIValue *shifted = ATTRIBUTESET_VALUES(_set, _set->attr_count);
+		if(shifted != values) {
+			memmove(shifted, values, sizeof(SIValue) * _set->attr_count);
+		}
+
 		// compute new set size
-		size_t n = ATTRIBUTESET_BYTE_SIZE(_set);
+		size_t n = ATTRIBUTESET_BYTE_SIZE(_set->attr_count);
 		*set = rm_realloc(_set, n);
 
 		// attribute removed
@@ -77,18 +96,13 @@ SIValue *AttributeSet_Get
 
 	if(attr_id == ATTRIBUTE_ID_NONE) return ATTRIBUTE_NOTFOUND;
 
-	// TODO: benchmark, consider alternatives:
-	// sorted set
-	// array divided in two:
-	// [attr_id_0, attr_id_1, attr_id_2, value_0, value_1, value_2]
 	for(int i = 0; i < set->attr_count; i++) {
-		Attribute *attr = set->attributes + i;
-		if(attr_id == attr->id) {
+		if(attr_id == set->ids[i]) {
 			// note, unsafe as attribute-set can get reallocated
 			// TODO: why do we return a pointer to value instead of a copy ?
 			// especially when AttributeSet_GetIdx returns SIValue
 			// note AttributeSet_Update operate on this pointer
-			return &attr->value;
+			return ATTRIBUTESET_VALUES(set, set->attr_count) + i;
 		}
 	}
 
@@ -106,10 +120,9 @@ SIValue AttributeSet_GetIdx
 	ASSERT(i < set->attr_count);
 	ASSERT(attr_id != NULL);
 
-	Attribute *attr = set->attributes + i;
-	*attr_id = attr->id;
+	*attr_id = set->ids[i];
 
-	return attr->value;
+	return ATTRIBUTESET_VALUES(set, set->attr_count)[i];
 }
 
 static AttributeSet AttributeSet_AddPrepare
@@ -127,16 +140,36 @@ static AttributeSet AttributeSet_AddPrepare
 
 	// allocate room for new attribute
 	if(_set == NULL) {
-		_set = rm_malloc(sizeof(_AttributeSet) + sizeof(Attribute));
+		_set = rm_malloc(ATTRIBUTESET_BYTE_SIZE(1));
 		_set->attr_count = 1;
 	} else {
-		_set->attr_count++;
-		size_t n = ATTRIBUTESET_BYTE_SIZE(_set);
+		ushort attr_count = _set->attr_count;
+		size_t n = ATTRIBUTESET_BYTE_SIZE(attr_count + 1);
 		_set = rm_realloc(_set, n);
+
+		// values array might need to shift to make room for the new identifier
+		SIValue *values  = ATTRIBUTESET_VALUES(_set, attr_count);
+		SIValue *shifted = ATTRIBUTESET_VALUES(_set, attr_count + 1);
+		if(shifted != values) {
+			memmove(shifted, values, sizeof(SIValue) * attr_count);
+		}
+
+		_set->attr_count++;
 	}
+
+	_set->ids[_set->attr_count - 1] = attr_id;
+
 	return _set;
 }
 
+// returns the value slot of the last attribute in set
+static inline SIValue *_AttributeSet_LastValue
+(
+	AttributeSet set
+) {
+	return ATTRIBUTESET_VALUES(set, set->attr_count) + set->attr_count - 1;
+}
+
 // adds an attribute to the set without cloning the SIvalue
 void AttributeSet_AddNoClone
 (
@@ -150,9 +183,7 @@ void AttributeSet_AddNoClone
 	AttributeSet _set = AttributeSet_AddPrepare(set, attr_id);
 
 	// set attribute
-	Attribute *attr = _set->attributes + _set->attr_count - 1;
-	attr->id = attr_id;
-	attr->value = value;
+	*_AttributeSet_LastValue(_set) = value;
 
 	// update pointer
 	*set = _set;
@@ -171,9 +202,7 @@ void AttributeSet_Add
 	AttributeSet _set = AttributeSet_AddPrepare(set, attr_id);
 
 	// set attribute
-	Attribute *attr = _set->attributes + _set->attr_count - 1;
-	attr->id = attr_id;
-	attr->value = SI_CloneValue(value);
+	*_AttributeSet_LastValue(_set) = SI_CloneValue(value);
 
 	// update pointer
 	*set = _set;
@@ -207,9 +236,7 @@ void AttributeSet_Set_Allow_Null
 	_set = AttributeSet_AddPrepare(set, attr_id);
 
 	// set attribute
-	Attribute *attr = _set->attributes + _set->attr_count - 1;
-	attr->id = attr_id;
-	attr->value = SI_CloneValue(value);
+	*_AttributeSet_LastValue(_set) = SI_CloneValue(value);
 
 	// update pointer
 	*set = _set;
@@ -278,16 +305,17 @@ AttributeSet AttributeSet_Clone
 ) {
 	if(set == NULL) return NULL;
 
-	size_t n = ATTRIBUTESET_BYTE_SIZE(set);
+	ushort attr_count   = set->attr_count;
+	size_t n            = ATTRIBUTESET_BYTE_SIZE(attr_count);
 	AttributeSet clone  = rm_malloc(n);
-	clone->attr_count   = set->attr_count;
-	
-	for (ushort i = 0; i < set->attr_count; i++) {
-		Attribute *attr        = set->attributes   + i;
-		Attribute *clone_attr  = clone->attributes + i;
-
-		clone_attr->id = attr->id;
-		clone_attr->value = SI_CloneValue(attr->value);
+	clone->attr_count   = attr_count;
+
+	SIValue *values        = ATTRIBUTESET_VALUES(set,   attr_count);
+	SIValue *clone_values  = ATTRIBUTESET_VALUES(clone, attr_count);
+
+	for (ushort i = 0; i < attr_count; i++) {
+		clone->ids[i]    = set->ids[i];
+		clone_values[i]  = SI_CloneValue(values[i]);
 	}
 
     return clone;
@@ -305,8 +333,9 @@ void AttributeSet_Free
 	if(_set == NULL) return;
 
 	// free all allocated properties
+	SIValue *values = ATTRIBUTESET_VALUES(_set, _set->attr_count);
 	for(int i = 0; i < _set->attr_count; i++) {
-		SIValue_Free(_set->attributes[i].value);
+		SIValue_Free(values[i]);
 	}
 
 	rm_free(_set);
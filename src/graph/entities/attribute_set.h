@@ -19,14 +19,14 @@
 
 typedef unsigned short Attribute_ID;
 
+// each entity owns a single set holding all of its attributes
+// identifiers are packed ahead of the values within the set's allocation:
+// [id_0, id_1, ..., id_n, pad, value_0, ..., value_n]
+// such that locating an attribute scans a tightly packed identifiers array
+// and no padding is introduced between each identifier and its value
 typedef struct {
-	Attribute_ID id;  // attribute identifier
-	SIValue value;    // attribute value
-} Attribute;
-
-typedef struct {
-	ushort attr_count;       // number of attributes
-	Attribute attributes[];  // key value pair of attributes
+	ushort attr_count;  // number of attributes
+	Attribute_ID ids[]; // attribute identifiers, followed by attribute values
 } _AttributeSet;
 
 typedef _AttributeSet* AttributeSet;
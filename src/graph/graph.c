@@ -8,6 +8,7 @@
 #include "graph.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../configuration/config.h"
 #include "../util/datablock/oo_datablock.h"
 #include "../graph/rg_matrix/rg_matrix_iter.h"
 
@@ -61,6 +62,13 @@ void Graph_AcquireReadLock(Graph *g) {
 void Graph_AcquireWriteLock(Graph *g) {
 	pthread_rwlock_wrlock(&g->_rwlock);
 	g->_writelocked = true;
+	g->_write_count++;
+}
+
+// acquire a lock for exclusive access to this graph's internal structures
+void Graph_AcquireMaintenanceLock(Graph *g) {
+	pthread_rwlock_wrlock(&g->_rwlock);
+	g->_writelocked = true;
 }
 
 // Release the held lock
@@ -79,6 +87,40 @@ void Graph_ReleaseLock
 	pthread_rwlock_unlock(&g->_rwlock);
 }
 
+// returns the number of times the graph was write locked for modification
+uint64_t Graph_WriteCount
+(
+	const Graph *g
+) {
+	ASSERT(g != NULL);
+	return g->_write_count;
+}
+
+// pin the graph's matrices in place for a query suspended in between reads
+void Graph_Pin
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	// the write count only grows, pinned queries suspended before the
+	// latest pin are either suspended at the same write count or invalid
+	__atomic_store_n(&g->_pinned_write_count, g->_write_count,
+			__ATOMIC_RELAXED);
+	__atomic_add_fetch(&g->_pinned, 1, __ATOMIC_RELEASE);
+}
+
+// release a pin acquired by Graph_Pin
+void Graph_Unpin
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+	ASSERT(g->_pinned > 0);
+
+	__atomic_sub_fetch(&g->_pinned, 1, __ATOMIC_RELEASE);
+}
+
 //------------------------------------------------------------------------------
 // Graph utility functions
 //------------------------------------------------------------------------------
@@ -426,6 +468,171 @@ bool Graph_Pending
 	return false;
 }
 
+//------------------------------------------------------------------------------
+// Delta matrices compaction
+//------------------------------------------------------------------------------
+
+// returns true if M has at least 'threshold' pending changes
+static bool _MatrixRequiresCompaction
+(
+	const RG_Matrix M,
+	uint64_t threshold
+) {
+	GrB_Index n;
+
+	RG_Matrix_pendingChanges(&n, M);
+	if(n >= threshold) {
+		return true;
+	}
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(M)) {
+		RG_Matrix_pendingChanges(&n, M->transposed);
+		if(n >= threshold) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// computes a compacted copy of M and its transpose
+// in case they've accumulated at least 'threshold' pending changes
+static void _MatrixCompact
+(
+	const Graph *g,
+	RG_Matrix M,
+	uint64_t threshold,
+	MatrixCompaction **compactions
+) {
+	// resize and materialize M, such that concurrent readers won't
+	// need to modify M while its compacted copy is being computed
+	_MatrixSynchronize(g, M);
+
+	// only capture M and its transpose while holding M's lock
+	// compacting the captured copies is done without the lock
+	// such that concurrent readers synchronizing M aren't blocked
+	int n_snapshots = 0;
+	RG_Matrix targets[2];
+	RG_MatrixSnapshot snapshots[2];
+
+	RG_Matrix_Lock(M);
+
+	RG_Matrix matrices[2] = {M, RG_Matrix_getTranspose(M)};
+	for(int i = 0; i < 2; i++) {
+		RG_Matrix A = matrices[i];
+		if(A == NULL) continue;
+
+		GrB_Index n;
+		RG_Matrix_pendingChanges(&n, A);
+		if(n < threshold) continue;
+
+		GrB_Info info = RG_Matrix_snapshot(snapshots + n_snapshots, A);
+		ASSERT(info == GrB_SUCCESS);
+		UNUSED(info);
+
+		targets[n_snapshots++] = A;
+	}
+
+	RG_Matrix_Unlock(M);
+
+	for(int i = 0; i < n_snapshots; i++) {
+		MatrixCompaction c = {.target  = targets[i],
+		                      .version = snapshots[i].version};
+		GrB_Info info = RG_Matrix_compact(&c.compacted, snapshots + i);
+		ASSERT(info == GrB_SUCCESS);
+		UNUSED(info);
+
+		array_append(*compactions, c);
+	}
+}
+
+// returns true if any of the graph's matrices accumulated at least
+// 'threshold' pending changes
+bool Graph_RequiresCompaction
+(
+	const Graph *g,
+	uint64_t threshold
+) {
+	ASSERT(g != NULL);
+	ASSERT(threshold > 0);
+
+	if(_MatrixRequiresCompaction(g->adjacency_matrix, threshold)) return true;
+	if(_MatrixRequiresCompaction(g->node_labels, threshold)) return true;
+
+	uint n = array_len(g->labels);
+	for(uint i = 0; i < n; i++) {
+		if(_MatrixRequiresCompaction(g->labels[i], threshold)) return true;
+	}
+
+	n = array_len(g->relations);
+	for(uint i = 0; i < n; i++) {
+		if(_MatrixRequiresCompaction(g->relations[i], threshold)) return true;
+	}
+
+	return false;
+}
+
+// computes a compacted copy of every graph matrix which accumulated at least
+// 'threshold' pending changes, the graph itself is not modified
+MatrixCompaction *Graph_CompactMatrices
+(
+	const Graph *g,
+	uint64_t threshold
+) {
+	ASSERT(g != NULL);
+	ASSERT(threshold > 0);
+
+	MatrixCompaction *compactions = array_new(MatrixCompaction, 0);
+
+	_MatrixCompact(g, g->adjacency_matrix, threshold, &compactions);
+	_MatrixCompact(g, g->node_labels, threshold, &compactions);
+
+	uint n = array_len(g->labels);
+	for(uint i = 0; i < n; i++) {
+		_MatrixCompact(g, g->labels[i], threshold, &compactions);
+	}
+
+	n = array_len(g->relations);
+	for(uint i = 0; i < n; i++) {
+		_MatrixCompact(g, g->relations[i], threshold, &compactions);
+	}
+
+	return compactions;
+}
+
+// replaces graph matrices with their compacted copies
+// copies of matrices modified since compaction are discarded
+void Graph_ApplyCompaction
+(
+	Graph *g,
+	MatrixCompaction *compactions
+) {
+	ASSERT(g           != NULL);
+	ASSERT(compactions != NULL);
+
+	// suspended queries hold iterators over the graph's matrices
+	// which are only safe to resume as long as the graph wasn't modified
+	bool pinned = __atomic_load_n(&g->_pinned, __ATOMIC_ACQUIRE) > 0 &&
+		__atomic_load_n(&g->_pinned_write_count, __ATOMIC_RELAXED) ==
+		g->_write_count;
+
+	// matrices are only removed from the graph by the same commit which
+	// introduced them, as such every compaction target is still valid
+	uint n = array_len(compactions);
+	for(uint i = 0; i < n; i++) {
+		MatrixCompaction *c = compactions + i;
+		if(pinned) {
+			GrB_Info info = GrB_Matrix_free(&c->compacted);
+			ASSERT(info == GrB_SUCCESS);
+			UNUSED(info);
+			continue;
+		}
+		RG_Matrix_applyCompaction(c->target, &c->compacted, c->version);
+	}
+
+	array_free(compactions);
+}
+
 //------------------------------------------------------------------------------
 // Graph API
 //------------------------------------------------------------------------------
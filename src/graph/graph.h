@@ -38,6 +38,13 @@ typedef enum {
 	SYNC_POLICY_NOP,
 } MATRIX_POLICY;
 
+// compacted copy of a graph matrix
+typedef struct {
+	RG_Matrix target;      // matrix being compacted
+	GrB_Matrix compacted;  // compacted copy of target's main matrix
+	uint64_t version;      // target's version the copy reflects
+} MatrixCompaction;
+
 // forward declaration of Graph struct
 typedef struct Graph Graph;
 // typedef for synchronization function pointer
@@ -53,6 +60,12 @@ struct Graph {
 	RG_Matrix _zero_matrix;             // zero matrix
 	pthread_rwlock_t _rwlock;           // read-write lock scoped to this specific graph
 	bool _writelocked;                  // true if the read-write lock was acquired by a writer
+	bool _compaction_scheduled;         // true if a background compaction is pending
+	bool _idle_compaction_scheduled;    // true if an idle compaction is pending
+	uint64_t _last_commit;              // time of last committed modification in ms
+	uint64_t _write_count;              // number of times the graph was write locked for modification
+	uint _pinned;                       // number of suspended queries iterating the graph's matrices
+	uint64_t _pinned_write_count;       // write count at the time the graph was last pinned
 	SyncMatrixFunc SynchronizeMatrix;   // function pointer to matrix synchronization routine
 	GraphStatistics stats;              // graph related statistics
 };
@@ -67,17 +80,48 @@ void Graph_AcquireReadLock
 );
 
 // acquire a lock for exclusive access to this graph's data
+// the graph is about to be modified, incrementing its write count
 void Graph_AcquireWriteLock
 (
 	Graph *g
 );
 
+// acquire a lock for exclusive access to this graph's internal structures
+// used by maintenance which leaves the graph's content as is
+// e.g. matrix compaction, the graph's write count isn't incremented
+void Graph_AcquireMaintenanceLock
+(
+	Graph *g
+);
+
 // release the held lock
 void Graph_ReleaseLock
 (
 	Graph *g
 );
 
+// returns the number of times the graph was write locked for modification
+// the graph's content is unchanged for as long as this number doesn't change
+// caller should hold the graph's lock
+uint64_t Graph_WriteCount
+(
+	const Graph *g
+);
+
+// pin the graph's matrices in place for a query suspended in between reads
+// compaction is postponed for as long as the graph is pinned and unmodified
+// caller should hold the graph's lock
+void Graph_Pin
+(
+	Graph *g
+);
+
+// release a pin acquired by Graph_Pin
+void Graph_Unpin
+(
+	Graph *g
+);
+
 // choose the current matrix synchronization policy
 void Graph_SetMatrixPolicy
 (
@@ -105,6 +149,33 @@ void Graph_SetMatrixPolicy
 	MATRIX_POLICY policy
 );
 
+// returns true if any of the graph's matrices accumulated at least
+// 'threshold' pending changes
+bool Graph_RequiresCompaction
+(
+	const Graph *g,
+	uint64_t threshold
+);
+
+// computes a compacted copy of every graph matrix which accumulated at least
+// 'threshold' pending changes, the graph itself is not modified
+// caller must hold the graph's read lock
+MatrixCompaction *Graph_CompactMatrices
+(
+	const Graph *g,
+	uint64_t threshold
+);
+
+// replaces graph matrices with their compacted copies
+// copies of matrices modified since compaction are discarded
+// all copies are discarded while the graph is pinned, see Graph_Pin
+// caller must hold the graph's write lock
+void Graph_ApplyCompaction
+(
+	Graph *g,
+	MatrixCompaction *compactions
+);
+
 // checks to see if graph has pending operations
 bool Graph_Pending
 (
@@ -0,0 +1,722 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "graph_defrag.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
+#include "../util/thpool/pools.h"
+#include "../query_ctx.h"
+#include "rg_matrix/rg_matrix_iter.h"
+
+// duration of a single defragmentation step in ms
+#define DEFRAG_STEP_MS 5
+
+// number of nodes moved in between step duration checks
+#define DEFRAG_NODE_BATCH 64
+
+// number of relation matrix rows scanned in between step duration checks
+#define DEFRAG_ROW_BATCH 1024
+
+// edge located past the graph's edge count, due to be moved
+typedef struct {
+	GrB_Index row;   // edge's source node
+	GrB_Index col;   // edge's destination node
+	EdgeID id;       // edge's current ID
+	uint64_t *slot;  // edge's position within multi-edge array, NULL if single
+} MisplacedEdge;
+
+typedef struct {
+	GraphContext *gc;      // graph being defragmented
+	RedisModuleCtx *ctx;   // thread-safe context, used to acquire the GIL
+	int db;                // graph's database, steps are replicated to
+	uint64_t *src;         // original IDs of moved entities
+	uint64_t *dst;         // new IDs of moved entities
+	GrB_Index *cols;       // scratch, matrix column indices
+	uint64_t *vals;        // scratch, matrix values
+	MisplacedEdge *edges;  // scratch, edges to move
+} DefragCtx;
+
+// defragmentation phases
+typedef enum {
+	DEFRAG_PHASE_NODES = 0,  // renumber nodes
+	DEFRAG_PHASE_EDGES,      // renumber edges
+	DEFRAG_PHASE_SHRINK      // release unused storage
+} DefragPhase;
+
+// defragmentation task, each step is executed as a separate writer task
+// such that writes queued in the meantime are executed in between steps
+typedef struct {
+	DefragCtx dc;       // defragmentation context
+	DefragPhase phase;  // current phase
+	int r;              // relation edges scan resumes from
+	NodeID row;         // row edges scan resumes from
+} DefragTask;
+
+// locks are acquired via QueryCtx_AcquireCommitLocks
+static void _Defrag_Unlock
+(
+	DefragCtx *dc
+) {
+	Graph_ReleaseLock(dc->gc->g);
+	RedisModule_ThreadSafeContextUnlock(dc->ctx);
+}
+
+// collect entries of row 'row'
+// values are collected only if 'vals' is not NULL
+static void _Defrag_CollectRow
+(
+	RG_Matrix M,       // matrix to scan
+	GrB_Index row,     // row to collect
+	GrB_Index **cols,  // [output] columns of row's entries
+	uint64_t **vals    // [output] values of row's entries
+) {
+	GrB_Index          j;
+	uint64_t           v;
+	RG_MatrixTupleIter it = {0};
+
+	array_clear(*cols);
+	if(vals != NULL) array_clear(*vals);
+
+	RG_MatrixTupleIter_AttachRange(&it, M, row, row);
+
+	if(vals != NULL) {
+		while(RG_MatrixTupleIter_next_UINT64(&it, NULL, &j, &v) == GrB_SUCCESS) {
+			array_append(*cols, j);
+			array_append(*vals, v);
+		}
+	} else {
+		while(RG_MatrixTupleIter_next_BOOL(&it, NULL, &j, NULL) == GrB_SUCCESS) {
+			array_append(*cols, j);
+		}
+	}
+
+	RG_MatrixTupleIter_detach(&it);
+}
+
+// duplicates a relation matrix entry
+// multi-edge arrays are freed once their entry is removed from the matrix
+// as such an entry moved to a new position requires its own copy
+static uint64_t _Defrag_CloneEntry
+(
+	uint64_t v
+) {
+	if(SINGLE_EDGE(v)) return v;
+
+	uint64_t *clone;
+	uint64_t *ids = (uint64_t *)(CLEAR_MSB(v));
+	array_clone(clone, ids);
+
+	return (uint64_t)SET_MSB(clone);
+}
+
+// replace an edge's index documents
+static void _Defrag_ReindexEdge
+(
+	Graph *g,         // graph
+	Schema *s,        // edge's schema
+	int r,            // edge's relationship type
+	EdgeID old_id,    // edge ID before move
+	NodeID old_src,   // source node ID before move
+	NodeID old_dest,  // destination node ID before move
+	EdgeID new_id,    // edge ID after move
+	NodeID new_src,   // source node ID after move
+	NodeID new_dest   // destination node ID after move
+) {
+	Edge e = {0};
+
+	e.relationID = r;
+	e.id         = old_id;
+	e.srcNodeID  = old_src;
+	e.destNodeID = old_dest;
+	Schema_RemoveEdgeFromIndices(s, &e);
+
+	e.id         = new_id;
+	e.srcNodeID  = new_src;
+	e.destNodeID = new_dest;
+	e.attributes = DataBlock_GetItem(g->edges, new_id);
+	ASSERT(e.attributes != NULL);
+	Schema_AddEdgeToIndices(s, &e);
+}
+
+// replace index documents of each edge within entry
+// after the entry's endpoints have moved
+static void _Defrag_ReindexEntry
+(
+	Graph *g,         // graph
+	Schema *s,        // relationship schema
+	int r,            // relationship type
+	uint64_t v,       // relation matrix entry
+	NodeID old_src,   // source node ID before move
+	NodeID old_dest,  // destination node ID before move
+	NodeID new_src,   // source node ID after move
+	NodeID new_dest   // destination node ID after move
+) {
+	if(SINGLE_EDGE(v)) {
+		_Defrag_ReindexEdge(g, s, r, v, old_src, old_dest, v, new_src,
+				new_dest);
+		return;
+	}
+
+	uint64_t *ids = (uint64_t *)(CLEAR_MSB(v));
+	uint n = array_len(ids);
+	for(uint i = 0; i < n; i++) {
+		_Defrag_ReindexEdge(g, s, r, ids[i], old_src, old_dest, ids[i],
+				new_src, new_dest);
+	}
+}
+
+// move node's labels from 'src' to 'dst'
+static void _Defrag_MoveNodeLabels
+(
+	DefragCtx *dc,
+	NodeID src,
+	NodeID dst
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	GraphContext *gc = dc->gc;
+	Graph        *g  = gc->g;
+	RG_Matrix    nl  = Graph_GetNodeLabelMatrix(g);
+
+	_Defrag_CollectRow(nl, src, &dc->cols, NULL);
+
+	Node old_node = GE_NEW_NODE();
+	Node new_node = GE_NEW_NODE();
+	old_node.id         = src;
+	new_node.id         = dst;
+	new_node.attributes = DataBlock_GetItem(g->nodes, dst);
+
+	uint label_count = array_len(dc->cols);
+	for(uint i = 0; i < label_count; i++) {
+		LabelID l = dc->cols[i];
+		RG_Matrix L = Graph_GetLabelMatrix(g, l);
+
+		info = RG_Matrix_removeElement_BOOL(L, src, src);
+		ASSERT(info == GrB_SUCCESS);
+		info = RG_Matrix_setElement_BOOL(L, dst, dst);
+		ASSERT(info == GrB_SUCCESS);
+
+		info = RG_Matrix_removeElement_BOOL(nl, src, l);
+		ASSERT(info == GrB_SUCCESS);
+		info = RG_Matrix_setElement_BOOL(nl, dst, l);
+		ASSERT(info == GrB_SUCCESS);
+
+		Schema *s = GraphContext_GetSchemaByID(gc, l, SCHEMA_NODE);
+		if(Schema_HasIndices(s)) {
+			Schema_RemoveNodeFromIndices(s, &old_node);
+			Schema_AddNodeToIndices(s, &new_node);
+		}
+	}
+}
+
+// move node's incoming and outgoing edges from 'src' to 'dst'
+static void _Defrag_MoveNodeEdges
+(
+	DefragCtx *dc,
+	NodeID src,
+	NodeID dst
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	GraphContext *gc = dc->gc;
+	Graph        *g  = gc->g;
+
+	//--------------------------------------------------------------------------
+	// relation matrices
+	//--------------------------------------------------------------------------
+
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int r = 0; r < relation_count; r++) {
+		RG_Matrix R  = Graph_GetRelationMatrix(g, r, false);
+		RG_Matrix TR = RG_Matrix_getTranspose(R);
+		Schema    *s = GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE);
+		bool indexed = Schema_HasIndices(s);
+
+		// outgoing edges, src -> j
+		_Defrag_CollectRow(R, src, &dc->cols, &dc->vals);
+
+		uint n = array_len(dc->cols);
+		for(uint i = 0; i < n; i++) {
+			GrB_Index j = dc->cols[i];
+			uint64_t  v = _Defrag_CloneEntry(dc->vals[i]);
+			// self pointing edge moves along with node
+			GrB_Index k = (j == src) ? dst : j;
+
+			info = RG_Matrix_removeElement_UINT64(R, src, j);
+			ASSERT(info == GrB_SUCCESS);
+			info = RG_Matrix_setElement_UINT64(R, v, dst, k);
+			ASSERT(info == GrB_SUCCESS);
+
+			if(indexed) _Defrag_ReindexEntry(g, s, r, v, src, j, dst, k);
+		}
+
+		// incoming edges, j -> src
+		_Defrag_CollectRow(TR, src, &dc->cols, NULL);
+
+		n = array_len(dc->cols);
+		for(uint i = 0; i < n; i++) {
+			uint64_t  v;
+			GrB_Index j = dc->cols[i];
+			// self pointing edges were moved as outgoing edges
+			if(j == src) continue;
+
+			info = RG_Matrix_extractElement_UINT64(&v, R, j, src);
+			ASSERT(info == GrB_SUCCESS);
+			v = _Defrag_CloneEntry(v);
+
+			info = RG_Matrix_removeElement_UINT64(R, j, src);
+			ASSERT(info == GrB_SUCCESS);
+			info = RG_Matrix_setElement_UINT64(R, v, j, dst);
+			ASSERT(info == GrB_SUCCESS);
+
+			if(indexed) _Defrag_ReindexEntry(g, s, r, v, j, src, j, dst);
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// adjacency matrix
+	//--------------------------------------------------------------------------
+
+	RG_Matrix A  = Graph_GetAdjacencyMatrix(g, false);
+	RG_Matrix TA = RG_Matrix_getTranspose(A);
+
+	// outgoing connections, src -> j
+	_Defrag_CollectRow(A, src, &dc->cols, NULL);
+
+	uint n = array_len(dc->cols);
+	for(uint i = 0; i < n; i++) {
+		GrB_Index j = dc->cols[i];
+		GrB_Index k = (j == src) ? dst : j;
+
+		info = RG_Matrix_removeElement_BOOL(A, src, j);
+		ASSERT(info == GrB_SUCCESS);
+		info = RG_Matrix_setElement_BOOL(A, dst, k);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// incoming connections, j -> src
+	_Defrag_CollectRow(TA, src, &dc->cols, NULL);
+
+	n = array_len(dc->cols);
+	for(uint i = 0; i < n; i++) {
+		GrB_Index j = dc->cols[i];
+		if(j == src) continue;
+
+		info = RG_Matrix_removeElement_BOOL(A, j, src);
+		ASSERT(info == GrB_SUCCESS);
+		info = RG_Matrix_setElement_BOOL(A, j, dst);
+		ASSERT(info == GrB_SUCCESS);
+	}
+}
+
+// moves up to 'n' nodes with the highest IDs into free node slots
+// returns number of nodes moved
+static uint64_t _Defrag_MoveNodes
+(
+	DefragCtx *dc,
+	uint64_t n
+) {
+	Graph *g = dc->gc->g;
+	uint64_t total = 0;
+
+	while(total < n) {
+		uint64_t batch = MIN(n - total, DEFRAG_NODE_BATCH);
+		uint64_t moved = DataBlock_Compact(g->nodes, batch, dc->src, dc->dst);
+
+		for(uint64_t i = 0; i < moved; i++) {
+			_Defrag_MoveNodeLabels(dc, dc->src[i], dc->dst[i]);
+			_Defrag_MoveNodeEdges(dc, dc->src[i], dc->dst[i]);
+		}
+
+		total += moved;
+
+		// node storage is compact
+		if(moved < batch) break;
+	}
+
+	return total;
+}
+
+static int _Defrag_CompareEdges
+(
+	const void *a,
+	const void *b
+) {
+	EdgeID x = ((const MisplacedEdge *)a)->id;
+	EdgeID y = ((const MisplacedEdge *)b)->id;
+	return (x > y) - (x < y);
+}
+
+// moves edges of relation 'r' originating from rows [lo, hi]
+// whose IDs lie past the graph's edge count into free edge slots
+// returns number of edges moved
+static uint64_t _Defrag_MoveEdges
+(
+	DefragCtx *dc,
+	int r,
+	NodeID lo,
+	NodeID hi
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	GraphContext *gc = dc->gc;
+	Graph        *g  = gc->g;
+
+	// once compact, edges occupy the ID range [0, edge count)
+	EdgeID             target = Graph_EdgeCount(g);
+	GrB_Index          i;
+	GrB_Index          j;
+	uint64_t           v;
+	RG_MatrixTupleIter it     = {0};
+	RG_Matrix          R      = Graph_GetRelationMatrix(g, r, false);
+
+	array_clear(dc->edges);
+
+	RG_MatrixTupleIter_AttachRange(&it, R, lo, hi);
+	while(RG_MatrixTupleIter_next_UINT64(&it, &i, &j, &v) == GrB_SUCCESS) {
+		if(SINGLE_EDGE(v)) {
+			if(v < target) continue;
+			MisplacedEdge e = {.row = i, .col = j, .id = v, .slot = NULL};
+			array_append(dc->edges, e);
+			continue;
+		}
+
+		uint64_t *ids = (uint64_t *)(CLEAR_MSB(v));
+		uint n = array_len(ids);
+		for(uint k = 0; k < n; k++) {
+			if(ids[k] < target) continue;
+			MisplacedEdge e = {.row = i, .col = j, .id = ids[k], .slot = ids + k};
+			array_append(dc->edges, e);
+		}
+	}
+	RG_MatrixTupleIter_detach(&it);
+
+	uint64_t n = array_len(dc->edges);
+	if(n == 0) return 0;
+
+	// the order in which entries are iterated depends on the matrix's
+	// internal state, sort edges by ID such that free slots are assigned
+	// identically wherever the move is applied
+	qsort(dc->edges, n, sizeof(MisplacedEdge), _Defrag_CompareEdges);
+
+	dc->src = array_ensure_len(dc->src, n);
+	dc->dst = array_ensure_len(dc->dst, n);
+	for(uint64_t k = 0; k < n; k++) dc->src[k] = dc->edges[k].id;
+
+	DataBlock_MoveItems(g->edges, dc->src, n, dc->dst);
+
+	Schema *s       = GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE);
+	bool    indexed = Schema_HasIndices(s);
+
+	for(uint64_t k = 0; k < n; k++) {
+		MisplacedEdge *e = dc->edges + k;
+
+		if(e->slot != NULL) {
+			// multi-edge arrays are updated in place
+			*e->slot = dc->dst[k];
+		} else {
+			info = RG_Matrix_removeElement_UINT64(R, e->row, e->col);
+			ASSERT(info == GrB_SUCCESS);
+			info = RG_Matrix_setElement_UINT64(R, dc->dst[k], e->row, e->col);
+			ASSERT(info == GrB_SUCCESS);
+		}
+
+		if(indexed) {
+			_Defrag_ReindexEdge(g, s, r, e->id, e->row, e->col, dc->dst[k],
+					e->row, e->col);
+		}
+	}
+
+	return n;
+}
+
+static void _DefragCtx_Init
+(
+	DefragCtx *dc,
+	GraphContext *gc,
+	RedisModuleCtx *ctx,
+	int db
+) {
+	dc->gc    = gc;
+	dc->ctx   = ctx;
+	dc->db    = db;
+	dc->src   = array_newlen(uint64_t, DEFRAG_NODE_BATCH);
+	dc->dst   = array_newlen(uint64_t, DEFRAG_NODE_BATCH);
+	dc->cols  = array_new(GrB_Index, 0);
+	dc->vals  = array_new(uint64_t, 0);
+	dc->edges = array_new(MisplacedEdge, 0);
+}
+
+static void _DefragCtx_Free
+(
+	DefragCtx *dc
+) {
+	array_free(dc->src);
+	array_free(dc->dst);
+	array_free(dc->cols);
+	array_free(dc->vals);
+	array_free(dc->edges);
+}
+
+//------------------------------------------------------------------------------
+// replication
+//------------------------------------------------------------------------------
+
+// steps are replicated as they're applied, rather than replicating the command
+// which scheduled the defragmentation, such that replicas apply them in the
+// same order relative to writes executed in between steps
+// as steps are deterministic, each replica renumbers entities identically
+
+static void _Defrag_ReplicateNodes
+(
+	DefragCtx *dc,
+	uint64_t n
+) {
+	RedisModule_SelectDb(dc->ctx, dc->db);
+	RedisModule_Replicate(dc->ctx, "GRAPH.DEBUG", "cccl!", "DEFRAG",
+			dc->gc->graph_name, "NODES", (long long)n);
+}
+
+static void _Defrag_ReplicateEdges
+(
+	DefragCtx *dc,
+	int r,
+	NodeID lo,
+	NodeID hi
+) {
+	RedisModule_SelectDb(dc->ctx, dc->db);
+	RedisModule_Replicate(dc->ctx, "GRAPH.DEBUG", "ccclll!", "DEFRAG",
+			dc->gc->graph_name, "EDGES", (long long)r, (long long)lo,
+			(long long)hi);
+}
+
+static void _Defrag_ReplicateShrink
+(
+	DefragCtx *dc
+) {
+	RedisModule_SelectDb(dc->ctx, dc->db);
+	RedisModule_Replicate(dc->ctx, "GRAPH.DEBUG", "ccc!", "DEFRAG",
+			dc->gc->graph_name, "SHRINK");
+}
+
+//------------------------------------------------------------------------------
+// defragmentation task
+//------------------------------------------------------------------------------
+
+// performs a single node defragmentation step
+// returns true once node storage is compact
+static bool _Defrag_NodesStep
+(
+	DefragCtx *dc
+) {
+	double tic[2];
+	simple_tic(tic);
+
+	bool     done  = false;
+	uint64_t total = 0;
+
+	while(!done && simple_toc(tic) * 1000 < DEFRAG_STEP_MS) {
+		uint64_t moved = _Defrag_MoveNodes(dc, DEFRAG_NODE_BATCH);
+		done = (moved < DEFRAG_NODE_BATCH);
+		total += moved;
+	}
+
+	// replicated even if no node was moved
+	// as compaction reorders the datablock's free slots
+	_Defrag_ReplicateNodes(dc, total);
+
+	return done;
+}
+
+// performs a single edge defragmentation step
+// relation matrices are scanned for misplaced edges in chunks of rows
+// the scan resumes from 'r' and 'row' and is restarted once all
+// relation matrices have been scanned and edges aren't compact yet
+// e.g. due to writes executed in between steps
+// returns true once edge storage is compact
+static bool _Defrag_EdgesStep
+(
+	DefragCtx *dc,
+	int *r,      // [input/output] relation to resume from
+	NodeID *row  // [input/output] row to resume from
+) {
+	double tic[2];
+	simple_tic(tic);
+
+	Graph *g = dc->gc->g;
+
+	while(simple_toc(tic) * 1000 < DEFRAG_STEP_MS) {
+		if(*r == Graph_RelationTypeCount(g)) {
+			if(DataBlock_IsCompact(g->edges)) return true;
+			*r   = 0;
+			*row = 0;
+			continue;
+		}
+
+		NodeID nrows = Graph_RequiredMatrixDim(g);
+		if(*row >= nrows) {
+			(*r)++;
+			*row = 0;
+			continue;
+		}
+
+		NodeID lo = *row;
+		NodeID hi = MIN(lo + DEFRAG_ROW_BATCH, nrows) - 1;
+		if(_Defrag_MoveEdges(dc, *r, lo, hi) > 0) {
+			_Defrag_ReplicateEdges(dc, *r, lo, hi);
+		}
+
+		*row = hi + 1;
+	}
+
+	return false;
+}
+
+static void _Defrag_Step(void *arg);
+
+// enqueue the task's next step behind writes queued in the meantime
+static void _Defrag_Enqueue
+(
+	DefragTask *task
+) {
+	// forced, a step can't be dropped once defragmentation started
+	int res = ThreadPools_AddWorkWriter(_Defrag_Step, task, 1);
+	ASSERT(res == 0);
+	UNUSED(res);
+}
+
+// free task, releasing its graph
+static void _Defrag_Done
+(
+	DefragTask *task
+) {
+	GraphContext *gc = task->dc.gc;
+
+	RedisModule_FreeThreadSafeContext(task->dc.ctx);
+	_DefragCtx_Free(&task->dc);
+	rm_free(task);
+
+	GraphContext_DecreaseRefCount(gc);
+}
+
+// performs a single defragmentation step, executed on the writer thread
+static void _Defrag_Step
+(
+	void *arg
+) {
+	DefragTask *task = (DefragTask *)arg;
+	DefragCtx  *dc   = &task->dc;
+	Graph      *g    = dc->gc->g;
+
+	QueryCtx_AcquireCommitLocks(g, dc->ctx);
+
+	switch(task->phase) {
+		case DEFRAG_PHASE_NODES:
+			// renumber nodes
+			if(_Defrag_NodesStep(dc)) task->phase = DEFRAG_PHASE_EDGES;
+			break;
+		case DEFRAG_PHASE_EDGES:
+			// renumber edges
+			if(_Defrag_EdgesStep(dc, &task->r, &task->row)) {
+				task->phase = DEFRAG_PHASE_SHRINK;
+			}
+			break;
+		case DEFRAG_PHASE_SHRINK:
+			// release unused storage and shrink matrices to the new node count
+			GraphDefrag_Shrink(dc->gc);
+			_Defrag_ReplicateShrink(dc);
+			_Defrag_Unlock(dc);
+			_Defrag_Done(task);
+			return;
+		default:
+			ASSERT(false && "unknown defragmentation phase");
+			break;
+	}
+
+	_Defrag_Unlock(dc);
+	_Defrag_Enqueue(task);
+}
+
+bool GraphDefrag_Schedule
+(
+	GraphContext *gc,
+	int db
+) {
+	ASSERT(gc != NULL);
+
+	DefragTask *task = rm_malloc(sizeof(DefragTask));
+	task->r     = 0;
+	task->row   = 0;
+	task->phase = DEFRAG_PHASE_NODES;
+	_DefragCtx_Init(&task->dc, gc, RedisModule_GetThreadSafeContext(NULL), db);
+
+	// keep graph alive until defragmentation is done
+	GraphContext_IncreaseRefCount(gc);
+
+	if(ThreadPools_AddWorkWriter(_Defrag_Step, task, 1) != 0) {
+		RedisModule_FreeThreadSafeContext(task->dc.ctx);
+		_DefragCtx_Free(&task->dc);
+		rm_free(task);
+		GraphContext_DecreaseRefCount(gc);
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// replicated steps
+//------------------------------------------------------------------------------
+
+uint64_t GraphDefrag_MoveNodes
+(
+	GraphContext *gc,
+	uint64_t n
+) {
+	ASSERT(gc != NULL);
+
+	DefragCtx dc;
+	_DefragCtx_Init(&dc, gc, NULL, 0);
+	uint64_t moved = _Defrag_MoveNodes(&dc, n);
+	_DefragCtx_Free(&dc);
+
+	return moved;
+}
+
+uint64_t GraphDefrag_MoveEdges
+(
+	GraphContext *gc,
+	int r,
+	NodeID lo,
+	NodeID hi
+) {
+	ASSERT(gc != NULL);
+	ASSERT(r < Graph_RelationTypeCount(gc->g));
+	ASSERT(lo <= hi);
+
+	DefragCtx dc;
+	_DefragCtx_Init(&dc, gc, NULL, 0);
+	uint64_t moved = _Defrag_MoveEdges(&dc, r, lo, hi);
+	_DefragCtx_Free(&dc);
+
+	return moved;
+}
+
+void GraphDefrag_Shrink
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+
+	DataBlock_Shrink(gc->g->nodes);
+	DataBlock_Shrink(gc->g->edges);
+	Graph_ApplyAllPending(gc->g, true);
+}
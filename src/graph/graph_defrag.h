@@ -0,0 +1,63 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "graphcontext.h"
+
+// graph defragmentation
+//
+// deleted nodes and edges leave holes in the graph's entity storage
+// defragmentation moves the entities with the highest IDs into these holes
+// renumbering them such that entity IDs are contiguous
+// every label, relation, adjacency and node-labels matrix as well as every
+// index is updated to reflect the new IDs, once all holes are filled
+// unused storage is released and matrices are shrunk to the new node count
+//
+// defragmentation is performed on the writer thread in time-sliced steps
+// the graph's write lock and the GIL are held for the duration of a step
+// each step is a separate writer task, re-enqueued once the step completes
+// such that readers and writes queued in the meantime run in between steps
+//
+// each step is replicated as it's applied, see GraphDefrag_MoveNodes,
+// GraphDefrag_MoveEdges and GraphDefrag_Shrink, steps are deterministic
+// such that replicas renumber entities exactly as the master did
+
+// schedules a defragmentation of the graph's node and edge storage
+// returns false if the work could not be scheduled
+bool GraphDefrag_Schedule
+(
+	GraphContext *gc,  // graph to defragment
+	int db             // graph's database
+);
+
+// moves up to 'n' nodes with the highest IDs into free node slots
+// the graph's write lock is expected to be held
+// returns number of nodes moved
+uint64_t GraphDefrag_MoveNodes
+(
+	GraphContext *gc,  // graph to defragment
+	uint64_t n         // maximum number of nodes to move
+);
+
+// moves edges of relation 'r' originating from nodes within [lo, hi]
+// whose IDs lie past the graph's edge count into free edge slots
+// the graph's write lock is expected to be held
+// returns number of edges moved
+uint64_t GraphDefrag_MoveEdges
+(
+	GraphContext *gc,  // graph to defragment
+	int r,             // relationship type
+	NodeID lo,         // first row to scan
+	NodeID hi          // last row to scan
+);
+
+// releases unused storage and shrinks matrices to the graph's node count
+// the graph's write lock is expected to be held
+void GraphDefrag_Shrink
+(
+	GraphContext *gc  // graph to shrink
+);
@@ -95,6 +95,72 @@ static void _AddEdgeToIndices(GraphContext *gc, Edge *e) {
 	Schema_AddEdgeToIndices(s, e);
 }
 
+// update the attribute statistics of each of the node's labels
+// the node is either introduced to or removed from the statistics
+static void _UpdateNodeStats
+(
+	GraphContext *gc,
+	Node *n,
+	bool add
+) {
+	ASSERT(n  != NULL);
+	ASSERT(gc != NULL);
+
+	Graph *g = gc->g;
+
+	// retrieve node labels
+	uint label_count;
+	NODE_GET_LABELS(g, n, label_count);
+
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		ASSERT(s != NULL);
+		if(!Schema_HasAttributeStats(s)) continue;
+
+		if(add) Schema_AddEntityToStats(s, (GraphEntity *)n);
+		else    Schema_RemoveEntityFromStats(s, (GraphEntity *)n);
+	}
+}
+
+// update the attribute statistics of each of the node's labels
+// prior to the node's attribute 'attr_id' being set to 'new_value'
+static void _UpdateNodeAttributeStats
+(
+	GraphContext *gc,
+	Node *n,
+	Attribute_ID attr_id,
+	SIValue new_value
+) {
+	ASSERT(n  != NULL);
+	ASSERT(gc != NULL);
+
+	Graph *g = gc->g;
+
+	// retrieve node labels
+	uint label_count;
+	NODE_GET_LABELS(g, n, label_count);
+
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		ASSERT(s != NULL);
+		if(!Schema_HasAttributeStats(s)) continue;
+
+		if(attr_id == ATTRIBUTE_ID_ALL) {
+			// all of the node's attributes are removed
+			const AttributeSet set = GraphEntity_GetAttributes((GraphEntity *)n);
+			for(int j = 0; j < ATTRIBUTE_SET_COUNT(set); j++) {
+				Attribute_ID id;
+				SIValue v = AttributeSet_GetIdx(set, j, &id);
+				Schema_UpdateAttributeStats(s, id, v, SI_NullVal());
+			}
+		} else {
+			SIValue old_value = *GraphEntity_GetProperty((GraphEntity *)n,
+					attr_id);
+			Schema_UpdateAttributeStats(s, attr_id, old_value, new_value);
+		}
+	}
+}
+
 uint CreateNode
 (
 	GraphContext *gc,
@@ -106,6 +172,8 @@ uint CreateNode
 	ASSERT(gc != NULL);
 	ASSERT(n != NULL);
 
+	GraphContext_InternAttributes(gc, set);
+
 	Graph_CreateNode(gc->g, n, labels, label_count);
 	*n->attributes = set;
 
@@ -114,6 +182,9 @@ uint CreateNode
 		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
 		ASSERT(s);
 		Schema_AddNodeToIndices(s, n);
+		if(Schema_HasAttributeStats(s)) {
+			Schema_AddEntityToStats(s, (GraphEntity *)n);
+		}
 	}
 
 	// add node creation operation to undo log
@@ -135,6 +206,8 @@ uint CreateEdge
 	ASSERT(gc != NULL);
 	ASSERT(e != NULL);
 
+	GraphContext_InternAttributes(gc, set);
+
 	Graph_CreateEdge(gc->g, src, dst, r, e);
 	*e->attributes = set;
 
@@ -166,6 +239,8 @@ uint DeleteNode
 		_DeleteNodeFromIndices(gc, n);
 	}
 
+	_UpdateNodeStats(gc, n, false);
+
 	Graph_DeleteNode(gc->g, n);
 
 	return 1;
@@ -207,6 +282,11 @@ static void _Update_Entity_Property
 	uint *props_removed_count
 ) {
 	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+
+	if(entity_type == GETYPE_NODE) {
+		_UpdateNodeAttributeStats(gc, (Node *)ge, attr_id, new_value);
+	}
+
 	if(attr_id == ATTRIBUTE_ID_ALL) {
 		// we're requested to clear entitiy's attribute-set
 		// backup entity's attributes in case we'll need to roolback
@@ -262,12 +342,17 @@ void UpdateEntityProperties
 	int set_props     = 0;
 	int removed_props = 0;
 
+	// intern new string attributes, the entity's attribute set
+	// acquires its own reference to each interned string
+	GraphContext_InternAttributes(gc, set);
+
 	for (uint i = 0; i < ATTRIBUTE_SET_COUNT(set); i++) {
-		Attribute *prop = set->attributes + i;
+		Attribute_ID attr_id;
+		SIValue value = AttributeSet_GetIdx(set, i, &attr_id);
 		uint _set_props     = 0;
 		uint _removed_props = 0;
 
-		_Update_Entity_Property(gc, ge, prop->id, prop->value, entity_type,
+		_Update_Entity_Property(gc, ge, attr_id, value, entity_type,
 				&_set_props, &_removed_props);
 
 		set_props     += _set_props;
@@ -330,6 +415,9 @@ void UpdateNodeLabels
 				add_labels_ids[add_labels_index++] = schema_id;
 				// add to index
 				Schema_AddNodeToIndices(s, node);
+				if(Schema_HasAttributeStats(s)) {
+					Schema_AddEntityToStats(s, (GraphEntity *)node);
+				}
 			}
 		}
 
@@ -362,6 +450,10 @@ void UpdateNodeLabels
 			remove_labels_ids[remove_labels_index++] = Schema_GetID(s);
 			// remove node from index
 			Schema_RemoveNodeFromIndices(s, node);
+			if(Schema_HasAttributeStats(s) &&
+			   Graph_IsNodeLabeled(gc->g, node->id, Schema_GetID(s))) {
+				Schema_RemoveEntityFromStats(s, (GraphEntity *)node);
+			}
 		}
 
 		if(remove_labels_index > 0) {
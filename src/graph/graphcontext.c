@@ -4,6 +4,7 @@
  * the Server Side Public License v1 (SSPLv1).
  */
 
+#include <time.h>
 #include <sys/param.h>
 #include <pthread.h>
 #include "graphcontext.h"
@@ -12,10 +13,12 @@
 #include "../util/uuid.h"
 #include "../query_ctx.h"
 #include "../redismodule.h"
+#include "../util/cron.h"
 #include "../util/rmalloc.h"
 #include "../util/thpool/pools.h"
 #include "../serializers/graphcontext_type.h"
 #include "../commands/execution_ctx.h"
+#include "../commands/prepared_statements.h"
 
 // Global array tracking all extant GraphContexts (defined in module.c)
 extern GraphContext **graphs_in_keyspace;
@@ -92,6 +95,7 @@ GraphContext *GraphContext_New
 	gc->string_mapping   = array_new(char *, 64);
 	gc->encoding_context = GraphEncodeContext_New();
 	gc->decoding_context = GraphDecodeContext_New();
+	gc->string_pool      = StringPool_New();
 
 	// read NODE_CREATION_BUFFER size from configuration
 	// this value controls how much extra room we're willing to spend for:
@@ -120,6 +124,8 @@ GraphContext *GraphContext_New
 	gc->cache = Cache_New(cache_size, (CacheEntryFreeFunc)ExecutionCtx_Free,
 						  (CacheEntryCopyFunc)ExecutionCtx_Clone);
 
+	gc->prepared = PreparedStatements_New();
+
 	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
 
 	return gc;
@@ -659,6 +665,252 @@ Cache *GraphContext_GetCache(const GraphContext *gc) {
 	return gc->cache;
 }
 
+PreparedStatements *GraphContext_GetPreparedStatements(const GraphContext *gc) {
+	ASSERT(gc != NULL);
+	return gc->prepared;
+}
+
+//------------------------------------------------------------------------------
+// Compaction API
+//------------------------------------------------------------------------------
+
+// graph matrices compaction, handed from the maintenance thread to the writer
+typedef struct {
+	GraphContext *gc;               // graph being compacted
+	uint64_t threshold;             // min number of pending changes to compact
+	MatrixCompaction *compactions;  // compacted copies of the graph's matrices
+} GraphCompactionCtx;
+
+// returns current time in milliseconds
+static uint64_t _GraphContext_Now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// swap in compacted matrices
+// executed on the writer thread, as writers access the graph without
+// acquiring the read lock
+static void _GraphContext_ApplyCompaction
+(
+	void *pdata
+) {
+	GraphCompactionCtx *ctx = (GraphCompactionCtx *)pdata;
+	GraphContext *gc = ctx->gc;
+
+	// compaction doesn't modify the graph's content
+	Graph_AcquireMaintenanceLock(gc->g);
+	{
+		Graph_ApplyCompaction(gc->g, ctx->compactions);
+	}
+	Graph_ReleaseLock(gc->g);
+
+	__atomic_store_n(&gc->g->_compaction_scheduled, false, __ATOMIC_RELEASE);
+
+	GraphContext_DecreaseRefCount(gc);
+	rm_free(ctx);
+}
+
+// compute compacted copies of the graph's matrices
+// executed on the maintenance thread, while readers keep using the graph
+static void _GraphContext_CompactMatrices
+(
+	void *pdata
+) {
+	GraphCompactionCtx *ctx = (GraphCompactionCtx *)pdata;
+	GraphContext *gc = ctx->gc;
+
+	Graph_AcquireReadLock(gc->g);
+	{
+		ctx->compactions = Graph_CompactMatrices(gc->g, ctx->threshold);
+	}
+	Graph_ReleaseLock(gc->g);
+
+	// nothing to compact, e.g. pending changes been flushed inline
+	if(array_len(ctx->compactions) == 0) {
+		array_free(ctx->compactions);
+		__atomic_store_n(&gc->g->_compaction_scheduled, false,
+				__ATOMIC_RELEASE);
+		GraphContext_DecreaseRefCount(gc);
+		rm_free(ctx);
+		return;
+	}
+
+	// force, compaction is discarded otherwise, leaking the copies
+	int res = ThreadPools_AddWorkWriter(_GraphContext_ApplyCompaction, ctx, 1);
+	ASSERT(res == 0);
+}
+
+// hand graph to the maintenance thread, compacting every matrix with at least
+// 'threshold' pending changes
+// returns false if a compaction is already in progress
+static bool _GraphContext_ScheduleCompaction
+(
+	GraphContext *gc,
+	uint64_t threshold
+) {
+	// compaction already in progress
+	bool scheduled = false;
+	if(!__atomic_compare_exchange_n(&gc->g->_compaction_scheduled, &scheduled,
+				true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		return false;
+	}
+
+	// keep graph alive until compaction completes
+	GraphContext_IncreaseRefCount(gc);
+
+	GraphCompactionCtx *ctx = rm_malloc(sizeof(GraphCompactionCtx));
+	ctx->gc          = gc;
+	ctx->threshold   = threshold;
+	ctx->compactions = NULL;
+
+	int res = ThreadPools_AddWorkMaintenance(_GraphContext_CompactMatrices, ctx);
+	ASSERT(res == 0);
+
+	return true;
+}
+
+// CRON task, compacts the graph's matrices once the graph wasn't modified
+// for DELTA_IDLE_COMPACTION_DELAY ms, leaving read-mostly matrices
+// without pending changes
+static void _GraphContext_IdleCompaction
+(
+	void *pdata
+) {
+	GraphContext *gc = (GraphContext *)pdata;
+
+	uint64_t delay;
+	Config_Option_get(Config_DELTA_IDLE_COMPACTION_DELAY, &delay);
+
+	// idle compaction been disabled
+	if(delay == 0) goto done;
+
+	// graph was modified since task was scheduled, postpone
+	uint64_t last_commit = __atomic_load_n(&gc->g->_last_commit,
+			__ATOMIC_RELAXED);
+	uint64_t idle = _GraphContext_Now() - last_commit;
+	if(idle < delay) {
+		Cron_AddTask(delay - idle, _GraphContext_IdleCompaction, gc);
+		return;
+	}
+
+	// compact every matrix with pending changes
+	// retry later in case a compaction is already in progress
+	if(!_GraphContext_ScheduleCompaction(gc, 1)) {
+		Cron_AddTask(delay, _GraphContext_IdleCompaction, gc);
+		return;
+	}
+
+done:
+	__atomic_store_n(&gc->g->_idle_compaction_scheduled, false,
+			__ATOMIC_RELAXED);
+	GraphContext_DecreaseRefCount(gc);
+}
+
+void GraphContext_ScheduleCompaction
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+
+	Graph *g = gc->g;
+
+	//--------------------------------------------------------------------------
+	// schedule idle compaction
+	//--------------------------------------------------------------------------
+
+	uint64_t delay;
+	Config_Option_get(Config_DELTA_IDLE_COMPACTION_DELAY, &delay);
+
+	if(delay > 0) {
+		__atomic_store_n(&g->_last_commit, _GraphContext_Now(),
+				__ATOMIC_RELAXED);
+
+		bool scheduled = false;
+		if(__atomic_compare_exchange_n(&g->_idle_compaction_scheduled,
+					&scheduled, true, false, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED)) {
+			// keep graph alive until task is done
+			GraphContext_IncreaseRefCount(gc);
+			Cron_AddTask(delay, _GraphContext_IdleCompaction, gc);
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// schedule background compaction
+	//--------------------------------------------------------------------------
+
+	bool background_compaction;
+	Config_Option_get(Config_DELTA_BACKGROUND_COMPACTION,
+			&background_compaction);
+
+	if(!background_compaction) return;
+
+	uint64_t threshold;
+	Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES, &threshold);
+
+	if(!Graph_RequiresCompaction(g, threshold)) return;
+
+	_GraphContext_ScheduleCompaction(gc, threshold);
+}
+
+//------------------------------------------------------------------------------
+// String interning API
+//------------------------------------------------------------------------------
+
+void GraphContext_InternValue
+(
+	GraphContext *gc,
+	SIValue *v
+) {
+	ASSERT(v  != NULL);
+	ASSERT(gc != NULL);
+
+	// only strings which aren't already interned
+	if(SI_TYPE(*v) != T_STRING || SI_ALLOCATION(v) == M_INTERN) return;
+
+	bool interning;
+	Config_Option_get(Config_STRING_INTERNING, &interning);
+	if(!interning) return;
+
+	SIValue interned = SI_InternStringVal(gc->string_pool, v->stringval);
+	SIValue_Free(*v);
+	*v = interned;
+}
+
+void GraphContext_InternAttributes
+(
+	GraphContext *gc,
+	AttributeSet set
+) {
+	ASSERT(gc != NULL);
+
+	bool interning;
+	Config_Option_get(Config_STRING_INTERNING, &interning);
+	if(!interning) return;
+
+	uint16_t n = ATTRIBUTE_SET_COUNT(set);
+	for(uint16_t i = 0; i < n; i++) {
+		Attribute_ID id;
+		SIValue v = AttributeSet_GetIdx(set, i, &id);
+		if(SI_TYPE(v) != T_STRING || v.allocation == M_INTERN) continue;
+
+		// replace value in place
+		GraphContext_InternValue(gc, AttributeSet_Get(set, id));
+	}
+}
+
+void GraphContext_VacuumStrings
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+
+	if(StringPool_RequiresVacuum(gc->string_pool)) {
+		StringPool_Vacuum(gc->string_pool);
+	}
+}
+
 //------------------------------------------------------------------------------
 // Free routine
 //------------------------------------------------------------------------------
@@ -719,6 +971,9 @@ static void _GraphContext_Free(void *arg) {
 
 	if(gc->attributes) raxFree(gc->attributes);
 
+	// entities released their interned strings once the graph was freed
+	StringPool_Free(&gc->string_pool);
+
 	if(gc->string_mapping) {
 		len = array_len(gc->string_mapping);
 		for(uint32_t i = 0; i < len; i ++) {
@@ -737,6 +992,7 @@ static void _GraphContext_Free(void *arg) {
 	//--------------------------------------------------------------------------
 
 	if(gc->cache) Cache_Free(gc->cache);
+	if(gc->prepared) PreparedStatements_Free(gc->prepared);
 
 	GraphEncodeContext_Free(gc->encoding_context);
 	GraphDecodeContext_Free(gc->decoding_context);
@@ -14,6 +14,10 @@
 #include "../serializers/encode_context.h"
 #include "../serializers/decode_context.h"
 #include "../util/cache/cache.h"
+#include "../util/string_pool.h"
+
+// prepared statements registry, see commands/prepared_statements.h
+typedef struct PreparedStatements PreparedStatements;
 
 // GraphContext holds refrences to various elements of a graph object
 // It is the value sitting behind a Redis graph key
@@ -39,6 +43,8 @@ typedef struct {
 	GraphEncodeContext *encoding_context;   // encode context of the graph
 	GraphDecodeContext *decoding_context;   // decode context of the graph
 	Cache *cache;                           // global cache of execution plans
+	PreparedStatements *prepared;           // queries prepared via GRAPH.PREPARE
+	StringPool string_pool;                 // interned string attributes
 	XXH32_hash_t version;                   // graph version
 } GraphContext;
 
@@ -306,3 +312,53 @@ Cache *GraphContext_GetCache
 	const GraphContext *gc
 );
 
+// return prepared statements associated with graph context
+PreparedStatements *GraphContext_GetPreparedStatements
+(
+	const GraphContext *gc
+);
+
+//------------------------------------------------------------------------------
+// Compaction API
+//------------------------------------------------------------------------------
+
+// schedule a background compaction of the graph's delta matrices
+// in case background compaction is enabled and any of the graph's matrices
+// accumulated enough pending changes
+// in addition, in case idle compaction is enabled, the graph's matrices are
+// compacted once the graph isn't modified for DELTA_IDLE_COMPACTION_DELAY ms
+// caller must hold the graph's write lock
+void GraphContext_ScheduleCompaction
+(
+	GraphContext *gc
+);
+
+//------------------------------------------------------------------------------
+// String interning API
+//------------------------------------------------------------------------------
+
+// replace a string value with its interned copy
+// in case string interning is enabled, other values are left untouched
+// the original string is released, 'v' owns a reference to the interned copy
+// must only be called by the graph's writer
+void GraphContext_InternValue
+(
+	GraphContext *gc,  // graph context
+	SIValue *v         // value to intern
+);
+
+// intern each string attribute within an attribute set
+// must only be called by the graph's writer
+void GraphContext_InternAttributes
+(
+	GraphContext *gc,  // graph context
+	AttributeSet set   // attribute set to intern
+);
+
+// release interned strings which are no longer referenced by the graph
+// in case enough strings were interned since the last vacuum
+// must only be called by the graph's writer
+void GraphContext_VacuumStrings
+(
+	GraphContext *gc  // graph context
+);
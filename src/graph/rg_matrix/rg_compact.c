@@ -0,0 +1,171 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "rg_matrix.h"
+
+// captures C's internal matrices, such that a compacted copy of C can be
+// computed without holding C's lock, caller must hold C's lock
+GrB_Info RG_Matrix_snapshot
+(
+	RG_MatrixSnapshot *S,  // [output] snapshot of C
+	const RG_Matrix C      // matrix to snapshot
+) {
+	ASSERT(S != NULL);
+	ASSERT(C != NULL);
+
+	GrB_Info info;
+
+	// make sure 'm' doesn't contain any pending work
+	info = GrB_wait(RG_MATRIX_M(C), GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_dup(&S->m, RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_dup(&S->dp, RG_MATRIX_DELTA_PLUS(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_dup(&S->dm, RG_MATRIX_DELTA_MINUS(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	S->version = C->version;
+
+	return info;
+}
+
+// computes a compacted copy of a snapshot's main matrix: A = (M - DM) + DP
+// the snapshot is private to the caller, as such no lock is required
+// the snapshot is consumed
+GrB_Info RG_Matrix_compact
+(
+	GrB_Matrix *A,         // [output] compacted copy
+	RG_MatrixSnapshot *S   // snapshot to compact
+) {
+	ASSERT(A     != NULL);
+	ASSERT(S     != NULL);
+	ASSERT(S->m  != NULL);
+	ASSERT(S->dp != NULL);
+	ASSERT(S->dm != NULL);
+
+	GrB_Info   info;
+	GrB_Type   t;
+	GrB_Index  dp_nvals;
+	GrB_Index  dm_nvals;
+	GrB_Matrix m = S->m;
+
+	info = GrB_wait(S->dp, GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_wait(S->dm, GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_nvals(&dp_nvals, S->dp);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nvals(&dm_nvals, S->dm);
+	ASSERT(info == GrB_SUCCESS);
+
+	// m = m - dm
+	if(dm_nvals > 0) {
+		info = GrB_transpose(m, S->dm, NULL, m, GrB_DESC_RSCT0);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// m = m + dp
+	if(dp_nvals > 0) {
+		info = GxB_Matrix_type(&t, m);
+		ASSERT(info == GrB_SUCCESS);
+
+		GrB_Semiring s = (t == GrB_BOOL) ? GxB_ANY_PAIR_BOOL :
+			GxB_ANY_PAIR_UINT64;
+		info = GrB_Matrix_eWiseAdd_Semiring(m, NULL, NULL, s, m, S->dp,
+				NULL);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// match 'm' sparsity control, can be either hypersparse or sparse
+	info = GxB_set(m, GxB_SPARSITY_CONTROL, GxB_SPARSE | GxB_HYPERSPARSE);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_wait(m, GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_free(&S->dp);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_free(&S->dm);
+	ASSERT(info == GrB_SUCCESS);
+
+	*A   = m;
+	S->m = NULL;
+
+	return info;
+}
+
+// replace C's main matrix with a compacted copy produced by RG_Matrix_compact
+// and clear C's delta matrices
+// in case C was modified since the copy was produced, the copy is discarded
+bool RG_Matrix_applyCompaction
+(
+	RG_Matrix C,       // matrix to update
+	GrB_Matrix *A,     // compacted copy of C
+	uint64_t version   // C's version A reflects
+) {
+	ASSERT(A  != NULL);
+	ASSERT(C  != NULL);
+	ASSERT(*A != NULL);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	// C was modified since A was computed, discard A
+	if(C->version != version) {
+		info = GrB_Matrix_free(A);
+		ASSERT(info == GrB_SUCCESS);
+		return false;
+	}
+
+	GrB_Index a_nrows;
+	GrB_Index a_ncols;
+	GrB_Index c_nrows;
+	GrB_Index c_ncols;
+
+	GrB_Matrix a  = *A;
+	GrB_Matrix m  = RG_MATRIX_M(C);
+	GrB_Matrix dp = RG_MATRIX_DELTA_PLUS(C);
+	GrB_Matrix dm = RG_MATRIX_DELTA_MINUS(C);
+
+	// C might have been resized since A was computed
+	// resizing doesn't change C's content, match A's dimensions
+	GrB_Matrix_nrows(&a_nrows, a);
+	GrB_Matrix_ncols(&a_ncols, a);
+	GrB_Matrix_nrows(&c_nrows, m);
+	GrB_Matrix_ncols(&c_ncols, m);
+
+	if(a_nrows != c_nrows || a_ncols != c_ncols) {
+		info = GrB_Matrix_resize(a, c_nrows, c_ncols);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// swap main matrix
+	// multi-edge arrays referenced by 'm' are now referenced by 'a'
+	// as such 'm' is freed without releasing them
+	info = GrB_Matrix_free(&m);
+	ASSERT(info == GrB_SUCCESS);
+	C->matrix = a;
+	*A = NULL;
+
+	// all pending changes are reflected in 'a'
+	info = GrB_Matrix_clear(dp);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_clear(dm);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_wait(dp, GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_wait(dm, GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+
+	return true;
+}
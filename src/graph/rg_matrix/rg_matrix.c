@@ -14,6 +14,7 @@ void RG_Matrix_setDirty
 ) {
 	ASSERT(C);
 	C->dirty = true;
+	C->version++;
 	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) C->transposed->dirty = true;
 }
 
@@ -166,6 +167,7 @@ GrB_Info RG_Matrix_clear
 	ASSERT(info == GrB_SUCCESS);
 
 	A->dirty = false;
+	A->version++;
 	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) A->transposed->dirty = false;
 
 	return info;
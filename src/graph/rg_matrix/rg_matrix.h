@@ -124,12 +124,21 @@ typedef _RG_Matrix *RG_Matrix;
 //
 //------------------------------------------------------------------------------
 
+// copies of a matrix's internal matrices, see RG_Matrix_snapshot
+typedef struct {
+	GrB_Matrix m;                       // copy of the main matrix
+	GrB_Matrix dp;                      // copy of delta-plus
+	GrB_Matrix dm;                      // copy of delta-minus
+	uint64_t version;                   // matrix version the copies reflect
+} RG_MatrixSnapshot;
+
 struct _RG_Matrix {
 	volatile bool dirty;                // Indicates if matrix requires sync
 	GrB_Matrix matrix;                  // Underlying GrB_Matrix
 	GrB_Matrix delta_plus;              // Pending additions
 	GrB_Matrix delta_minus;             // Pending deletions
 	RG_Matrix transposed;               // Transposed matrix
+	uint64_t version;                   // Incremented on every modification
 	pthread_mutex_t mutex;              // Lock
 };
 
@@ -306,6 +315,40 @@ GrB_Info RG_Matrix_wait
 	bool force_sync
 );
 
+// get the number of pending changes, nvals(delta-plus) + nvals(delta-minus)
+GrB_Info RG_Matrix_pendingChanges
+(
+	GrB_Index *n,                   // number of pending changes
+	const RG_Matrix C               // matrix to query
+);
+
+// captures C's internal matrices, such that a compacted copy of C can be
+// computed without holding C's lock, caller must hold C's lock
+GrB_Info RG_Matrix_snapshot
+(
+	RG_MatrixSnapshot *S,           // [output] snapshot of C
+	const RG_Matrix C               // matrix to snapshot
+);
+
+// computes a compacted copy of a snapshot's main matrix: A = (M - DM) + DP
+// the snapshot is consumed, no lock is required
+GrB_Info RG_Matrix_compact
+(
+	GrB_Matrix *A,                  // [output] compacted copy
+	RG_MatrixSnapshot *S            // snapshot to compact
+);
+
+// replace C's main matrix with a compacted copy produced by RG_Matrix_compact
+// and clear C's delta matrices
+// in case C was modified since the copy was produced, the copy is discarded
+// returns true if the compacted copy was applied
+bool RG_Matrix_applyCompaction
+(
+	RG_Matrix C,                    // matrix to update
+	GrB_Matrix *A,                  // compacted copy of C
+	uint64_t version                // C's version A reflects
+);
+
 // get the type of the M matrix
 GrB_Info RG_Matrix_type
 (
@@ -11,6 +11,20 @@
 // returns true if iterator is detached from a matrix
 #define IS_DETACHED(iter) ((iter) == NULL || (iter)->A == NULL)
 
+// determine if M's entries should be checked against delta-minus
+// a flushed matrix has an empty delta-minus, in which case M is scanned
+// sequentially without looking up each entry in delta-minus
+static inline void _set_iter_mask
+(
+	RG_MatrixTupleIter *iter
+) {
+	GrB_Index nvals;
+	GrB_Info info = GrB_Matrix_nvals(&nvals, RG_MATRIX_DELTA_MINUS(iter->A));
+	ASSERT(info == GrB_SUCCESS);
+
+	iter->m_masked = (nvals > 0);
+}
+
 static inline void _set_iter_range
 (
 	GxB_Iterator it,
@@ -80,6 +94,7 @@ GrB_Info RG_MatrixTupleIter_iterate_row
 	iter->min_row = rowIdx ;
 	iter->max_row = rowIdx ;
 
+	_set_iter_mask(iter) ;
 	_set_iter_range(&iter->m_it, iter->min_row, iter->max_row, &iter->m_depleted) ;
 	_set_iter_range(&iter->dp_it, iter->min_row, iter->max_row, &iter->dp_depleted) ;
 
@@ -97,6 +112,7 @@ GrB_Info RG_MatrixTupleIter_iterate_range
 	iter->min_row = startRowIdx ;
 	iter->max_row = endRowIdx ;
 
+	_set_iter_mask(iter) ;
 	_set_iter_range(&iter->m_it, iter->min_row, iter->max_row, &iter->m_depleted) ;
 	_set_iter_range(&iter->dp_it, iter->min_row, iter->max_row, &iter->dp_depleted) ;
 
@@ -129,14 +145,13 @@ static void _iter_next
 static GrB_Info _next_m_iter_bool
 (
 	RG_MatrixTupleIter *iter,  // iterator scanning M
-	const GrB_Matrix DM,       // delta-minus, masked entries
+	const GrB_Matrix DM,       // delta-minus, NULL if m isn't masked
 	GrB_Index *row,            // optional extracted row index
 	GrB_Index *col,            // optional extracted column index
 	bool *val,                 // optional extracted value
 	bool *depleted             // [output] true if iterator depleted
 ) {
 	ASSERT(iter     != NULL) ;
-	ASSERT(DM       != NULL) ;
 	ASSERT(depleted != NULL) ;
 
 	GrB_Index  _row ;
@@ -155,6 +170,9 @@ static GrB_Info _next_m_iter_bool
 		// prep value for next iteration
 		_iter_next(m_it, iter->max_row, depleted);
 
+		// no pending deletions, entry is valid
+		if(DM == NULL) break ;
+
 		bool x ;
  		GrB_Info delete_info = GrB_Matrix_extractElement_BOOL(&x, DM, _row, _col) ;
  		if(delete_info == GrB_NO_VALUE) break ; // entry isn't deleted, return
@@ -177,9 +195,11 @@ GrB_Info RG_MatrixTupleIter_next_BOOL
 	if(IS_DETACHED(iter)) return GrB_NULL_POINTER ;
 
 	GrB_Info             info     =  GrB_SUCCESS                    ;
-	GrB_Matrix           DM       =  RG_MATRIX_DELTA_MINUS(iter->A) ;
+	GrB_Matrix           DM       =  NULL                           ;
 	GxB_Iterator         dp_it    =  &iter->dp_it                   ;
 
+	if(iter->m_masked) DM = RG_MATRIX_DELTA_MINUS(iter->A) ;
+
 	if(!iter->m_depleted) {
 		info = _next_m_iter_bool(iter, DM, row, col, val, &iter->m_depleted) ;
 		if(info == GrB_SUCCESS) return GrB_SUCCESS ;
@@ -203,14 +223,13 @@ GrB_Info RG_MatrixTupleIter_next_BOOL
 static GrB_Info _next_m_iter_uint64
 (
 	RG_MatrixTupleIter *iter,  // iterator scanning M
-	const GrB_Matrix DM,       // delta-minus, masked entries
+	const GrB_Matrix DM,       // delta-minus, NULL if m isn't masked
 	GrB_Index *row,            // optional extracted row index
 	GrB_Index *col,            // optional extracted column index
 	uint64_t *val,             // optional extracted value
 	bool *depleted             // [output] true if iterator depleted
 ) {
 	ASSERT(iter     != NULL) ;
-	ASSERT(DM       != NULL) ;
 	ASSERT(depleted != NULL) ;
 
 	GrB_Index  _row ;
@@ -229,6 +248,9 @@ static GrB_Info _next_m_iter_uint64
 		// prep value for next iteration
 		_iter_next(m_it, iter->max_row, depleted);
 
+		// no pending deletions, entry is valid
+		if(DM == NULL) break ;
+
 		bool x ;
  		GrB_Info delete_info = GrB_Matrix_extractElement_BOOL(&x, DM, _row, _col) ;
  		if(delete_info == GrB_NO_VALUE) break ; // entry isn't deleted, return
@@ -251,9 +273,11 @@ GrB_Info RG_MatrixTupleIter_next_UINT64
 	if(IS_DETACHED(iter)) return GrB_NULL_POINTER ;
 
 	GrB_Info             info     =  GrB_SUCCESS                    ;
-	GrB_Matrix           DM       =  RG_MATRIX_DELTA_MINUS(iter->A) ;
+	GrB_Matrix           DM       =  NULL                           ;
 	GxB_Iterator         dp_it    =  &iter->dp_it                    ;
 
+	if(iter->m_masked) DM = RG_MATRIX_DELTA_MINUS(iter->A) ;
+
 	if(!iter->m_depleted) {
 		info = _next_m_iter_uint64(iter, DM, row, col, val, &iter->m_depleted) ;
 		if(info == GrB_SUCCESS) return GrB_SUCCESS ;
@@ -282,6 +306,7 @@ GrB_Info RG_MatrixTupleIter_reset
 
 	if(IS_DETACHED(iter)) return GrB_NULL_POINTER ;
 
+	_set_iter_mask(iter) ;
 	_set_iter_range(&iter->m_it, iter->min_row, iter->max_row, &iter->m_depleted) ;
 	_set_iter_range(&iter->dp_it, iter->min_row, iter->max_row, &iter->dp_depleted) ;
 
@@ -327,6 +352,7 @@ GrB_Info RG_MatrixTupleIter_AttachRange
 	iter->min_row = min_row ;
 	iter->max_row = max_row ;
 
+	_set_iter_mask(iter) ;
 	_init_iter(&iter->m_it, M, iter->min_row, iter->max_row, &iter->m_depleted) ;
 	_init_iter(&iter->dp_it, DP, iter->min_row, iter->max_row, &iter->dp_depleted) ;
 
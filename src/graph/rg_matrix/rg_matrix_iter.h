@@ -22,6 +22,7 @@ typedef struct
 	struct GB_Iterator_opaque dp_it;  // internal delta plus iterator
 	bool m_depleted;                  // is m iterator depleted
 	bool dp_depleted;                 // is dp iterator depleted
+	bool m_masked;                    // are m entries masked by delta minus
 	GrB_Index min_row;                // minimum row for iteration
 	GrB_Index max_row;                // maximum row for iteration
 } RG_MatrixTupleIter ;
@@ -103,6 +103,28 @@ static GrB_Info RG_Matrix_sync
 	return info;
 }
 
+// get the number of pending changes, nvals(delta-plus) + nvals(delta-minus)
+GrB_Info RG_Matrix_pendingChanges
+(
+	GrB_Index *n,       // number of pending changes
+	const RG_Matrix C   // matrix to query
+) {
+	ASSERT(n != NULL);
+	ASSERT(C != NULL);
+
+	GrB_Info  info;
+	GrB_Index dp_nvals;
+	GrB_Index dm_nvals;
+
+	info = GrB_Matrix_nvals(&dp_nvals, RG_MATRIX_DELTA_PLUS(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nvals(&dm_nvals, RG_MATRIX_DELTA_MINUS(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	*n = dp_nvals + dm_nvals;
+	return info;
+}
+
 GrB_Info RG_Matrix_wait
 (
 	RG_Matrix A,
@@ -119,17 +141,25 @@ GrB_Info RG_Matrix_wait
 	GrB_Matrix delta_minus = RG_MATRIX_DELTA_MINUS(A);
 
 	// check if merge is required
-	GrB_Index delta_plus_nvals;
-	GrB_Index delta_minus_nvals;
-	GrB_Matrix_nvals(&delta_plus_nvals, delta_plus);
-	GrB_Matrix_nvals(&delta_minus_nvals, delta_minus);
+	GrB_Index pending_changes;
+	RG_Matrix_pendingChanges(&pending_changes, A);
 
 	uint64_t delta_max_pending_changes;
 	Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES,
 			&delta_max_pending_changes);
 
-	if(force_sync ||
-	   delta_plus_nvals + delta_minus_nvals >= delta_max_pending_changes) {
+	// when background compaction is enabled, crossing the threshold is handled
+	// by the compaction worker, only merge inline once the number of pending
+	// changes grows beyond a hard limit, e.g. the worker is falling behind
+	bool background_compaction;
+	Config_Option_get(Config_DELTA_BACKGROUND_COMPACTION,
+			&background_compaction);
+
+	if(background_compaction) {
+		delta_max_pending_changes *= DELTA_BACKGROUND_COMPACTION_HARD_LIMIT;
+	}
+
+	if(force_sync || pending_changes >= delta_max_pending_changes) {
 		info = RG_Matrix_sync(A);
 	} else {
 		// wait on 'm', in most cases 'm' won't contain any pending work
@@ -148,4 +178,3 @@ GrB_Info RG_Matrix_wait
 
 	return info;
 }
-
@@ -6,6 +6,7 @@
 
 #include <stdio.h>
 #include "group.h"
+#include "../RG.h"
 #include "../redismodule.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
@@ -29,6 +30,21 @@ Group *Group_New
 	return g;
 }
 
+// merge src's partial aggregations into dest
+void Group_Merge
+(
+	Group *dest,  // group to merge into
+	Group *src    // group to merge
+) {
+	ASSERT(src  != NULL);
+	ASSERT(dest != NULL);
+	ASSERT(src->func_count == dest->func_count);
+
+	for(uint i = 0; i < dest->func_count; i++) {
+		AR_EXP_MergeAggregations(dest->agg[i], src->agg[i]);
+	}
+}
+
 // free group
 void Group_Free
 (
@@ -25,6 +25,14 @@ Group *Group_New
 	uint func_count    // number of aggregation functions
 );
 
+// merge src's partial aggregations into dest
+// both groups must be created from the same aggregation functions
+void Group_Merge
+(
+	Group *dest,  // group to merge into
+	Group *src    // group to merge
+);
+
 // free group
 void Group_Free
 (
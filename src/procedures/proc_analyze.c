@@ -0,0 +1,319 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "proc_analyze.h"
+#include "RG.h"
+#include "../value.h"
+#include "../errors.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../util/cache/cache.h"
+#include "../schema/schema.h"
+#include "../datatypes/array.h"
+#include "../graph/graphcontext.h"
+#include "../schema/attribute_stats.h"
+
+#include <math.h>
+
+// CALL db.stats.analyze()
+// CALL db.stats.analyze('Person', 'City')
+//
+// collects statistics for each attribute of the given labels
+// (all labels if none are specified) and yields a row per analyzed attribute
+// the statistics are consumed by the query optimizer to estimate the
+// selectivity of filters
+
+// an analyzed (label, attribute) pair
+typedef struct {
+	const Schema *s;        // analyzed schema
+	Attribute_ID attr_id;   // analyzed attribute
+} AnalyzedAttribute;
+
+typedef struct {
+	uint i;                       // current analyzed attribute
+	GraphContext *gc;             // graph context
+	AnalyzedAttribute *analyzed;  // analyzed attributes
+	SIValue *output;              // outputs
+	SIValue *yield_label;         // yield label
+	SIValue *yield_property;      // yield property
+	SIValue *yield_count;         // yield number of entities
+	SIValue *yield_null_fraction; // yield fraction of entities missing attribute
+	SIValue *yield_distinct;      // yield estimated number of distinct values
+	SIValue *yield_histogram;     // yield histogram bounds
+} AnalyzeContext;
+
+static void _process_yield
+(
+	AnalyzeContext *ctx,
+	const char **yield
+) {
+	ctx->yield_label         = NULL;
+	ctx->yield_count         = NULL;
+	ctx->yield_property      = NULL;
+	ctx->yield_distinct      = NULL;
+	ctx->yield_histogram     = NULL;
+	ctx->yield_null_fraction = NULL;
+
+	int idx = 0;
+	for(uint i = 0; i < array_len(yield); i++) {
+		if(strcasecmp("label", yield[i]) == 0) {
+			ctx->yield_label = ctx->output + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("property", yield[i]) == 0) {
+			ctx->yield_property = ctx->output + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("count", yield[i]) == 0) {
+			ctx->yield_count = ctx->output + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("nullFraction", yield[i]) == 0) {
+			ctx->yield_null_fraction = ctx->output + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("distinctValues", yield[i]) == 0) {
+			ctx->yield_distinct = ctx->output + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("histogram", yield[i]) == 0) {
+			ctx->yield_histogram = ctx->output + idx;
+			idx++;
+			continue;
+		}
+	}
+}
+
+// scan every node of schema 's' and compute statistics for
+// each of the attributes encountered
+static void _AnalyzeSchema
+(
+	AnalyzeContext *pdata,
+	Schema *s
+) {
+	GraphContext *gc = pdata->gc;
+	Graph        *g  = gc->g;
+
+	uint attr_count = GraphContext_AttributeCount(gc);
+	AttributeStatsBuilder **builders =
+		rm_calloc(attr_count, sizeof(AttributeStatsBuilder *));
+
+	// make sure previously analyzed attributes are recomputed
+	// even if no node holds them anymore
+	for(uint i = 0; i < attr_count; i++) {
+		if(Schema_GetAttributeStats(s, i) != NULL) {
+			builders[i] = AttributeStatsBuilder_New();
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// scan labeled nodes
+	//--------------------------------------------------------------------------
+
+	uint64_t count = 0;
+	GrB_Index node_id;
+	RG_MatrixTupleIter it = {0};
+	RG_Matrix L = Graph_GetLabelMatrix(g, Schema_GetID(s));
+
+	GrB_Info info = RG_MatrixTupleIter_attach(&it, L);
+	ASSERT(info == GrB_SUCCESS);
+
+	while(RG_MatrixTupleIter_next_BOOL(&it, &node_id, NULL, NULL)
+			== GrB_SUCCESS) {
+		Node n;
+		bool found = Graph_GetNode(g, node_id, &n);
+		ASSERT(found == true);
+		count++;
+
+		const AttributeSet set = GraphEntity_GetAttributes((GraphEntity *)&n);
+		uint n_attr = ATTRIBUTE_SET_COUNT(set);
+		for(uint i = 0; i < n_attr; i++) {
+			Attribute_ID attr_id;
+			SIValue v = AttributeSet_GetIdx(set, i, &attr_id);
+			ASSERT(attr_id < attr_count);
+
+			if(builders[attr_id] == NULL) {
+				builders[attr_id] = AttributeStatsBuilder_New();
+			}
+			AttributeStatsBuilder_Add(builders[attr_id], v);
+		}
+	}
+
+	RG_MatrixTupleIter_detach(&it);
+
+	//--------------------------------------------------------------------------
+	// store statistics in schema
+	//--------------------------------------------------------------------------
+
+	for(uint i = 0; i < attr_count; i++) {
+		AttributeStatsBuilder *b = builders[i];
+		if(b == NULL) continue;
+
+		AttributeStats *stats = Schema_AddAttributeStats(s, i);
+		AttributeStatsBuilder_Finalize(b, count, stats);
+		AttributeStatsBuilder_Free(b);
+
+		AnalyzedAttribute analyzed = {.s = s, .attr_id = i};
+		array_append(pdata->analyzed, analyzed);
+	}
+
+	rm_free(builders);
+}
+
+ProcedureResult Proc_AnalyzeInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	// validate arguments, each argument is a label to analyze
+	uint arg_count = array_len((SIValue *)args);
+	for(uint i = 0; i < arg_count; i++) {
+		if(SI_TYPE(args[i]) != T_STRING) {
+			ErrorCtx_SetError("Label must be a string");
+			return PROCEDURE_ERR;
+		}
+		if(GraphContext_GetSchema(gc, args[i].stringval, SCHEMA_NODE) == NULL) {
+			ErrorCtx_SetError("Label '%s' does not exist", args[i].stringval);
+			return PROCEDURE_ERR;
+		}
+	}
+
+	AnalyzeContext *pdata = rm_malloc(sizeof(AnalyzeContext));
+
+	pdata->i        = 0;
+	pdata->gc       = gc;
+	pdata->output   = array_new(SIValue, 6);
+	pdata->analyzed = array_new(AnalyzedAttribute, 0);
+
+	_process_yield(pdata, yield);
+
+	// procedure is a write procedure, graph is exclusively locked
+	if(arg_count == 0) {
+		uint schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+		for(uint i = 0; i < schema_count; i++) {
+			_AnalyzeSchema(pdata, GraphContext_GetSchemaByID(gc, i, SCHEMA_NODE));
+		}
+	} else {
+		for(uint i = 0; i < arg_count; i++) {
+			_AnalyzeSchema(pdata,
+					GraphContext_GetSchema(gc, args[i].stringval, SCHEMA_NODE));
+		}
+	}
+
+	// cached execution plans were optimized using outdated statistics
+	Cache_Clear(GraphContext_GetCache(gc));
+
+	ctx->privateData = pdata;
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_AnalyzeStep
+(
+	ProcedureCtx *ctx
+) {
+	ASSERT(ctx->privateData != NULL);
+
+	AnalyzeContext *pdata = (AnalyzeContext *)ctx->privateData;
+
+	// depleted?
+	if(pdata->i >= array_len(pdata->analyzed)) return NULL;
+
+	AnalyzedAttribute *analyzed = pdata->analyzed + pdata->i++;
+	const Schema *s = analyzed->s;
+	const AttributeStats *stats = Schema_GetAttributeStats(s, analyzed->attr_id);
+	ASSERT(stats != NULL);
+
+	if(pdata->yield_label) {
+		*pdata->yield_label = SI_ConstStringVal((char *)Schema_GetName(s));
+	}
+
+	if(pdata->yield_property) {
+		const char *attr = GraphContext_GetAttributeString(pdata->gc,
+				analyzed->attr_id);
+		*pdata->yield_property = SI_ConstStringVal((char *)attr);
+	}
+
+	if(pdata->yield_count) {
+		*pdata->yield_count = SI_LongVal(stats->count);
+	}
+
+	if(pdata->yield_null_fraction) {
+		*pdata->yield_null_fraction =
+			SI_DoubleVal(AttributeStats_NullFraction(stats));
+	}
+
+	if(pdata->yield_distinct) {
+		*pdata->yield_distinct =
+			SI_LongVal((int64_t)round(AttributeStats_DistinctCount(stats)));
+	}
+
+	if(pdata->yield_histogram) {
+		uint n = (stats->bucket_count > 0) ? stats->bucket_count + 1 : 0;
+		SIValue histogram = SI_Array(n);
+		for(uint i = 0; i < n; i++) {
+			SIArray_Append(&histogram, SI_DoubleVal(stats->bounds[i]));
+		}
+		*pdata->yield_histogram = histogram;
+	}
+
+	return pdata->output;
+}
+
+ProcedureResult Proc_AnalyzeFree
+(
+	ProcedureCtx *ctx
+) {
+	// clean up
+	if(ctx->privateData) {
+		AnalyzeContext *pdata = ctx->privateData;
+		array_free(pdata->output);
+		array_free(pdata->analyzed);
+		rm_free(ctx->privateData);
+	}
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_AnalyzeCtx() {
+	void *privateData = NULL;
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 6);
+	ProcedureOutput out_label          = {.name = "label",          .type = T_STRING};
+	ProcedureOutput out_property       = {.name = "property",       .type = T_STRING};
+	ProcedureOutput out_count          = {.name = "count",          .type = T_INT64};
+	ProcedureOutput out_null_fraction  = {.name = "nullFraction",   .type = T_DOUBLE};
+	ProcedureOutput out_distinct       = {.name = "distinctValues", .type = T_INT64};
+	ProcedureOutput out_histogram      = {.name = "histogram",      .type = T_ARRAY};
+	array_append(outputs, out_label);
+	array_append(outputs, out_property);
+	array_append(outputs, out_count);
+	array_append(outputs, out_null_fraction);
+	array_append(outputs, out_distinct);
+	array_append(outputs, out_histogram);
+
+	ProcedureCtx *ctx = ProcCtxNew("db.stats.analyze",
+								   PROCEDURE_VARIABLE_ARG_COUNT,
+								   outputs,
+								   Proc_AnalyzeStep,
+								   Proc_AnalyzeInvoke,
+								   Proc_AnalyzeFree,
+								   privateData,
+								   false);
+	return ctx;
+}
@@ -31,6 +31,7 @@ void Proc_Register() {
 	_procRegister("db.propertyKeys", Proc_PropKeysCtx);
 	_procRegister("dbms.procedures", Proc_ProceduresCtx);
 	_procRegister("db.relationshipTypes", Proc_RelationsCtx);
+	_procRegister("db.stats.analyze", Proc_AnalyzeCtx);
 
 	// Register graph algorithms.
 	_procRegister("algo.BFS", Proc_BFS_Ctx);
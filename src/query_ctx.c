@@ -7,10 +7,13 @@
 #include "query_ctx.h"
 #include "RG.h"
 #include "errors.h"
+#include "util/arr.h"
 #include "util/simple_timer.h"
 #include "arithmetic/arithmetic_expression.h"
 #include "serializers/graphcontext_type.h"
+#include "effects/effects.h"
 #include "undo_log/undo_log.h"
+#include "configuration/config.h"
 
 // GraphContext type as it is registered at Redis.
 extern RedisModuleType *GraphContextRedisModuleType;
@@ -150,16 +153,31 @@ static void _QueryCtx_ThreadSafeContextUnlock(QueryCtx *ctx) {
 	if(ctx->global_exec_ctx.bc) RedisModule_ThreadSafeContextUnlock(ctx->global_exec_ctx.redis_ctx);
 }
 
+// acquire both the GIL and the graph's write lock
+// the GIL is always acquired first, threads acquiring a graph lock
+// while holding the GIL (e.g. fork prepare) rely on this order
+void QueryCtx_AcquireCommitLocks
+(
+	Graph *g,                  // graph to write lock
+	RedisModuleCtx *redis_ctx  // thread-safe context, NULL if GIL is held
+) {
+	ASSERT(g != NULL);
+
+	if(redis_ctx != NULL) RedisModule_ThreadSafeContextLock(redis_ctx);
+	Graph_AcquireWriteLock(g);
+}
+
 bool QueryCtx_LockForCommit(void) {
 	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
 	if(ctx->internal_exec_ctx.locked_for_commit) return true;
 
-	// lock GIL
+	// lock GIL and graph
 	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
 	GraphContext *gc = ctx->gc;
 	RedisModuleString *graphID = RedisModule_CreateString(redis_ctx, gc->graph_name,
 														  strlen(gc->graph_name));
 	_QueryCtx_ThreadSafeContextLock(ctx);
+	Graph_AcquireWriteLock(gc->g);
 
 	// open key and verify
 	RedisModuleKey *key = RedisModule_OpenKey(redis_ctx, graphID, REDISMODULE_WRITE);
@@ -178,14 +196,14 @@ bool QueryCtx_LockForCommit(void) {
 		goto clean_up;
 	}
 	ctx->internal_exec_ctx.key = key;
-
-	// acquire graph write lock
-	Graph_AcquireWriteLock(gc->g);
 	ctx->internal_exec_ctx.locked_for_commit = true;
 
 	return true;
 
 clean_up:
+	// release graph write lock
+	Graph_ReleaseLock(gc->g);
+
 	// free key handle
 	RedisModule_CloseKey(key);
 
@@ -201,6 +219,14 @@ static void _QueryCtx_UnlockCommit(QueryCtx *ctx) {
 	GraphContext *gc = ctx->gc;
 
 	ctx->internal_exec_ctx.locked_for_commit = false;
+
+	// hand accumulated delta changes to the background compaction
+	// while the write lock is still held
+	GraphContext_ScheduleCompaction(gc);
+
+	// release interned strings no longer referenced by the graph
+	GraphContext_VacuumStrings(gc);
+
 	// release graph R/W lock
 	Graph_ReleaseLock(gc->g);
 
@@ -211,6 +237,37 @@ static void _QueryCtx_UnlockCommit(QueryCtx *ctx) {
 	_QueryCtx_ThreadSafeContextUnlock(ctx);
 }
 
+// replicate the query's modifications as effects
+// returns false if the modifications can't be expressed as effects
+static bool _QueryCtx_ReplicateEffects
+(
+	QueryCtx *ctx
+) {
+	bool replicate_effects;
+	Config_Option_get(Config_REPLICATE_EFFECTS, &replicate_effects);
+	if(!replicate_effects) return false;
+
+	// index operations aren't tracked by the undo log
+	ResultSet *result_set = ctx->internal_exec_ctx.result_set;
+	if(result_set == NULL ||
+	   result_set->stats.index_creation ||
+	   result_set->stats.index_deletion ||
+	   array_len(ctx->undo_log) == 0) {
+		return false;
+	}
+
+	size_t len;
+	GraphContext *gc = ctx->gc;
+	unsigned char *effects = Effects_FromUndoLog(gc, ctx->undo_log, &len);
+	if(effects == NULL) return false;
+
+	RedisModule_Replicate(ctx->global_exec_ctx.redis_ctx, "GRAPH.EFFECT", "cb!",
+			gc->graph_name, (const char *)effects, len);
+	array_free(effects);
+
+	return true;
+}
+
 // replicate command
 void QueryCtx_Replicate
 (
@@ -221,6 +278,9 @@ void QueryCtx_Replicate
 	GraphContext   *gc        = ctx->gc;
 	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
 
+	// replicate effects instead of re-executing the query, if enabled
+	if(_QueryCtx_ReplicateEffects(ctx)) return;
+
 	// replicate
 	RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name,
 			"cc!", gc->graph_name, ctx->query_data.query);
@@ -253,6 +313,11 @@ void QueryCtx_Free(void) {
 		ctx->query_data.params = NULL;
 	}
 
+	if(ctx->query_data.query_normalized) {
+		rm_free(ctx->query_data.query_normalized);
+		ctx->query_data.query_normalized = NULL;
+	}
+
 	rm_free(ctx);
 	// NULL-set the context for reuse the next time this thread receives a query
 	QueryCtx_RemoveFromTLS();
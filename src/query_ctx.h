@@ -23,6 +23,7 @@ typedef struct {
 	rax *params;                  // Query parameters.
 	const char *query;            // Query string.
 	const char *query_no_params;  // Query string without parameters part.
+	char *query_normalized;       // Query string with literals lifted into parameters.
 } QueryCtx_QueryData;
 
 typedef struct {
@@ -92,6 +93,15 @@ ResultSetStatistics *QueryCtx_GetResultSetStatistics(void);
 // print the current query
 void QueryCtx_PrintQuery(void);
 
+// acquire both the GIL and the graph's write lock
+// the GIL is acquired through the thread-safe context 'redis_ctx'
+// which is NULL when called from Redis main thread
+void QueryCtx_AcquireCommitLocks
+(
+	Graph *g,                  // graph to write lock
+	RedisModuleCtx *redis_ctx  // thread-safe context, NULL if GIL is held
+);
+
 /* Starts a locking flow before commiting changes in the graph and Redis keyspace.
  * Locking flow is:
  * 1. LOCK GIL
@@ -9,6 +9,7 @@
 #include "../../redismodule.h"
 #include "../../graph/graphcontext.h"
 #include "../../graph/query_graph.h"
+#include "../../util/datablock/datablock.h"
 
 typedef enum {
 	COLUMN_UNKNOWN = 0,
@@ -40,8 +41,14 @@ typedef void (*EmitHeaderFunc)(RedisModuleCtx *ctx, const char **columns,
 typedef void (*EmitRowFunc)(RedisModuleCtx *ctx, GraphContext *gc,
 		SIValue **row, uint numcols);
 							   
+// Typedef for columnar formatters, emitting all rows at once
+// cells are stored row by row.
+typedef void (*EmitRowsFunc)(RedisModuleCtx *ctx, GraphContext *gc,
+		DataBlock *cells, uint numcols);
+
 typedef struct {
 	EmitRowFunc    EmitRow;
+	EmitRowsFunc   EmitRows;  // optional, replaces EmitRow when set
 	EmitHeaderFunc EmitHeader;
 } ResultSetFormatter;
 
@@ -10,11 +10,13 @@
 #include "resultset_replynop.h"
 #include "resultset_replycompact.h"
 #include "resultset_replyverbose.h"
+#include "resultset_replybinary.h"
 
 typedef enum {
 	FORMATTER_NOP = 0,
 	FORMATTER_VERBOSE = 1,
 	FORMATTER_COMPACT = 2,
+	FORMATTER_BINARY = 3,
 } ResultSetFormatterType;
 
 /* Retrieves result-set formatter.
@@ -40,3 +42,9 @@ static ResultSetFormatter ResultSetFormatterVerbose __attribute__((used)) = {
 	.EmitHeader = ResultSet_ReplyWithVerboseHeader
 };
 
+/* Binary columnar reply formatter, used by analytics clients. */
+static ResultSetFormatter ResultSetFormatterBinary __attribute__((used)) = {
+	.EmitRow = ResultSet_EmitNOPRow,
+	.EmitRows = ResultSet_EmitBinaryRows,
+	.EmitHeader = ResultSet_ReplyWithCompactHeader
+};
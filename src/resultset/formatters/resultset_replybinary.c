@@ -0,0 +1,215 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "resultset_formatters.h"
+#include "RG.h"
+#include "rax.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+
+// binary column layout, all integers and doubles are little-endian
+// regardless of the host's byte order
+//
+// offset 0  uint8   ValueType of the column's values
+// offset 1  3 bytes reserved
+// offset 4  uint32  number of rows
+// offset 8  null bitmap, bit i is set if row i is null, padded to 8 bytes
+//           followed by the column's values, null rows hold zeros
+//
+// VALUE_INTEGER  int64 per row
+// VALUE_DOUBLE   double per row
+// VALUE_BOOLEAN  uint8 per row
+// VALUE_STRING   uint32 dictionary size, dictionary entries each an uint32
+//                length followed by the string's bytes,
+//                followed by an uint32 dictionary index per row
+// VALUE_NULL     no values
+
+#define BINARY_HEADER_SIZE 8
+
+static inline size_t _pad8(size_t n) {
+	return (n + 7) & ~((size_t)7);
+}
+
+// write 'v' as a little-endian uint32
+static inline void _put_u32(char *buf, uint32_t v) {
+	for(int i = 0; i < 4; i++) buf[i] = (unsigned char)(v >> (i * 8));
+}
+
+// write 'v' as a little-endian uint64
+static inline void _put_u64(char *buf, uint64_t v) {
+	for(int i = 0; i < 8; i++) buf[i] = (unsigned char)(v >> (i * 8));
+}
+
+static inline SIValue *_cell(DataBlock *cells, uint numcols, uint64_t row,
+		uint col) {
+	return DataBlock_GetItem(cells, row * numcols + col);
+}
+
+// determine column encoding
+// returns VALUE_UNKNOWN if the column holds values of different types
+// or values without a binary encoding
+static ValueType _ColumnEncoding(DataBlock *cells, uint numcols, uint col,
+		uint64_t first_row, uint nrows) {
+	ValueType enc = VALUE_NULL;
+
+	for(uint i = 0; i < nrows; i++) {
+		ValueType t;
+		SIValue *v = _cell(cells, numcols, first_row + i, col);
+
+		switch(SI_TYPE(*v)) {
+		case T_NULL:
+			continue;
+		case T_INT64:
+			t = VALUE_INTEGER;
+			break;
+		case T_DOUBLE:
+			t = VALUE_DOUBLE;
+			break;
+		case T_BOOL:
+			t = VALUE_BOOLEAN;
+			break;
+		case T_STRING:
+			t = VALUE_STRING;
+			break;
+		default:
+			return VALUE_UNKNOWN;
+		}
+
+		if(enc == VALUE_NULL) enc = t;
+		else if(enc != t) return VALUE_UNKNOWN;
+	}
+
+	return enc;
+}
+
+static void _ResultSet_BinaryReplyWithColumn(RedisModuleCtx *ctx,
+		DataBlock *cells, uint numcols, uint col, uint64_t first_row,
+		uint nrows, ValueType enc) {
+	size_t bitmap_size = _pad8((nrows + 7) / 8);
+	size_t size = BINARY_HEADER_SIZE + bitmap_size;
+
+	// string dictionary, maps each distinct string to its index
+	rax *dict = NULL;
+	const char **entries = NULL;
+
+	switch(enc) {
+	case VALUE_INTEGER:
+	case VALUE_DOUBLE:
+		size += (size_t)nrows * 8;
+		break;
+	case VALUE_BOOLEAN:
+		size += nrows;
+		break;
+	case VALUE_STRING:
+		dict = raxNew();
+		entries = array_new(const char *, 0);
+		for(uint i = 0; i < nrows; i++) {
+			SIValue *v = _cell(cells, numcols, first_row + i, col);
+			if(SI_TYPE(*v) == T_NULL) continue;
+
+			size_t len = strlen(v->stringval);
+			void *idx = (void *)(intptr_t)array_len(entries);
+			if(raxTryInsert(dict, (unsigned char *)v->stringval, len, idx,
+						NULL)) {
+				array_append(entries, v->stringval);
+				size += sizeof(uint32_t) + len;
+			}
+		}
+		size += sizeof(uint32_t) + (size_t)nrows * sizeof(uint32_t);
+		break;
+	default:
+		break;
+	}
+
+	char *buf = rm_calloc(1, size);
+	buf[0] = enc;
+	_put_u32(buf + 4, nrows);
+
+	uint8_t *bitmap = (uint8_t *)buf + BINARY_HEADER_SIZE;
+	char *values = buf + BINARY_HEADER_SIZE + bitmap_size;
+
+	// string columns start with their dictionary
+	if(enc == VALUE_STRING) {
+		uint32_t dict_size = array_len(entries);
+		_put_u32(values, dict_size);
+		values += sizeof(uint32_t);
+		for(uint32_t i = 0; i < dict_size; i++) {
+			uint32_t len = strlen(entries[i]);
+			_put_u32(values, len);
+			memcpy(values + sizeof(uint32_t), entries[i], len);
+			values += sizeof(uint32_t) + len;
+		}
+	}
+
+	for(uint i = 0; i < nrows; i++) {
+		SIValue *v = _cell(cells, numcols, first_row + i, col);
+		if(SI_TYPE(*v) == T_NULL) {
+			bitmap[i >> 3] |= 1 << (i & 7);
+			continue;
+		}
+
+		switch(enc) {
+		case VALUE_INTEGER:
+			_put_u64(values + (size_t)i * 8, (uint64_t)v->longval);
+			break;
+		case VALUE_DOUBLE: {
+			uint64_t bits;
+			memcpy(&bits, &v->doubleval, sizeof(bits));
+			_put_u64(values + (size_t)i * 8, bits);
+			break;
+		}
+		case VALUE_BOOLEAN:
+			values[i] = v->longval != 0;
+			break;
+		case VALUE_STRING: {
+			uint32_t idx = (intptr_t)raxFind(dict,
+					(unsigned char *)v->stringval, strlen(v->stringval));
+			_put_u32(values + (size_t)i * sizeof(uint32_t), idx);
+			break;
+		}
+		default:
+			ASSERT(false);
+		}
+	}
+
+	RedisModule_ReplyWithStringBuffer(ctx, buf, size);
+
+	rm_free(buf);
+	if(dict != NULL) {
+		raxFree(dict);
+		array_free(entries);
+	}
+}
+
+void ResultSet_EmitBinaryRows(RedisModuleCtx *ctx, GraphContext *gc,
+		DataBlock *cells, uint numcols) {
+	uint64_t nrows = DataBlock_ItemCount(cells) / numcols;
+	uint64_t nbatches = (nrows + BINARY_BATCH_ROWS - 1) / BINARY_BATCH_ROWS;
+
+	RedisModule_ReplyWithArray(ctx, nbatches);
+	for(uint64_t first_row = 0; first_row < nrows;
+			first_row += BINARY_BATCH_ROWS) {
+		uint n = (nrows - first_row < BINARY_BATCH_ROWS) ?
+			nrows - first_row : BINARY_BATCH_ROWS;
+
+		RedisModule_ReplyWithArray(ctx, numcols);
+		for(uint col = 0; col < numcols; col++) {
+			ValueType enc = _ColumnEncoding(cells, numcols, col, first_row, n);
+			if(enc != VALUE_UNKNOWN) {
+				_ResultSet_BinaryReplyWithColumn(ctx, cells, numcols, col,
+						first_row, n, enc);
+				continue;
+			}
+
+			// mixed or nested values, emit each as a compact value
+			RedisModule_ReplyWithArray(ctx, n);
+			for(uint i = 0; i < n; i++) {
+				ResultSet_EmitCompactValue(ctx, gc,
+						*_cell(cells, numcols, first_row + i, col));
+			}
+		}
+	}
+}
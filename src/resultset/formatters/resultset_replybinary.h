@@ -0,0 +1,17 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+// maximum number of rows in a binary columnar batch
+#define BINARY_BATCH_ROWS 65536
+
+// Formatter for binary columnar replies
+// rows are emitted as batches of columns, each column is a bulk string
+// holding fixed-width values, or a dictionary for strings, and a null bitmap
+// columns which can't be encoded fall back to an array of compact values
+void ResultSet_EmitBinaryRows(RedisModuleCtx *ctx, GraphContext *gc,
+		DataBlock *cells, uint numcols);
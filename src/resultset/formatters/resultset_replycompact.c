@@ -287,6 +287,12 @@ void ResultSet_EmitCompactRow(RedisModuleCtx *ctx, GraphContext *gc,
 	}
 }
 
+void ResultSet_EmitCompactValue(RedisModuleCtx *ctx, GraphContext *gc,
+								SIValue v) {
+	RedisModule_ReplyWithArray(ctx, 2); // Reply with array with space for type and value
+	_ResultSet_CompactReplyWithSIValue(ctx, gc, v);
+}
+
 // For every column in the header, emit a 2-array containing the ColumnType enum
 // followed by the column alias.
 void ResultSet_ReplyWithCompactHeader(RedisModuleCtx *ctx, const char **columns,
@@ -12,3 +12,6 @@ void ResultSet_ReplyWithCompactHeader(RedisModuleCtx *ctx, const char **columns,
 void ResultSet_EmitCompactRow(RedisModuleCtx *ctx, GraphContext *gc,
 		SIValue **row, uint numcols);
 
+// emit a single value as a 2-array holding its ValueType followed by the value
+void ResultSet_EmitCompactValue(RedisModuleCtx *ctx, GraphContext *gc,
+		SIValue v);
@@ -14,20 +14,76 @@
 
 static void _ResultSet_ReplyWithPreamble
 (
-	ResultSet *set
+	ResultSet *set,
+	bool cursor  // response is followed by a cursor id
 ) {
 	if(set->column_count > 0) {
 		// prepare a response containing a header, records, and statistics
-		RedisModule_ReplyWithArray(set->ctx, 3);
+		RedisModule_ReplyWithArray(set->ctx, 3 + cursor);
 		// emit the table header using the appropriate formatter
 		set->formatter->EmitHeader(set->ctx, set->columns,
 				set->columns_record_map);
 	} else {
 		// prepare a response containing only statistics
-		RedisModule_ReplyWithArray(set->ctx, 1);
+		RedisModule_ReplyWithArray(set->ctx, 1 + cursor);
+	}
+}
+
+// free accumulated cells
+static void _ResultSet_FreeCells
+(
+	ResultSet *set
+) {
+	// NOTE: for large result-set containing only NONE heap allocated values
+	// the following is a bit of a waste as there's no real memory to free
+	// at the moment we can't tell rather or not
+	// calling SIValue_Free is required
+	if(set->cells) {
+		// free individual cells if resultset encountered a heap allocated value
+		if(set->cells_allocation & (M_SELF | M_INTERN)) {
+			uint64_t n = DataBlock_ItemCount(set->cells);
+			for(uint64_t i = 0; i < n; i++) {
+				SIValue *v = DataBlock_GetItem(set->cells, i);
+				SIValue_Free(*v);
+			}
+		}
+		DataBlock_Free(set->cells);
 	}
 }
 
+static void _ResultSet_Reply
+(
+	ResultSet *set,  // resultset to reply with
+	bool cursor      // follow response with a cursor id
+) {
+	uint64_t row_count = ResultSet_RowCount(set);
+
+	// set up the results array and emit the header if the query requires one
+	_ResultSet_ReplyWithPreamble(set, cursor);
+
+	// emit resultset
+	if(set->column_count > 0 && set->formatter->EmitRows != NULL) {
+		// columnar formatters emit all rows at once
+		set->formatter->EmitRows(set->ctx, set->gc, set->cells,
+				set->column_count);
+	} else if(set->column_count > 0) {
+		RedisModule_ReplyWithArray(set->ctx, row_count);
+		SIValue *row[set->column_count];
+		uint64_t cells = DataBlock_ItemCount(set->cells);
+		// for each row
+		for(uint64_t i = 0; i < cells; i += set->column_count) {
+			// for each column
+			for(uint j = 0; j < set->column_count; j++) {
+				row[j] = DataBlock_GetItem(set->cells, i + j);
+			}
+
+			set->formatter->EmitRow(set->ctx, set->gc, row, set->column_count);
+		}
+	}
+
+	ResultSetStat_emit(set->ctx, &set->stats); // response with statistics
+}
+
 static void _ResultSet_SetColumns
 (
 	ResultSet *set
@@ -200,8 +256,6 @@ void ResultSet_Reply
 ) {
 	ASSERT(set != NULL);
 
-	uint64_t row_count = ResultSet_RowCount(set);
-
 	// check to see if we've encountered a run-time error
 	// if so, emit it as the only response
 	if(ErrorCtx_EncounteredError()) {
@@ -209,26 +263,35 @@ void ResultSet_Reply
 		return;
 	}
 
-	// set up the results array and emit the header if the query requires one
-	_ResultSet_ReplyWithPreamble(set);
+	_ResultSet_Reply(set, false);
+}
 
-	// emit resultset
-	if(set->column_count > 0) {
-		RedisModule_ReplyWithArray(set->ctx, row_count);
-		SIValue *row[set->column_count];
-		uint64_t cells = DataBlock_ItemCount(set->cells);
-		// for each row
-		for(uint64_t i = 0; i < cells; i += set->column_count) {
-			// for each column
-			for(uint j = 0; j < set->column_count; j++) {
-				row[j] = DataBlock_GetItem(set->cells, i + j);
-			}
+// flush accumulated rows to network followed by a cursor id
+// emitted rows are discarded, allowing the resultset to be refilled
+void ResultSet_ReplyWithCursor
+(
+	ResultSet *set,      // resultset to reply with
+	uint64_t cursor_id   // cursor id, 0 once the query is depleted
+) {
+	ASSERT(set != NULL);
 
-			set->formatter->EmitRow(set->ctx, set->gc, row, set->column_count);
-		}
+	// check to see if we've encountered a run-time error
+	// if so, emit it as the only response
+	if(ErrorCtx_EncounteredError()) {
+		ErrorCtx_EmitException();
+		return;
 	}
 
-	ResultSetStat_emit(set->ctx, &set->stats); // response with statistics
+	_ResultSet_Reply(set, true);
+	RedisModule_ReplyWithLongLong(set->ctx, cursor_id);
+
+	// discard emitted rows
+	if(set->cells != NULL) {
+		_ResultSet_FreeCells(set);
+		set->cells = DataBlock_New(16384, set->column_count * 10,
+				sizeof(SIValue), NULL);
+		set->cells_allocation = M_NONE;
+	}
 }
 
 void ResultSet_Clear(ResultSet *set) {
@@ -252,21 +315,7 @@ void ResultSet_Free
 	}
 
 	// free resultset cells
-	// NOTE: for large result-set containing only NONE heap allocated values
-	// the following is a bit of a waste as there's no real memory to free
-	// at the moment we can't tell rather or not
-	// calling SIValue_Free is required
-	if(set->cells) {
-		// free individual cells if resultset encountered a heap allocated value
-		if(set->cells_allocation & M_SELF) {
-			uint64_t n = DataBlock_ItemCount(set->cells);
-			for(uint64_t i = 0; i < n; i++) {
-				SIValue *v = DataBlock_GetItem(set->cells, i);
-				SIValue_Free(*v);
-			}
-		}
-		DataBlock_Free(set->cells);
-	}
+	_ResultSet_FreeCells(set);
 
 	rm_free(set);
 }
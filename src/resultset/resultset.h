@@ -84,6 +84,14 @@ void ResultSet_Reply
 	ResultSet *set  // resultset to reply with
 );
 
+// flush accumulated rows to network followed by a cursor id
+// emitted rows are discarded, allowing the resultset to be refilled
+void ResultSet_ReplyWithCursor
+(
+	ResultSet *set,      // resultset to reply with
+	uint64_t cursor_id   // cursor id, 0 once the query is depleted
+);
+
 // clear result set stats
 void ResultSet_Clear
 (
@@ -0,0 +1,345 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "attribute_stats.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+#include <math.h>
+
+struct AttributeStatsBuilder {
+	uint64_t present;   // number of non-null values
+	uint64_t numerics;  // number of numeric values
+	uint64_t sampled;   // number of values offered to the reservoir
+	uint64_t rng;       // reservoir sampling random state
+	double *sample;     // reservoir of numeric values
+	uint8_t registers[ATTRIBUTE_STATS_HLL_REGISTERS];  // HyperLogLog registers
+};
+
+//------------------------------------------------------------------------------
+// HyperLogLog
+//------------------------------------------------------------------------------
+
+// add value to HyperLogLog registers
+// the top bits of the value's hash select a register, which tracks
+// the longest run of leading zeros seen in the remaining bits
+static void _HLL_Add
+(
+	uint8_t *registers,
+	SIValue v
+) {
+	uint64_t hash = SIValue_HashCode(v);
+	uint64_t idx  = hash >> (64 - ATTRIBUTE_STATS_HLL_PRECISION);
+
+	// make sure the remaining bits are not all zeros
+	uint64_t w = (hash << ATTRIBUTE_STATS_HLL_PRECISION) |
+		(1ULL << (ATTRIBUTE_STATS_HLL_PRECISION - 1));
+	uint8_t rank = __builtin_clzll(w) + 1;
+
+	if(registers[idx] < rank) registers[idx] = rank;
+}
+
+static double _HLL_Count
+(
+	const uint8_t *registers
+) {
+	double m     = ATTRIBUTE_STATS_HLL_REGISTERS;
+	double alpha = 0.7213 / (1 + 1.079 / m);
+	double sum   = 0;
+	uint zeros   = 0;
+
+	for(uint i = 0; i < ATTRIBUTE_STATS_HLL_REGISTERS; i++) {
+		sum += ldexp(1.0, -registers[i]);
+		if(registers[i] == 0) zeros++;
+	}
+
+	double estimate = alpha * m * m / sum;
+
+	// small range correction, use linear counting
+	if(estimate <= 2.5 * m && zeros > 0) estimate = m * log(m / zeros);
+
+	return estimate;
+}
+
+//------------------------------------------------------------------------------
+// histogram
+//------------------------------------------------------------------------------
+
+static int _double_cmp
+(
+	const void *a,
+	const void *b
+) {
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+// build an equi-depth histogram from a sample of values
+// each bucket holds the same number of sampled values
+static void _Histogram_Build
+(
+	AttributeStats *stats,
+	double *sample
+) {
+	uint n = array_len(sample);
+	if(n == 0) {
+		stats->bucket_count = 0;
+		return;
+	}
+
+	qsort(sample, n, sizeof(double), _double_cmp);
+
+	uint buckets = MIN(n, ATTRIBUTE_STATS_BUCKETS);
+	for(uint i = 0; i <= buckets; i++) {
+		stats->bounds[i] = sample[((uint64_t)i * (n - 1)) / buckets];
+	}
+	stats->bucket_count = buckets;
+}
+
+// estimate the fraction of numeric values smaller than 'v'
+// values are assumed to be uniformly distributed within each bucket
+static double _Histogram_FractionBelow
+(
+	const AttributeStats *stats,
+	double v
+) {
+	uint buckets = stats->bucket_count;
+	const double *bounds = stats->bounds;
+	ASSERT(buckets > 0);
+
+	if(v <= bounds[0])      return 0;
+	if(v >  bounds[buckets]) return 1;
+
+	for(uint i = 0; i < buckets; i++) {
+		if(v > bounds[i + 1]) continue;
+		double lo    = bounds[i];
+		double width = bounds[i + 1] - lo;
+		double frac  = (width > 0) ? (v - lo) / width : 1;
+		return (i + frac) / buckets;
+	}
+
+	return 1;
+}
+
+//------------------------------------------------------------------------------
+// build
+//------------------------------------------------------------------------------
+
+AttributeStatsBuilder *AttributeStatsBuilder_New(void) {
+	AttributeStatsBuilder *b = rm_calloc(1, sizeof(AttributeStatsBuilder));
+
+	b->rng    = 0x9E3779B97F4A7C15ULL;
+	b->sample = array_new(double, 0);
+
+	return b;
+}
+
+void AttributeStatsBuilder_Add
+(
+	AttributeStatsBuilder *b,
+	SIValue v
+) {
+	ASSERT(b != NULL);
+
+	if(SIValue_IsNull(v)) return;
+
+	b->present++;
+	_HLL_Add(b->registers, v);
+
+	if(!(SI_TYPE(v) & SI_NUMERIC)) return;
+
+	b->numerics++;
+	double d = SI_GET_NUMERIC(v);
+	if(isnan(d)) return;
+
+	// reservoir sampling, each numeric value is sampled with equal probability
+	b->sampled++;
+	if(array_len(b->sample) < ATTRIBUTE_STATS_SAMPLE_SIZE) {
+		array_append(b->sample, d);
+		return;
+	}
+
+	// xorshift64*
+	b->rng ^= b->rng >> 12;
+	b->rng ^= b->rng << 25;
+	b->rng ^= b->rng >> 27;
+	uint64_t j = (b->rng * 0x2545F4914F6CDD1DULL) % b->sampled;
+	if(j < ATTRIBUTE_STATS_SAMPLE_SIZE) b->sample[j] = d;
+}
+
+void AttributeStatsBuilder_Finalize
+(
+	AttributeStatsBuilder *b,
+	uint64_t count,
+	AttributeStats *stats
+) {
+	ASSERT(b     != NULL);
+	ASSERT(stats != NULL);
+
+	stats->count    = MAX(count, b->present);
+	stats->nulls    = stats->count - b->present;
+	stats->numerics = b->numerics;
+	memcpy(stats->registers, b->registers, sizeof(b->registers));
+
+	_Histogram_Build(stats, b->sample);
+}
+
+void AttributeStatsBuilder_Free
+(
+	AttributeStatsBuilder *b
+) {
+	ASSERT(b != NULL);
+
+	array_free(b->sample);
+	rm_free(b);
+}
+
+//------------------------------------------------------------------------------
+// maintenance
+//------------------------------------------------------------------------------
+
+void AttributeStats_Add
+(
+	AttributeStats *stats,
+	SIValue v
+) {
+	ASSERT(stats != NULL);
+
+	stats->count++;
+
+	if(SIValue_IsNull(v)) {
+		stats->nulls++;
+		return;
+	}
+
+	_HLL_Add(stats->registers, v);
+
+	if(!(SI_TYPE(v) & SI_NUMERIC)) return;
+
+	stats->numerics++;
+
+	// widen histogram to cover the new value
+	double d = SI_GET_NUMERIC(v);
+	uint buckets = stats->bucket_count;
+	if(buckets > 0 && !isnan(d)) {
+		if(d < stats->bounds[0])       stats->bounds[0]       = d;
+		if(d > stats->bounds[buckets]) stats->bounds[buckets] = d;
+	}
+}
+
+void AttributeStats_Remove
+(
+	AttributeStats *stats,
+	SIValue v
+) {
+	ASSERT(stats != NULL);
+
+	if(stats->count > 0) stats->count--;
+
+	if(SIValue_IsNull(v)) {
+		if(stats->nulls > 0) stats->nulls--;
+	} else if(SI_TYPE(v) & SI_NUMERIC) {
+		if(stats->numerics > 0) stats->numerics--;
+	}
+}
+
+//------------------------------------------------------------------------------
+// estimation
+//------------------------------------------------------------------------------
+
+double AttributeStats_NullFraction
+(
+	const AttributeStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	if(stats->count == 0) return 0;
+	return (double)MIN(stats->nulls, stats->count) / stats->count;
+}
+
+double AttributeStats_DistinctCount
+(
+	const AttributeStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	uint64_t present = stats->count - MIN(stats->nulls, stats->count);
+	if(present == 0) return 0;
+
+	// there can't be more distinct values than entities holding a value
+	double distinct = _HLL_Count(stats->registers);
+	return MAX(1, MIN(distinct, present));
+}
+
+bool AttributeStats_Selectivity
+(
+	const AttributeStats *stats,
+	AST_Operator op,
+	SIValue v,
+	double *selectivity
+) {
+	ASSERT(stats       != NULL);
+	ASSERT(selectivity != NULL);
+
+	if(stats->count == 0) return false;
+
+	// comparing against null never holds
+	if(SIValue_IsNull(v)) {
+		*selectivity = 0;
+		return true;
+	}
+
+	double present  = 1 - AttributeStats_NullFraction(stats);
+	double distinct = AttributeStats_DistinctCount(stats);
+	double eq       = (distinct > 0) ? present / distinct : 0;
+
+	bool   numeric  = (SI_TYPE(v) & SI_NUMERIC);
+	double d        = numeric ? SI_GET_NUMERIC(v) : 0;
+	uint   buckets  = stats->bucket_count;
+
+	// a numeric value outside of the histogram's range isn't held
+	// by any entity
+	bool out_of_range = numeric && buckets > 0 &&
+		(d < stats->bounds[0] || d > stats->bounds[buckets]);
+
+	double sel;
+	switch(op) {
+		case OP_EQUAL:
+			sel = out_of_range ? 0 : eq;
+			break;
+		case OP_NEQUAL:
+			sel = out_of_range ? present : present - eq;
+			break;
+		case OP_LT:
+		case OP_LE:
+		case OP_GT:
+		case OP_GE:
+		{
+			if(!numeric || buckets == 0 || isnan(d)) return false;
+
+			// range predicates only hold for numeric values
+			double numerics = (double)stats->numerics / stats->count;
+			double below    = _Histogram_FractionBelow(stats, d);
+			double eq_num   = (distinct > 0) ? 1 / distinct : 0;
+			if(out_of_range) eq_num = 0;
+
+			if(op == OP_LT)      sel = below;
+			else if(op == OP_LE) sel = below + eq_num;
+			else if(op == OP_GT) sel = 1 - below - eq_num;
+			else                 sel = 1 - below;
+
+			sel = MAX(0, MIN(sel, 1)) * numerics;
+			break;
+		}
+		default:
+			return false;
+	}
+
+	*selectivity = MAX(0, MIN(sel, 1));
+	return true;
+}
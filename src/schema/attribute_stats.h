@@ -0,0 +1,117 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../value.h"
+#include "../ast/ast_shared.h"
+
+// number of equi-depth histogram buckets
+#define ATTRIBUTE_STATS_BUCKETS 32
+
+// number of HyperLogLog registers is 2^ATTRIBUTE_STATS_HLL_PRECISION
+// standard error of the distinct count estimate is 1.04 / sqrt(registers)
+#define ATTRIBUTE_STATS_HLL_PRECISION 10
+#define ATTRIBUTE_STATS_HLL_REGISTERS (1 << ATTRIBUTE_STATS_HLL_PRECISION)
+
+// maximum number of numeric values sampled to build a histogram
+#define ATTRIBUTE_STATS_SAMPLE_SIZE 8192
+
+// statistics describing the values of a single attribute
+// across all entities of a schema
+//
+// null fraction and distinct count are maintained as entities are created,
+// updated and deleted, as HyperLogLog registers can't forget values
+// removed values are still counted as distinct
+// histogram bounds are only widened by new values and are recomputed
+// once the schema is analyzed again
+typedef struct AttributeStats {
+	uint64_t count;     // number of entities represented
+	uint64_t nulls;     // number of entities missing the attribute
+	uint64_t numerics;  // number of entities holding a numeric value
+	uint bucket_count;  // number of histogram buckets, 0 if there's no histogram
+	double bounds[ATTRIBUTE_STATS_BUCKETS + 1];  // bucket boundaries
+	uint8_t registers[ATTRIBUTE_STATS_HLL_REGISTERS];  // HyperLogLog registers
+} AttributeStats;
+
+// collects attribute values while a schema is analyzed
+typedef struct AttributeStatsBuilder AttributeStatsBuilder;
+
+//------------------------------------------------------------------------------
+// build
+//------------------------------------------------------------------------------
+
+// create a new builder
+AttributeStatsBuilder *AttributeStatsBuilder_New(void);
+
+// introduce a value to the builder
+// null values are ignored, missing values are accounted for when
+// the builder is finalized
+void AttributeStatsBuilder_Add
+(
+	AttributeStatsBuilder *b,  // builder
+	SIValue v                  // attribute value
+);
+
+// compute statistics from the values introduced to the builder
+// 'stats' is overwritten in place
+void AttributeStatsBuilder_Finalize
+(
+	AttributeStatsBuilder *b,  // builder
+	uint64_t count,            // number of entities scanned
+	AttributeStats *stats      // [output] statistics
+);
+
+// free builder
+void AttributeStatsBuilder_Free
+(
+	AttributeStatsBuilder *b
+);
+
+//------------------------------------------------------------------------------
+// maintenance
+//------------------------------------------------------------------------------
+
+// account for an entity introduced with value 'v'
+// ATTRIBUTE_NOTFOUND or null denote a missing attribute
+void AttributeStats_Add
+(
+	AttributeStats *stats,
+	SIValue v
+);
+
+// account for an entity with value 'v' being removed
+void AttributeStats_Remove
+(
+	AttributeStats *stats,
+	SIValue v
+);
+
+//------------------------------------------------------------------------------
+// estimation
+//------------------------------------------------------------------------------
+
+// fraction of entities missing the attribute
+double AttributeStats_NullFraction
+(
+	const AttributeStats *stats
+);
+
+// estimated number of distinct values
+double AttributeStats_DistinctCount
+(
+	const AttributeStats *stats
+);
+
+// estimate the fraction of entities for which `attr op v` holds
+// returns false if the predicate can't be estimated
+bool AttributeStats_Selectivity
+(
+	const AttributeStats *stats,  // attribute statistics
+	AST_Operator op,              // comparison operator
+	SIValue v,                    // constant compared against
+	double *selectivity           // [output] estimated selectivity
+);
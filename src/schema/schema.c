@@ -5,6 +5,7 @@
  */
 
 #include "schema.h"
+#include "attribute_stats.h"
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
@@ -24,6 +25,7 @@ Schema *Schema_New
 	s->type         =  type;
 	s->index        =  NULL;
 	s->fulltextIdx  =  NULL;
+	s->stats        =  NULL;
 	s->name         =  rm_strdup(name);
 
 	return s;
@@ -286,6 +288,91 @@ void Schema_RemoveEdgeFromIndices
 	if(idx) Index_RemoveEdge(idx, e);
 }
 
+bool Schema_HasAttributeStats
+(
+	const Schema *s
+) {
+	ASSERT(s != NULL);
+	return s->stats != NULL;
+}
+
+AttributeStats *Schema_GetAttributeStats
+(
+	const Schema *s,
+	Attribute_ID attr_id
+) {
+	ASSERT(s != NULL);
+
+	if(s->stats == NULL || attr_id >= array_len(s->stats)) return NULL;
+	return s->stats[attr_id];
+}
+
+AttributeStats *Schema_AddAttributeStats
+(
+	Schema *s,
+	Attribute_ID attr_id
+) {
+	ASSERT(s != NULL);
+
+	AttributeStats *stats = Schema_GetAttributeStats(s, attr_id);
+	if(stats != NULL) return stats;
+
+	if(s->stats == NULL) s->stats = array_new(AttributeStats *, attr_id + 1);
+	while(array_len(s->stats) <= attr_id) array_append(s->stats, NULL);
+
+	stats = rm_calloc(1, sizeof(AttributeStats));
+	s->stats[attr_id] = stats;
+	return stats;
+}
+
+void Schema_AddEntityToStats
+(
+	const Schema *s,
+	const GraphEntity *e
+) {
+	ASSERT(s != NULL);
+	ASSERT(e != NULL);
+
+	uint n = (s->stats != NULL) ? array_len(s->stats) : 0;
+	for(Attribute_ID i = 0; i < n; i++) {
+		AttributeStats *stats = s->stats[i];
+		if(stats == NULL) continue;
+		AttributeStats_Add(stats, *GraphEntity_GetProperty(e, i));
+	}
+}
+
+void Schema_RemoveEntityFromStats
+(
+	const Schema *s,
+	const GraphEntity *e
+) {
+	ASSERT(s != NULL);
+	ASSERT(e != NULL);
+
+	uint n = (s->stats != NULL) ? array_len(s->stats) : 0;
+	for(Attribute_ID i = 0; i < n; i++) {
+		AttributeStats *stats = s->stats[i];
+		if(stats == NULL) continue;
+		AttributeStats_Remove(stats, *GraphEntity_GetProperty(e, i));
+	}
+}
+
+void Schema_UpdateAttributeStats
+(
+	const Schema *s,
+	Attribute_ID attr_id,
+	SIValue old_value,
+	SIValue new_value
+) {
+	ASSERT(s != NULL);
+
+	AttributeStats *stats = Schema_GetAttributeStats(s, attr_id);
+	if(stats == NULL) return;
+
+	AttributeStats_Remove(stats, old_value);
+	AttributeStats_Add(stats, new_value);
+}
+
 void Schema_Free
 (
 	Schema *s
@@ -298,6 +385,15 @@ void Schema_Free
 	if(s->index) Index_Free(s->index);
 	if(s->fulltextIdx) Index_Free(s->fulltextIdx);
 
+	// free attribute statistics
+	if(s->stats) {
+		uint n = array_len(s->stats);
+		for(uint i = 0; i < n; i++) {
+			if(s->stats[i]) rm_free(s->stats[i]);
+		}
+		array_free(s->stats);
+	}
+
 	rm_free(s);
 }
 
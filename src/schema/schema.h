@@ -12,6 +12,8 @@
 #include "redisearch_api.h"
 #include "../graph/entities/graph_entity.h"
 
+typedef struct AttributeStats AttributeStats;
+
 typedef enum {
 	SCHEMA_NODE,
 	SCHEMA_EDGE,
@@ -26,6 +28,7 @@ typedef struct {
 	SchemaType type;    // schema type (node/edge)
 	Index index;        // exact match index
 	Index fulltextIdx;  // full-text index
+	AttributeStats **stats;  // attribute statistics, indexed by attribute id
 } Schema;
 
 // creates a new schema
@@ -114,6 +117,53 @@ void Schema_RemoveEdgeFromIndices
 	const Edge *e
 );
 
+// returns true if any of the schema's attributes were analyzed
+bool Schema_HasAttributeStats
+(
+	const Schema *s
+);
+
+// retrieves attribute statistics
+// returns NULL if attribute wasn't analyzed
+AttributeStats *Schema_GetAttributeStats
+(
+	const Schema *s,
+	Attribute_ID attr_id
+);
+
+// retrieves attribute statistics, creating them if missing
+// statistics are never freed before the schema, as such once created
+// they're updated in place
+AttributeStats *Schema_AddAttributeStats
+(
+	Schema *s,
+	Attribute_ID attr_id
+);
+
+// introduce entity to schema attribute statistics
+void Schema_AddEntityToStats
+(
+	const Schema *s,
+	const GraphEntity *e
+);
+
+// remove entity from schema attribute statistics
+void Schema_RemoveEntityFromStats
+(
+	const Schema *s,
+	const GraphEntity *e
+);
+
+// update schema attribute statistics with an entity's attribute changing
+// from 'old_value' to 'new_value'
+void Schema_UpdateAttributeStats
+(
+	const Schema *s,
+	Attribute_ID attr_id,
+	SIValue old_value,
+	SIValue new_value
+);
+
 // Free schema
 void Schema_Free
 (
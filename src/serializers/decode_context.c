@@ -16,6 +16,8 @@ GraphDecodeContext *GraphDecodeContext_New() {
 	ctx->graph_keys_count = 1;
 	ctx->meta_keys = raxNew();
 	ctx->multi_edge = NULL;
+	ctx->label_tuples = NULL;
+	ctx->relation_tuples = NULL;
 	return ctx;
 }
 
@@ -29,6 +31,8 @@ void GraphDecodeContext_Reset(GraphDecodeContext *ctx) {
 		array_free(ctx->multi_edge);
 		ctx->multi_edge = NULL;
 	}
+
+	GraphDecodeContext_FreeMatrixTuples(ctx);
 }
 
 void GraphDecodeContext_SetKeyCount(GraphDecodeContext *ctx, uint64_t key_count) {
@@ -41,6 +45,68 @@ uint64_t GraphDecodeContext_GetKeyCount(const GraphDecodeContext *ctx) {
 	return ctx->graph_keys_count;
 }
 
+void GraphDecodeContext_InitMatrixTuples(GraphDecodeContext *ctx, uint64_t label_count,
+										 uint64_t relation_count) {
+	ASSERT(ctx);
+	ASSERT(ctx->label_tuples == NULL);
+	ASSERT(ctx->relation_tuples == NULL);
+
+	ctx->label_tuples = array_new(MatrixTuples, label_count);
+	for(uint64_t i = 0; i < label_count; i++) {
+		MatrixTuples tuples = {.rows = array_new(uint64_t, 0), .cols = NULL, .vals = NULL};
+		array_append(ctx->label_tuples, tuples);
+	}
+
+	ctx->relation_tuples = array_new(MatrixTuples, relation_count);
+	for(uint64_t i = 0; i < relation_count; i++) {
+		MatrixTuples tuples = {
+			.rows = array_new(uint64_t, 0),
+			.cols = array_new(uint64_t, 0),
+			.vals = array_new(uint64_t, 0)
+		};
+		array_append(ctx->relation_tuples, tuples);
+	}
+}
+
+void GraphDecodeContext_AddNodeLabel(GraphDecodeContext *ctx, uint64_t id, uint64_t label) {
+	ASSERT(ctx);
+	ASSERT(label < array_len(ctx->label_tuples));
+
+	array_append(ctx->label_tuples[label].rows, id);
+}
+
+void GraphDecodeContext_AddEdge(GraphDecodeContext *ctx, uint64_t id, uint64_t src,
+								uint64_t dest, uint64_t relation) {
+	ASSERT(ctx);
+	ASSERT(relation < array_len(ctx->relation_tuples));
+
+	MatrixTuples *tuples = ctx->relation_tuples + relation;
+	array_append(tuples->rows, src);
+	array_append(tuples->cols, dest);
+	array_append(tuples->vals, id);
+}
+
+static void _MatrixTuples_Free(MatrixTuples *tuples) {
+	if(tuples == NULL) return;
+
+	uint n = array_len(tuples);
+	for(uint i = 0; i < n; i++) {
+		if(tuples[i].rows) array_free(tuples[i].rows);
+		if(tuples[i].cols) array_free(tuples[i].cols);
+		if(tuples[i].vals) array_free(tuples[i].vals);
+	}
+	array_free(tuples);
+}
+
+void GraphDecodeContext_FreeMatrixTuples(GraphDecodeContext *ctx) {
+	ASSERT(ctx);
+
+	_MatrixTuples_Free(ctx->label_tuples);
+	_MatrixTuples_Free(ctx->relation_tuples);
+	ctx->label_tuples = NULL;
+	ctx->relation_tuples = NULL;
+}
+
 void GraphDecodeContext_AddMetaKey(GraphDecodeContext *ctx, const char *key) {
 	ASSERT(ctx);
 	raxInsert(ctx->meta_keys, (unsigned char *)key, strlen(key), NULL, NULL);
@@ -82,6 +148,8 @@ void GraphDecodeContext_Free(GraphDecodeContext *ctx) {
 			ctx->multi_edge = NULL;
 		}
 
+		GraphDecodeContext_FreeMatrixTuples(ctx);
+
 		rm_free(ctx);
 	}
 }
@@ -11,12 +11,21 @@
 #include "stdint.h"
 #include "rax.h"
 
+// Matrix entries collected while decoding, used to build the matrix at once.
+typedef struct {
+	uint64_t *rows;  // Row indices.
+	uint64_t *cols;  // Column indices, NULL for diagonal matrices.
+	uint64_t *vals;  // Entry values, NULL for boolean matrices.
+} MatrixTuples;
+
 // A struct that maintains the state of a graph decoding from RDB.
 typedef struct {
-	uint64_t keys_processed;    // Count the number of procssed graph keys.
-	uint64_t graph_keys_count;  // The number of keys representing the graph.
-	rax *meta_keys;             // The meta keys encountered so far in the decode process.
-	uint64_t *multi_edge;       // Is relation contains multi edge values.
+	uint64_t keys_processed;          // Count the number of procssed graph keys.
+	uint64_t graph_keys_count;        // The number of keys representing the graph.
+	rax *meta_keys;                   // The meta keys encountered so far in the decode process.
+	uint64_t *multi_edge;             // Is relation contains multi edge values.
+	MatrixTuples *label_tuples;       // Labeled nodes, per label.
+	MatrixTuples *relation_tuples;    // Edges, per relationship type.
 } GraphDecodeContext;
 
 // Creates a new graph decoding context.
@@ -31,6 +40,20 @@ void GraphDecodeContext_SetKeyCount(GraphDecodeContext *ctx, uint64_t key_count)
 // Returns the number of keys required for decoding the graph.
 uint64_t GraphDecodeContext_GetKeyCount(const GraphDecodeContext *ctx);
 
+// Allocate matrix tuples for the graph's label and relation matrices.
+void GraphDecodeContext_InitMatrixTuples(GraphDecodeContext *ctx, uint64_t label_count,
+										 uint64_t relation_count);
+
+// Record node 'id' is labeled as 'label'.
+void GraphDecodeContext_AddNodeLabel(GraphDecodeContext *ctx, uint64_t id, uint64_t label);
+
+// Record edge 'id' of type 'relation' connecting 'src' to 'dest'.
+void GraphDecodeContext_AddEdge(GraphDecodeContext *ctx, uint64_t id, uint64_t src,
+								uint64_t dest, uint64_t relation);
+
+// Free collected matrix tuples.
+void GraphDecodeContext_FreeMatrixTuples(GraphDecodeContext *ctx);
+
 // Add a meta key name, required for encoding the graph.
 void GraphDecodeContext_AddMetaKey(GraphDecodeContext *ctx, const char *key);
 
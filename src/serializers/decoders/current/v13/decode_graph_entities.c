@@ -0,0 +1,302 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "decode_v13.h"
+
+// reads entities out of an encoded chunk
+typedef struct {
+	const unsigned char *buf;  // chunk
+	size_t len;                // chunk length
+	size_t pos;                // read position
+} ChunkReader;
+
+// values are read as 8 little-endian bytes
+static uint64_t _ChunkReadUnsigned
+(
+	ChunkReader *reader
+) {
+	ASSERT(reader->pos + sizeof(uint64_t) <= reader->len);
+	uint64_t v = 0;
+	for(int i = 0; i < 8; i++) {
+		v |= (uint64_t)reader->buf[reader->pos++] << (i * 8);
+	}
+	return v;
+}
+
+static double _ChunkReadDouble
+(
+	ChunkReader *reader
+) {
+	double v;
+	uint64_t bits = _ChunkReadUnsigned(reader);
+	memcpy(&v, &bits, sizeof(v));
+	return v;
+}
+
+static char *_ChunkReadString
+(
+	ChunkReader *reader
+) {
+	size_t len = _ChunkReadUnsigned(reader);
+	ASSERT(reader->pos + len <= reader->len);
+	char *s = rm_malloc(len + 1);
+	memcpy(s, reader->buf + reader->pos, len);
+	s[len] = '\0';
+	reader->pos += len;
+	return s;
+}
+
+// forward declarations
+static SIValue _ChunkLoadSIArray(ChunkReader *reader);
+
+static SIValue _ChunkLoadSIValue
+(
+	ChunkReader *reader
+) {
+	// Format:
+	// SIType
+	// Value
+	SIType t = _ChunkReadUnsigned(reader);
+	switch(t) {
+	case T_INT64:
+		return SI_LongVal((int64_t)_ChunkReadUnsigned(reader));
+	case T_DOUBLE:
+		return SI_DoubleVal(_ChunkReadDouble(reader));
+	case T_STRING:
+		// transfer ownership of the heap-allocated string to the
+		// newly-created SIValue
+		return SI_TransferStringVal(_ChunkReadString(reader));
+	case T_BOOL:
+		return SI_BoolVal((int64_t)_ChunkReadUnsigned(reader));
+	case T_ARRAY:
+		return _ChunkLoadSIArray(reader);
+	case T_POINT: {
+		double lat = _ChunkReadDouble(reader);
+		double lon = _ChunkReadDouble(reader);
+		return SI_Point(lat, lon);
+	}
+	case T_NULL:
+	default: // currently impossible
+		return SI_NullVal();
+	}
+}
+
+static SIValue _ChunkLoadSIArray
+(
+	ChunkReader *reader
+) {
+	/* loads array as
+	   unsinged : array legnth
+	   array[0]
+	   .
+	   .
+	   .
+	   array[array length -1]
+	 */
+	uint arrayLen = _ChunkReadUnsigned(reader);
+	SIValue list = SI_Array(arrayLen);
+	for(uint i = 0; i < arrayLen; i++) {
+		SIValue elem = _ChunkLoadSIValue(reader);
+		SIArray_Append(&list, elem);
+		SIValue_Free(elem);
+	}
+	return list;
+}
+
+static void _ChunkLoadEntity
+(
+	ChunkReader *reader,
+	GraphContext *gc,
+	GraphEntity *e
+) {
+	// Format:
+	// #properties N
+	// (name, value type, value) X N
+
+	uint64_t propCount = _ChunkReadUnsigned(reader);
+
+	for(int i = 0; i < propCount; i++) {
+		Attribute_ID attr_id = _ChunkReadUnsigned(reader);
+		SIValue attr_value = _ChunkLoadSIValue(reader);
+		GraphContext_InternValue(gc, &attr_value);
+		// transfer ownership of the loaded value to the entity
+		AttributeSet_AddNoClone(e->attributes, attr_id, attr_value);
+	}
+}
+
+static void _ChunkLoadNode
+(
+	ChunkReader *reader,
+	GraphContext *gc
+) {
+	// Node Format:
+	//      ID
+	//      #labels M
+	//      (labels) X M
+	//      #properties N
+	//      (name, value type, value) X N
+
+	Node n;
+	NodeID id = _ChunkReadUnsigned(reader);
+
+	// #labels M
+	uint64_t nodeLabelCount = _ChunkReadUnsigned(reader);
+
+	// * (labels) x M
+	LabelID labels[nodeLabelCount];
+	for(uint64_t i = 0; i < nodeLabelCount; i ++){
+		labels[i] = _ChunkReadUnsigned(reader);
+	}
+
+	// label matrices are built once all keys are decoded
+	Serializer_Graph_SetNode(gc->g, id, NULL, 0, &n);
+	for(uint64_t i = 0; i < nodeLabelCount; i++) {
+		GraphDecodeContext_AddNodeLabel(gc->decoding_context, id, labels[i]);
+	}
+
+	_ChunkLoadEntity(reader, gc, (GraphEntity *)&n);
+
+	// introduce n to each relevant index
+	for (int i = 0; i < nodeLabelCount; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		ASSERT(s != NULL);
+		if(s->index) Index_IndexNode(s->index, &n);
+		if(s->fulltextIdx) Index_IndexNode(s->fulltextIdx, &n);
+	}
+}
+
+static void _ChunkLoadEdge
+(
+	ChunkReader *reader,
+	GraphContext *gc
+) {
+	// Format:
+	//  edge ID
+	//  source node ID
+	//  destination node ID
+	//  relation type
+	//  edge properties
+
+	Edge e;
+	EdgeID    edgeId    =  _ChunkReadUnsigned(reader);
+	NodeID    srcId     =  _ChunkReadUnsigned(reader);
+	NodeID    destId    =  _ChunkReadUnsigned(reader);
+	uint64_t  relation  =  _ChunkReadUnsigned(reader);
+	// relationship matrices are built once all keys are decoded
+	Serializer_Graph_AllocateEdge(gc->g, edgeId, srcId, destId, relation,
+			&e);
+	GraphDecodeContext_AddEdge(gc->decoding_context, edgeId, srcId, destId,
+			relation);
+	_ChunkLoadEntity(reader, gc, (GraphEntity *)&e);
+
+	// index edge
+	Schema *s = GraphContext_GetSchemaByID(gc, relation, SCHEMA_EDGE);
+	ASSERT(s != NULL);
+	if(s->index) Index_IndexEdge(s->index, &e);
+	if(s->fulltextIdx) Index_IndexEdge(s->fulltextIdx, &e);
+}
+
+// load entity chunks, each chunk is a string buffer
+// holding a consecutive range of encoded entities
+static void _RdbLoadChunks
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t entity_count,
+	bool edges
+) {
+	// Format:
+	// #chunks C
+	// chunk X C
+
+	uint64_t loaded = 0;
+	uint64_t chunk_count = RedisModule_LoadUnsigned(rdb);
+
+	for(uint64_t i = 0; i < chunk_count; i++) {
+		size_t len;
+		char *buf = RedisModule_LoadStringBuffer(rdb, &len);
+		ChunkReader reader = {.buf = (const unsigned char *)buf, .len = len,
+			.pos = 0};
+
+		while(reader.pos < reader.len) {
+			if(edges) _ChunkLoadEdge(&reader, gc);
+			else _ChunkLoadNode(&reader, gc);
+			loaded++;
+		}
+
+		RedisModule_Free(buf);
+	}
+
+	ASSERT(loaded == entity_count);
+}
+
+void RdbLoadNodes_v13
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t node_count
+) {
+	// Format:
+	// #chunks C
+	// chunk X C, each holding a range of nodes:
+	//      ID
+	//      #labels M
+	//      (labels) X M
+	//      #properties N
+	//      (name, value type, value) X N
+
+	// nothing is encoded for an empty payload
+	if(node_count == 0) return;
+	_RdbLoadChunks(rdb, gc, node_count, false);
+}
+
+void RdbLoadDeletedNodes_v13
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t deleted_node_count
+) {
+	// Format:
+	// node id X N
+	for(uint64_t i = 0; i < deleted_node_count; i++) {
+		NodeID id = RedisModule_LoadUnsigned(rdb);
+		Serializer_Graph_MarkNodeDeleted(gc->g, id);
+	}
+}
+
+void RdbLoadEdges_v13
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t edge_count
+) {
+	// Format:
+	// #chunks C
+	// chunk X C, each holding a range of edges:
+	//  edge ID
+	//  source node ID
+	//  destination node ID
+	//  relation type
+	//  edge properties
+
+	// nothing is encoded for an empty payload
+	if(edge_count == 0) return;
+	_RdbLoadChunks(rdb, gc, edge_count, true);
+}
+
+void RdbLoadDeletedEdges_v13
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t deleted_edge_count
+) {
+	// Format:
+	// edge id X N
+	for(uint64_t i = 0; i < deleted_edge_count; i++) {
+		EdgeID id = RedisModule_LoadUnsigned(rdb);
+		Serializer_Graph_MarkEdgeDeleted(gc->g, id);
+	}
+}
@@ -99,6 +99,11 @@ static GraphContext *_DecodeHeader
 		}
 
 		GraphDecodeContext_SetKeyCount(gc->decoding_context, key_number);
+
+		// label and relationship matrices are built from their entries
+		// once the entire graph is decoded
+		GraphDecodeContext_InitMatrixTuples(gc->decoding_context, label_count,
+				relation_count);
 	}
 
 	// decode graph schemas
@@ -107,6 +112,45 @@ static GraphContext *_DecodeHeader
 	return gc;
 }
 
+// builds label, relationship and adjacency matrices
+// out of the entries collected while decoding the graph's keys
+// building a matrix at once is considerably faster than
+// introducing its entries one by one
+static void _BuildMatrices
+(
+	GraphContext *gc
+) {
+	Graph *g = gc->g;
+	GraphDecodeContext *ctx = gc->decoding_context;
+
+	// free each matrix entries as soon as the matrix is built
+	uint label_count = array_len(ctx->label_tuples);
+	for(uint i = 0; i < label_count; i++) {
+		MatrixTuples *tuples = ctx->label_tuples + i;
+		Serializer_Graph_BuildLabelMatrix(g, i, tuples->rows,
+				array_len(tuples->rows));
+		array_free(tuples->rows);
+		tuples->rows = NULL;
+	}
+
+	uint relation_count = array_len(ctx->relation_tuples);
+	for(uint i = 0; i < relation_count; i++) {
+		MatrixTuples *tuples = ctx->relation_tuples + i;
+		Serializer_Graph_BuildRelationMatrix(g, i, tuples->rows, tuples->cols,
+				tuples->vals, array_len(tuples->rows));
+		array_free(tuples->rows);
+		array_free(tuples->cols);
+		array_free(tuples->vals);
+		tuples->rows = NULL;
+		tuples->cols = NULL;
+		tuples->vals = NULL;
+	}
+
+	Serializer_Graph_SetAdjacencyMatrix(g);
+
+	GraphDecodeContext_FreeMatrixTuples(ctx);
+}
+
 static PayloadInfo *_RdbLoadKeySchema
 (
 	RedisModuleIO *rdb
@@ -200,6 +244,9 @@ GraphContext *RdbLoadGraphContext_v12
 	if(GraphDecodeContext_Finished(gc->decoding_context)) {
 		Graph *g = gc->g;
 
+		// build matrices out of the decoded entities
+		_BuildMatrices(gc);
+
 		// set the node label matrix
 		Serializer_Graph_SetNodeLabels(g);
 
@@ -85,8 +85,9 @@ static void _RdbLoadEntity
 	for(int i = 0; i < propCount; i++) {
 		Attribute_ID attr_id = RedisModule_LoadUnsigned(rdb);
 		SIValue attr_value = _RdbLoadSIValue(rdb);
-		GraphEntity_AddProperty(e, attr_id, attr_value);
-		SIValue_Free(attr_value);
+		GraphContext_InternValue(gc, &attr_value);
+		// transfer ownership of the loaded value to the entity
+		AttributeSet_AddNoClone(e->attributes, attr_id, attr_value);
 	}
 }
 
@@ -116,7 +117,11 @@ void RdbLoadNodes_v12
 			labels[i] = RedisModule_LoadUnsigned(rdb);
 		}
 
-		Serializer_Graph_SetNode(gc->g, id, labels, nodeLabelCount, &n);
+		// label matrices are built once all keys are decoded
+		Serializer_Graph_SetNode(gc->g, id, NULL, 0, &n);
+		for(uint64_t i = 0; i < nodeLabelCount; i++) {
+			GraphDecodeContext_AddNodeLabel(gc->decoding_context, id, labels[i]);
+		}
 
 		_RdbLoadEntity(rdb, gc, (GraphEntity *)&n);
 
@@ -166,9 +171,11 @@ void RdbLoadEdges_v12
 		NodeID    srcId     =  RedisModule_LoadUnsigned(rdb);
 		NodeID    destId    =  RedisModule_LoadUnsigned(rdb);
 		uint64_t  relation  =  RedisModule_LoadUnsigned(rdb);
-		Serializer_Graph_SetEdge(gc->g,
-				gc->decoding_context->multi_edge[relation], edgeId, srcId,
-				destId, relation, &e);
+		// relationship matrices are built once all keys are decoded
+		Serializer_Graph_AllocateEdge(gc->g, edgeId, srcId, destId, relation,
+				&e);
+		GraphDecodeContext_AddEdge(gc->decoding_context, edgeId, srcId, destId,
+				relation);
 		_RdbLoadEntity(rdb, gc, (GraphEntity *)&e);
 
 		// index edge
@@ -4,19 +4,94 @@
  * the Server Side Public License v1 (SSPLv1).
  */
 
-#include "encode_v12.h"
+#include "encode_v13.h"
 #include "../../../datatypes/datatypes.h"
+#include "../../../util/thpool/thpool.h"
+
+extern bool process_is_child; // global variable declared in module.c
+
+// number of entities encoded into a single chunk
+#define ENCODE_CHUNK_SIZE 4096
+
+// an entity collected for encoding
+typedef struct {
+	GraphEntity e;      // entity ID and attribute set
+	uint64_t labels;    // node, offset of the node's labels
+	uint l_count;       // node, number of labels
+	NodeID src;         // edge, source node ID
+	NodeID dest;        // edge, destination node ID
+	int r;              // edge, relation type
+} EncodeEntity;
+
+// a range of entities encoded into a single buffer
+typedef struct {
+	const EncodeEntity *entities;  // first entity in range
+	uint64_t count;                // number of entities in range
+	const LabelID *labels;         // node labels
+	bool edges;                    // range holds edges
+	unsigned char *buf;            // encoded chunk
+	size_t len;                    // chunk length
+	size_t cap;                    // chunk capacity
+} EncodeChunk;
+
+// encoder threads, created once within a forked process
+static threadpool _encoder_pool = NULL;
+
+static void _ChunkReserve
+(
+	EncodeChunk *chunk,
+	size_t n
+) {
+	if(chunk->len + n <= chunk->cap) return;
+	chunk->cap = MAX(chunk->cap * 2, chunk->len + n);
+	chunk->buf = rm_realloc(chunk->buf, chunk->cap);
+}
+
+// values are written as 8 little-endian bytes
+// regardless of host byte order
+static void _ChunkWriteUnsigned
+(
+	EncodeChunk *chunk,
+	uint64_t v
+) {
+	_ChunkReserve(chunk, sizeof(uint64_t));
+	for(int i = 0; i < 8; i++) {
+		chunk->buf[chunk->len++] = (unsigned char)(v >> (i * 8));
+	}
+}
+
+static void _ChunkWriteDouble
+(
+	EncodeChunk *chunk,
+	double v
+) {
+	uint64_t bits;
+	memcpy(&bits, &v, sizeof(bits));
+	_ChunkWriteUnsigned(chunk, bits);
+}
+
+static void _ChunkWriteString
+(
+	EncodeChunk *chunk,
+	const char *s
+) {
+	size_t len = strlen(s);
+	_ChunkWriteUnsigned(chunk, len);
+	_ChunkReserve(chunk, len);
+	memcpy(chunk->buf + chunk->len, s, len);
+	chunk->len += len;
+}
 
 // forword decleration
-static void _RdbSaveSIValue
+static void _ChunkSaveSIValue
 (
-	RedisModuleIO *rdb,
+	EncodeChunk *chunk,
 	const SIValue *v
 );
 
-static void _RdbSaveSIArray
+static void _ChunkSaveSIArray
 (
-	RedisModuleIO *rdb,
+	EncodeChunk *chunk,
 	const SIValue list
 ) {
 	/* saves array as
@@ -28,39 +103,39 @@ static void _RdbSaveSIArray
 	   array[array length -1]
 	 */
 	uint arrayLen = SIArray_Length(list);
-	RedisModule_SaveUnsigned(rdb, arrayLen);
+	_ChunkWriteUnsigned(chunk, arrayLen);
 	for(uint i = 0; i < arrayLen; i ++) {
 		SIValue value = SIArray_Get(list, i);
-		_RdbSaveSIValue(rdb, &value);
+		_ChunkSaveSIValue(chunk, &value);
 	}
 }
 
-static void _RdbSaveSIValue
+static void _ChunkSaveSIValue
 (
-	RedisModuleIO *rdb,
+	EncodeChunk *chunk,
 	const SIValue *v
 ) {
 	// Format:
 	// SIType
 	// Value
-	RedisModule_SaveUnsigned(rdb, v->type);
+	_ChunkWriteUnsigned(chunk, v->type);
 	switch(v->type) {
 		case T_BOOL:
 		case T_INT64:
-			RedisModule_SaveSigned(rdb, v->longval);
+			_ChunkWriteUnsigned(chunk, (uint64_t)v->longval);
 			return;
 		case T_DOUBLE:
-			RedisModule_SaveDouble(rdb, v->doubleval);
+			_ChunkWriteDouble(chunk, v->doubleval);
 			return;
 		case T_STRING:
-			RedisModule_SaveStringBuffer(rdb, v->stringval, strlen(v->stringval) + 1);
+			_ChunkWriteString(chunk, v->stringval);
 			return;
 		case T_ARRAY:
-			_RdbSaveSIArray(rdb, *v);
+			_ChunkSaveSIArray(chunk, *v);
 			return;
 		case T_POINT:
-			RedisModule_SaveDouble(rdb, Point_lat(*v));
-			RedisModule_SaveDouble(rdb, Point_lon(*v));
+			_ChunkWriteDouble(chunk, Point_lat(*v));
+			_ChunkWriteDouble(chunk, Point_lon(*v));
 		case T_NULL:
 			return; // No data beyond the type needs to be encoded for a NULL value.
 		default:
@@ -68,35 +143,32 @@ static void _RdbSaveSIValue
 	}
 }
 
-static void _RdbSaveEntity
+static void _ChunkSaveEntity
 (
-	RedisModuleIO *rdb,
+	EncodeChunk *chunk,
 	const GraphEntity *e
 ) {
 	// Format:
 	// #attributes N
-	// (name, value type, value) X N 
+	// (name, value type, value) X N
 
 	const AttributeSet set = GraphEntity_GetAttributes(e);
 
-	RedisModule_SaveUnsigned(rdb, ATTRIBUTE_SET_COUNT(set));
+	_ChunkWriteUnsigned(chunk, ATTRIBUTE_SET_COUNT(set));
 
 	for(int i = 0; i < ATTRIBUTE_SET_COUNT(set); i++) {
 		Attribute_ID attr_id;
 		SIValue value = AttributeSet_GetIdx(set, i, &attr_id);
-		RedisModule_SaveUnsigned(rdb, attr_id);
-		_RdbSaveSIValue(rdb, &value);
+		_ChunkWriteUnsigned(chunk, attr_id);
+		_ChunkSaveSIValue(chunk, &value);
 	}
 }
 
-static void _RdbSaveEdge
+static void _ChunkSaveEdge
 (
-	RedisModuleIO *rdb,
-	const Graph *g,
-	const Edge *e,
-	int r
+	EncodeChunk *chunk,
+	const EncodeEntity *e
 ) {
-
 	// Format:
 	//  edge ID
 	//  source node ID
@@ -104,52 +176,124 @@ static void _RdbSaveEdge
 	//  relation type
 	//  edge properties
 
-	RedisModule_SaveUnsigned(rdb, ENTITY_GET_ID(e));
-
-	// source node ID
-	RedisModule_SaveUnsigned(rdb, Edge_GetSrcNodeID(e));
-
-	// destination node ID
-	RedisModule_SaveUnsigned(rdb, Edge_GetDestNodeID(e));
-
-	// relation type
-	RedisModule_SaveUnsigned(rdb, r);
-
-	// edge properties
-	_RdbSaveEntity(rdb, (GraphEntity *)e);
+	_ChunkWriteUnsigned(chunk, ENTITY_GET_ID(&e->e));
+	_ChunkWriteUnsigned(chunk, e->src);
+	_ChunkWriteUnsigned(chunk, e->dest);
+	_ChunkWriteUnsigned(chunk, e->r);
+	_ChunkSaveEntity(chunk, &e->e);
 }
 
-static void _RdbSaveNode_v12
+static void _ChunkSaveNode
 (
-	RedisModuleIO *rdb,
-	GraphContext *gc,
-	GraphEntity *n
+	EncodeChunk *chunk,
+	const EncodeEntity *n
 ) {
 	// Format:
 	//     ID
 	//     #labels M
 	//     (labels) X M
 	//     #properties N
-	//     (name, value type, value) X N */
+	//     (name, value type, value) X N
+
+	_ChunkWriteUnsigned(chunk, ENTITY_GET_ID(&n->e));
+	_ChunkWriteUnsigned(chunk, n->l_count);
+	for(uint i = 0; i < n->l_count; i++) {
+		_ChunkWriteUnsigned(chunk, chunk->labels[n->labels + i]);
+	}
+	_ChunkSaveEntity(chunk, &n->e);
+}
+
+// encode a range of entities into the chunk's buffer
+// runs on an encoder thread, only reading from the graph
+static void _EncodeChunk
+(
+	void *arg
+) {
+	EncodeChunk *chunk = (EncodeChunk *)arg;
+	for(uint64_t i = 0; i < chunk->count; i++) {
+		if(chunk->edges) _ChunkSaveEdge(chunk, chunk->entities + i);
+		else _ChunkSaveNode(chunk, chunk->entities + i);
+	}
+}
 
-	// save ID
-	EntityID id = ENTITY_GET_ID(n);
-	RedisModule_SaveUnsigned(rdb, id);
+// encoder threads are only used by a forked process, which owns
+// its copy of the graph and can't disturb the serving process
+static threadpool _EncoderPool(void) {
+	if(!process_is_child) return NULL;
 
-	// retrieve node labels
-	uint l_count;
-	NODE_GET_LABELS(gc->g, (Node *)n, l_count);
-	RedisModule_SaveUnsigned(rdb, l_count);
+	if(_encoder_pool == NULL) {
+		int thread_count = 1;
+		Config_Option_get(Config_THREAD_POOL_SIZE, &thread_count);
+		if(thread_count > 1) {
+			_encoder_pool = thpool_init(thread_count, "encoder");
+		}
+	}
 
-	// save labels
-	for(uint i = 0; i < l_count; i++) RedisModule_SaveUnsigned(rdb, labels[i]);
+	return _encoder_pool;
+}
 
-	// properties N
-	// (name, value type, value) X N
-	_RdbSaveEntity(rdb, (GraphEntity *)n);
+// encode collected entities in chunks and write each chunk
+// as a single string buffer, in order
+static void _RdbSaveChunks
+(
+	RedisModuleIO *rdb,
+	EncodeEntity *entities,
+	const LabelID *labels,
+	bool edges
+) {
+	// Format:
+	// #chunks C
+	// chunk X C
+
+	uint64_t n = array_len(entities);
+	uint64_t chunk_count = (n + ENCODE_CHUNK_SIZE - 1) / ENCODE_CHUNK_SIZE;
+	RedisModule_SaveUnsigned(rdb, chunk_count);
+	if(chunk_count == 0) return;
+
+	EncodeChunk *chunks = rm_calloc(chunk_count, sizeof(EncodeChunk));
+	for(uint64_t i = 0; i < chunk_count; i++) {
+		uint64_t offset = i * ENCODE_CHUNK_SIZE;
+		chunks[i].entities = entities + offset;
+		chunks[i].count    = MIN(ENCODE_CHUNK_SIZE, n - offset);
+		chunks[i].labels   = labels;
+		chunks[i].edges    = edges;
+	}
+
+	threadpool pool = _EncoderPool();
+	if(pool != NULL && chunk_count > 1) {
+		for(uint64_t i = 0; i < chunk_count; i++) {
+			int res = thpool_add_work(pool, _EncodeChunk, chunks + i);
+			ASSERT(res == 0);
+		}
+		thpool_wait(pool);
+	} else {
+		for(uint64_t i = 0; i < chunk_count; i++) _EncodeChunk(chunks + i);
+	}
+
+	for(uint64_t i = 0; i < chunk_count; i++) {
+		RedisModule_SaveStringBuffer(rdb, (const char *)chunks[i].buf,
+				chunks[i].len);
+		rm_free(chunks[i].buf);
+	}
+	rm_free(chunks);
+}
+
+static void _CollectEdge
+(
+	EncodeEntity **entities,
+	const Edge *e,
+	int r
+) {
+	EncodeEntity ee = {0};
+	ee.e.id         = ENTITY_GET_ID(e);
+	ee.e.attributes = e->attributes;
+	ee.src          = Edge_GetSrcNodeID(e);
+	ee.dest         = Edge_GetDestNodeID(e);
+	ee.r            = r;
+	array_append(*entities, ee);
 }
 
-static void _RdbSaveDeletedEntities_v12
+static void _RdbSaveDeletedEntities_v13
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -165,7 +309,7 @@ static void _RdbSaveDeletedEntities_v12
 	}
 }
 
-void RdbSaveDeletedNodes_v12
+void RdbSaveDeletedNodes_v13
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -177,10 +321,10 @@ void RdbSaveDeletedNodes_v12
 	if(deleted_nodes_to_encode == 0) return;
 	// get deleted nodes list
 	uint64_t *deleted_nodes_list = Serializer_Graph_GetDeletedNodesList(gc->g);
-	_RdbSaveDeletedEntities_v12(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
+	_RdbSaveDeletedEntities_v13(rdb, gc, deleted_nodes_to_encode, deleted_nodes_list);
 }
 
-void RdbSaveDeletedEdges_v12
+void RdbSaveDeletedEdges_v13
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
@@ -193,17 +337,18 @@ void RdbSaveDeletedEdges_v12
 
 	// get deleted edges list
 	uint64_t *deleted_edges_list = Serializer_Graph_GetDeletedEdgesList(gc->g);
-	_RdbSaveDeletedEntities_v12(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
+	_RdbSaveDeletedEntities_v13(rdb, gc, deleted_edges_to_encode, deleted_edges_list);
 }
 
-void RdbSaveNodes_v12
+void RdbSaveNodes_v13
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
 	uint64_t nodes_to_encode
 ) {
 	// Format:
-	// Node Format * nodes_to_encode:
+	// #chunks C
+	// chunk X C, each holding up to ENCODE_CHUNK_SIZE nodes:
 	//  ID
 	//  #labels M
 	//  (labels) X M
@@ -224,12 +369,42 @@ void RdbSaveNodes_v12
 		GraphEncodeContext_SetDatablockIterator(gc->encoding_context, iter);
 	}
 
-	for(uint64_t i = 0; i < nodes_to_encode; i++) {
-		GraphEntity e;
-		e.attributes = (AttributeSet *)DataBlockIterator_Next(iter, &e.id);
-		_RdbSaveNode_v12(rdb, gc, &e);
+	// collect runs of consecutive nodes, skipping deleted nodes in bulk
+	// labels are read here, encoder threads only read attribute sets
+	EncodeEntity *entities = array_new(EncodeEntity, nodes_to_encode);
+	LabelID *node_labels = array_new(LabelID, nodes_to_encode);
+
+	uint64_t i = 0;
+	size_t item_size = DataBlockIterator_ItemSize(iter);
+	while(i < nodes_to_encode) {
+		uint64_t id;
+		void *item;
+		uint64_t n = DataBlockIterator_NextRun(iter, nodes_to_encode - i, &id,
+				&item);
+		ASSERT(n > 0);
+
+		for(uint64_t j = 0; j < n; j++) {
+			EncodeEntity ee = {0};
+			ee.e.id = id + j;
+			ee.e.attributes =
+				(AttributeSet *)((unsigned char *)item + j * item_size);
+
+			uint l_count;
+			NODE_GET_LABELS(gc->g, (Node *)&ee.e, l_count);
+			ee.labels  = array_len(node_labels);
+			ee.l_count = l_count;
+			for(uint k = 0; k < l_count; k++) array_append(node_labels, labels[k]);
+
+			array_append(entities, ee);
+		}
+
+		i += n;
 	}
 
+	_RdbSaveChunks(rdb, entities, node_labels, false);
+	array_free(entities);
+	array_free(node_labels);
+
 	// check if done encodeing nodes
 	if(offset + nodes_to_encode == graph_nodes) {
 		DataBlockIterator_Free(iter);
@@ -238,12 +413,12 @@ void RdbSaveNodes_v12
 	}
 }
 
-// Auxilary function to encode a multiple edges array,
+// Auxilary function to collect a multiple edges array for encoding,
 // while consdirating the allowed number of edges to encode
 // returns true if the number of encoded edges has reached the capacity
-static void _RdbSaveMultipleEdges
+static void _CollectMultipleEdges
 (
-	RedisModuleIO *rdb,                  // RDB IO.
+	EncodeEntity **entities,             // Collected edges.
 	GraphContext *gc,                    // Graph context.
 	uint r,                              // Edges relation id.
 	EdgeID *multiple_edges_array,        // Multiple edges array (passed by ref).
@@ -267,7 +442,7 @@ static void _RdbSaveMultipleEdges
 		e.srcNodeID = src;
 		e.destNodeID = dest;
 		Graph_GetEdge(gc->g, edgeID, &e);
-		_RdbSaveEdge(rdb, gc->g, &e, r);
+		_CollectEdge(entities, &e, r);
 		encoded_edges_count++;
 	}
 
@@ -276,14 +451,15 @@ static void _RdbSaveMultipleEdges
 	*multiple_edges_current_index = i;
 }
 
-void RdbSaveEdges_v12
+void RdbSaveEdges_v13
 (
 	RedisModuleIO *rdb,
 	GraphContext *gc,
 	uint64_t edges_to_encode
 ) {
 	// Format:
-	// Edge format * edges_to_encode:
+	// #chunks C
+	// chunk X C, each holding up to ENCODE_CHUNK_SIZE edges:
 	//  edge ID
 	//  source node ID
 	//  destination node ID
@@ -304,6 +480,9 @@ void RdbSaveEdges_v12
 	// count the edges that will be encoded in this phase
 	uint64_t encoded_edges = 0;
 
+	// edges are collected sequentially and encoded in chunks
+	EncodeEntity *entities = array_new(EncodeEntity, edges_to_encode);
+
 	// get current relation matrix
 	uint r = GraphEncodeContext_GetCurrentRelationID(gc->encoding_context);
 
@@ -325,7 +504,7 @@ void RdbSaveEdges_v12
 	uint multiple_edges_current_index = GraphEncodeContext_GetMultipleEdgesCurrentIndex(
 											gc->encoding_context);
 	if(multiple_edges_array) {
-		_RdbSaveMultipleEdges(rdb, gc, r, multiple_edges_array,
+		_CollectMultipleEdges(&entities, gc, r, multiple_edges_array,
 							  &multiple_edges_current_index,
 							  &encoded_edges, edges_to_encode, src, dest);
 		// if the multiple edges array filled the capacity of entities allowed
@@ -370,11 +549,11 @@ void RdbSaveEdges_v12
 		e.destNodeID = dest;
 		if(SINGLE_EDGE(edgeID)) {
 			Graph_GetEdge(gc->g, edgeID, &e);
-			_RdbSaveEdge(rdb, gc->g, &e, r);
+			_CollectEdge(&entities, &e, r);
 			encoded_edges++;
 		} else {
 			multiple_edges_array = (EdgeID *)(CLEAR_MSB(edgeID));
-			_RdbSaveMultipleEdges(rdb, gc, r, multiple_edges_array,
+			_CollectMultipleEdges(&entities, gc, r, multiple_edges_array,
 								  &multiple_edges_current_index, &encoded_edges, edges_to_encode, src, dest);
 			// if the multiple edges array filled the capacity of entities
 			// allowed to be encoded, finish encoding
@@ -389,6 +568,9 @@ void RdbSaveEdges_v12
 	}
 
 finish:
+	_RdbSaveChunks(rdb, entities, NULL, true);
+	array_free(entities);
+
 	// check if done encoding edges
 	if(offset + edges_to_encode == graph_edges) {
 		RG_MatrixTupleIter_detach(iter);
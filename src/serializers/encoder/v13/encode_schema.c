@@ -4,7 +4,7 @@
  * the Server Side Public License v1 (SSPLv1).
  */
 
-#include "encode_v12.h"
+#include "encode_v13.h"
 
 static void _RdbSaveAttributeKeys
 (
@@ -137,7 +137,7 @@ static void _RdbSaveSchema(RedisModuleIO *rdb, Schema *s) {
 	_RdbSaveIndexData(rdb, s->type, s->fulltextIdx);
 }
 
-void RdbSaveGraphSchema_v12(RedisModuleIO *rdb, GraphContext *gc) {
+void RdbSaveGraphSchema_v13(RedisModuleIO *rdb, GraphContext *gc) {
 	/* Format:
 	 * attribute keys (unified schema)
 	 * #node schemas
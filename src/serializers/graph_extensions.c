@@ -11,6 +11,9 @@
 // functions declerations - implemented in graph.c
 bool Graph_FormConnection(Graph *g, NodeID src, NodeID dest, EdgeID edge_id, int r);
 
+// functions declerations - implemented in rg_set_element_uint64.c
+void _edge_accum(void *_z, const void *_x, const void *_y);
+
 void Graph_EnsureNodeCap
 (
 	Graph *g,
@@ -127,6 +130,127 @@ void Serializer_Graph_SetNodeLabels
 	GrB_Vector_free(&v);
 }
 
+// builds label matrix 'l' out of the ids of the nodes carrying the label
+// must be called once after all virtual keys loaded, on an empty matrix
+void Serializer_Graph_BuildLabelMatrix
+(
+	Graph *g,
+	LabelID l,
+	const NodeID *ids,
+	uint64_t n
+) {
+	ASSERT(g != NULL);
+	ASSERT(ids != NULL || n == 0);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index  dim = Graph_RequiredMatrixDim(g);
+	RG_Matrix  L   = Graph_GetLabelMatrix(g, l);
+	GrB_Matrix m   = RG_MATRIX_M(L);
+
+	info = RG_Matrix_resize(L, dim, dim);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(n == 0) return;
+
+	// L[id, id] = true
+	GrB_Scalar t;
+	info = GrB_Scalar_new(&t, GrB_BOOL);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Scalar_setElement_BOOL(t, true);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GxB_Matrix_build_Scalar(m, ids, ids, t, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_free(&t);
+}
+
+// builds relationship matrix 'r' and its transpose out of the relationship's
+// edges, edges sharing both source and destination form a multi-edge entry
+// must be called once after all virtual keys loaded, on an empty matrix
+void Serializer_Graph_BuildRelationMatrix
+(
+	Graph *g,
+	int r,
+	const NodeID *src,
+	const NodeID *dest,
+	const EdgeID *ids,
+	uint64_t n
+) {
+	ASSERT(g != NULL);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index  dim = Graph_RequiredMatrixDim(g);
+	RG_Matrix  R   = Graph_GetRelationMatrix(g, r, false);
+	GrB_Matrix m   = RG_MATRIX_M(R);
+
+	info = RG_Matrix_resize(R, dim, dim);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(n == 0) return;
+
+	// duplicates are assembled in the order they appear
+	// accumulating edge ids into a multi-edge array
+	// same as forming the connections one by one would
+	GrB_BinaryOp dup;
+	info = GrB_BinaryOp_new(&dup, _edge_accum, GrB_UINT64, GrB_UINT64,
+			GrB_UINT64);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_build_UINT64(m, src, dest, ids, n, dup);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_free(&dup);
+
+	// TM = one(M')
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(R)) {
+		GrB_Matrix tm = RG_MATRIX_TM(R);
+		info = GrB_Matrix_apply(tm, NULL, NULL, GxB_ONE_BOOL, m, GrB_DESC_T0);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	GraphStatistics_IncEdgeCount(&g->stats, r, n);
+}
+
+// computes the adjacency matrix out of the relationship matrices
+// ADJ = one(R0) + one(R1) + ... + one(Rn)
+// must be called once after all relationship matrices are built
+void Serializer_Graph_SetAdjacencyMatrix
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index  dim   = Graph_RequiredMatrixDim(g);
+	RG_Matrix  adj   = Graph_GetAdjacencyMatrix(g, false);
+	GrB_Matrix adj_m = RG_MATRIX_M(adj);
+
+	info = RG_Matrix_resize(adj, dim, dim);
+	ASSERT(info == GrB_SUCCESS);
+
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int i = 0; i < relation_count; i++) {
+		RG_Matrix  R = Graph_GetRelationMatrix(g, i, false);
+		GrB_Matrix m = RG_MATRIX_M(R);
+
+		info = GrB_Matrix_apply(adj_m, NULL, GrB_LOR, GxB_ONE_BOOL, m, NULL);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(adj)) {
+		GrB_Matrix adj_tm = RG_MATRIX_TM(adj);
+		info = GrB_transpose(adj_tm, NULL, NULL, adj_m, NULL);
+		ASSERT(info == GrB_SUCCESS);
+	}
+}
+
 // optimized version of Graph_FormConnection
 // used only when matrix doesn't contains multi edge values
 static void _OptimizedSingleEdgeFormConnection
@@ -180,18 +304,18 @@ static void _OptimizedSingleEdgeFormConnection
 	GraphStatistics_IncEdgeCount(&g->stats, r, 1);
 }
 
-// set a given edge in the graph - Used for deserialization of graph
-void Serializer_Graph_SetEdge
+// allocates a given edge in the graph without connecting it
+void Serializer_Graph_AllocateEdge
 (
 	Graph *g,
-	bool multi_edge,
 	EdgeID edge_id,
 	NodeID src,
 	NodeID dest,
 	int r,
 	Edge *e
 ) {
-	GrB_Info info;
+	ASSERT(g != NULL);
+	ASSERT(e != NULL);
 
 	AttributeSet *set = DataBlock_AllocateItemOutOfOrder(g->edges, edge_id);
 	*set = NULL;
@@ -201,6 +325,20 @@ void Serializer_Graph_SetEdge
 	e->relationID    =  r;
 	e->srcNodeID     =  src;
 	e->destNodeID    =  dest;
+}
+
+// set a given edge in the graph - Used for deserialization of graph
+void Serializer_Graph_SetEdge
+(
+	Graph *g,
+	bool multi_edge,
+	EdgeID edge_id,
+	NodeID src,
+	NodeID dest,
+	int r,
+	Edge *e
+) {
+	Serializer_Graph_AllocateEdge(g, edge_id, src, dest, r, e);
 
 	if(multi_edge) {
 		if(!Graph_FormConnection(g, src, dest, edge_id, r)) {
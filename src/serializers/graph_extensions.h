@@ -24,6 +24,43 @@ void Serializer_Graph_SetNodeLabels
 	Graph *g
 );
 
+// builds a label matrix out of the ids of the nodes carrying the label
+void Serializer_Graph_BuildLabelMatrix
+(
+	Graph *g,               // graph to build matrix in
+	LabelID l,              // label
+	const NodeID *ids,      // labeled nodes
+	uint64_t n              // number of labeled nodes
+);
+
+// builds a relationship matrix out of the relationship's edges
+void Serializer_Graph_BuildRelationMatrix
+(
+	Graph *g,               // graph to build matrix in
+	int r,                  // relationship-type
+	const NodeID *src,      // edges source
+	const NodeID *dest,     // edges destination
+	const EdgeID *ids,      // edges ID
+	uint64_t n              // number of edges
+);
+
+// sets graph's adjacency matrix out of its relationship matrices
+void Serializer_Graph_SetAdjacencyMatrix
+(
+	Graph *g
+);
+
+// allocates a given edge in the graph without connecting it
+void Serializer_Graph_AllocateEdge
+(
+	Graph *g,               // graph to add edge to
+	EdgeID edge_id,         // edge ID
+	NodeID src,             // edge source
+	NodeID dest,            // edge destination
+	int r,                  // edge relationship-type
+	Edge *e                 // pointer to edge
+);
+
 // set a given edge in the graph
 void Serializer_Graph_SetEdge
 (
@@ -17,6 +17,7 @@ Block *Block_New(uint itemSize, uint capacity) {
 
 void Block_Free(Block *block) {
 	ASSERT(block != NULL);
+	if(block->occupied != NULL) rm_free(block->occupied);
 	rm_free(block);
 }
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 /* The Block is a type-agnostic block of continuous memory used to hold items of the same type.
@@ -14,6 +15,7 @@
 typedef struct Block {
 	size_t itemSize;        // Size of a single item in bytes.
 	struct Block *next;     // Pointer to next block.
+	uint64_t *occupied;     // Optional occupancy bitmap, a bit per item, NULL if not tracked.
 	unsigned char data[];   // Item array. MUST BE LAST MEMBER OF THE STRUCT!
 } Block;
 
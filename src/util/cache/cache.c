@@ -63,6 +63,8 @@ Cache *Cache_New(uint cap, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copyF
 	cache->size      = 0;
 	cache->lookup    = raxNew();       // Instantiate key entry mapping.
 	cache->counter   = 0;             // Initialize counter to zero.
+	cache->hits      = 0;
+	cache->misses    = 0;
 	cache->copy_item = copyFunc;
 	cache->free_item = freeFunc;
 	cache->arr = rm_calloc(cap, sizeof(CacheEntry)); // Array of cached values.
@@ -87,7 +89,12 @@ void *Cache_GetValue(Cache *cache, const char *key) {
 	size_t key_len = strlen(key);
 	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
 
-	if(entry == raxNotFound) goto cleanup;
+	if(entry == raxNotFound) {
+		__atomic_fetch_add(&cache->misses, 1, __ATOMIC_RELAXED);
+		goto cleanup;
+	}
+
+	__atomic_fetch_add(&cache->hits, 1, __ATOMIC_RELAXED);
 
 	// element is now the most recently used; update its LRU
 	// note that multiple threads can be here simultaneously
@@ -145,6 +152,47 @@ void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
 	return value_to_return;
 }
 
+void Cache_GetStats(Cache *cache, uint64_t *hits, uint64_t *misses,
+		uint *size) {
+	ASSERT(cache  != NULL);
+	ASSERT(hits   != NULL);
+	ASSERT(misses != NULL);
+	ASSERT(size   != NULL);
+
+	// acquire READ lock
+	int res = pthread_rwlock_rdlock(&cache->_cache_rwlock);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	*hits   = __atomic_load_n(&cache->hits, __ATOMIC_RELAXED);
+	*misses = __atomic_load_n(&cache->misses, __ATOMIC_RELAXED);
+	*size   = cache->size;
+
+	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
+	ASSERT(res == 0);
+}
+
+void Cache_Clear(Cache *cache) {
+	ASSERT(cache != NULL);
+
+	// acquire WRITE lock
+	int res = pthread_rwlock_wrlock(&cache->_cache_rwlock);
+	UNUSED(res);
+	ASSERT(res == 0);
+
+	// free cache entries
+	for(size_t i = 0; i < cache->size; i++) {
+		CacheArray_CleanEntry(cache->arr + i, cache->free_item);
+	}
+
+	cache->size = 0;
+	raxFree(cache->lookup);
+	cache->lookup = raxNew();
+
+	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
+	ASSERT(res == 0);
+}
+
 void Cache_Free(Cache *cache) {
 	ASSERT(cache != NULL);
 
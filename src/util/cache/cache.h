@@ -17,6 +17,8 @@ typedef struct Cache {
 	uint cap;                          // Cache capacity.
 	uint size;                         // Cache current size.
 	long long counter;                 // Atomic counter for number of reads.
+	uint64_t hits;                     // Atomic counter for number of cache hits.
+	uint64_t misses;                   // Atomic counter for number of cache misses.
 	rax *lookup;                       // Mapping between keys to entries, for fast lookups.
 	CacheEntry *arr;                   // Array of cache elements.
 	CacheEntryFreeFunc free_item;      // Callback function that free cached value.
@@ -60,6 +62,21 @@ void Cache_SetValue(Cache *cache, const char *key, void *item);
  */
 void *Cache_SetGetValue(Cache *cache, const char *key, void *value);
 
+/**
+ * @brief  Reports cache lookup statistics.
+ * @param  *cache: cache pointer.
+ * @param  *hits: [output] number of lookups which found their key.
+ * @param  *misses: [output] number of lookups which didn't find their key.
+ * @param  *size: [output] number of stored items.
+ */
+void Cache_GetStats(Cache *cache, uint64_t *hits, uint64_t *misses, uint *size);
+
+/**
+ * @brief  Removes and frees all stored items.
+ * @param  *cache: cache pointer
+ */
+void Cache_Clear(Cache *cache);
+
 /**
  * @brief  Destroys the cache and free all stored items.
  * @param  *cache: cache pointer
@@ -10,6 +10,8 @@
 #include "../arr.h"
 #include "../rmalloc.h"
 #include <math.h>
+#include <string.h>
+#include <sys/param.h>
 #include <stdbool.h>
 
 // computes the number of blocks required to accommodate n items.
@@ -28,6 +30,26 @@
 #define GET_ITEM_BLOCK(dataBlock, idx) \
     dataBlock->blocks[ITEM_INDEX_TO_BLOCK_INDEX(idx, dataBlock->blockCap)]
 
+// sets the occupancy bit of item at index idx
+static inline void _DataBlock_MarkOccupied
+(
+	const DataBlock *dataBlock,
+	uint64_t idx
+) {
+	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
+	MARK_ITEM_OCCUPIED(block, ITEM_POSITION_WITHIN_BLOCK(idx, dataBlock->blockCap));
+}
+
+// clears the occupancy bit of item at index idx
+static inline void _DataBlock_MarkFree
+(
+	const DataBlock *dataBlock,
+	uint64_t idx
+) {
+	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
+	MARK_ITEM_FREE(block, ITEM_POSITION_WITHIN_BLOCK(idx, dataBlock->blockCap));
+}
+
 static void _DataBlock_AddBlocks
 (
 	DataBlock *dataBlock,
@@ -46,6 +68,8 @@ static void _DataBlock_AddBlocks
 	uint i;
 	for(i = prevBlockCount; i < dataBlock->blockCount; i++) {
 		dataBlock->blocks[i] = Block_New(dataBlock->itemSize, dataBlock->blockCap);
+		dataBlock->blocks[i]->occupied = rm_calloc(
+				OCCUPANCY_WORD_COUNT(dataBlock->blockCap), sizeof(uint64_t));
 		if(i > 0) dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
 	}
 	dataBlock->blocks[i - 1]->next = NULL;
@@ -185,6 +209,7 @@ void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 
 	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, pos);
 	MARK_HEADER_AS_NOT_DELETED(item_header);
+	_DataBlock_MarkOccupied(dataBlock, pos);
 
 	return ITEM_DATA(item_header);
 }
@@ -204,6 +229,7 @@ void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 	}
 
 	MARK_HEADER_AS_DELETED(item_header);
+	_DataBlock_MarkFree(dataBlock, idx);
 
 	array_append(dataBlock->deletedIdx, idx);
 	dataBlock->itemCount--;
@@ -218,6 +244,226 @@ inline bool DataBlock_ItemIsDeleted(void *item) {
 	return IS_ITEM_DELETED(header);
 }
 
+static int _DataBlock_CompareIdx
+(
+	const void *a,
+	const void *b
+) {
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+// sorts free slots in ascending order
+// skip sorting in case free slots are already sorted
+// e.g. no items were deleted since the last call
+static void _DataBlock_SortFree
+(
+	DataBlock *dataBlock
+) {
+	uint64_t *deleted = dataBlock->deletedIdx;
+	uint64_t deletedCount = array_len(deleted);
+
+	for(uint64_t i = 1; i < deletedCount; i++) {
+		if(deleted[i - 1] > deleted[i]) {
+			qsort(deleted, deletedCount, sizeof(uint64_t),
+					_DataBlock_CompareIdx);
+			return;
+		}
+	}
+}
+
+// drops trailing free slots, free slots are expected to be sorted
+static void _DataBlock_TrimFree
+(
+	DataBlock *dataBlock
+) {
+	uint64_t *deleted = dataBlock->deletedIdx;
+	uint64_t n   = array_len(deleted);
+	uint64_t end = dataBlock->itemCount + n;
+
+	while(n > 0 && deleted[n - 1] == end - 1) {
+		n--;
+		end--;
+	}
+
+	dataBlock->deletedIdx = array_trimm_len(dataBlock->deletedIdx, n);
+}
+
+uint64_t DataBlock_Compact
+(
+	DataBlock *dataBlock,
+	uint64_t n,
+	uint64_t *src,
+	uint64_t *dst
+) {
+	ASSERT(dataBlock != NULL);
+	ASSERT(src != NULL);
+	ASSERT(dst != NULL);
+
+	uint64_t deletedCount = array_len(dataBlock->deletedIdx);
+	if(deletedCount == 0) return 0;
+
+	// process free slots in ascending order
+	_DataBlock_SortFree(dataBlock);
+	uint64_t *deleted = dataBlock->deletedIdx;
+
+	uint64_t lo    = 0;             // lowest free slot
+	uint64_t hi    = deletedCount;  // one past highest free slot
+	uint64_t end   = dataBlock->itemCount + deletedCount;
+	uint64_t moved = 0;
+
+	while(true) {
+		// trailing free slots are dropped
+		while(hi > lo && deleted[hi - 1] == end - 1) {
+			hi--;
+			end--;
+		}
+
+		if(lo == hi || moved == n) break;
+
+		// move last item into lowest free slot
+		uint64_t from = end - 1;
+		uint64_t to   = deleted[lo];
+
+		DataBlockItemHeader *from_header = DataBlock_GetItemHeader(dataBlock, from);
+		DataBlockItemHeader *to_header   = DataBlock_GetItemHeader(dataBlock, to);
+		ASSERT(!IS_ITEM_DELETED(from_header));
+		ASSERT(IS_ITEM_DELETED(to_header));
+
+		memcpy(to_header, from_header, dataBlock->itemSize);
+		MARK_HEADER_AS_NOT_DELETED(to_header);
+		MARK_HEADER_AS_DELETED(from_header);
+		_DataBlock_MarkOccupied(dataBlock, to);
+		_DataBlock_MarkFree(dataBlock, from);
+
+		src[moved] = from;
+		dst[moved] = to;
+
+		lo++;
+		end--;
+		moved++;
+	}
+
+	// keep remaining free slots
+	uint64_t remaining = hi - lo;
+	if(lo > 0 && remaining > 0) {
+		memmove(deleted, deleted + lo, remaining * sizeof(uint64_t));
+	}
+	dataBlock->deletedIdx = array_trimm_len(dataBlock->deletedIdx, remaining);
+
+	ASSERT(dataBlock->itemCount + remaining == end);
+	return moved;
+}
+
+void DataBlock_MoveItems
+(
+	DataBlock *dataBlock,
+	const uint64_t *src,
+	uint64_t n,
+	uint64_t *dst
+) {
+	ASSERT(dataBlock != NULL);
+	ASSERT(src != NULL);
+	ASSERT(dst != NULL);
+	ASSERT(n <= array_len(dataBlock->deletedIdx));
+
+	if(n == 0) return;
+
+	// items are moved into the lowest free slots
+	_DataBlock_SortFree(dataBlock);
+
+	uint64_t *deleted = dataBlock->deletedIdx;
+	uint64_t deletedCount = array_len(deleted);
+
+	for(uint64_t i = 0; i < n; i++) {
+		uint64_t from = src[i];
+		uint64_t to   = deleted[i];
+
+		DataBlockItemHeader *from_header = DataBlock_GetItemHeader(dataBlock, from);
+		DataBlockItemHeader *to_header   = DataBlock_GetItemHeader(dataBlock, to);
+		ASSERT(!IS_ITEM_DELETED(from_header));
+		ASSERT(IS_ITEM_DELETED(to_header));
+
+		memcpy(to_header, from_header, dataBlock->itemSize);
+		MARK_HEADER_AS_NOT_DELETED(to_header);
+		MARK_HEADER_AS_DELETED(from_header);
+		_DataBlock_MarkOccupied(dataBlock, to);
+		_DataBlock_MarkFree(dataBlock, from);
+
+		dst[i] = to;
+	}
+
+	// replace consumed free slots with the vacated ones
+	// merging both sorted sequences from the back
+	uint64_t *vacated = rm_malloc(sizeof(uint64_t) * n);
+	memcpy(vacated, src, sizeof(uint64_t) * n);
+	qsort(vacated, n, sizeof(uint64_t), _DataBlock_CompareIdx);
+
+	uint64_t remaining = deletedCount - n;
+	memmove(deleted, deleted + n, remaining * sizeof(uint64_t));
+
+	uint64_t i = remaining;
+	uint64_t j = n;
+	uint64_t w = deletedCount;
+	while(j > 0) {
+		if(i > 0 && deleted[i - 1] > vacated[j - 1]) {
+			deleted[--w] = deleted[--i];
+		} else {
+			deleted[--w] = vacated[--j];
+		}
+	}
+
+	rm_free(vacated);
+
+	_DataBlock_TrimFree(dataBlock);
+}
+
+bool DataBlock_IsCompact
+(
+	const DataBlock *dataBlock
+) {
+	ASSERT(dataBlock != NULL);
+
+	// items are contiguous if none of the free slots precedes an item
+	uint64_t *deleted = dataBlock->deletedIdx;
+	uint64_t deletedCount = array_len(deleted);
+	for(uint64_t i = 0; i < deletedCount; i++) {
+		if(deleted[i] < dataBlock->itemCount) return false;
+	}
+
+	return true;
+}
+
+void DataBlock_Shrink
+(
+	DataBlock *dataBlock
+) {
+	ASSERT(dataBlock != NULL);
+
+	// trailing free slots are dropped
+	_DataBlock_SortFree(dataBlock);
+	_DataBlock_TrimFree(dataBlock);
+
+	// highest index in use
+	uint64_t end = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
+
+	// keep at least a single block
+	uint blockCount = ITEM_COUNT_TO_BLOCK_COUNT(end, dataBlock->blockCap);
+	blockCount = MAX(blockCount, 1);
+	if(blockCount >= dataBlock->blockCount) return;
+
+	for(uint i = blockCount; i < dataBlock->blockCount; i++) {
+		Block_Free(dataBlock->blocks[i]);
+	}
+
+	dataBlock->blockCount = blockCount;
+	dataBlock->blocks = rm_realloc(dataBlock->blocks,
+			sizeof(Block *) * blockCount);
+	dataBlock->blocks[blockCount - 1]->next = NULL;
+	dataBlock->itemCap = blockCount * dataBlock->blockCap;
+}
+
 //------------------------------------------------------------------------------
 // Out of order functionality
 //------------------------------------------------------------------------------
@@ -231,6 +477,7 @@ void *DataBlock_AllocateItemOutOfOrder
 	DataBlock_Ensure(dataBlock, idx);
 	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, idx);
 	MARK_HEADER_AS_NOT_DELETED(item_header);
+	_DataBlock_MarkOccupied(dataBlock, idx);
 	dataBlock->itemCount++;
 	return ITEM_DATA(item_header);
 }
@@ -245,6 +492,7 @@ void DataBlock_MarkAsDeletedOutOfOrder
 	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, idx);
 	// Delete
 	MARK_HEADER_AS_DELETED(item_header);
+	_DataBlock_MarkFree(dataBlock, idx);
 	array_append(dataBlock->deletedIdx, idx);
 }
 
@@ -32,10 +32,23 @@ typedef void (*fpDestructor)(void *);
 // Checks if the deleted bit in the header is 1 or not.
 #define IS_ITEM_DELETED(header) ((header)->deleted & 1)
 
+// Number of 64 bit words required for an occupancy bitmap of n items.
+#define OCCUPANCY_WORD_COUNT(n) (((n) + 63) / 64)
+
+// Sets the occupancy bit of the item at position pos within a block.
+#define MARK_ITEM_OCCUPIED(block, pos) \
+	((block)->occupied[(pos) >> 6] |= (1ULL << ((pos) & 63)))
+
+// Clears the occupancy bit of the item at position pos within a block.
+#define MARK_ITEM_FREE(block, pos) \
+	((block)->occupied[(pos) >> 6] &= ~(1ULL << ((pos) & 63)))
+
 /* The DataBlock is a container structure for holding arbitrary items of a uniform type
  * in order to reduce the number of alloc/free calls and improve locality of reference.
- * Item deletions are thread-safe, and a DataBlockIterator can be used to traverse a
- * range within the block. */
+ * Item allocations and deletions require exclusive access to the datablock,
+ * concurrent readers may traverse a range within the block using a DataBlockIterator.
+ * In addition to the deleted bit within each item header, every block maintains an
+ * occupancy bitmap, allowing iterators to skip over deleted items 64 at a time. */
 typedef struct {
 	uint64_t itemCount;         // Number of items stored in datablock.
 	uint64_t itemCap;           // Number of items datablock can hold.
@@ -97,6 +110,42 @@ uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock);
 // Returns true if the given item has been deleted.
 bool DataBlock_ItemIsDeleted(void *item);
 
+// moves items from the end of the datablock into free slots
+// such that items occupy a contiguous range of indices
+// at most 'n' items are moved, the original and new index of each moved item
+// are reported via 'src' and 'dst'
+// returns number of items moved
+uint64_t DataBlock_Compact
+(
+	DataBlock *dataBlock,  // datablock to compact
+	uint64_t n,            // maximum number of items to move
+	uint64_t *src,         // [output] original index of each moved item
+	uint64_t *dst          // [output] new index of each moved item
+);
+
+// moves the 'n' items at indices 'src' into the lowest free slots
+// the new index of each moved item is reported via 'dst'
+// callers are expected to move items residing past the lowest free slots
+void DataBlock_MoveItems
+(
+	DataBlock *dataBlock,  // datablock to compact
+	const uint64_t *src,   // indices of items to move
+	uint64_t n,            // number of items to move
+	uint64_t *dst          // [output] new index of each moved item
+);
+
+// returns true if datablock items occupy a contiguous range of indices
+bool DataBlock_IsCompact
+(
+	const DataBlock *dataBlock
+);
+
+// drops trailing free slots and releases blocks which do not hold any items
+void DataBlock_Shrink
+(
+	DataBlock *dataBlock
+);
+
 // Free block.
 void DataBlock_Free(DataBlock *block);
 
@@ -9,6 +9,7 @@
 #include "datablock.h"
 #include "../rmalloc.h"
 #include <stdio.h>
+#include <sys/param.h>
 #include <stdbool.h>
 
 DataBlockIterator *DataBlockIterator_New
@@ -30,41 +31,141 @@ DataBlockIterator *DataBlockIterator_New
 	return iter;
 }
 
-void *DataBlockIterator_Next
+// returns position of the first occupied slot in range [pos, limit)
+// returns limit if all slots within range are free
+static inline uint64_t _NextOccupied
+(
+	const uint64_t *occupied,  // block occupancy bitmap
+	uint64_t pos,              // range start
+	uint64_t limit             // range end
+) {
+	while(pos < limit) {
+		uint64_t word = occupied[pos >> 6] >> (pos & 63);
+		if(word != 0) {
+			pos += __builtin_ctzll(word);
+			return MIN(pos, limit);
+		}
+		// skip to the beginning of the next word
+		pos = (pos | 63) + 1;
+	}
+
+	return limit;
+}
+
+// returns position of the first free slot in range [pos, limit)
+// returns limit if all slots within range are occupied
+static inline uint64_t _NextFree
+(
+	const uint64_t *occupied,  // block occupancy bitmap
+	uint64_t pos,              // range start
+	uint64_t limit             // range end
+) {
+	while(pos < limit) {
+		uint64_t word = ~occupied[pos >> 6] >> (pos & 63);
+		if(word != 0) {
+			pos += __builtin_ctzll(word);
+			return MIN(pos, limit);
+		}
+		pos = (pos | 63) + 1;
+	}
+
+	return limit;
+}
+
+// advance iterator by n positions within the current block
+static inline void _DataBlockIterator_Advance
 (
 	DataBlockIterator *iter,
-	uint64_t *id
+	uint64_t n
 ) {
-	ASSERT(iter != NULL);
+	iter->_block_pos   += n;
+	iter->_current_pos += n;
 
-	// set default
-	void                 *item         =  NULL;
-	DataBlockItemHeader  *item_header  =  NULL;
+	// advance to next block if current block consumed
+	if(iter->_block_pos == iter->_block_cap) {
+		iter->_block_pos = 0;
+		iter->_current_block = iter->_current_block->next;
+	}
+}
 
-	// have we reached the end of our iterator?
+// seeks the next occupied slot
+// returns false if iterator is depleted
+static bool _DataBlockIterator_Seek
+(
+	DataBlockIterator *iter,
+	uint64_t *limit  // [output] end of scanned range within current block
+) {
 	while(iter->_current_pos < iter->_end_pos && iter->_current_block != NULL) {
-		// get item at current position
 		Block *block = iter->_current_block;
-		item_header = (DataBlockItemHeader *)block->data + (iter->_block_pos * block->itemSize);
 
-		// advance to next position
-		iter->_block_pos += 1;
-		iter->_current_pos += 1;
+		// scan up to the end of the current block or the end of the iterator
+		uint64_t pos = iter->_block_pos;
+		*limit = MIN(iter->_block_cap, pos + (iter->_end_pos - iter->_current_pos));
 
-		// advance to next block if current block consumed
-		if(iter->_block_pos == iter->_block_cap) {
-			iter->_block_pos = 0;
-			iter->_current_block = iter->_current_block->next;
+		uint64_t found = _NextOccupied(block->occupied, pos, *limit);
+		if(found < *limit) {
+			iter->_block_pos    = found;
+			iter->_current_pos += found - pos;
+			return true;
 		}
 
-		if(!IS_ITEM_DELETED(item_header)) {
-			item = ITEM_DATA(item_header);
-			if(id) *id = iter->_current_pos - 1;
-			break;
-		}
+		// no occupied slots within range, skip it
+		_DataBlockIterator_Advance(iter, *limit - pos);
+	}
+
+	return false;
+}
+
+void *DataBlockIterator_Next
+(
+	DataBlockIterator *iter,
+	uint64_t *id
+) {
+	ASSERT(iter != NULL);
+
+	uint64_t limit;
+	if(!_DataBlockIterator_Seek(iter, &limit)) return NULL;
+
+	Block *block = iter->_current_block;
+	DataBlockItemHeader *item_header =
+		(DataBlockItemHeader *)block->data + (iter->_block_pos * block->itemSize);
+	ASSERT(!IS_ITEM_DELETED(item_header));
+
+	if(id) *id = iter->_current_pos;
+	_DataBlockIterator_Advance(iter, 1);
+
+	return ITEM_DATA(item_header);
+}
+
+uint64_t DataBlockIterator_NextRun
+(
+	DataBlockIterator *iter,
+	uint64_t max,
+	uint64_t *start,
+	void **item
+) {
+	ASSERT(max   > 0);
+	ASSERT(iter  != NULL);
+	ASSERT(start != NULL);
+
+	uint64_t limit;
+	if(!_DataBlockIterator_Seek(iter, &limit)) return 0;
+
+	// run ends at the first free slot, the end of the block
+	// or the end of the iterator, whichever comes first
+	Block *block = iter->_current_block;
+	uint64_t pos = iter->_block_pos;
+	uint64_t len = MIN(max, _NextFree(block->occupied, pos, limit) - pos);
+
+	*start = iter->_current_pos;
+	if(item) {
+		DataBlockItemHeader *item_header =
+			(DataBlockItemHeader *)block->data + (pos * block->itemSize);
+		*item = ITEM_DATA(item_header);
 	}
+	_DataBlockIterator_Advance(iter, len);
 
-	return item;
+	return len;
 }
 
 void DataBlockIterator_Reset
@@ -9,7 +9,9 @@
 #include <stdint.h>
 #include "../block.h"
 
-/* Datablock iterator iterates over items within a datablock. */
+/* Datablock iterator iterates over items within a datablock.
+ * Free slots are located via the blocks' occupancy bitmaps,
+ * allowing iteration to skip over ranges of deleted items. */
 
 typedef struct {
 	Block *_start_block;			// first block accessed by iterator
@@ -30,12 +32,28 @@ DataBlockIterator *DataBlockIterator_New
 
 #define DataBlockIterator_Position(iter) (iter)->_current_pos
 
+// distance in bytes between consecutive items of a run
+#define DataBlockIterator_ItemSize(iter) (iter)->_start_block->itemSize
+
 // Returns the next item, unless we've reached the end
 // in which case NULL is returned.
 // if `id` is provided and an item is located
 // `id` will be set to the returned item index
 void *DataBlockIterator_Next(DataBlockIterator *iter, uint64_t *id);
 
+// Returns the length of the next run of consecutive items, at most 'max'
+// sets 'start' to the index of the run's first item
+// and if provided, 'item' to the run's first item
+// runs do not span multiple blocks, 0 is returned once iterator is depleted
+// items of a run are stored contiguously, DataBlockIterator_ItemSize apart
+uint64_t DataBlockIterator_NextRun
+(
+	DataBlockIterator *iter,  // iterator
+	uint64_t max,             // max run length
+	uint64_t *start,          // [output] index of the run's first item
+	void **item               // [optional output] run's first item
+);
+
 // Reset iterator to original position.
 void DataBlockIterator_Reset(DataBlockIterator *iter);
 
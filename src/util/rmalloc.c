@@ -31,6 +31,14 @@ void rm_reset_n_alloced() {
 	n_alloced = 0;
 }
 
+int64_t rm_n_alloced(void) {
+	return n_alloced;
+}
+
+int64_t rm_mem_capacity(void) {
+	return mem_capacity;
+}
+
 // removes n_bytes from thread memory consumption
 static inline void _nmalloc_decrement(int64_t n_bytes) {
 	n_alloced -= n_bytes;
@@ -120,6 +128,14 @@ void rm_set_mem_capacity(int64_t cap) {
 void rm_reset_n_alloced() {
 }
 
+int64_t rm_n_alloced(void) {
+	return 0;
+}
+
+int64_t rm_mem_capacity(void) {
+	return 0;
+}
+
 void rm_set_mem_capacity(int64_t cap) {
 }
 
@@ -18,6 +18,13 @@ void rm_set_mem_capacity(int64_t cap);
 // reset thread memory consumption counter to 0 (no memory consumed)
 void rm_reset_n_alloced();
 
+// returns the calling thread's memory consumption counter
+// only tracked while a memory capacity is set
+int64_t rm_n_alloced(void);
+
+// returns the per query memory capacity, 0 if memory is not capped
+int64_t rm_mem_capacity(void);
+
 static inline void *rm_malloc(size_t n) {
 	return RedisModule_Alloc(n);
 }
@@ -0,0 +1,192 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "dict.h"
+#include "xxhash.h"
+#include "rmalloc.h"
+#include "string_pool.h"
+
+#include <string.h>
+#include <stddef.h>
+
+// minimum number of strings in pool before a vacuum is considered
+#define STRING_POOL_MIN_VACUUM_SIZE 1024
+
+// interned string, reference count followed by string content
+typedef struct {
+	uint32_t ref_count;  // number of references to string
+	char str[];          // string content
+} InternedString;
+
+// get interned string header from string content
+#define INTERNED_STRING(s) \
+	((InternedString *)((char *)(s) - offsetof(InternedString, str)))
+
+struct _StringPool {
+	dict *strings;         // interned strings
+	uint64_t vacuum_size;  // pool size at the end of the last vacuum
+};
+
+static uint64_t _hash
+(
+	const void *key
+) {
+	return XXH64(key, strlen((const char *)key), 0);
+}
+
+static int _compare
+(
+	dict *d,
+	const void *key1,
+	const void *key2
+) {
+	return strcmp((const char *)key1, (const char *)key2) == 0;
+}
+
+// hashtable callbacks
+// keys are the interned strings themselves, no value is associated with them
+static dictType _dt = { _hash, NULL, NULL, _compare, NULL, NULL, NULL, NULL,
+	NULL, NULL};
+
+StringPool StringPool_New(void) {
+	StringPool pool = rm_malloc(sizeof(_StringPool));
+
+	pool->strings     = HashTableCreate(&_dt);
+	pool->vacuum_size = 0;
+
+	return pool;
+}
+
+char *StringPool_Intern
+(
+	StringPool pool,
+	const char *str
+) {
+	ASSERT(str  != NULL);
+	ASSERT(pool != NULL);
+
+	dictEntry *entry = HashTableFind(pool->strings, str);
+	if(entry != NULL) {
+		return StringPool_IncRef(HashTableGetKey(entry));
+	}
+
+	// string isn't in pool, create it
+	// one reference is held by the pool, the other by the caller
+	size_t len = strlen(str);
+	InternedString *s = rm_malloc(sizeof(InternedString) + len + 1);
+	s->ref_count = 2;
+	memcpy(s->str, str, len + 1);
+
+	int res = HashTableAdd(pool->strings, s->str, NULL);
+	UNUSED(res);
+	ASSERT(res == DICT_OK);
+
+	return s->str;
+}
+
+uint64_t StringPool_Size
+(
+	const StringPool pool
+) {
+	ASSERT(pool != NULL);
+	return HashTableElemCount(pool->strings);
+}
+
+bool StringPool_RequiresVacuum
+(
+	const StringPool pool
+) {
+	ASSERT(pool != NULL);
+
+	// vacuum once the pool doubled in size since the last vacuum
+	uint64_t size = StringPool_Size(pool);
+	return (size >= STRING_POOL_MIN_VACUUM_SIZE &&
+			size >= pool->vacuum_size * 2);
+}
+
+uint64_t StringPool_Vacuum
+(
+	StringPool pool
+) {
+	ASSERT(pool != NULL);
+
+	uint64_t removed = 0;
+	dictEntry *entry;
+	dictIterator *it = HashTableGetSafeIterator(pool->strings);
+
+	while((entry = HashTableNext(it)) != NULL) {
+		char *str = HashTableGetKey(entry);
+		// a string referenced only by the pool can't gain new references
+		// other than through the pool, it is safe to remove
+		if(StringPool_RefCount(str) > 1) continue;
+
+		HashTableDelete(pool->strings, str);
+		StringPool_DecRef(str);
+		removed++;
+	}
+
+	HashTableReleaseIterator(it);
+
+	pool->vacuum_size = StringPool_Size(pool);
+	return removed;
+}
+
+char *StringPool_IncRef
+(
+	char *str
+) {
+	ASSERT(str != NULL);
+
+	InternedString *s = INTERNED_STRING(str);
+	__atomic_fetch_add(&s->ref_count, 1, __ATOMIC_RELAXED);
+
+	return str;
+}
+
+void StringPool_DecRef
+(
+	char *str
+) {
+	ASSERT(str != NULL);
+
+	InternedString *s = INTERNED_STRING(str);
+	ASSERT(s->ref_count > 0);
+	if(__atomic_sub_fetch(&s->ref_count, 1, __ATOMIC_ACQ_REL) == 0) {
+		rm_free(s);
+	}
+}
+
+uint32_t StringPool_RefCount
+(
+	const char *str
+) {
+	ASSERT(str != NULL);
+
+	const InternedString *s = INTERNED_STRING(str);
+	return __atomic_load_n(&s->ref_count, __ATOMIC_ACQUIRE);
+}
+
+void StringPool_Free
+(
+	StringPool *pool
+) {
+	ASSERT(pool != NULL && *pool != NULL);
+
+	StringPool _pool = *pool;
+
+	dictEntry *entry;
+	dictIterator *it = HashTableGetIterator(_pool->strings);
+	while((entry = HashTableNext(it)) != NULL) {
+		StringPool_DecRef(HashTableGetKey(entry));
+	}
+	HashTableReleaseIterator(it);
+
+	HashTableRelease(_pool->strings);
+	rm_free(_pool);
+
+	*pool = NULL;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// string pool, maps string content to a single reference counted copy
+// such that equal strings stored multiple times share one allocation
+// and can be compared by address
+//
+// the pool holds a reference to each of its strings, every other holder
+// of an interned string acquires its own reference via StringPool_IncRef
+// and releases it via StringPool_DecRef, a string is freed once its last
+// reference is released
+//
+// the pool itself is not thread-safe and is only accessed by the graph's
+// writer, reference counting is atomic and can be performed by any thread
+
+// forward declaration
+typedef struct _StringPool _StringPool;
+typedef _StringPool* StringPool;
+
+// create a new string pool
+StringPool StringPool_New(void);
+
+// returns an interned copy of 'str'
+// the caller owns a reference to the returned string
+char *StringPool_Intern
+(
+	StringPool pool,  // string pool
+	const char *str   // string to intern
+);
+
+// number of strings in pool
+uint64_t StringPool_Size
+(
+	const StringPool pool
+);
+
+// returns true if enough strings were interned since the last vacuum
+// for a vacuum to be worthwhile
+bool StringPool_RequiresVacuum
+(
+	const StringPool pool
+);
+
+// removes strings referenced only by the pool
+// returns number of strings removed
+uint64_t StringPool_Vacuum
+(
+	StringPool pool
+);
+
+// acquire an additional reference to an interned string
+char *StringPool_IncRef
+(
+	char *str  // interned string
+);
+
+// release a reference to an interned string
+// the string is freed once its last reference is released
+void StringPool_DecRef
+(
+	char *str  // interned string
+);
+
+// returns number of references to an interned string
+uint32_t StringPool_RefCount
+(
+	const char *str  // interned string
+);
+
+// free pool, releasing its reference to each interned string
+void StringPool_Free
+(
+	StringPool *pool
+);
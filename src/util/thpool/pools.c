@@ -13,8 +13,10 @@
 // Thread pools
 //------------------------------------------------------------------------------
 
-static threadpool _readers_thpool = NULL;  // readers
-static threadpool _writers_thpool = NULL;  // writers
+static threadpool _readers_thpool     = NULL;  // readers
+static threadpool _writers_thpool     = NULL;  // writers
+static threadpool _maintenance_thpool = NULL;  // background maintenance
+static threadpool _workers_thpool     = NULL;  // intra-query parallelism
 
 int ThreadPools_Init
 (
@@ -53,12 +55,23 @@ int ThreadPools_CreatePools
 	_writers_thpool = thpool_init(writer_count, "writer");
 	if(_writers_thpool == NULL) return 0;
 
+	// a single maintenance thread, performing background tasks
+	// e.g. delta matrices compaction
+	_maintenance_thpool = thpool_init(1, "maintenance");
+	if(_maintenance_thpool == NULL) return 0;
+
+	// workers execute parts of a running query in parallel
+	// a separate pool is used as a reader waiting on tasks queued
+	// to the readers pool might deadlock once all readers wait
+	_workers_thpool = thpool_init(reader_count, "worker");
+	if(_workers_thpool == NULL) return 0;
+
 	ThreadPools_SetMaxPendingWork(max_pending_work);
 
 	return 1;
 }
 
-// return number of threads in both the readers and writers pools
+// return number of threads in the readers, writers and workers pools
 uint ThreadPools_ThreadCount
 (
 	void
@@ -69,6 +82,7 @@ uint ThreadPools_ThreadCount
 	uint count = 0;
 	count += thpool_num_threads(_readers_thpool);
 	count += thpool_num_threads(_writers_thpool);
+	count += ThreadPools_WorkersCount();
 
 	return count;
 }
@@ -81,10 +95,19 @@ uint ThreadPools_ReadersCount
 	return thpool_num_threads(_readers_thpool);
 }
 
+uint ThreadPools_WorkersCount
+(
+	void
+) {
+	if(_workers_thpool == NULL) return 0;
+	return thpool_num_threads(_workers_thpool);
+}
+
 // retrieve current thread id
-// 0         redis-main
-// 1..N + 1  readers
-// N + 2..   writers
+// 0                  redis-main
+// 1..N               readers
+// N + 1..N + M       writers
+// N + M + 1..        workers
 int ThreadPools_GetThreadID
 (
 	void
@@ -97,6 +120,14 @@ int ThreadPools_GetThreadID
 	int thread_id;
 	pthread_t pthread = pthread_self();
 	int readers_count = thpool_num_threads(_readers_thpool);
+	int writers_count = thpool_num_threads(_writers_thpool);
+
+	// search in workers
+	if(_workers_thpool != NULL) {
+		thread_id = thpool_get_thread_id(_workers_thpool, pthread);
+		// compensate for Redis main thread
+		if(thread_id != -1) return readers_count + writers_count + thread_id + 1;
+	}
 
 	// search in writers
 	thread_id = thpool_get_thread_id(_writers_thpool, pthread);
@@ -121,6 +152,8 @@ void ThreadPools_Pause
 
 	thpool_pause(_readers_thpool);
 	thpool_pause(_writers_thpool);
+	if(_maintenance_thpool != NULL) thpool_pause(_maintenance_thpool);
+	if(_workers_thpool != NULL) thpool_pause(_workers_thpool);
 }
 
 void ThreadPools_Resume
@@ -133,6 +166,8 @@ void ThreadPools_Resume
 
 	thpool_resume(_readers_thpool);
 	thpool_resume(_writers_thpool);
+	if(_maintenance_thpool != NULL) thpool_resume(_maintenance_thpool);
+	if(_workers_thpool != NULL) thpool_resume(_workers_thpool);
 }
 
 // add task for reader thread
@@ -164,6 +199,28 @@ int ThreadPools_AddWorkWriter
 	return thpool_add_work(_writers_thpool, function_p, arg_p);
 }
 
+// add task for the maintenance thread
+int ThreadPools_AddWorkMaintenance
+(
+	void (*function_p)(void *),
+	void *arg_p
+) {
+	ASSERT(_maintenance_thpool != NULL);
+
+	return thpool_add_work(_maintenance_thpool, function_p, arg_p);
+}
+
+// add a task to the workers pool
+int ThreadPools_AddWorkWorker
+(
+	void (*function_p)(void *),
+	void *arg_p
+) {
+	ASSERT(_workers_thpool != NULL);
+
+	return thpool_add_work(_workers_thpool, function_p, arg_p);
+}
+
 void ThreadPools_SetMaxPendingWork(uint64_t val) {
 	if(_readers_thpool != NULL) thpool_set_jobqueue_cap(_readers_thpool, val);
 	if(_writers_thpool != NULL) thpool_set_jobqueue_cap(_writers_thpool, val);
@@ -178,4 +235,6 @@ void ThreadPools_Destroy
 
 	thpool_destroy(_readers_thpool);
 	thpool_destroy(_writers_thpool);
+	thpool_destroy(_maintenance_thpool);
+	thpool_destroy(_workers_thpool);
 }
@@ -24,7 +24,7 @@ int ThreadPools_CreatePools
 	uint64_t max_pending_work
 );
 
-// return number of threads in both the readers and writers pools
+// return number of threads in the readers, writers and workers pools
 uint ThreadPools_ThreadCount
 (
 	void
@@ -36,10 +36,17 @@ uint ThreadPools_ReadersCount
 	void
 );
 
+// return size of WORKERS thread-pool
+uint ThreadPools_WorkersCount
+(
+	void
+);
+
 // retrieve current thread id
-// 0         redis-main
-// 1..N + 1  readers
-// N + 2..   writers
+// 0                  redis-main
+// 1..N               readers
+// N + 1..N + M       writers
+// N + M + 1..        workers
 int ThreadPools_GetThreadID
 (
 	void
@@ -72,6 +79,21 @@ int ThreadPools_AddWorkWriter
 	int force                    // true will add task even if internal queue is full
 );
 
+// add a background maintenance task
+int ThreadPools_AddWorkMaintenance
+(
+	void (*function_p)(void *),  // function to run
+	void *arg_p                  // function arguments
+);
+
+// add a task to the workers pool
+// workers execute parts of a running query in parallel
+int ThreadPools_AddWorkWorker
+(
+	void (*function_p)(void *),  // function to run
+	void *arg_p                  // function arguments
+);
+
 // sets the limit on max queued queries in each thread pool
 void ThreadPools_SetMaxPendingWork
 (
@@ -15,6 +15,7 @@
 #include <ctype.h>
 #include <sys/param.h>
 #include "util/rmalloc.h"
+#include "util/string_pool.h"
 #include "datatypes/map.h"
 #include "datatypes/array.h"
 #include "datatypes/point.h"
@@ -111,6 +112,12 @@ SIValue SI_TransferStringVal(char *s) {
 	};
 }
 
+SIValue SI_InternStringVal(StringPool pool, const char *s) {
+	return (SIValue) {
+		.stringval = StringPool_Intern(pool, s), .type = T_STRING, .allocation = M_INTERN
+	};
+}
+
 SIValue SI_Point(float latitude, float longitude) {
 	return (SIValue) {
 		.type = T_POINT, .allocation = M_NONE,
@@ -124,7 +131,7 @@ SIValue SI_Point(float latitude, float longitude) {
 SIValue SI_ShareValue(const SIValue v) {
 	SIValue dup = v;
 	// If the original value owns an allocation, mark that the duplicate shares it.
-	if(v.allocation == M_SELF) dup.allocation = M_VOLATILE;
+	if(v.allocation & (M_SELF | M_INTERN)) dup.allocation = M_VOLATILE;
 	return dup;
 }
 
@@ -134,6 +141,12 @@ SIValue SI_ShareValue(const SIValue v) {
 SIValue SI_CloneValue(const SIValue v) {
 	if(v.allocation == M_NONE) return v; // Stack value; no allocation necessary.
 
+	if(v.allocation == M_INTERN) {
+		// Interned strings are shared, acquire an additional reference.
+		StringPool_IncRef(v.stringval);
+		return v;
+	}
+
 	if(v.type == T_STRING) {
 		// Allocate a new copy of the input's string value.
 		return SI_DuplicateStringVal(v.stringval);
@@ -187,7 +200,7 @@ SIValue SI_ConstValue(const SIValue *v) {
 // Clone 'v' and set v's allocation to volatile if 'v' owned the memory
 SIValue SI_TransferOwnership(SIValue *v) {
 	SIValue dup = *v;
-	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	if(v->allocation & (M_SELF | M_INTERN)) v->allocation = M_VOLATILE;
 	return dup;
 }
 
@@ -195,7 +208,7 @@ SIValue SI_TransferOwnership(SIValue *v) {
  * with no responsibility for freeing or guarantee regarding scope.
  * This is used in cases like performing shallow copies of scalars in Record entries. */
 void SIValue_MakeVolatile(SIValue *v) {
-	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	if(v->allocation & (M_SELF | M_INTERN)) v->allocation = M_VOLATILE;
 }
 
 /* Ensure that any allocation held by the given SIValue is guaranteed to not go out
@@ -597,6 +610,8 @@ int SIValue_Compare(const SIValue a, const SIValue b, int *disjointOrNull) {
 
 			return SAFE_COMPARISON_RESULT(a.doubleval - b.doubleval);
 		case T_STRING:
+			// Interned strings sharing an allocation are equal.
+			if(a.stringval == b.stringval) return 0;
 			return strcmp(a.stringval, b.stringval);
 		case T_NODE:
 		case T_EDGE:
@@ -763,6 +778,12 @@ XXH64_hash_t SIValue_HashCode(SIValue v) {
 }
 
 void SIValue_Free(SIValue v) {
+	// Interned strings are released rather than freed.
+	if(v.allocation == M_INTERN) {
+		StringPool_DecRef(v.stringval);
+		return;
+	}
+
 	// The free routine only performs work if it owns a heap allocation.
 	if(v.allocation != M_SELF) return;
 
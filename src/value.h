@@ -12,6 +12,7 @@
 #include <stdbool.h>
 #include <sys/types.h>
 #include "xxhash.h"
+#include "util/string_pool.h"
 
 /* Type defines the supported types by the system. The types are powers
  * of 2 so they can be used in bitmasks of matching types.
@@ -44,7 +45,8 @@ typedef enum {
 	M_NONE = 0,             // SIValue is not heap-allocated
 	M_SELF = (1 << 0),      // SIValue is responsible for freeing its reference
 	M_VOLATILE = (1 << 1),  // SIValue does not own its reference and may go out of scope
-	M_CONST = (1 << 2)      // SIValue does not own its allocation, but its access is safe
+	M_CONST = (1 << 2),     // SIValue does not own its allocation, but its access is safe
+	M_INTERN = (1 << 3)     // SIValue holds a reference to a shared interned string
 } SIAllocation;
 
 #define SI_TYPE(value) (value).type
@@ -123,6 +125,9 @@ SIValue SI_ConstStringVal(const char *s);
 // Don't duplicate input string, but assume ownership.
 SIValue SI_TransferStringVal(char *s);
 
+// Acquire a reference to the interned copy of the input string.
+SIValue SI_InternStringVal(StringPool pool, const char *s);
+
 /* Functions for copying and guaranteeing memory safety for SIValues. */
 // SI_ShareValue creates an SIValue that shares all of the original's allocations.
 SIValue SI_ShareValue(const SIValue v);
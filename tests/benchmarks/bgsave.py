@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+
+# Times BGSAVE of a graph holding nodes and edges with attributes.
+# Entity chunks are encoded by THREAD_COUNT threads within the forked process,
+# compare runs against servers loaded with different THREAD_COUNT values, e.g.
+#   redis-server --loadmodule redisgraph.so THREAD_COUNT 1
+#   redis-server --loadmodule redisgraph.so THREAD_COUNT 8
+
+import time
+import argparse
+import redis
+
+
+def populate(con, graph, nodes):
+    batch = 100000
+    for start in range(0, nodes, batch):
+        end = min(start + batch, nodes) - 1
+        q = f"""UNWIND range({start}, {end}) AS x
+                CREATE (:N {{v: x, s: 'node_' + toString(x), a: [x, x * 0.5]}})
+                -[:R {{w: x * 1.5, s: 'edge_' + toString(x)}}]->
+                (:M {{v: x}})"""
+        con.execute_command("GRAPH.QUERY", graph, q)
+
+
+def bgsave(con):
+    last = con.lastsave()
+    con.bgsave()
+    while True:
+        info = con.info("persistence")
+        if info['rdb_bgsave_in_progress'] == 0 and con.lastsave() != last:
+            break
+        time.sleep(0.01)
+    assert info['rdb_last_bgsave_status'] == "ok"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="BGSAVE encoding benchmark")
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--port", type=int, default=6379)
+    parser.add_argument("--graph", default="bgsave_bench")
+    parser.add_argument("--nodes", type=int, default=1000000)
+    parser.add_argument("--runs", type=int, default=5)
+    args = parser.parse_args()
+
+    con = redis.Redis(host=args.host, port=args.port, decode_responses=True)
+    con.delete(args.graph)
+    populate(con, args.graph, args.nodes)
+
+    timings = []
+    for _ in range(args.runs):
+        start = time.time()
+        bgsave(con)
+        timings.append(time.time() - start)
+        # LASTSAVE has a one second resolution
+        time.sleep(1)
+
+    timings.sort()
+    print(f"nodes: {args.nodes * 2}, edges: {args.nodes}")
+    print(f"BGSAVE min: {timings[0]:.3f}s median: {timings[len(timings) // 2]:.3f}s")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,120 @@
+from common import *
+from itertools import product
+
+GRAPH_ID = "adaptive_traversal"
+NODE_COUNT = 200
+
+graph = None
+edges = None
+
+
+class testAdaptiveTraversal(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global graph
+        graph = Graph(self.env.getConnection(), GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # nodes with an even 'v' are also labeled :E
+        # each node is connected via :R to 3 nodes and via :S to 1 node
+        global edges
+        edges = {'R': set(), 'S': set()}
+        for i in range(NODE_COUNT):
+            for j in [(i + 1) % NODE_COUNT, (i * 3) % NODE_COUNT, (i * 7 + 2) % NODE_COUNT]:
+                edges['R'].add((i, j))
+            edges['S'].add((i, (i + 5) % NODE_COUNT))
+
+        graph.query("UNWIND range(0, $n - 1) AS i CREATE (:N {v: i})", {'n': NODE_COUNT})
+        graph.query("MATCH (n:N) WHERE n.v % 2 = 0 SET n:E")
+        for t in edges:
+            graph.query(f"""UNWIND $edges AS e
+                            MATCH (a:N {{v: e[0]}}), (b:N {{v: e[1]}})
+                            CREATE (a)-[:{t}]->(b)""",
+                        {'edges': [list(e) for e in edges[t]]})
+
+    def neighbours(self, src, types, direction='out'):
+        res = set()
+        for t in types:
+            for (a, b) in edges[t]:
+                if direction in ('out', 'both') and a == src:
+                    res.add(b)
+                if direction in ('in', 'both') and b == src:
+                    res.add(a)
+        return res
+
+    def test01_point_lookup(self):
+        # a single source record is traversed row by row
+        for v in [0, 1, 17, 199]:
+            q = "MATCH (a:N {v: $v})-[:R]->(b) RETURN b.v ORDER BY b.v"
+            res = graph.query(q, {'v': v}).result_set
+            expected = [[b] for b in sorted(self.neighbours(v, ['R']))]
+            self.env.assertEquals(res, expected)
+
+    def test02_labels_and_directions(self):
+        # destination label, incoming and undirected edges
+        # multiple relationship types
+        queries = [
+            ("MATCH (a:N {v: $v})-[:R]->(b:E) RETURN b.v ORDER BY b.v",
+             lambda v: {b for b in self.neighbours(v, ['R']) if b % 2 == 0}),
+            ("MATCH (a:N {v: $v})<-[:R]-(b) RETURN b.v ORDER BY b.v",
+             lambda v: self.neighbours(v, ['R'], 'in')),
+            ("MATCH (a:N {v: $v})-[:R]-(b) RETURN b.v ORDER BY b.v",
+             lambda v: self.neighbours(v, ['R'], 'both')),
+            ("MATCH (a:N {v: $v})-[:R|S]->(b) RETURN b.v ORDER BY b.v",
+             lambda v: self.neighbours(v, ['R', 'S'])),
+            ("MATCH (a:N {v: $v})-[:NONE]->(b) RETURN b.v ORDER BY b.v",
+             lambda v: set()),
+        ]
+
+        for q, f in queries:
+            for v in [0, 3, 42]:
+                res = graph.query(q, {'v': v}).result_set
+                self.env.assertEquals(res, [[b] for b in sorted(f(v))])
+
+    def test03_multi_hop(self):
+        # the unreferenced intermediate node is collapsed into
+        # a single expression R * S
+        q = "MATCH (a:N {v: $v})-[:R]->()-[:S]->(c) RETURN c.v ORDER BY c.v"
+        for v in [0, 5, 150]:
+            res = graph.query(q, {'v': v}).result_set
+            expected = set()
+            for b in self.neighbours(v, ['R']):
+                expected |= self.neighbours(b, ['S'])
+            self.env.assertEquals(res, [[c] for c in sorted(expected)])
+
+    def test04_large_frontier(self):
+        # batches grow as records keep flowing in
+        # and are traversed via matrix multiplication
+        q = "MATCH (a:N)-[:R]->(b:E) RETURN a.v, b.v ORDER BY a.v, b.v"
+        res = graph.query(q).result_set
+        expected = sorted([[a, b] for (a, b) in edges['R'] if b % 2 == 0])
+        self.env.assertEquals(res, expected)
+
+        q = "MATCH (a:N)-[:R]-(b) RETURN count(*)"
+        expected = sum(len(self.neighbours(v, ['R'], 'both')) for v in range(NODE_COUNT))
+        self.env.assertEquals(graph.query(q).result_set, [[expected]])
+
+    def test05_limit(self):
+        q = "MATCH (a:N)-[:R]->(b) RETURN a.v, b.v LIMIT 3"
+        res = graph.query(q).result_set
+        self.env.assertEquals(len(res), 3)
+        for a, b in res:
+            self.env.assertIn((a, b), edges['R'])
+
+    def test06_pending_changes(self):
+        # traverse edges created within the same query
+        q = """MATCH (a:N {v: 7})
+               CREATE (a)-[:T]->(:X {v: 1}), (a)-[:T]->(:X {v: 2})
+               WITH a
+               MATCH (a)-[:T]->(x:X)
+               RETURN x.v ORDER BY x.v"""
+        self.env.assertEquals(graph.query(q).result_set, [[1], [2]])
+
+        # delete an edge and traverse within the same query
+        q = """MATCH (a:N {v: 7})-[t:T]->(x:X {v: 1})
+               DELETE t
+               WITH a
+               MATCH (a)-[:T]->(x:X)
+               RETURN x.v"""
+        self.env.assertEquals(graph.query(q).result_set, [[2]])
@@ -0,0 +1,171 @@
+from common import *
+from index_utils import *
+
+GRAPH_ID = "attribute_stats"
+graph = None
+
+
+class testAttributeStats(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global graph
+        graph = Graph(self.env.getConnection(), GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # 1000 :P nodes
+        # age holds 100 distinct values
+        # country holds 2 distinct values
+        # score is missing from every 4th node
+        q = """UNWIND range(0, 999) AS i
+               CREATE (:P {age: i % 100,
+                           country: CASE WHEN i % 10 = 0 THEN 'US' ELSE 'UK' END,
+                           score: CASE WHEN i % 4 = 0 THEN null ELSE i END})"""
+        graph.query(q)
+
+    def analyze(self, *labels):
+        q = "CALL db.stats.analyze(" + ", ".join(f"'{l}'" for l in labels) + ")"
+        q += """ YIELD label, property, count, nullFraction, distinctValues, histogram
+                 RETURN label, property, count, nullFraction, distinctValues, histogram
+                 ORDER BY label, property"""
+        return graph.query(q).result_set
+
+    def test01_analyze(self):
+        res = self.analyze('P')
+        self.env.assertEquals(len(res), 3)
+
+        age, country, score = res
+
+        self.env.assertEquals(age[0:4], ['P', 'age', 1000, 0.0])
+        self.env.assertTrue(abs(age[4] - 100) <= 5)
+        histogram = age[5]
+        self.env.assertEquals(len(histogram), 33)
+        self.env.assertEquals(histogram[0], 0)
+        self.env.assertEquals(histogram[-1], 99)
+        self.env.assertEquals(histogram, sorted(histogram))
+
+        # strings have no histogram
+        self.env.assertEquals(country, ['P', 'country', 1000, 0.0, 2, []])
+
+        self.env.assertEquals(score[0:4], ['P', 'score', 1000, 0.25])
+        self.env.assertTrue(abs(score[4] - 750) <= 75)
+        self.env.assertEquals(score[5][0], 1)
+        self.env.assertEquals(score[5][-1], 999)
+
+        # analyzing all labels
+        graph.query("CREATE (:Q {v: 1})")
+        res = self.analyze()
+        self.env.assertEquals([row[0:2] for row in res],
+                              [['P', 'age'], ['P', 'country'], ['P', 'score'], ['Q', 'v']])
+
+    def test02_invalid_arguments(self):
+        try:
+            graph.query("CALL db.stats.analyze('NoSuchLabel')")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Label 'NoSuchLabel' does not exist", str(e))
+
+        try:
+            graph.query("CALL db.stats.analyze(1)")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Label must be a string", str(e))
+
+    def test03_index_selection(self):
+        g = Graph(self.env.getConnection(), "attribute_stats_index")
+        g.query("""UNWIND range(0, 999) AS i
+                   CREATE (:P {age: i % 100})""")
+        create_node_exact_match_index(g, 'P', 'age', sync=True)
+
+        # without statistics an index is used for any applicable filter
+        q = "MATCH (p:P) WHERE p.age > 5 RETURN count(p)"
+        plan = g.execution_plan(q)
+        self.env.assertIn("Node By Index Scan", plan)
+        self.env.assertEquals(g.query(q).result_set, [[940]])
+
+        g.query("CALL db.stats.analyze('P')")
+
+        # filter matches most nodes, index isn't used
+        plan = g.execution_plan(q)
+        self.env.assertNotIn("Node By Index Scan", plan)
+        self.env.assertIn("Node By Label Scan | (p:P)", plan)
+        self.env.assertEquals(g.query(q).result_set, [[940]])
+
+        # selective filters still utilize the index
+        q = "MATCH (p:P) WHERE p.age = 5 RETURN count(p)"
+        plan = g.execution_plan(q)
+        self.env.assertIn("Node By Index Scan", plan)
+        self.env.assertEquals(g.query(q).result_set, [[10]])
+
+        q = "MATCH (p:P) WHERE p.age < 3 RETURN count(p)"
+        plan = g.execution_plan(q)
+        self.env.assertIn("Node By Index Scan", plan)
+        self.env.assertEquals(g.query(q).result_set, [[30]])
+
+    def test04_multi_label_index_selection(self):
+        # :X is smaller than :Y, but filtering on x is not selective
+        g = Graph(self.env.getConnection(), "attribute_stats_multi_label")
+        g.query("UNWIND range(0, 999) AS i CREATE (:X:Y {x: 1, y: i})")
+        g.query("UNWIND range(1000, 2999) AS i CREATE (:Y {y: i})")
+        create_node_exact_match_index(g, 'X', 'x', sync=True)
+        create_node_exact_match_index(g, 'Y', 'y', sync=True)
+
+        q = "MATCH (n:X:Y) WHERE n.x = 1 AND n.y = 7 RETURN n.y"
+        plan = g.execution_plan(q)
+        self.env.assertIn("Node By Index Scan | (n:X)", plan)
+        self.env.assertEquals(g.query(q).result_set, [[7]])
+
+        g.query("CALL db.stats.analyze()")
+
+        plan = g.execution_plan(q)
+        self.env.assertIn("Node By Index Scan | (n:Y)", plan)
+        self.env.assertEquals(g.query(q).result_set, [[7]])
+
+    def test05_traverse_order(self):
+        # 2000 :A nodes connected to 10 :B nodes
+        g = Graph(self.env.getConnection(), "attribute_stats_traverse")
+        g.query("""UNWIND range(0, 9) AS i
+                   CREATE (b:B {v: i})
+                   WITH b, i
+                   UNWIND range(0, 199) AS j
+                   CREATE (:A {v: i * 200 + j, flag: true})-[:R]->(b)""")
+
+        g.query("CALL db.stats.analyze()")
+
+        # filter on 'a' matches every :A node, start from the smaller :B
+        q = """MATCH (a:A)-[:R]->(b:B)
+               WHERE a.flag = true
+               RETURN count(a)"""
+        plan = g.execution_plan(q)
+        self.env.assertIn("Node By Label Scan | (b:B)", plan)
+        self.env.assertEquals(g.query(q).result_set, [[2000]])
+
+        # filter on 'a' matches a single :A node
+        q = """MATCH (a:A)-[:R]->(b:B)
+               WHERE a.v = 7
+               RETURN b.v"""
+        plan = g.execution_plan(q)
+        self.env.assertIn("Node By Label Scan | (a:A)", plan)
+        self.env.assertEquals(g.query(q).result_set, [[0]])
+
+    def test06_maintained_on_write(self):
+        g = Graph(self.env.getConnection(), "attribute_stats_writes")
+        g.query("UNWIND range(0, 99) AS i CREATE (:W {v: i})")
+        g.query("CALL db.stats.analyze('W')")
+
+        # statistics are updated as nodes are created, updated and deleted
+        g.query("UNWIND range(100, 199) AS i CREATE (:W {v: i})")
+        g.query("MATCH (n:W) WHERE n.v < 10 SET n.v = n.v + 1000")
+        g.query("MATCH (n:W) WHERE n.v >= 190 SET n = {u: 1}")
+        g.query("MATCH (n:W) WHERE n.v >= 180 AND n.v < 190 REMOVE n:W")
+        g.query("MATCH (n:W) WHERE n.v >= 170 AND n.v < 180 DELETE n")
+        g.query("MATCH (n) WHERE n.v >= 180 AND n.v < 190 SET n:W")
+
+        q = "MATCH (n:W) WHERE n.v >= 100 RETURN count(n)"
+        self.env.assertEquals(g.query(q).result_set, [[80]])
+
+        res = g.query("""CALL db.stats.analyze('W')
+                         YIELD property, count, nullFraction
+                         RETURN property, count, nullFraction
+                         ORDER BY property""").result_set
+        self.env.assertEquals(res, [['u', 190, 170 / 190], ['v', 190, 20 / 190]])
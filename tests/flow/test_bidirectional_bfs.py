@@ -0,0 +1,142 @@
+from common import *
+from math import comb
+from collections import deque
+
+GRAPH_ID = "bidirectional_bfs"
+WIDTH = 6
+HEIGHT = 5
+
+graph = None
+edges = None
+
+
+def node_id(x, y):
+    return y * WIDTH + x
+
+
+class testBidirectionalBFS(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global graph
+        graph = Graph(self.env.getConnection(), GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # a grid in which each cell is connected via :R to the cell
+        # on its right and to the cell below it
+        # edges leaving the last row are marked as blocked
+        global edges
+        edges = []
+        for y in range(HEIGHT):
+            for x in range(WIDTH):
+                blocked = 1 if y == HEIGHT - 1 else 0
+                if x + 1 < WIDTH:
+                    edges.append([node_id(x, y), node_id(x + 1, y), blocked])
+                if y + 1 < HEIGHT:
+                    edges.append([node_id(x, y), node_id(x, y + 1), 0])
+
+        graph.query("UNWIND range(0, $n - 1) AS i CREATE (:N {v: i})",
+                    {'n': WIDTH * HEIGHT})
+        graph.query("""UNWIND $edges AS e
+                       MATCH (a:N {v: e[0]}), (b:N {v: e[1]})
+                       CREATE (a)-[:R {blocked: e[2]}]->(b)""",
+                    {'edges': edges})
+
+    def distance(self, src, dest, directed=True, blocked=True):
+        adj = {}
+        for a, b, w in edges:
+            if w == 1 and not blocked:
+                continue
+            adj.setdefault(a, []).append(b)
+            if not directed:
+                adj.setdefault(b, []).append(a)
+
+        dist = {src: 0}
+        q = deque([src])
+        while q:
+            n = q.popleft()
+            for m in adj.get(n, []):
+                if m not in dist:
+                    dist[m] = dist[n] + 1
+                    q.append(m)
+        return dist.get(dest)
+
+    def test01_shortest_path_length(self):
+        q = """MATCH (a:N {v: $src}), (b:N {v: $dest})
+               RETURN length(shortestPath((a)-[:R*]->(b)))"""
+        for src in [0, 7, 13]:
+            for dest in range(WIDTH * HEIGHT):
+                if src == dest:
+                    continue
+                res = graph.query(q, {'src': src, 'dest': dest}).result_set
+                self.env.assertEquals(res, [[self.distance(src, dest)]])
+
+    def test02_shortest_path_is_connected(self):
+        # consecutive nodes on the returned path are connected
+        q = """MATCH (a:N {v: 0}), (b:N {v: $dest})
+               WITH shortestPath((a)-[*]->(b)) AS p
+               UNWIND nodes(p) AS n
+               RETURN n.v"""
+        connected = {(a, b) for a, b, _ in edges}
+        dest = node_id(WIDTH - 1, HEIGHT - 1)
+        res = [row[0] for row in graph.query(q, {'dest': dest}).result_set]
+        self.env.assertEquals(len(res), self.distance(0, dest) + 1)
+        self.env.assertEquals(res[0], 0)
+        self.env.assertEquals(res[-1], dest)
+        for a, b in zip(res, res[1:]):
+            self.env.assertIn((a, b), connected)
+
+    def test03_shortest_path_max_hops(self):
+        dest = node_id(3, 3)
+        q = """MATCH (a:N {v: 0}), (b:N {v: $dest})
+               RETURN length(shortestPath((a)-[*..6]->(b))),
+                      length(shortestPath((a)-[*..5]->(b)))"""
+        res = graph.query(q, {'dest': dest}).result_set
+        self.env.assertEquals(res, [[6, None]])
+
+        # unreachable destination
+        q = """MATCH (a:N {v: $src}), (b:N {v: 0})
+               RETURN shortestPath((a)-[*]->(b))"""
+        res = graph.query(q, {'src': node_id(2, 2)}).result_set
+        self.env.assertEquals(res, [[None]])
+
+    def test04_all_shortest_paths_count(self):
+        # the number of monotone paths through a grid
+        q = """MATCH (a:N {v: 0}), (b:N {v: $dest})
+               WITH a, b
+               MATCH p = allShortestPaths((a)-[*]->(b))
+               RETURN count(p)"""
+        for x, y in [(1, 0), (1, 1), (3, 2), (WIDTH - 1, HEIGHT - 1)]:
+            res = graph.query(q, {'dest': node_id(x, y)}).result_set
+            self.env.assertEquals(res, [[comb(x + y, x)]])
+
+        # right to left traversal
+        q = """MATCH (a:N {v: 0}), (b:N {v: $dest})
+               WITH a, b
+               MATCH p = allShortestPaths((b)<-[*]-(a))
+               RETURN count(p), min(length(p)), max(length(p))"""
+        res = graph.query(q, {'dest': node_id(4, 3)}).result_set
+        self.env.assertEquals(res, [[comb(7, 4), 7, 7]])
+
+    def test05_all_shortest_paths_undirected(self):
+        # every shortest path between opposite corners is monotone
+        q = """MATCH (a:N {v: $src}), (b:N {v: 0})
+               WITH a, b
+               MATCH p = allShortestPaths((a)-[*]-(b))
+               RETURN count(p), min(length(p)), max(length(p))"""
+        src = node_id(3, 2)
+        res = graph.query(q, {'src': src}).result_set
+        self.env.assertEquals(res, [[comb(5, 3), 5, 5]])
+
+    def test06_all_shortest_paths_filtered(self):
+        # blocked edges along the last row can't be traversed
+        # paths must reach the last row at the destination's column
+        q = """MATCH (a:N {v: 0}), (b:N {v: $dest})
+               WITH a, b
+               MATCH p = allShortestPaths((a)-[* {blocked: 0}]->(b))
+               RETURN count(p), min(length(p))"""
+        x, y = 4, HEIGHT - 1
+        res = graph.query(q, {'dest': node_id(x, y)}).result_set
+        self.env.assertEquals(res, [[comb(x + y - 1, x), x + y]])
+        self.env.assertEquals(self.distance(0, node_id(x, y), blocked=False),
+                              x + y)
@@ -0,0 +1,94 @@
+import struct
+from common import *
+
+GRAPH_ID = "binary_resultset"
+
+# ValueType
+VALUE_NULL    = 1
+VALUE_STRING  = 2
+VALUE_INTEGER = 3
+VALUE_BOOLEAN = 4
+VALUE_DOUBLE  = 5
+
+
+def decode_column(buf):
+    enc = buf[0]
+    nrows = struct.unpack_from('<I', buf, 4)[0]
+    bitmap_size = (((nrows + 7) // 8) + 7) & ~7
+    nulls = [(buf[8 + (i >> 3)] >> (i & 7)) & 1 for i in range(nrows)]
+    offset = 8 + bitmap_size
+
+    if enc == VALUE_NULL:
+        values = [None] * nrows
+    elif enc == VALUE_INTEGER:
+        values = list(struct.unpack_from(f'<{nrows}q', buf, offset))
+    elif enc == VALUE_DOUBLE:
+        values = list(struct.unpack_from(f'<{nrows}d', buf, offset))
+    elif enc == VALUE_BOOLEAN:
+        values = [b != 0 for b in buf[offset:offset + nrows]]
+    elif enc == VALUE_STRING:
+        dict_size = struct.unpack_from('<I', buf, offset)[0]
+        offset += 4
+        entries = []
+        for _ in range(dict_size):
+            length = struct.unpack_from('<I', buf, offset)[0]
+            entries.append(buf[offset + 4:offset + 4 + length].decode())
+            offset += 4 + length
+        codes = struct.unpack_from(f'<{nrows}I', buf, offset)
+        values = [entries[c] for c in codes]
+    else:
+        raise ValueError(enc)
+
+    return enc, [None if nulls[i] else values[i] for i in range(nrows)]
+
+
+class testBinaryResultSet():
+    def __init__(self):
+        self.env = Env(decodeResponses=False)
+        self.conn = self.env.getConnection()
+        self.conn.execute_command("GRAPH.QUERY", GRAPH_ID,
+                "UNWIND range(1, 5) AS x CREATE (:N {v: x, s: 'str' + toString(x % 2)})")
+
+    def query(self, q):
+        return self.conn.execute_command("GRAPH.QUERY", GRAPH_ID, q, "--binary")
+
+    def test01_typed_columns(self):
+        res = self.query("""MATCH (n:N)
+                            RETURN n.v, n.v / 2.0, n.v > 2, n.s,
+                                   CASE WHEN n.v = 3 THEN NULL ELSE n.v END,
+                                   NULL
+                            ORDER BY n.v""")
+
+        # header is identical to the compact header
+        self.env.assertEqual(len(res), 3)
+        self.env.assertEqual(res[0][0], [1, b'n.v'])
+
+        # a single batch holding a bulk string per column
+        batches = res[1]
+        self.env.assertEqual(len(batches), 1)
+        columns = [decode_column(c) for c in batches[0]]
+
+        self.env.assertEqual(columns[0], (VALUE_INTEGER, [1, 2, 3, 4, 5]))
+        self.env.assertEqual(columns[1], (VALUE_DOUBLE, [0.5, 1.0, 1.5, 2.0, 2.5]))
+        self.env.assertEqual(columns[2], (VALUE_BOOLEAN, [False, False, True, True, True]))
+        self.env.assertEqual(columns[3], (VALUE_STRING, ['str1', 'str0', 'str1', 'str0', 'str1']))
+        self.env.assertEqual(columns[4], (VALUE_INTEGER, [1, 2, None, 4, 5]))
+        self.env.assertEqual(columns[5], (VALUE_NULL, [None] * 5))
+
+    def test02_string_dictionary(self):
+        res = self.query("MATCH (n:N) RETURN n.s")
+        buf = res[1][0][0]
+        bitmap_size = 8
+        dict_size = struct.unpack_from('<I', buf, 8 + bitmap_size)[0]
+        # repeated strings are stored once
+        self.env.assertEqual(dict_size, 2)
+
+    def test03_mixed_columns(self):
+        # columns which can't be encoded fall back to compact values
+        res = self.query("UNWIND [1, 'a', [2]] AS x RETURN x")
+        column = res[1][0][0]
+        self.env.assertEqual(column, [[3, 1], [2, b'a'], [6, [[3, 2]]]])
+
+    def test04_empty_result(self):
+        res = self.query("MATCH (n:N) WHERE n.v > 100 RETURN n.v")
+        self.env.assertEqual(res[1], [])
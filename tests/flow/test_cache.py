@@ -25,15 +25,17 @@ class testCache():
 
     def test_01_sanity_check(self):
         graph = Graph(redis_con, 'Cache_Sanity_Check')
+        # queries differing only by their literals share a cache entry
+        # vary the attribute name to produce distinct queries
         for i in range(CACHE_SIZE + 1):
-            result = graph.query("MATCH (n) WHERE n.value = {val} RETURN n".format(val=i))
+            result = graph.query("MATCH (n) WHERE n.value{val} = 1 RETURN n".format(val=i))
             self.env.assertFalse(result.cached_execution)
         
         for i in range(1, CACHE_SIZE + 1):
-            result = graph.query("MATCH (n) WHERE n.value = {val} RETURN n".format(val=i))
+            result = graph.query("MATCH (n) WHERE n.value{val} = 1 RETURN n".format(val=i))
             self.env.assertTrue(result.cached_execution)
         
-        result = graph.query("MATCH (n) WHERE n.value = 0 RETURN n")
+        result = graph.query("MATCH (n) WHERE n.value0 = 1 RETURN n")
         self.env.assertFalse(result.cached_execution)
 
         graph.delete()
@@ -286,3 +288,47 @@ class testCache():
 
         loop.run_until_complete(asyncio.wait(tasks))
 
+    def test_15_auto_parameterization(self):
+        # queries differing only by their literals reuse the same plan
+        graph = Graph(self.env.getConnection(), 'Cache_Auto_Params')
+        graph.query("UNWIND range(1, 10) AS x CREATE (:User {id: x, name: toString(x)})")
+
+        def stats():
+            res = self.env.execute_command("GRAPH.DEBUG", "CACHE", 'Cache_Auto_Params')
+            return dict(zip(res[::2], res[1::2]))
+
+        before = stats()
+
+        q = "MATCH (u:User {id: %d}) WHERE u.name <> '%s' RETURN u.id, 'const'"
+        result = graph.query(q % (3, 'x'))
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[3, 'const']])
+
+        result = graph.query(q % (7, '7'))
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [])
+
+        result = graph.query(q % (8, 'x'))
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[8, 'const']])
+        # projected literals keep naming their columns
+        self.env.assertEqual(result.header[1][1], "'const'")
+
+        after = stats()
+        self.env.assertEqual(after['hits'] - before['hits'], 2)
+        self.env.assertEqual(after['misses'] - before['misses'], 1)
+        self.env.assertGreater(after['size'], 0)
+
+        # literals of different types share the plan as well
+        result = graph.query("MATCH (u:User) WHERE u.id = 'a' RETURN count(u)")
+        self.env.assertEqual(result.result_set, [[0]])
+        result = graph.query("MATCH (u:User) WHERE u.id = 4 RETURN count(u)")
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[1]])
+
+        # literals which can't be lifted are reported as before
+        try:
+            graph.query("MATCH (u:User) WHERE u.id = 1 OR u.id = 9223372036854775808 RETURN u")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Integer overflow", str(e))
@@ -1,3 +1,4 @@
+import time
 from common import *
 
 redis_con = None
@@ -24,8 +25,8 @@ class testConfig(FlowTestsBase):
         # Try reading all configurations
         config_name = "*"
         response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
-        # 12 configurations should be reported
-        self.env.assertEquals(len(response), 13)
+        # 17 configurations should be reported
+        self.env.assertEquals(len(response), 17)
 
     def test02_config_get_invalid_name(self):
         global redis_graph
@@ -297,3 +298,95 @@ class testConfig(FlowTestsBase):
         expected_response = ["NODE_CREATION_BUFFER", 1024]
         self.env.assertEqual(creation_buffer_size, expected_response)
 
+
+    def test12_delta_background_compaction(self):
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, "compaction")
+
+        # background compaction is disabled by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET DELTA_BACKGROUND_COMPACTION")
+        self.env.assertEqual(response, ["DELTA_BACKGROUND_COMPACTION", 0])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET DELTA_BACKGROUND_COMPACTION yes")
+        self.env.assertEqual(response, "OK")
+
+        response = redis_con.execute_command("GRAPH.CONFIG GET DELTA_BACKGROUND_COMPACTION")
+        self.env.assertEqual(response, ["DELTA_BACKGROUND_COMPACTION", 1])
+
+        # accumulate enough pending changes to trigger a compaction
+        redis_con.execute_command("GRAPH.CONFIG SET DELTA_MAX_PENDING_CHANGES 10")
+        for i in range(10):
+            redis_graph.query("UNWIND range(1, 10) AS x CREATE (:N {v: x})-[:R]->(:M)")
+
+        # graph content is unaffected by compaction
+        result = redis_graph.query("MATCH (:N)-[r:R]->(:M) RETURN count(r)")
+        self.env.assertEqual(result.result_set[0][0], 100)
+
+        redis_graph.query("MATCH (n:N) WHERE n.v > 5 DELETE n")
+        result = redis_graph.query("MATCH (:N)-[r:R]->(:M) RETURN count(r)")
+        self.env.assertEqual(result.result_set[0][0], 50)
+
+        # toggling back is supported
+        response = redis_con.execute_command("GRAPH.CONFIG SET DELTA_BACKGROUND_COMPACTION no")
+        self.env.assertEqual(response, "OK")
+
+        # invalid values are rejected
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET DELTA_BACKGROUND_COMPACTION 5")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Failed to set config value DELTA_BACKGROUND_COMPACTION to 5" in str(e))
+
+    def test13_delta_idle_compaction_delay(self):
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, "idle_compaction")
+
+        # idle compaction is disabled by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET DELTA_IDLE_COMPACTION_DELAY")
+        self.env.assertEqual(response, ["DELTA_IDLE_COMPACTION_DELAY", 0])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET DELTA_IDLE_COMPACTION_DELAY 100")
+        self.env.assertEqual(response, "OK")
+
+        # introduce a few pending changes, below DELTA_MAX_PENDING_CHANGES
+        redis_con.execute_command("GRAPH.CONFIG SET DELTA_MAX_PENDING_CHANGES 10000")
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:N {v: x})-[:R]->(:M)")
+        redis_graph.query("MATCH (n:N) WHERE n.v > 5 DELETE n")
+
+        # wait for idle compaction to kick in
+        time.sleep(0.5)
+
+        result = redis_graph.query("MATCH (:N)-[r:R]->(:M) RETURN count(r)")
+        self.env.assertEqual(result.result_set[0][0], 5)
+
+        # disable idle compaction
+        response = redis_con.execute_command("GRAPH.CONFIG SET DELTA_IDLE_COMPACTION_DELAY 0")
+        self.env.assertEqual(response, "OK")
+
+    def test14_string_interning(self):
+        redis_con = self.env.getConnection()
+        graph = Graph(redis_con, "string_interning")
+
+        # string interning is enabled by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET STRING_INTERNING")
+        self.env.assertEqual(response, ["STRING_INTERNING", 1])
+
+        graph.query("UNWIND range(1, 10) AS x CREATE (:N {v: x, s: 'status'})")
+        graph.query("MATCH (n:N) WHERE n.v > 5 SET n.s = 'updated'")
+
+        # interned strings are shared between entities
+        result = graph.query("MATCH (a:N), (b:N) WHERE a.s = b.s RETURN count(1)")
+        self.env.assertEqual(result.result_set[0][0], 50)
+
+        # disable string interning, mixing interned and non interned strings
+        response = redis_con.execute_command("GRAPH.CONFIG SET STRING_INTERNING no")
+        self.env.assertEqual(response, "OK")
+
+        graph.query("MATCH (n:N) WHERE n.v > 8 SET n.s = 'status'")
+        result = graph.query("MATCH (n:N) RETURN n.s, count(1) ORDER BY n.s")
+        self.env.assertEqual(result.result_set, [['status', 7], ['updated', 3]])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET STRING_INTERNING yes")
+        self.env.assertEqual(response, "OK")
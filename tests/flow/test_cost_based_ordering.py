@@ -0,0 +1,99 @@
+from common import *
+
+GRAPH_ID = "cost_based_ordering"
+graph = None
+
+
+class testCostBasedOrdering(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global graph
+        graph = Graph(self.env.getConnection(), GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # 2000 :A nodes, 10 :B nodes, 1000 :C nodes and a single :D node
+        # every :A node is connected to a :B node
+        # every :B node is connected to 100 :C nodes
+        # the first :B node is connected to the :D node
+        q = """UNWIND range(0, 9) AS i
+               CREATE (b:B {v: i})
+               WITH b, i
+               UNWIND range(0, 199) AS j
+               CREATE (:A {v: i * 200 + j})-[:R]->(b)"""
+        graph.query(q)
+
+        q = """MATCH (b:B)
+               UNWIND range(0, 99) AS j
+               CREATE (b)-[:S]->(:C {v: b.v * 100 + j})"""
+        graph.query(q)
+
+        graph.query("MATCH (b:B {v: 0}) CREATE (b)-[:T]->(:D)")
+
+    def test01_start_from_selective_end(self):
+        # both endpoints are labeled, scan the label with fewer nodes
+        q = "MATCH (a:A)-[:R]->(b:B) RETURN count(a)"
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Node By Label Scan | (b:B)", plan)
+        self.env.assertEqual(graph.query(q).result_set, [[2000]])
+
+        q = "MATCH (b:B)<-[:R]-(a:A) RETURN count(a)"
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Node By Label Scan | (b:B)", plan)
+        self.env.assertEqual(graph.query(q).result_set, [[2000]])
+
+    def test02_multi_hop(self):
+        # a multi-hop pattern starts from its most selective node
+        # and expands outwards
+        q = """MATCH (a:A)-[:R]->(b:B)-[:T]->(d:D)
+               RETURN count(a)"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Node By Label Scan | (d:D)", plan)
+        self.env.assertEqual(graph.query(q).result_set, [[200]])
+
+        q = """MATCH (d:D)<-[:T]-(b:B)<-[:R]-(a:A)
+               RETURN count(a)"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Node By Label Scan | (d:D)", plan)
+        self.env.assertEqual(graph.query(q).result_set, [[200]])
+
+        # results are unaffected by the arrangement
+        q = """MATCH (a:A)-[:R]->(b:B)-[:S]->(c:C)
+               RETURN count(*)"""
+        self.env.assertEqual(graph.query(q).result_set, [[200 * 100 * 10]])
+
+    def test03_bound_and_filtered_nodes(self):
+        # bound nodes are resolved to a single node per record
+        # and remain the traversal's starting point
+        q = """MATCH (c:C {v: 5})
+               WITH c
+               MATCH (a:A)-[:R]->(b:B)-[:S]->(c)
+               RETURN count(a)"""
+        plan = graph.execution_plan(q)
+        self.env.assertNotIn("Node By Label Scan | (a:A)", plan)
+        self.env.assertEqual(graph.query(q).result_set, [[200]])
+
+        # a filtered node is selective
+        q = """MATCH (a:A)-[:R]->(b:B)
+               WHERE a.v = 7
+               RETURN b.v"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Node By Label Scan | (a:A)", plan)
+        self.env.assertEqual(graph.query(q).result_set, [[0]])
+
+    def test04_results_unaffected(self):
+        q = """MATCH (a:A)-[:R]->(b:B)-[:S]->(c:C)
+               WHERE c.v < 150
+               RETURN count(*)"""
+        self.env.assertEqual(graph.query(q).result_set, [[200 * 100 + 200 * 50]])
+
+        q = """MATCH (c:C)<-[:S]-(b:B)<-[:R]-(a:A)
+               WHERE a.v % 500 = 0
+               RETURN a.v, count(c) ORDER BY a.v"""
+        self.env.assertEqual(graph.query(q).result_set, [[v, 100] for v in range(0, 2000, 500)])
+
+        q = """MATCH (a:A)-[:R]->(b:B), (b)-[:S]->(c:C)
+               WHERE a.v = c.v
+               RETURN a.v ORDER BY a.v"""
+        self.env.assertEqual(graph.query(q).result_set, [[v] for v in range(100)])
+
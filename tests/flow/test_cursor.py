@@ -0,0 +1,173 @@
+import time
+from common import *
+
+GRAPH_ID = "cursor"
+NODES = 1000
+
+
+class testCursor():
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+        self.graph.query(f"UNWIND range(1, {NODES}) AS x CREATE (:N {{v: x}})")
+
+    def query(self, q, count):
+        res = self.conn.execute_command("GRAPH.QUERY", GRAPH_ID, q, "--compact",
+                                        "CURSOR", count)
+        return query_result.QueryResult(self.graph, res[:-1]), res[-1]
+
+    def read(self, cursor, count=None):
+        args = ["GRAPH.CURSOR", "READ", GRAPH_ID, cursor]
+        if count is not None:
+            args += ["COUNT", count]
+        res = self.conn.execute_command(*args)
+        return query_result.QueryResult(self.graph, res[:-1]), res[-1]
+
+    def test01_stream_results(self):
+        q = "MATCH (n:N) RETURN n.v ORDER BY n.v"
+        result, cursor = self.query(q, 100)
+        self.env.assertNotEqual(cursor, 0)
+        self.env.assertEqual(len(result.result_set), 100)
+        self.env.assertEqual(result.header[0][1], "n.v")
+
+        # each read returns exactly the cursor's count
+        id = cursor
+        rows = result.result_set
+        while cursor != 0 and len(rows) < NODES:
+            result, cursor = self.read(cursor)
+            self.env.assertEqual(len(result.result_set), 100)
+            rows += result.result_set
+
+        # final read detects depletion
+        result, cursor = self.read(cursor)
+        self.env.assertEqual(len(result.result_set), 0)
+        self.env.assertEqual(cursor, 0)
+
+        self.env.assertEqual(rows, [[i] for i in range(1, NODES + 1)])
+
+        # depleted cursors are freed
+        try:
+            self.read(id)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Cursor not found", str(e))
+
+    def test02_read_count(self):
+        q = "MATCH (n:N) RETURN n.v"
+        result, cursor = self.query(q, 1)
+        self.env.assertNotEqual(cursor, 0)
+        self.env.assertEqual(len(result.result_set), 1)
+
+        result, cursor = self.read(cursor, 10)
+        self.env.assertEqual(len(result.result_set), 10)
+        self.env.assertNotEqual(cursor, 0)
+
+        result, cursor = self.read(cursor, NODES)
+        self.env.assertEqual(len(result.result_set), NODES - 11)
+        self.env.assertEqual(cursor, 0)
+
+    def test03_small_result(self):
+        # queries depleted by the first read don't keep a cursor
+        result, cursor = self.query("MATCH (n:N) RETURN count(n)", 10)
+        self.env.assertEqual(cursor, 0)
+        self.env.assertEqual(result.result_set, [[NODES]])
+
+    def test04_delete_cursor(self):
+        _, cursor = self.query("MATCH (n:N) RETURN n", 1)
+        self.env.assertNotEqual(cursor, 0)
+
+        res = self.conn.execute_command("GRAPH.CURSOR", "DEL", GRAPH_ID, cursor)
+        self.env.assertEqual(res, "OK")
+
+        try:
+            self.read(cursor)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Cursor not found", str(e))
+
+    def test05_invalidated_by_write(self):
+        _, cursor = self.query("MATCH (n:N) RETURN n.v", 1)
+        self.env.assertNotEqual(cursor, 0)
+
+        self.graph.query("CREATE (:M)")
+
+        try:
+            self.read(cursor)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Cursor invalidated", str(e))
+
+        # invalidated cursors are freed
+        try:
+            self.read(cursor)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Cursor not found", str(e))
+
+    def test06_write_query(self):
+        try:
+            self.query("CREATE (:M) RETURN 1", 1)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("read only queries", str(e))
+
+    def test07_invalid_arguments(self):
+        for count in ["0", "-1", "a"]:
+            try:
+                self.query("MATCH (n) RETURN n", count)
+                self.env.assertTrue(False)
+            except ResponseError as e:
+                self.env.assertContains("Failed to parse cursor count value", str(e))
+
+        try:
+            self.conn.execute_command("GRAPH.CURSOR", "READ", GRAPH_ID, "x")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Invalid cursor id", str(e))
+
+    def test08_survives_compaction(self):
+        # introduce pending changes, compacted once the graph is idle
+        self.conn.execute_command("GRAPH.CONFIG SET DELTA_IDLE_COMPACTION_DELAY 100")
+        self.graph.query(f"UNWIND range(1, 10) AS x CREATE (:N {{v: {NODES} + x}})")
+        self.graph.query(f"MATCH (n:N) WHERE n.v > {NODES} DELETE n")
+
+        result, cursor = self.query("MATCH (n:N) RETURN n.v ORDER BY n.v", 1)
+        self.env.assertNotEqual(cursor, 0)
+        rows = result.result_set
+
+        # compaction doesn't modify the graph, cursor remains valid
+        time.sleep(0.5)
+
+        while cursor != 0:
+            result, cursor = self.read(cursor)
+            rows += result.result_set
+
+        self.env.assertEqual(rows, [[i] for i in range(1, NODES + 1)])
+
+        self.conn.execute_command("GRAPH.CONFIG SET DELTA_IDLE_COMPACTION_DELAY 0")
+
+
+class testCursorParallelScan():
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='THREAD_COUNT 4')
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+        self.graph.query("UNWIND range(1, 100000) AS x CREATE (:N {v: x})")
+
+    def test01_suspended_parallel_scan(self):
+        # scan is paused in between reads and resumed by the next read
+        q = "MATCH (n:N) WHERE n.v % 10 = 0 RETURN n.v"
+        res = self.conn.execute_command("GRAPH.QUERY", GRAPH_ID, q, "--compact",
+                                        "CURSOR", 1000)
+        cursor = res[-1]
+        rows = query_result.QueryResult(self.graph, res[:-1]).result_set
+        self.env.assertNotEqual(cursor, 0)
+
+        while cursor != 0:
+            res = self.conn.execute_command("GRAPH.CURSOR", "READ", GRAPH_ID,
+                                            cursor)
+            cursor = res[-1]
+            rows += query_result.QueryResult(self.graph, res[:-1]).result_set
+
+        self.env.assertEqual(rows, [[i] for i in range(10, 100001, 10)])
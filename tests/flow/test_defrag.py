@@ -0,0 +1,161 @@
+import time
+from common import *
+from index_utils import *
+
+GRAPH_ID = "defrag"
+
+
+# defragmentation steps run as separate writer tasks, interleaving with writes
+# wait for node and edge IDs to become contiguous
+def wait_for_defrag(env, graph):
+    q = """MATCH (a) WITH count(a) AS n, max(ID(a)) AS m
+           OPTIONAL MATCH ()-[e]->() RETURN n = m + 1, count(e) = max(ID(e)) + 1"""
+    for _ in range(100):
+        if graph.query(q).result_set[0] == [True, True]:
+            break
+        time.sleep(0.1)
+    env.assertEqual(graph.query(q).result_set[0], [True, True])
+redis_con = None
+redis_graph = None
+
+
+class testDefrag(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, GRAPH_ID)
+
+    def defrag(self):
+        res = redis_con.execute_command("GRAPH.DEBUG", "DEFRAG", GRAPH_ID)
+        self.env.assertEqual(res, "OK")
+        wait_for_defrag(self.env, redis_graph)
+
+    def test01_defrag_missing_graph(self):
+        try:
+            redis_con.execute_command("GRAPH.DEBUG", "DEFRAG", "missing")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+
+    def test02_defrag(self):
+        # create nodes connected in a chain, self loops and multi-edges
+        q = """UNWIND range(0, 999) AS x
+               CREATE (:A {v: x})"""
+        redis_graph.query(q)
+
+        q = """MATCH (a:A), (b:A) WHERE b.v = a.v + 1
+               CREATE (a)-[:R {v: a.v}]->(b), (a)-[:R {v: -a.v}]->(b)"""
+        redis_graph.query(q)
+
+        q = """MATCH (a:A) WHERE a.v % 10 = 0
+               CREATE (a)-[:S {v: a.v}]->(a)"""
+        redis_graph.query(q)
+
+        create_node_exact_match_index(redis_graph, 'A', 'v', sync=True)
+        create_edge_exact_match_index(redis_graph, 'R', 'v', sync=True)
+
+        # delete every odd node, leaving holes in node and edge storage
+        redis_graph.query("MATCH (a:A) WHERE a.v % 2 = 1 DELETE a")
+
+        # capture graph's state prior to defragmentation
+        queries = [
+            "MATCH (a:A) RETURN count(a)",
+            "MATCH (a:A) RETURN a.v ORDER BY a.v",
+            "MATCH (a:A)-[r:R]->(b:A) RETURN a.v, r.v, b.v ORDER BY a.v, r.v",
+            "MATCH (a:A)-[:S]->(b) RETURN a.v, b.v ORDER BY a.v",
+            "MATCH (a:A)<-[:S]-(b) RETURN a.v, b.v ORDER BY a.v",
+            "MATCH (a:A {v: 500}) RETURN a.v",
+            "MATCH ()-[r:R {v: 498}]->() RETURN r.v",
+        ]
+        expected = [redis_graph.query(q).result_set for q in queries]
+
+        self.defrag()
+
+        # node and edge IDs are contiguous
+        res = redis_graph.query("MATCH (a) RETURN max(ID(a)), count(a)").result_set
+        self.env.assertEqual(res[0][0], res[0][1] - 1)
+        res = redis_graph.query("MATCH ()-[e]->() RETURN max(ID(e)), count(e)").result_set
+        self.env.assertEqual(res[0][0], res[0][1] - 1)
+
+        # graph content and indices are unaffected
+        for q, e in zip(queries, expected):
+            self.env.assertEqual(redis_graph.query(q).result_set, e)
+
+        # index lookups find renumbered entities
+        plan = redis_graph.execution_plan(queries[5])
+        self.env.assertIn("Node By Index Scan", plan)
+        plan = redis_graph.execution_plan(queries[6])
+        self.env.assertIn("Edge By Index Scan", plan)
+
+        # graph accepts new entities after defragmentation
+        res = redis_graph.query("CREATE (a:A {v: 1000})-[:R {v: 1000}]->(a)")
+        self.env.assertEqual(res.nodes_created, 1)
+        self.env.assertEqual(res.relationships_created, 1)
+        res = redis_graph.query("MATCH (a:A {v: 1000})-[r:R]->(a) RETURN r.v").result_set
+        self.env.assertEqual(res, [[1000]])
+
+
+class testDefragReplication(FlowTestsBase):
+    def __init__(self):
+        # skip test if we're running under Valgrind
+        if VALGRIND or SANITIZER != "":
+            Env.skip(None) # valgrind is not working correctly with replication
+
+        self.env = Env(decodeResponses=True, env='oss', useSlaves=True)
+
+    def test01_defrag_replication(self):
+        source_con = self.env.getConnection()
+        replica_con = self.env.getSlaveConnection()
+        graph = Graph(source_con, GRAPH_ID)
+        replica = Graph(replica_con, GRAPH_ID)
+
+        # enable write commands on slave, required as all RedisGraph
+        # commands are registered as write commands
+        replica_con.config_set("slave-read-only", "no")
+
+        graph.query("UNWIND range(0, 9999) AS x CREATE (:A {v: x})")
+        graph.query("""MATCH (a:A), (b:A) WHERE b.v = a.v + 1
+                       CREATE (a)-[:R {v: a.v}]->(b), (a)-[:R {v: -a.v}]->(b)""")
+        graph.query("MATCH (a:A) WHERE a.v % 3 = 0 DELETE a")
+
+        res = source_con.execute_command("GRAPH.DEBUG", "DEFRAG", GRAPH_ID)
+        self.env.assertEqual(res, "OK")
+
+        # writes issued while defragmentation is in progress
+        for i in range(10):
+            source_con.execute_command("GRAPH.QUERY", GRAPH_ID,
+                    f"MATCH (a:A {{v: {i * 3 + 1}}}) DELETE a")
+        wait_for_defrag(self.env, graph)
+
+        # the WAIT command forces master slave sync to complete
+        source_con.execute_command("WAIT", "1", "0")
+
+        # replica renumbered entities exactly as the master did
+        queries = [
+            "MATCH (a) RETURN ID(a), a.v ORDER BY ID(a)",
+            "MATCH (a)-[e]->(b) RETURN ID(e), ID(a), ID(b), e.v ORDER BY ID(e)",
+        ]
+        for q in queries:
+            expected = graph.query(q).result_set
+            self.env.assertEqual(replica.query(q).result_set, expected)
+
+        # steps issued by clients are rejected
+        try:
+            source_con.execute_command("GRAPH.DEBUG", "DEFRAG", GRAPH_ID,
+                    "EDGES", "0", "0", "10")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("reserved for replication", str(e))
+
+        # defragmentation is scheduled on the primary only
+        try:
+            replica_con.execute_command("GRAPH.DEBUG", "DEFRAG", GRAPH_ID)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("only be scheduled on the primary", str(e))
+
+        # other debug subcommands remain available on the replica
+        res = replica_con.execute_command("GRAPH.DEBUG", "CACHE", GRAPH_ID)
+        self.env.assertEqual(len(res), 6)
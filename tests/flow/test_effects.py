@@ -0,0 +1,123 @@
+from common import *
+from index_utils import *
+
+GRAPH_ID = "effects"
+
+
+# with REPLICATE_EFFECTS enabled write queries are replicated as effects
+# a binary changelog of the modifications performed by the query
+# which replicas apply using GRAPH.EFFECT instead of re-executing the query
+
+class testEffects():
+    def __init__(self):
+        # skip test if we're running under Valgrind
+        if VALGRIND or SANITIZER != "":
+            Env.skip(None) # valgrind is not working correctly with replication
+
+        self.env = Env(decodeResponses=True, env='oss', useSlaves=True)
+        self.source_con = self.env.getConnection()
+        self.replica_con = self.env.getSlaveConnection()
+
+        # enable write commands on slave, required as all RedisGraph
+        # commands are registered as write commands
+        self.replica_con.config_set("slave-read-only", "no")
+
+        self.source_con.execute_command("GRAPH.CONFIG", "SET",
+                                        "REPLICATE_EFFECTS", "yes")
+
+        self.graph = Graph(self.source_con, GRAPH_ID)
+        self.replica = Graph(self.replica_con, GRAPH_ID)
+
+    def wait_for_replica(self):
+        # the WAIT command forces master slave sync to complete
+        self.source_con.execute_command("WAIT", "1", "0")
+
+    def assert_graphs_eq(self):
+        self.wait_for_replica()
+
+        queries = ["MATCH (n) RETURN n ORDER BY ID(n)",
+                   "MATCH ()-[e]->() RETURN e ORDER BY ID(e)",
+                   "CALL db.labels() YIELD label RETURN label ORDER BY label",
+                   "CALL db.propertyKeys() YIELD propertyKey RETURN propertyKey ORDER BY propertyKey",
+                   "CALL db.relationshipTypes() YIELD relationshipType RETURN relationshipType ORDER BY relationshipType"]
+
+        for q in queries:
+            result = self.graph.query(q).result_set
+            replica_result = self.replica.query(q).result_set
+            self.env.assertEquals(replica_result, result)
+
+    def test01_create(self):
+        self.graph.query("""UNWIND range(0, 9) AS x
+                            CREATE (:L {v: x, s: toString(x), a: [x, 'a', [1.5]]})
+                            -[:R {w: x * 0.5, b: x % 2 = 0}]->
+                            (:M:N {p: point({latitude: x, longitude: x})})""")
+        self.assert_graphs_eq()
+
+    def test02_update(self):
+        self.graph.query("MATCH (n:L) WHERE n.v < 5 SET n.v = n.v * 10, n.v = n.v + 1, n.new = 'x'")
+        self.graph.query("MATCH (n:L) WHERE n.v = 9 SET n = {replaced: true}")
+        self.graph.query("MATCH (:L)-[e:R]->() WHERE e.b SET e.w = NULL, e.c = 'c'")
+        self.assert_graphs_eq()
+
+        # attributes introduced after the entity was created
+        self.graph.query("CREATE (n:L {v: 200}) SET n.new_attr = 2")
+        self.graph.query("CREATE (:L {v: 201})-[e:R {w: 1}]->(:L {v: 202}) SET e.new_edge_attr = 3")
+        self.assert_graphs_eq()
+
+    def test03_labels(self):
+        self.graph.query("MATCH (n:M) WITH n LIMIT 5 SET n:X:Y REMOVE n:N")
+        self.graph.query("CREATE (n:Z) REMOVE n:Z SET n:W")
+        self.assert_graphs_eq()
+
+        # labels introduced after the node was created
+        self.graph.query("CREATE (n:L {v: 203}) SET n:Late, n.late = true")
+        self.assert_graphs_eq()
+
+    def test04_merge(self):
+        self.graph.query("UNWIND range(0, 19) AS x MERGE (n:L {v: x}) ON CREATE SET n.merged = true ON MATCH SET n.matched = true")
+        self.graph.query("MATCH (a:L), (b:L) WHERE a.v = b.v + 1 MERGE (a)-[:NEXT]->(b)")
+        self.assert_graphs_eq()
+
+    def test05_delete(self):
+        self.graph.query("MATCH (n:L) WHERE n.v % 3 = 0 DETACH DELETE n")
+        self.graph.query("MATCH ()-[e:NEXT]->() WITH e LIMIT 3 DELETE e")
+        self.assert_graphs_eq()
+
+    def test06_reuse_deleted_ids(self):
+        # created entities reuse the ids of deleted entities
+        self.graph.query("UNWIND range(0, 9) AS x CREATE (:Reuse {v: x})-[:R]->(:Reuse)")
+        self.assert_graphs_eq()
+
+        # create and delete entities within the same query
+        self.graph.query("CREATE (a:T {v: 1})-[:R]->(b:T) DELETE a, b CREATE (:T {v: 2})")
+        self.assert_graphs_eq()
+
+    def test07_index(self):
+        # index operations are replicated as queries
+        create_node_exact_match_index(self.graph, 'L', 'v', sync=True)
+        self.graph.query("CREATE (:L {v: 100})")
+        self.wait_for_replica()
+        wait_for_indices_to_sync(self.replica)
+
+        q = "MATCH (n:L {v: 100}) RETURN n.v"
+        plan = self.graph.execution_plan(q)
+        replica_plan = self.replica.execution_plan(q)
+        self.env.assertIn("Index Scan", plan)
+        self.env.assertEquals(replica_plan, plan)
+        self.env.assertEquals(self.replica.query(q).result_set, [[100]])
+
+    def test08_failed_query(self):
+        # failed queries are rolled back and aren't replicated
+        try:
+            self.graph.query("CREATE (:F {v: 1}) WITH 1 AS x RETURN 1 / 0")
+        except ResponseError:
+            pass
+        self.assert_graphs_eq()
+
+    def test09_effect_reserved_for_replication(self):
+        # effects are only accepted from the primary
+        try:
+            self.source_con.execute_command("GRAPH.EFFECT", GRAPH_ID, "\x01")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("reserved for replication", str(e))
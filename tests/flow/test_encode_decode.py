@@ -2,6 +2,7 @@ from common import *
 from index_utils import *
 from random_graph import create_random_schema, create_random_graph, run_random_graph_ops, ALL_OPS
 import re
+import time
 
 redis_con = None
 
@@ -343,3 +344,101 @@ class test_encode_decode(FlowTestsBase):
 
         compare_nodes_result_set(self.env, nodes_before.result_set, nodes_after.result_set)
         self.env.assertEquals(edges_before.result_set, edges_after.result_set)
+
+    # BGSAVE encodes entity chunks on multiple threads within a forked process
+    # make sure the produced RDB loads the same graph
+    def test13_bgsave_encoding(self):
+        redis_con.flushall()
+
+        graph_name = "bgsave_encoding"
+        redis_graph = Graph(redis_con, graph_name)
+
+        # span multiple virtual keys
+        redis_con.execute_command(
+            "GRAPH.CONFIG SET VKEY_MAX_ENTITY_COUNT 30000")
+
+        # nodes, single edges and multi-edge entries
+        redis_graph.query("""UNWIND range(0, 25000) AS i
+                             CREATE (n:L {v: i, s: toString(i), a: [i, 'x', [i]]}),
+                                    (m:L:M {v: i, p: point({latitude: 1.0, longitude: 2.0})}),
+                                    (n)-[:R {v: i}]->(m), (n)-[:R {s: 'x'}]->(m),
+                                    (m)-[:S]->(n)""")
+
+        # introduce deleted entities
+        redis_graph.query("MATCH (n:L) WHERE n.v % 7 = 0 DETACH DELETE n")
+
+        nodes_query = "MATCH (n) RETURN n ORDER BY id(n)"
+        edges_query = "MATCH ()-[e]->() RETURN e ORDER BY id(e)"
+        nodes_before = redis_graph.query(nodes_query)
+        edges_before = redis_graph.query(edges_query)
+
+        # save RDB from a forked process
+        redis_con.execute_command("BGSAVE")
+        while True:
+            info = redis_con.execute_command("INFO", "persistence")
+            if info['rdb_bgsave_in_progress'] == 0:
+                break
+            time.sleep(0.1)
+        self.env.assertEquals(info['rdb_last_bgsave_status'], "ok")
+
+        # load RDB produced by BGSAVE
+        redis_con.execute_command("DEBUG", "RELOAD", "NOSAVE")
+
+        nodes_after = redis_graph.query(nodes_query)
+        edges_after = redis_graph.query(edges_query)
+
+        compare_nodes_result_set(self.env, nodes_before.result_set, nodes_after.result_set)
+        self.env.assertEquals(edges_before.result_set, edges_after.result_set)
+
+    # label, relationship and adjacency matrices are built at once
+    # after all keys are decoded, validate every matrix is reconstructed
+    def test14_decode_builds_matrices(self):
+        redis_con.flushall()
+
+        graph_name = "decode_builds_matrices"
+        redis_graph = Graph(redis_con, graph_name)
+
+        redis_con.execute_command(
+            "GRAPH.CONFIG SET VKEY_MAX_ENTITY_COUNT 10")
+
+        # multi-labeled nodes, single edges, multi-edge entries
+        # and edges of different types sharing endpoints
+        redis_graph.query("""UNWIND range(0, 30) AS i
+                             CREATE (a:A {v: i}), (b:A:B {v: i}),
+                                    (a)-[:R {v: 0}]->(b), (a)-[:R {v: 1}]->(b),
+                                    (a)-[:R {v: 2}]->(b), (a)-[:S]->(b),
+                                    (b)-[:S]->(a)""")
+
+        # reuse deleted ids
+        redis_graph.query("MATCH (a:A)-[r:R {v: 1}]->() WHERE a.v % 3 = 0 DELETE r")
+        redis_graph.query("MATCH (a:A {v: 0}), (b:B {v: 1}) CREATE (a)-[:R {v: 3}]->(b)")
+
+        queries = [
+            "MATCH (n:A) RETURN count(n)",
+            "MATCH (n:B) RETURN count(n)",
+            "MATCH (n:A:B) RETURN count(n)",
+            "MATCH (n) RETURN id(n), labels(n) ORDER BY id(n)",
+            # relationship matrices
+            "MATCH (a)-[r:R]->(b) RETURN id(a), id(b), collect(r.v) ORDER BY id(a), id(b)",
+            "MATCH (a)-[r:S]->(b) RETURN id(a), id(b), id(r) ORDER BY id(r)",
+            # transposed relationship matrices
+            "MATCH (b)<-[r:R]-(a) RETURN id(b), id(a), id(r) ORDER BY id(r)",
+            # adjacency matrix and its transpose
+            "MATCH (a)-->(b) RETURN id(a), id(b), count(1) ORDER BY id(a), id(b)",
+            "MATCH (b)<--(a) RETURN id(b), id(a), count(1) ORDER BY id(b), id(a)",
+            "MATCH (a {v: 0})-[*1..2]->(b) RETURN count(b)",
+        ]
+
+        results_before = [redis_graph.query(q).result_set for q in queries]
+
+        # save RDB & load from RDB
+        redis_con.execute_command("DEBUG", "RELOAD")
+
+        for q, expected in zip(queries, results_before):
+            actual = redis_graph.query(q).result_set
+            self.env.assertEquals(expected, actual)
+
+        # graph remains writable
+        redis_graph.query("MATCH (a:A {v: 0}), (b:B {v: 0}) CREATE (a)-[:R {v: 4}]->(b)")
+        res = redis_graph.query("MATCH (a:A {v: 0})-[r:R]->(b:B {v: 0}) RETURN count(r)")
+        self.env.assertEquals(res.result_set[0][0], 3)
@@ -0,0 +1,123 @@
+from common import *
+
+GRAPH_ID = "external_sort"
+ROW_COUNT = 100000
+MB = 1024 * 1024
+graph = None
+redis_con = None
+
+
+def type_rank(v):
+    # cross type ordering: strings < booleans < numbers < null
+    if isinstance(v, str):
+        return 0
+    if isinstance(v, bool):
+        return 1
+    if v is None:
+        return 3
+    return 2
+
+
+def sort_key(v):
+    return (type_rank(v), 0 if v is None else v)
+
+
+class testExternalSort(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='THREAD_COUNT 4')
+        global graph
+        global redis_con
+        redis_con = self.env.getConnection()
+        graph = Graph(redis_con, GRAPH_ID)
+
+    def set_mem_capacity(self, cap):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", cap)
+
+    def test01_parallel_sort(self):
+        # large inputs are sorted as multiple runs which are then merged
+        q = """UNWIND range(0, $n - 1) AS x
+               RETURN x % 1000 AS a, x
+               ORDER BY a DESC, x"""
+        res = graph.query(q, {'n': ROW_COUNT}).result_set
+        expected = sorted([[x % 1000, x] for x in range(ROW_COUNT)],
+                          key=lambda row: (-row[0], row[1]))
+        self.env.assertEqual(res, expected)
+
+    def test02_mixed_types(self):
+        q = """UNWIND range(0, $n - 1) AS x
+               WITH CASE x % 5
+                    WHEN 0 THEN x
+                    WHEN 1 THEN -toFloat(x) / 3
+                    WHEN 2 THEN 'v' + toString(x)
+                    WHEN 3 THEN x % 2 = 0
+                    ELSE null END AS v
+               RETURN v
+               ORDER BY v"""
+        res = [row[0] for row in graph.query(q, {'n': ROW_COUNT}).result_set]
+        self.env.assertEqual(len(res), ROW_COUNT)
+        self.env.assertEqual(res, sorted(res, key=sort_key))
+
+        q = q + " DESC"
+        res = [row[0] for row in graph.query(q, {'n': ROW_COUNT}).result_set]
+        self.env.assertEqual(len(res), ROW_COUNT)
+        self.env.assertEqual(res, sorted(res, key=sort_key, reverse=True))
+
+    def test03_shared_prefix(self):
+        # strings sharing a long prefix are compared in full
+        q = """UNWIND range(0, $n - 1) AS x
+               RETURN 'shared prefix ' + toString(x % 7919) AS s, x
+               ORDER BY s, x DESC"""
+        res = graph.query(q, {'n': ROW_COUNT}).result_set
+        expected = sorted([['shared prefix ' + str(x % 7919), x] for x in range(ROW_COUNT)],
+                          key=lambda row: (row[0], -row[1]))
+        self.env.assertEqual(res, expected)
+
+    def test04_spill_scalars(self):
+        # a sort exceeding a fraction of the query memory capacity
+        # spills sorted runs to disk
+        n = 200000
+        self.set_mem_capacity(16 * MB)
+        try:
+            q = """UNWIND range(1, $n) AS x
+                   WITH x, 'value ' + toString(x) + ' padding padding padding padding' AS s
+                   ORDER BY s DESC
+                   SKIP $skip
+                   RETURN x, s"""
+            res = graph.query(q, {'n': n, 'skip': n - 10}).result_set
+        finally:
+            self.set_mem_capacity(0)
+
+        expected = sorted([[x, 'value ' + str(x) + ' padding padding padding padding'] for x in range(1, n + 1)],
+                          key=lambda row: row[1], reverse=True)[n - 10:]
+        self.env.assertEqual(res, expected)
+
+    def test05_spill_entities(self):
+        # spilled graph entities are re-fetched from the graph
+        n = 50000
+        graph.query("UNWIND range(0, $n - 1) AS x CREATE (:N {v: x})-[:R {v: x}]->(:M {v: x})", {'n': n})
+
+        self.set_mem_capacity(8 * MB)
+        try:
+            q = """MATCH p = (a:N)-[e:R]->(b:M)
+                   WITH a, e, b, p, [a.v, {v: b.v}] AS l
+                   ORDER BY a.v % 1000, a.v
+                   SKIP $skip
+                   RETURN a.v, e.v, b.v, labels(b), length(p), l"""
+            res = graph.query(q, {'skip': n - 5}).result_set
+        finally:
+            self.set_mem_capacity(0)
+
+        values = sorted(range(n), key=lambda x: (x % 1000, x))[n - 5:]
+        expected = [[v, v, v, ['M'], 1, [v, {'v': v}]] for v in values]
+        self.env.assertEqual(res, expected)
+
+    def test06_sort_with_limit(self):
+        q = """UNWIND range(0, $n - 1) AS x
+               RETURN x % 977 AS a, x
+               ORDER BY a DESC, x
+               SKIP 5 LIMIT 10"""
+        res = graph.query(q, {'n': ROW_COUNT}).result_set
+        expected = sorted([[x % 977, x] for x in range(ROW_COUNT)],
+                          key=lambda row: (-row[0], row[1]))[5:15]
+        self.env.assertEqual(res, expected)
+
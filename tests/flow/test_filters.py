@@ -95,3 +95,31 @@ class testFilters():
 
         res = g.query("WITH 1 AS x WHERE 0.0 / 0.0 <> 0.0 / 0.0 RETURN x")
         self.env.assertEquals(res.result_set, [[1]])
+
+    def test03_filter_attributes_and_params(self):
+        g = Graph(self.env.getConnection(), "g_compiled")
+        g.query("UNWIND range(1, 20) AS x CREATE (:N {v: x, d: x / 2.0, s: toString(x)})")
+        # node without any of the filtered attributes
+        g.query("CREATE (:N)")
+
+        # integer, floating point and mixed comparisons against attributes
+        cases = [("n.v > 15", lambda v: v > 15),
+                 ("n.v >= $p", lambda v: v >= 7),
+                 ("n.d < $p", lambda v: v / 2.0 < 7),
+                 ("n.v = n.d * 2 AND n.v <> 4", lambda v: v != 4),
+                 ("$p > n.v OR n.s = '19'", lambda v: v < 7 or v == 19),
+                 ("NOT (n.v <= 18 XOR n.d > 3)", lambda v: not ((v <= 18) != (v / 2.0 > 3))),
+                 ("n.s > 5", lambda v: False),
+                 ("n.missing = 1 OR n.v = 1", lambda v: v == 1)]
+
+        for cond, f in cases:
+            q = "MATCH (n:N) WHERE %s RETURN n.v ORDER BY n.v" % cond
+            result = g.query(q, {'p': 7})
+            expected = [[v] for v in range(1, 21) if f(v)]
+            self.env.assertEqual(result.result_set, expected)
+
+        # attribute introduced after the query was cached
+        q = "MATCH (n:N) WHERE n.late = 1 RETURN count(n)"
+        self.env.assertEqual(g.query(q).result_set, [[0]])
+        g.query("MATCH (n:N {v: 3}) SET n.late = 1")
+        self.env.assertEqual(g.query(q).result_set, [[1]])
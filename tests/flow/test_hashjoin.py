@@ -35,3 +35,62 @@ class testHashJoin(FlowTestsBase):
 
         self.env.assertEquals(actual_result.result_set, expected_result)
 
+
+    def test_hashjoin_duplicate_values(self):
+        graph = Graph(self.env.getConnection(), "hashjoin_duplicates")
+        graph.query("UNWIND range(0, 1999) AS i CREATE (:A {v: i % 100, i: i})")
+        graph.query("UNWIND range(0, 499) AS i CREATE (:B {v: i % 50, i: i})")
+
+        q = """MATCH (a:A), (b:B) WHERE a.v = b.v
+               RETURN count(*), sum(a.i), sum(b.i)"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Value Hash Join", plan)
+
+        a = [(i % 100, i) for i in range(2000)]
+        b = [(i % 50, i) for i in range(500)]
+        pairs = [(x, y) for x in a for y in b if x[0] == y[0]]
+        expected = [[len(pairs), sum(x[1] for x, _ in pairs), sum(y[1] for _, y in pairs)]]
+        self.env.assertEquals(graph.query(q).result_set, expected)
+
+    def test_hashjoin_mixed_types(self):
+        graph = Graph(self.env.getConnection(), "hashjoin_mixed_types")
+        graph.query("""UNWIND [1, 2.5, 'a', true, [1, 2], null, 3] AS v
+                       CREATE (:A {v: v})""")
+        graph.query("""UNWIND [1.0, 2.5, 'a', true, [1.0, 2], 4] AS v
+                       CREATE (:B {v: v})""")
+        graph.query("CREATE (:A {v: date('2020-01-01')}), (:B {v: date('2020-01-01')})")
+
+        # integers and floats holding the same value are joined
+        # nulls never intersect
+        q = """MATCH (a:A), (b:B) WHERE a.v = b.v
+               RETURN count(*)"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Value Hash Join", plan)
+        self.env.assertEquals(graph.query(q).result_set, [[6]])
+
+        # compare against filtering the cartesian product
+        q = """MATCH (a:A), (b:B) WHERE a.v = b.v
+               RETURN id(a), id(b) ORDER BY id(a), id(b)"""
+        expected = """MATCH (a:A), (b:B) WITH a, b WHERE a.v = b.v
+                      RETURN id(a), id(b) ORDER BY id(a), id(b)"""
+        self.env.assertNotIn("Value Hash Join", graph.execution_plan(expected))
+        self.env.assertEquals(graph.query(q).result_set,
+                              graph.query(expected).result_set)
+
+    def test_hashjoin_spill(self):
+        redis_con = self.env.getConnection()
+        graph = Graph(redis_con, "hashjoin_spill")
+        graph.query("UNWIND range(0, 49999) AS i CREATE (:A {v: i % 5000, s: 'a' + toString(i)})")
+        graph.query("UNWIND range(0, 9999) AS i CREATE (:B {v: i})")
+
+        q = """MATCH (a:A), (b:B) WHERE a.v = b.v
+               RETURN count(*), sum(b.v), count(DISTINCT a.s)"""
+        expected = [[50000, sum(i % 5000 for i in range(50000)), 50000]]
+        self.env.assertEquals(graph.query(q).result_set, expected)
+
+        # cap query memory, cached records are partitioned and spilled to disk
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 64 * 1024 * 1024)
+        try:
+            self.env.assertEquals(graph.query(q).result_set, expected)
+        finally:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 0)
@@ -0,0 +1,150 @@
+from common import *
+from itertools import product
+
+GRAPH_ID = "leapfrog_join"
+NODE_COUNT = 30
+
+graph = None
+edges = None
+
+
+class testLeapfrogJoin(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global graph
+        graph = Graph(self.env.getConnection(), GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        global edges
+        edges = set()
+        for i in range(NODE_COUNT):
+            for j in [(i * 7 + 3) % NODE_COUNT, (i * 11 + 5) % NODE_COUNT, (i + 1) % NODE_COUNT]:
+                if i != j:
+                    edges.add((i, j))
+
+        graph.query("UNWIND range(0, $n - 1) AS i CREATE (:P {v: i})", {'n': NODE_COUNT})
+        graph.query("""UNWIND $edges AS e
+                       MATCH (a:P {v: e[0]}), (b:P {v: e[1]})
+                       CREATE (a)-[:T]->(b)""", {'edges': [list(e) for e in edges]})
+
+    def connected(self, a, b):
+        return (a, b) in edges
+
+    def test01_directed_cycle(self):
+        q = """MATCH (a:P)-[:T]->(b:P)-[:T]->(c:P)-[:T]->(a)
+               RETURN a.v, b.v, c.v ORDER BY a.v, b.v, c.v"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Leapfrog Join", plan)
+        self.env.assertNotIn("Expand Into", plan)
+
+        expected = [[a, b, c] for a, b, c in product(range(NODE_COUNT), repeat=3)
+                    if self.connected(a, b) and self.connected(b, c) and self.connected(c, a)]
+        self.env.assertGreater(len(expected), 0)
+        self.env.assertEquals(graph.query(q).result_set, expected)
+
+    def test02_undirected_cycle(self):
+        # a -> b -> c and a -> c
+        q = """MATCH (a)-[:T]->(b)-[:T]->(c), (a)-[:T]->(c)
+               RETURN a.v, b.v, c.v ORDER BY a.v, b.v, c.v"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Leapfrog Join", plan)
+
+        expected = [[a, b, c] for a, b, c in product(range(NODE_COUNT), repeat=3)
+                    if self.connected(a, b) and self.connected(b, c) and self.connected(a, c)]
+        self.env.assertGreater(len(expected), 0)
+        self.env.assertEquals(graph.query(q).result_set, expected)
+
+    def test03_bidirectional_edges(self):
+        q = """MATCH (a)-[:T]-(b)-[:T]-(c)-[:T]-(a)
+               RETURN a.v, b.v, c.v ORDER BY a.v, b.v, c.v"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Leapfrog Join", plan)
+
+        def adjacent(x, y):
+            return self.connected(x, y) or self.connected(y, x)
+
+        expected = [[a, b, c] for a, b, c in product(range(NODE_COUNT), repeat=3)
+                    if adjacent(a, b) and adjacent(b, c) and adjacent(c, a)]
+        self.env.assertEquals(graph.query(q).result_set, expected)
+
+    def test04_filtered_cycle(self):
+        q = """MATCH (a:P)-[:T]->(b)-[:T]->(c)-[:T]->(d)-[:T]->(a)
+               WHERE a.v < 10 AND d.v > 5
+               RETURN a.v, b.v, c.v, d.v ORDER BY a.v, b.v, c.v, d.v"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Leapfrog Join", plan)
+
+        expected = [[a, b, c, d] for a, b, c, d in product(range(NODE_COUNT), repeat=4)
+                    if a < 10 and d > 5 and self.connected(a, b) and self.connected(b, c)
+                    and self.connected(c, d) and self.connected(d, a)]
+        self.env.assertGreater(len(expected), 0)
+        self.env.assertEquals(graph.query(q).result_set, expected)
+
+    def test05_bound_variables(self):
+        # 'a' and 'c' are bound by the first clause
+        q = """MATCH (a:P), (c:P) WHERE a.v = 3 AND c.v < 20
+               WITH a, c
+               MATCH (a)-[:T]->(b)-[:T]->(c)-[:T]->(a)
+               RETURN a.v, b.v, c.v ORDER BY a.v, b.v, c.v"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Leapfrog Join", plan)
+
+        expected = [[3, b, c] for b, c in product(range(NODE_COUNT), range(20))
+                    if self.connected(3, b) and self.connected(b, c) and self.connected(c, 3)]
+        self.env.assertEquals(graph.query(q).result_set, expected)
+
+    def test06_relationship_types(self):
+        # missing relationship type
+        q = """MATCH (a)-[:T]->(b)-[:NONE]->(c)-[:T]->(a)
+               RETURN a.v, b.v, c.v"""
+        self.env.assertIn("Leapfrog Join", graph.execution_plan(q))
+        self.env.assertEquals(graph.query(q).result_set, [])
+
+        # missing relationship type as an alternative
+        q = """MATCH (a)-[:T]->(b)-[:T|NONE]->(c)-[:T]->(a)
+               RETURN a.v, b.v, c.v ORDER BY a.v, b.v, c.v"""
+        expected = """MATCH (a)-[:T]->(b)-[:T]->(c)-[:T]->(a)
+                      RETURN a.v, b.v, c.v ORDER BY a.v, b.v, c.v"""
+        self.env.assertEquals(graph.query(q).result_set,
+                              graph.query(expected).result_set)
+
+        # missing label
+        q = """MATCH (a)-[:T]->(b:NONE)-[:T]->(c)-[:T]->(a)
+               RETURN a.v, b.v, c.v"""
+        self.env.assertEquals(graph.query(q).result_set, [])
+
+    def test07_traversal_fallback(self):
+        # referenced edges are collected by traversals
+        q = """MATCH (a)-[e:T]->(b)-[:T]->(c)-[:T]->(a)
+               RETURN a.v, b.v, c.v, type(e) ORDER BY a.v, b.v, c.v"""
+        plan = graph.execution_plan(q)
+        self.env.assertNotIn("Leapfrog Join", plan)
+
+        expected = """MATCH (a)-[:T]->(b)-[:T]->(c)-[:T]->(a)
+                      RETURN a.v, b.v, c.v, 'T' ORDER BY a.v, b.v, c.v"""
+        self.env.assertEquals(graph.query(q).result_set,
+                              graph.query(expected).result_set)
+
+        # unreferenced intermediate node
+        q = """MATCH (a)-[:T]->(b)-[:T]->(c)-[:T]->(a)
+               RETURN a.v, b.v"""
+        self.env.assertNotIn("Leapfrog Join", graph.execution_plan(q))
+
+        # variable length edge
+        q = """MATCH (a)-[:T*1..2]->(b)-[:T]->(c)-[:T]->(a)
+               RETURN a.v, b.v, c.v"""
+        self.env.assertNotIn("Leapfrog Join", graph.execution_plan(q))
+
+    def test08_pending_changes(self):
+        # introduce a triangle without flushing pending matrix changes
+        q = """CREATE (a:Q {v: 0})-[:T]->(b:Q {v: 1})-[:T]->(c:Q {v: 2})-[:T]->(a)
+               WITH a
+               MATCH (a)-[:T]->(b)-[:T]->(c)-[:T]->(a)
+               RETURN a.v, b.v, c.v"""
+        self.env.assertEquals(graph.query(q).result_set, [[0, 1, 2]])
+
+        q = """MATCH (a:Q)-[:T]->(b)-[:T]->(c)-[:T]->(a)
+               RETURN a.v, b.v, c.v ORDER BY a.v"""
+        self.env.assertEquals(graph.query(q).result_set,
+                              [[0, 1, 2], [1, 2, 0], [2, 0, 1]])
@@ -0,0 +1,87 @@
+from common import *
+from math import ceil
+from statistics import stdev, pstdev
+
+GRAPH_ID = "parallel_aggregation"
+ROW_COUNT = 50000
+GROUP_COUNT = 10
+graph = None
+
+
+class testParallelAggregation(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='THREAD_COUNT 4')
+        global graph
+        graph = Graph(self.env.getConnection(), GRAPH_ID)
+
+    def test01_grouped_aggregation(self):
+        # large inputs are aggregated by multiple workers
+        q = """UNWIND range(0, $n - 1) AS x
+               RETURN x % $g AS k, count(x), sum(x), min(x), max(x), avg(x),
+               stDev(x), stDevP(x), percentileDisc(x, 0.5)
+               ORDER BY k"""
+        res = graph.query(q, {'n': ROW_COUNT, 'g': GROUP_COUNT}).result_set
+        self.env.assertEqual(len(res), GROUP_COUNT)
+
+        for row in res:
+            k = row[0]
+            values = [x for x in range(ROW_COUNT) if x % GROUP_COUNT == k]
+            self.env.assertEqual(row[1], len(values))
+            self.env.assertEqual(row[2], sum(values))
+            self.env.assertEqual(row[3], min(values))
+            self.env.assertEqual(row[4], max(values))
+            self.env.assertAlmostEqual(row[5], sum(values) / len(values), 0.0001)
+            self.env.assertAlmostEqual(row[6], stdev(values), 0.0001)
+            self.env.assertAlmostEqual(row[7], pstdev(values), 0.0001)
+            self.env.assertEqual(row[8], values[ceil(0.5 * len(values)) - 1])
+
+    def test02_ungrouped_aggregation(self):
+        q = """UNWIND range(0, $n - 1) AS x
+               RETURN count(x), sum(x), collect(x)"""
+        res = graph.query(q, {'n': ROW_COUNT}).result_set
+        self.env.assertEqual(res[0][0], ROW_COUNT)
+        self.env.assertEqual(res[0][1], sum(range(ROW_COUNT)))
+        # collect preserves the order in which values are consumed
+        self.env.assertEqual(res[0][2], list(range(ROW_COUNT)))
+
+        q = """UNWIND range(0, $n - 1) AS x
+               WITH x ORDER BY x DESC
+               RETURN collect(x)"""
+        res = graph.query(q, {'n': ROW_COUNT}).result_set
+        self.env.assertEqual(res[0][0], list(reversed(range(ROW_COUNT))))
+
+    def test03_distinct_aggregation(self):
+        # distinct aggregations are performed serially
+        q = """UNWIND range(0, $n - 1) AS x
+               RETURN x % 2 AS k, count(DISTINCT x % 100) ORDER BY k"""
+        res = graph.query(q, {'n': ROW_COUNT}).result_set
+        self.env.assertEqual(res, [[0, 50], [1, 50]])
+
+    def test04_aggregate_shared_values(self):
+        # values produced by a dynamic UNWIND are aggregated
+        # after the producing list was replaced
+        q = """UNWIND range(0, $n - 1) AS x
+               WITH toString(x % 7) AS s
+               UNWIND [s + 'a', s + 'b'] AS t
+               RETURN t, count(t) ORDER BY t"""
+        res = graph.query(q, {'n': ROW_COUNT}).result_set
+        expected = []
+        for i in range(7):
+            c = len([x for x in range(ROW_COUNT) if x % 7 == i])
+            expected.append([str(i) + 'a', c])
+            expected.append([str(i) + 'b', c])
+        self.env.assertEqual(res, sorted(expected))
+
+    def test05_runtime_error(self):
+        # errors raised by workers are reported
+        q = """UNWIND range(0, $n - 1) AS x
+               RETURN x % 3 AS k, sum(1 / (x - 40000))"""
+        try:
+            graph.query(q, {'n': ROW_COUNT})
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("Division by zero", str(e))
+
+        # server remains operational
+        res = graph.query("UNWIND range(1, 10) AS x RETURN sum(x)").result_set
+        self.env.assertEqual(res[0][0], 55)
@@ -0,0 +1,95 @@
+from common import *
+
+GRAPH_ID = "parallel_scan"
+NODE_COUNT = 100000
+redis_con = None
+redis_graph = None
+
+
+class testParallelScan(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='THREAD_COUNT 4')
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(redis_con, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # every other node is labeled A, the rest are labeled B
+        q = """UNWIND range(0, $n - 1) AS x
+               FOREACH(i IN CASE WHEN x % 2 = 0 THEN [1] ELSE [] END | CREATE (:A {v: x}))
+               FOREACH(i IN CASE WHEN x % 2 = 1 THEN [1] ELSE [] END | CREATE (:B {v: x}))"""
+        redis_graph.query(q, {'n': NODE_COUNT})
+
+    def test01_parallel_plan(self):
+        # filtered scans of read-only queries are gathered
+        queries = ["MATCH (n) WHERE n.v > 10 RETURN count(n)",
+                   "MATCH (n:A) WHERE n.v > 10 RETURN count(n)",
+                   "MATCH (n:A) WHERE ID(n) > 10 AND n.v > 10 RETURN count(n)"]
+        for q in queries:
+            plan = redis_graph.execution_plan(q)
+            self.env.assertIn("Gather", plan)
+
+        # unfiltered scans and write queries are not
+        queries = ["MATCH (n:A) RETURN n.v",
+                   "MATCH (n:A) WHERE n.v > 10 SET n.w = 1"]
+        for q in queries:
+            plan = redis_graph.execution_plan(q)
+            self.env.assertNotIn("Gather", plan)
+
+    def test02_parallel_results(self):
+        q = "MATCH (n) WHERE n.v % 3 = 0 RETURN count(n)"
+        res = redis_graph.query(q).result_set
+        self.env.assertEqual(res[0][0], (NODE_COUNT + 2) // 3)
+
+        q = "MATCH (n:A) WHERE n.v % 3 = 0 AND n.v > 100 RETURN count(n), sum(n.v)"
+        expected = [x for x in range(0, NODE_COUNT, 2) if x % 3 == 0 and x > 100]
+        res = redis_graph.query(q).result_set
+        self.env.assertEqual(res[0], [len(expected), sum(expected)])
+
+        # ID range scans are parallelized as well
+        q = "MATCH (n:B) WHERE ID(n) >= 50000 AND n.v % 5 = 0 RETURN count(n)"
+        expected = [x for x in range(1, NODE_COUNT, 2) if x >= 50000 and x % 5 == 0]
+        res = redis_graph.query(q).result_set
+        self.env.assertEqual(res[0][0], len(expected))
+
+    def test03_parallel_order(self):
+        # records are produced in scan order
+        q = "MATCH (n) WHERE n.v % 97 = 0 RETURN n.v"
+        res = redis_graph.query(q).result_set
+        self.env.assertEqual(res, [[x] for x in range(0, NODE_COUNT, 97)])
+
+        q = "MATCH (n:B) WHERE n.v % 101 = 0 RETURN n.v LIMIT 10"
+        res = redis_graph.query(q).result_set
+        expected = [x for x in range(1, NODE_COUNT, 2) if x % 101 == 0][:10]
+        self.env.assertEqual(res, [[x] for x in expected])
+
+    def test04_parallel_runtime_error(self):
+        # errors raised by workers are reported
+        q = "MATCH (n:A) WHERE 1 / (n.v - 90000) >= 0 RETURN count(n)"
+        try:
+            redis_graph.query(q)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("Division by zero", str(e))
+
+        # server remains operational
+        res = redis_graph.query("MATCH (n:A) WHERE n.v < 10 RETURN count(n)").result_set
+        self.env.assertEqual(res[0][0], 5)
+
+    def test05_profile(self):
+        # profiled scans are not parallelized, record counts are exact
+        q = "MATCH (n:A) WHERE n.v < 10 RETURN n"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+        profile = [x[0:x.index(',')].strip() for x in profile]
+        self.env.assertIn("Gather | Records produced: 5", profile)
+        self.env.assertIn("Filter | Records produced: 5", profile)
+        self.env.assertIn("Node By Label Scan | (n:A) | Records produced: %d" % (NODE_COUNT // 2), profile)
+
+    def test06_parallel_parameters(self):
+        # workers evaluate filters against the query's parameters
+        q = "MATCH (n:A) WHERE n.v % $m = 0 AND n.v >= $min RETURN count(n)"
+        res = redis_graph.query(q, {'m': 7, 'min': 1000}).result_set
+        expected = [x for x in range(0, NODE_COUNT, 2) if x % 7 == 0 and x >= 1000]
+        self.env.assertEqual(res[0][0], len(expected))
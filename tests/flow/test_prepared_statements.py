@@ -0,0 +1,203 @@
+from common import *
+
+GRAPH_ID = "prepared_statements"
+
+
+class testPreparedStatements():
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        self.graph.query("UNWIND range(1, 10) AS x CREATE (:N {v: x, s: toString(x)})")
+
+    def prepare(self, query):
+        return self.conn.execute_command("GRAPH.PREPARE", GRAPH_ID, query)
+
+    def execute(self, handle, *params):
+        args = ["GRAPH.EXECUTE", GRAPH_ID, handle, "--compact"]
+        if len(params) > 0:
+            args += ["PARAMS"] + list(params)
+        res = self.conn.execute_command(*args)
+        return query_result.QueryResult(self.graph, res)
+
+    def test01_prepare(self):
+        q = "MATCH (n:N) WHERE n.v = $v RETURN n.s"
+        handle = self.prepare(q)
+        self.env.assertGreaterEqual(handle, 0)
+
+        # preparing the same query returns the same handle
+        self.env.assertEqual(self.prepare(q), handle)
+
+        # different queries are given different handles
+        other = self.prepare("MATCH (n:N) RETURN count(n)")
+        self.env.assertNotEqual(other, handle)
+
+    def test02_execute(self):
+        handle = self.prepare("MATCH (n:N) WHERE n.v = $v RETURN n.s")
+
+        for v in [2, 7]:
+            result = self.execute(handle, "v", str(v))
+            self.env.assertTrue(result.cached_execution)
+            self.env.assertEqual(result.result_set, [[str(v)]])
+
+        # parameters of different types
+        result = self.execute(handle, "v", "'2'")
+        self.env.assertEqual(result.result_set, [])
+
+        handle = self.prepare("MATCH (n:N) WHERE n.s = $s AND n.v IN $l RETURN n.v")
+        result = self.execute(handle, "s", "'3'", "l", "[1, 2, 3]")
+        self.env.assertEqual(result.result_set, [[3]])
+        result = self.execute(handle, "s", "'4'", "l", "[1, 2, 3]")
+        self.env.assertEqual(result.result_set, [])
+
+        # prepare-time parameters are used for planning only
+        handle = self.prepare("CYPHER lim=1 MATCH (n:N) RETURN n.v ORDER BY n.v LIMIT $lim")
+        result = self.execute(handle, "lim", "3")
+        self.env.assertEqual(result.result_set, [[1], [2], [3]])
+
+    def test03_write_statement(self):
+        handle = self.prepare("CREATE (:M {v: $v, w: $w})")
+        result = self.execute(handle, "v", "1", "w", "{a: 1.5}")
+        self.env.assertEqual(result.nodes_created, 1)
+
+        result = self.graph.query("MATCH (m:M) RETURN m.v, m.w")
+        self.env.assertEqual(result.result_set, [[1, {'a': 1.5}]])
+
+    def test04_errors(self):
+        handle = self.prepare("MATCH (n:N) WHERE n.v = $v RETURN n")
+
+        # unknown handle
+        try:
+            self.execute(1000)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Unknown prepared statement", str(e))
+
+        # missing parameter value
+        try:
+            self.execute(handle, "v")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("PARAMS expects name value pairs", str(e))
+
+        # values can't carry queries
+        try:
+            self.execute(handle, "v", "1 MATCH (x) DELETE x")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            pass
+
+        result = self.graph.query("MATCH (n:N) RETURN count(n)")
+        self.env.assertEqual(result.result_set, [[10]])
+
+        # index operations can't be prepared
+        try:
+            self.prepare("CREATE INDEX FOR (n:N) ON (n.v)")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("can't be prepared", str(e))
+
+        # preparing against a missing key doesn't create it
+        try:
+            self.conn.execute_command("GRAPH.PREPARE", "missing_graph",
+                                      "MATCH (n) RETURN n")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("empty key", str(e))
+        self.env.assertEqual(self.conn.exists("missing_graph"), 0)
+
+    def test05_negative_parameters(self):
+        handle = self.prepare("MATCH (n:N) WHERE n.v > $v RETURN count(n)")
+
+        result = self.execute(handle, "v", "-1")
+        self.env.assertEqual(result.result_set, [[10]])
+
+        result = self.execute(handle, "v", "-0.5")
+        self.env.assertEqual(result.result_set, [[10]])
+
+        result = self.execute(handle, "v", "8.5")
+        self.env.assertEqual(result.result_set, [[2]])
+
+    def test06_deallocate(self):
+        q = "MATCH (n:N) WHERE n.v = $v RETURN n.s"
+        handle = self.prepare(q)
+
+        res = self.conn.execute_command("GRAPH.DEALLOCATE", GRAPH_ID, handle)
+        self.env.assertEqual(res, "OK")
+
+        # deallocated handle is unknown
+        try:
+            self.execute(handle, "v", "1")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Unknown prepared statement", str(e))
+
+        try:
+            self.conn.execute_command("GRAPH.DEALLOCATE", GRAPH_ID, handle)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Unknown prepared statement", str(e))
+
+        # preparing the query again yields a new handle
+        new_handle = self.prepare(q)
+        self.env.assertNotEqual(new_handle, handle)
+        result = self.execute(new_handle, "v", "1")
+        self.env.assertEqual(result.result_set, [["1"]])
+
+    def test07_statements_limit(self):
+        # deallocating statements makes room for new ones
+        handles = []
+        for i in range(4096):
+            try:
+                handles.append(self.prepare(f"RETURN {i}"))
+            except ResponseError as e:
+                self.env.assertContains("Max prepared statements", str(e))
+                break
+
+        try:
+            self.prepare("RETURN -1")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Max prepared statements", str(e))
+
+        self.conn.execute_command("GRAPH.DEALLOCATE", GRAPH_ID, handles[0])
+        result = self.execute(self.prepare("RETURN -1"))
+        self.env.assertEqual(result.result_set, [[-1]])
+
+
+class testPreparedStatementsReplication():
+    def __init__(self):
+        # skip test if we're running under Valgrind
+        if VALGRIND or SANITIZER != "":
+            Env.skip(None) # valgrind is not working correctly with replication
+
+        self.env = Env(decodeResponses=True, env='oss', useSlaves=True)
+
+    def test01_replica_rejects_write_statements(self):
+        source_con = self.env.getConnection()
+        replica_con = self.env.getSlaveConnection()
+
+        Graph(source_con, GRAPH_ID).query("CREATE (:N {v: 1})")
+        source_con.execute_command("WAIT", "1", "0")
+
+        # readonly commands are served by a read-only replica
+        read = replica_con.execute_command("GRAPH.PREPARE", GRAPH_ID,
+                                           "MATCH (n:N) RETURN n.v")
+        res = replica_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, read)
+        self.env.assertEqual(res[1], [[1]])
+
+        # write statements are rejected on a replica
+        write = replica_con.execute_command("GRAPH.PREPARE", GRAPH_ID,
+                                            "CREATE (:N {v: 2})")
+        try:
+            replica_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, write)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("can't be executed on a replica", str(e))
+
+        res = replica_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID,
+                                          "MATCH (n:N) RETURN count(n)")
+        self.env.assertEqual(res[1], [[1]])
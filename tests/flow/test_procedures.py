@@ -372,5 +372,6 @@ class testProcedures(FlowTestsBase):
                            ["READ", "db.labels"],
                            ["READ", "db.propertyKeys"],
                            ["READ", "db.relationshipTypes"],
+                           ["WRITE", "db.stats.analyze"],
                            ["READ", "dbms.procedures"]]
         self.env.assertEquals(actual_resultset, expected_result)
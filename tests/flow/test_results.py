@@ -189,3 +189,25 @@ class testResultSetFlow(FlowTestsBase):
         query = """RETURN 'Foo\r\nBar'"""
         result = graph.query(query)
         self.env.assertEqual(result.result_set[0][0], 'Foo\r\nBar')
+
+    # Test results spanning multiple record batches
+    def test11_multi_batch_results(self):
+        g = Graph(redis_con, "multi_batch")
+        g.query("UNWIND range(0, 4999) AS x CREATE (:N {v: x})")
+
+        # scan, filter and project over multiple batches
+        query = "MATCH (n:N) WHERE n.v % 3 = 0 RETURN n.v * 2 ORDER BY n.v"
+        result = g.query(query).result_set
+        self.env.assertEqual(result, [[x * 2] for x in range(0, 5000, 3)])
+
+        query = "MATCH (n) WHERE n.v >= 2500 RETURN count(n), sum(n.v)"
+        result = g.query(query).result_set
+        self.env.assertEqual(result, [[2500, sum(range(2500, 5000))]])
+
+        # implicit limit within a batch
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_SIZE", 1500)
+        result = g.query("MATCH (n:N) RETURN n.v").result_set
+        self.env.assertEqual(len(result), 1500)
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_SIZE", -1)
+
+        g.delete()
@@ -0,0 +1,115 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/rmalloc.h"
+#include "src/graph/entities/graph_entity.h"
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+// number of attributes used by tests, large enough for the values array
+// to shift multiple times as attributes are added and removed
+#define ATTR_COUNT 40
+
+void test_attributeSet_add() {
+	AttributeSet set = NULL;
+
+	for(Attribute_ID i = 0; i < ATTR_COUNT; i++) {
+		AttributeSet_Add(&set, i, SI_LongVal(i * 10));
+		TEST_ASSERT(ATTRIBUTE_SET_COUNT(set) == i + 1);
+
+		// all previously added attributes remain accessible
+		for(Attribute_ID j = 0; j <= i; j++) {
+			SIValue *v = AttributeSet_Get(set, j);
+			TEST_ASSERT(v != ATTRIBUTE_NOTFOUND);
+			TEST_ASSERT(v->longval == j * 10);
+		}
+	}
+
+	TEST_ASSERT(AttributeSet_Get(set, ATTR_COUNT) == ATTRIBUTE_NOTFOUND);
+
+	// access by index
+	for(int i = 0; i < ATTR_COUNT; i++) {
+		Attribute_ID attr_id;
+		SIValue v = AttributeSet_GetIdx(set, i, &attr_id);
+		TEST_ASSERT(v.longval == attr_id * 10);
+	}
+
+	AttributeSet_Free(&set);
+	TEST_ASSERT(set == NULL);
+}
+
+void test_attributeSet_remove() {
+	AttributeSet set = NULL;
+
+	for(Attribute_ID i = 0; i < ATTR_COUNT; i++) {
+		AttributeSet_Add(&set, i, SI_LongVal(i * 10));
+	}
+
+	// setting an attribute to NULL removes it
+	for(Attribute_ID i = 0; i < ATTR_COUNT; i += 3) {
+		TEST_ASSERT(AttributeSet_Update(&set, i, SI_NullVal()));
+
+		for(Attribute_ID j = 0; j < ATTR_COUNT; j++) {
+			SIValue *v = AttributeSet_Get(set, j);
+			if(j <= i && j % 3 == 0) {
+				TEST_ASSERT(v == ATTRIBUTE_NOTFOUND);
+			} else {
+				TEST_ASSERT(v->longval == j * 10);
+			}
+		}
+	}
+
+	// remove remaining attributes
+	for(Attribute_ID i = 0; i < ATTR_COUNT; i++) {
+		if(i % 3 == 0) continue;
+		TEST_ASSERT(AttributeSet_Update(&set, i, SI_NullVal()));
+	}
+
+	// removing the last attribute frees the set
+	TEST_ASSERT(set == NULL);
+}
+
+void test_attributeSet_update() {
+	AttributeSet set = NULL;
+
+	AttributeSet_Add(&set, 0, SI_LongVal(1));
+	AttributeSet_Add(&set, 1, SI_ConstStringVal("a"));
+
+	// updating to the same value is a no-op
+	TEST_ASSERT(!AttributeSet_Update(&set, 0, SI_LongVal(1)));
+	TEST_ASSERT(AttributeSet_Update(&set, 0, SI_LongVal(2)));
+	TEST_ASSERT(AttributeSet_Get(set, 0)->longval == 2);
+
+	// update or add
+	AttributeSet_Set_Allow_Null(&set, 1, SI_ConstStringVal("b"));
+	AttributeSet_Set_Allow_Null(&set, 2, SI_DoubleVal(0.5));
+	TEST_ASSERT(ATTRIBUTE_SET_COUNT(set) == 3);
+	TEST_ASSERT(strcmp(AttributeSet_Get(set, 1)->stringval, "b") == 0);
+	TEST_ASSERT(AttributeSet_Get(set, 2)->doubleval == 0.5);
+
+	// clone is independent of the original set
+	AttributeSet clone = AttributeSet_Clone(set);
+	AttributeSet_Update(&set, 1, SI_NullVal());
+	TEST_ASSERT(ATTRIBUTE_SET_COUNT(clone) == 3);
+	TEST_ASSERT(strcmp(AttributeSet_Get(clone, 1)->stringval, "b") == 0);
+	TEST_ASSERT(AttributeSet_Get(set, 1) == ATTRIBUTE_NOTFOUND);
+
+	AttributeSet_Free(&set);
+	AttributeSet_Free(&clone);
+}
+
+TEST_LIST = {
+	{"attributeSet_add", test_attributeSet_add},
+	{"attributeSet_remove", test_attributeSet_remove},
+	{"attributeSet_update", test_attributeSet_update},
+	{NULL, NULL}
+};
@@ -0,0 +1,153 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/rmalloc.h"
+#include "src/schema/attribute_stats.h"
+
+#include <math.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+// build statistics over 'count' entities
+// entity i holds value i % distinct, every 'null_every' entity misses the value
+static void _build
+(
+	AttributeStats *stats,
+	uint64_t count,
+	uint64_t distinct,
+	uint64_t null_every
+) {
+	AttributeStatsBuilder *b = AttributeStatsBuilder_New();
+	for(uint64_t i = 0; i < count; i++) {
+		if(null_every > 0 && i % null_every == 0) continue;
+		AttributeStatsBuilder_Add(b, SI_LongVal(i % distinct));
+	}
+	AttributeStatsBuilder_Finalize(b, count, stats);
+	AttributeStatsBuilder_Free(b);
+}
+
+void test_distinctCount() {
+	AttributeStats stats = {0};
+
+	// small number of distinct values
+	_build(&stats, 10000, 10, 0);
+	TEST_ASSERT(round(AttributeStats_DistinctCount(&stats)) == 10);
+
+	// large number of distinct values, estimate is within 10%
+	_build(&stats, 100000, 100000, 0);
+	double distinct = AttributeStats_DistinctCount(&stats);
+	TEST_ASSERT(fabs(distinct - 100000) < 10000);
+
+	// strings and numbers are counted alike
+	AttributeStatsBuilder *b = AttributeStatsBuilder_New();
+	char str[32];
+	for(int i = 0; i < 1000; i++) {
+		sprintf(str, "value %d", i % 500);
+		AttributeStatsBuilder_Add(b, SI_ConstStringVal(str));
+	}
+	AttributeStatsBuilder_Finalize(b, 1000, &stats);
+	AttributeStatsBuilder_Free(b);
+	distinct = AttributeStats_DistinctCount(&stats);
+	TEST_ASSERT(fabs(distinct - 500) < 50);
+	TEST_ASSERT(stats.bucket_count == 0);
+}
+
+void test_nullFraction() {
+	AttributeStats stats = {0};
+
+	_build(&stats, 1000, 100, 4);
+	TEST_ASSERT(stats.count == 1000);
+	TEST_ASSERT(stats.nulls == 250);
+	TEST_ASSERT(AttributeStats_NullFraction(&stats) == 0.25);
+
+	// equality with null never holds
+	double sel;
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_EQUAL, SI_NullVal(), &sel));
+	TEST_ASSERT(sel == 0);
+}
+
+void test_selectivity() {
+	double sel;
+	AttributeStats stats = {0};
+
+	// uniformly distributed values [0, 10000)
+	_build(&stats, 10000, 10000, 0);
+	TEST_ASSERT(stats.bucket_count == ATTRIBUTE_STATS_BUCKETS);
+	TEST_ASSERT(stats.bounds[0] == 0);
+	TEST_ASSERT(stats.bounds[ATTRIBUTE_STATS_BUCKETS] == 9999);
+
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_LT, SI_LongVal(2500), &sel));
+	TEST_ASSERT(fabs(sel - 0.25) < 0.05);
+
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_GE, SI_DoubleVal(9000), &sel));
+	TEST_ASSERT(fabs(sel - 0.1) < 0.05);
+
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_GT, SI_LongVal(-1), &sel));
+	TEST_ASSERT(sel > 0.99);
+
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_LT, SI_LongVal(-1), &sel));
+	TEST_ASSERT(sel == 0);
+
+	// equality
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_EQUAL, SI_LongVal(7), &sel));
+	TEST_ASSERT(sel > 0 && sel < 0.001);
+
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_NEQUAL, SI_LongVal(7), &sel));
+	TEST_ASSERT(sel > 0.999);
+
+	// value outside of the histogram's range
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_EQUAL, SI_LongVal(20000), &sel));
+	TEST_ASSERT(sel == 0);
+
+	// range over strings can't be estimated
+	TEST_ASSERT(!AttributeStats_Selectivity(&stats, OP_LT, SI_ConstStringVal("a"), &sel));
+
+	// low number of distinct values
+	_build(&stats, 10000, 4, 0);
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_EQUAL, SI_LongVal(2), &sel));
+	TEST_ASSERT(fabs(sel - 0.25) < 0.01);
+}
+
+void test_maintenance() {
+	double sel;
+	AttributeStats stats = {0};
+
+	_build(&stats, 100, 100, 0);
+	TEST_ASSERT(AttributeStats_NullFraction(&stats) == 0);
+
+	// introduce entities missing the attribute
+	for(int i = 0; i < 100; i++) AttributeStats_Add(&stats, SI_NullVal());
+	TEST_ASSERT(stats.count == 200);
+	TEST_ASSERT(AttributeStats_NullFraction(&stats) == 0.5);
+
+	// remove them
+	for(int i = 0; i < 100; i++) AttributeStats_Remove(&stats, SI_NullVal());
+	TEST_ASSERT(stats.count == 100);
+	TEST_ASSERT(AttributeStats_NullFraction(&stats) == 0);
+
+	// new values widen the histogram
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_EQUAL, SI_LongVal(500), &sel));
+	TEST_ASSERT(sel == 0);
+
+	AttributeStats_Add(&stats, SI_LongVal(500));
+	TEST_ASSERT(stats.bounds[stats.bucket_count] == 500);
+	TEST_ASSERT(AttributeStats_Selectivity(&stats, OP_EQUAL, SI_LongVal(500), &sel));
+	TEST_ASSERT(sel > 0);
+}
+
+TEST_LIST = {
+	{"distinctCount", test_distinctCount},
+	{"nullFraction", test_nullFraction},
+	{"selectivity", test_selectivity},
+	{"maintenance", test_maintenance},
+	{NULL, NULL}
+};
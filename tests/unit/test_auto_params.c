@@ -0,0 +1,124 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/rmalloc.h"
+#include "src/ast/ast_auto_params.h"
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+static void _FreeParam(void *p) {
+	SIValue *v = (SIValue *)p;
+	SIValue_Free(*v);
+	rm_free(v);
+}
+
+static SIValue *_GetParam(rax *params, const char *name) {
+	void *v = raxFind(params, (unsigned char *)name, strlen(name));
+	return (v == raxNotFound) ? NULL : v;
+}
+
+void test_liftLiterals() {
+	rax *params = raxNew();
+	char *q = AST_AutoParameterize(
+			"MATCH (n:User {id: 17}) WHERE n.score > 2.5 AND n.name = 'a b' "
+			"RETURN n", params);
+
+	TEST_ASSERT(q != NULL);
+	TEST_ASSERT(strcmp(q, "MATCH (n:User {id: $__lit0}) WHERE n.score > "
+				"$__lit1 AND n.name = $__lit2 RETURN n") == 0);
+	TEST_ASSERT(raxSize(params) == 3);
+
+	SIValue *v = _GetParam(params, "__lit0");
+	TEST_ASSERT(v != NULL && SI_TYPE(*v) == T_INT64 && v->longval == 17);
+	v = _GetParam(params, "__lit1");
+	TEST_ASSERT(v != NULL && SI_TYPE(*v) == T_DOUBLE && v->doubleval == 2.5);
+	v = _GetParam(params, "__lit2");
+	TEST_ASSERT(v != NULL && SI_TYPE(*v) == T_STRING &&
+			strcmp(v->stringval, "a b") == 0);
+
+	rm_free(q);
+	raxFreeWithCallback(params, _FreeParam);
+}
+
+void test_sameNormalizedForm() {
+	rax *a = raxNew();
+	rax *b = raxNew();
+
+	char *qa = AST_AutoParameterize("MATCH (n {v: 1}) SET n.s = 'x'", a);
+	char *qb = AST_AutoParameterize("MATCH (n {v: 200}) SET n.s = \"y\"", b);
+	TEST_ASSERT(qa != NULL && qb != NULL);
+	TEST_ASSERT(strcmp(qa, qb) == 0);
+
+	rm_free(qa);
+	rm_free(qb);
+	raxFreeWithCallback(a, _FreeParam);
+	raxFreeWithCallback(b, _FreeParam);
+}
+
+void test_keepLiterals() {
+	// literals which the query relies on at compile time are kept
+	const char *queries[] = {
+		"RETURN 1, 'a'",
+		"MATCH (n) RETURN n.v + 1 ORDER BY n.v LIMIT 3",
+		"MATCH (a)-[*1..3]->(b) RETURN b",
+		"UNWIND $list AS x WITH x SKIP 2 LIMIT 4 RETURN x",
+		"MATCH (n:L2) WHERE n.v = 'a\\'b' RETURN n",
+		"MATCH (n) WHERE n.v = 0x1F OR n.v = 012 OR n.v = 1e3 RETURN n",
+		"MATCH (n) WHERE n.v = 9223372036854775808 RETURN n",
+		"MATCH (n) WHERE n.`v 1` = $p // 1\n /* 2 */ RETURN n",
+		"WITH [1, 2, 3] AS l RETURN l[1..2]",
+	};
+
+	int n = sizeof(queries) / sizeof(queries[0]);
+	for(int i = 0; i < n; i++) {
+		rax *params = raxNew();
+		char *q = AST_AutoParameterize(queries[i], params);
+		if(i == 8) {
+			// only the list within the WITH clause is lifted
+			TEST_ASSERT(q != NULL);
+			TEST_ASSERT(strcmp(q, "WITH [$__lit0, $__lit1, $__lit2] AS l "
+						"RETURN l[1..2]") == 0);
+			rm_free(q);
+		} else {
+			TEST_MSG("query: %s", queries[i]);
+			TEST_ASSERT(q == NULL);
+			TEST_ASSERT(raxSize(params) == 0);
+		}
+		raxFreeWithCallback(params, _FreeParam);
+	}
+}
+
+void test_paramCollision() {
+	rax *params = raxNew();
+
+	// query refers to a parameter sharing the synthetic prefix
+	TEST_ASSERT(AST_AutoParameterize("MATCH (n {v: $__lit0}) WHERE n.x = 1 "
+				"RETURN n", params) == NULL);
+
+	// parameter sharing the synthetic prefix
+	SIValue *v = rm_malloc(sizeof(SIValue));
+	*v = SI_LongVal(1);
+	raxInsert(params, (unsigned char *)"__lit7", 6, v, NULL);
+	TEST_ASSERT(AST_AutoParameterize("MATCH (n {v: 1}) RETURN n", params)
+			== NULL);
+	TEST_ASSERT(raxSize(params) == 1);
+
+	raxFreeWithCallback(params, _FreeParam);
+}
+
+TEST_LIST = {
+	{"liftLiterals", test_liftLiterals},
+	{"sameNormalizedForm", test_sameNormalizedForm},
+	{"keepLiterals", test_keepLiterals},
+	{"paramCollision", test_paramCollision},
+	{NULL, NULL}
+};
@@ -99,8 +99,72 @@ void test_executionPlanCache() {
 	TEST_ASSERT(free_count == 9);
 }
 
+void test_cacheClear() {
+	Cache *cache = Cache_New(2, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *key1 = "MATCH (a) RETURN a";
+	const char *key2 = "MATCH (b) RETURN b";
+	const char *key3 = "MATCH (c) RETURN c";
+
+	Cache_SetValue(cache, key1, CacheObj_New("1"));
+	Cache_SetValue(cache, key2, CacheObj_New("2"));
+
+	// clearing the cache frees all stored items
+	int freed = free_count;
+	Cache_Clear(cache);
+	TEST_ASSERT(free_count - freed == 2);
+	TEST_ASSERT(Cache_GetValue(cache, key1) == NULL);
+	TEST_ASSERT(Cache_GetValue(cache, key2) == NULL);
+
+	// cache is usable once cleared
+	CacheObj *item = CacheObj_New("3");
+	Cache_SetValue(cache, key3, item);
+	CacheObj *from_cache = (CacheObj*)Cache_GetValue(cache, key3);
+	TEST_ASSERT(CacheObj_EQ(item, from_cache));
+	CacheObj_Free(from_cache);
+
+	Cache_Free(cache);
+}
+
+void test_cacheStats() {
+	Cache *cache = Cache_New(2, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	uint     size;
+	uint64_t hits;
+	uint64_t misses;
+
+	const char *key1 = "MATCH (a) RETURN a";
+	const char *key2 = "MATCH (b) RETURN b";
+
+	Cache_GetStats(cache, &hits, &misses, &size);
+	TEST_ASSERT(hits == 0 && misses == 0 && size == 0);
+
+	// miss, populate, hit
+	TEST_ASSERT(Cache_GetValue(cache, key1) == NULL);
+	Cache_SetValue(cache, key1, CacheObj_New("1"));
+	CacheObj *from_cache = (CacheObj*)Cache_GetValue(cache, key1);
+	CacheObj_Free(from_cache);
+	TEST_ASSERT(Cache_GetValue(cache, key2) == NULL);
+
+	Cache_GetStats(cache, &hits, &misses, &size);
+	TEST_ASSERT(hits == 1);
+	TEST_ASSERT(misses == 2);
+	TEST_ASSERT(size == 1);
+
+	// clearing the cache retains its statistics
+	Cache_Clear(cache);
+	Cache_GetStats(cache, &hits, &misses, &size);
+	TEST_ASSERT(hits == 1 && misses == 2 && size == 0);
+
+	Cache_Free(cache);
+}
+
 TEST_LIST = {
 	{"executionPlanCache", test_executionPlanCache},
+	{"cacheClear", test_cacheClear},
+	{"cacheStats", test_cacheStats},
 	{NULL, NULL}
 };
 
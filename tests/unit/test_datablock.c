@@ -128,6 +128,105 @@ void test_dataBlockScan() {
 	DataBlockIterator_Free(it);
 }
 
+void test_dataBlockScanDeleted() {
+	DataBlock *dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, 1024, sizeof(int), NULL);
+	size_t itemCount = DATABLOCK_BLOCK_CAP * 3;
+	DataBlock_Accommodate(dataBlock, itemCount);
+
+	for(int i = 0 ; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// delete every item but the ones whose index is a multiple of 100
+	// in addition, delete the entire second block
+	for(int i = 0 ; i < itemCount; i++) {
+		bool second_block = (i >= DATABLOCK_BLOCK_CAP && i < DATABLOCK_BLOCK_CAP * 2);
+		if(i % 100 != 0 || second_block) DataBlock_DeleteItem(dataBlock, i);
+	}
+
+	int *item = NULL;
+	uint64_t idx = 0;
+	uint64_t prev = 0;
+	int count = 0;
+
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	while((item = (int *)DataBlockIterator_Next(it, &idx))) {
+		TEST_ASSERT(*item == idx);
+		TEST_ASSERT(idx % 100 == 0);
+		TEST_ASSERT(idx < DATABLOCK_BLOCK_CAP || idx >= DATABLOCK_BLOCK_CAP * 2);
+		TEST_ASSERT(count == 0 || idx > prev);
+		prev = idx;
+		count++;
+	}
+	TEST_ASSERT(count == DataBlock_ItemCount(dataBlock));
+	DataBlockIterator_Free(it);
+
+	// every remaining item forms a run of its own
+	uint64_t len;
+	uint64_t start;
+	count = 0;
+	it = DataBlock_Scan(dataBlock);
+	while((len = DataBlockIterator_NextRun(it, UINT64_MAX, &start, NULL)) > 0) {
+		TEST_ASSERT(len == 1);
+		TEST_ASSERT(start % 100 == 0);
+		count += len;
+	}
+	TEST_ASSERT(count == DataBlock_ItemCount(dataBlock));
+	DataBlockIterator_Free(it);
+	DataBlock_Free(dataBlock);
+
+	// runs are split by deleted items
+	dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, 1024, sizeof(int), NULL);
+	for(int i = 0 ; i < 300; i++) DataBlock_AllocateItem(dataBlock, NULL);
+	for(int i = 100 ; i < 200; i++) DataBlock_DeleteItem(dataBlock, i);
+
+	it = DataBlock_Scan(dataBlock);
+	TEST_ASSERT(DataBlockIterator_NextRun(it, UINT64_MAX, &start, NULL) == 100);
+	TEST_ASSERT(start == 0);
+	TEST_ASSERT(DataBlockIterator_NextRun(it, UINT64_MAX, &start, NULL) == 100);
+	TEST_ASSERT(start == 200);
+	TEST_ASSERT(DataBlockIterator_NextRun(it, UINT64_MAX, &start, NULL) == 0);
+	DataBlockIterator_Free(it);
+
+	// runs are capped by max length, items are stored contiguously
+	for(int i = 200 ; i < 300; i++) {
+		*(int *)DataBlock_GetItem(dataBlock, i) = i;
+	}
+
+	void *run;
+	it = DataBlock_Scan(dataBlock);
+	TEST_ASSERT(DataBlockIterator_NextRun(it, 100, &start, NULL) == 100);
+	TEST_ASSERT(DataBlockIterator_NextRun(it, 60, &start, &run) == 60);
+	TEST_ASSERT(start == 200);
+	TEST_ASSERT(DataBlockIterator_NextRun(it, 60, &start, &run) == 40);
+	TEST_ASSERT(start == 260);
+	for(int i = 0; i < 40; i++) {
+		int *item = (int *)((unsigned char *)run +
+				i * DataBlockIterator_ItemSize(it));
+		TEST_ASSERT(*item == 260 + i);
+	}
+	TEST_ASSERT(DataBlockIterator_NextRun(it, 60, &start, &run) == 0);
+	DataBlockIterator_Free(it);
+
+	// a fully occupied datablock is a single run per block
+	DataBlock_Free(dataBlock);
+	dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, 1024, sizeof(int), NULL);
+	for(int i = 0 ; i < DATABLOCK_BLOCK_CAP + 10; i++) {
+		DataBlock_AllocateItem(dataBlock, NULL);
+	}
+
+	it = DataBlock_Scan(dataBlock);
+	TEST_ASSERT(DataBlockIterator_NextRun(it, UINT64_MAX, &start, NULL) == DATABLOCK_BLOCK_CAP);
+	TEST_ASSERT(start == 0);
+	TEST_ASSERT(DataBlockIterator_NextRun(it, UINT64_MAX, &start, NULL) == 10);
+	TEST_ASSERT(start == DATABLOCK_BLOCK_CAP);
+	TEST_ASSERT(DataBlockIterator_NextRun(it, UINT64_MAX, &start, NULL) == 0);
+
+	DataBlockIterator_Free(it);
+	DataBlock_Free(dataBlock);
+}
+
 void test_dataBlockRemoveItem() {
 	DataBlock *dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, 1024, sizeof(int), NULL);
 	uint itemCount = 32;
@@ -230,12 +329,123 @@ void test_dataBlockOutOfOrderBuilding() {
 	DataBlockIterator_Free(it);
 }
 
+void test_dataBlockCompact() {
+	DataBlock *dataBlock = DataBlock_New(16, 16, sizeof(int), NULL);
+
+	// populate 64 items spread over 4 blocks
+	for(int i = 0; i < 64; i++) {
+		int *item = DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// delete all odd items and the last 8 items
+	for(int i = 1; i < 64; i += 2) DataBlock_DeleteItem(dataBlock, i);
+	for(int i = 56; i < 64; i += 2) DataBlock_DeleteItem(dataBlock, i);
+	TEST_ASSERT(dataBlock->itemCount == 28);
+	TEST_ASSERT(!DataBlock_IsCompact(dataBlock));
+
+	uint64_t src[64];
+	uint64_t dst[64];
+
+	// move a limited number of items
+	uint64_t moved = DataBlock_Compact(dataBlock, 4, src, dst);
+	TEST_ASSERT(moved == 4);
+	for(uint64_t i = 0; i < moved; i++) {
+		// items move from the end into the lowest free slots
+		TEST_ASSERT(src[i] > dst[i]);
+		TEST_ASSERT(dst[i] == 1 + 2 * i);
+		int *item = DataBlock_GetItem(dataBlock, dst[i]);
+		TEST_ASSERT(item != NULL && *item == (int)src[i]);
+		TEST_ASSERT(DataBlock_GetItem(dataBlock, src[i]) == NULL);
+	}
+
+	// delete an item in between compaction steps
+	DataBlock_DeleteItem(dataBlock, 0);
+
+	// complete compaction
+	moved = DataBlock_Compact(dataBlock, 64, src, dst);
+	TEST_ASSERT(DataBlock_IsCompact(dataBlock));
+	TEST_ASSERT(dataBlock->itemCount == 27);
+
+	// remaining items occupy the range [0, 27)
+	bool seen[64] = {0};
+	for(uint64_t i = 0; i < 27; i++) {
+		int *item = DataBlock_GetItem(dataBlock, i);
+		TEST_ASSERT(item != NULL);
+		TEST_ASSERT(*item > 0 && *item < 56 && *item % 2 == 0);
+		TEST_ASSERT(!seen[*item]);
+		seen[*item] = true;
+	}
+	TEST_ASSERT(DataBlock_GetItem(dataBlock, 27) == NULL);
+
+	// release unused blocks
+	DataBlock_Shrink(dataBlock);
+	TEST_ASSERT(dataBlock->blockCount == 2);
+	TEST_ASSERT(dataBlock->itemCap == 32);
+
+	// new items are appended
+	uint64_t idx;
+	DataBlock_AllocateItem(dataBlock, &idx);
+	TEST_ASSERT(idx == 27);
+
+	DataBlock_Free(dataBlock);
+}
+
+void test_dataBlockMoveItems() {
+	DataBlock *dataBlock = DataBlock_New(16, 16, sizeof(int), NULL);
+
+	// populate 32 items
+	for(int i = 0; i < 32; i++) {
+		int *item = DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// delete items 2, 5, 9 and the last item
+	DataBlock_DeleteItem(dataBlock, 9);
+	DataBlock_DeleteItem(dataBlock, 2);
+	DataBlock_DeleteItem(dataBlock, 31);
+	DataBlock_DeleteItem(dataBlock, 5);
+	TEST_ASSERT(dataBlock->itemCount == 28);
+	TEST_ASSERT(!DataBlock_IsCompact(dataBlock));
+
+	// items 28, 29 and 30 are misplaced
+	// items are moved into the lowest free slots, in the given order
+	uint64_t src[2] = {29, 28};
+	uint64_t dst[2];
+	DataBlock_MoveItems(dataBlock, src, 2, dst);
+	TEST_ASSERT(dst[0] == 2);
+	TEST_ASSERT(dst[1] == 5);
+	TEST_ASSERT(*(int *)DataBlock_GetItem(dataBlock, 2) == 29);
+	TEST_ASSERT(*(int *)DataBlock_GetItem(dataBlock, 5) == 28);
+	TEST_ASSERT(DataBlock_GetItem(dataBlock, 28) == NULL);
+	TEST_ASSERT(DataBlock_GetItem(dataBlock, 29) == NULL);
+	TEST_ASSERT(!DataBlock_IsCompact(dataBlock));
+
+	src[0] = 30;
+	DataBlock_MoveItems(dataBlock, src, 1, dst);
+	TEST_ASSERT(dst[0] == 9);
+	TEST_ASSERT(*(int *)DataBlock_GetItem(dataBlock, 9) == 30);
+
+	// trailing free slots are dropped
+	TEST_ASSERT(DataBlock_IsCompact(dataBlock));
+	TEST_ASSERT(DataBlock_DeletedItemsCount(dataBlock) == 0);
+
+	uint64_t idx;
+	DataBlock_AllocateItem(dataBlock, &idx);
+	TEST_ASSERT(idx == 28);
+
+	DataBlock_Free(dataBlock);
+}
+
 TEST_LIST = {
 	{"dataBlockNew", test_dataBlockNew},
 	{"dataBlockAddItem", test_dataBlockAddItem },
 	{"dataBlockScan", test_dataBlockScan},
+	{"dataBlockScanDeleted", test_dataBlockScanDeleted},
 	{"dataBlockRemoveItem", test_dataBlockRemoveItem},
 	{"dataBlockOutOfOrderBuilding", test_dataBlockOutOfOrderBuilding},
+	{"dataBlockCompact", test_dataBlockCompact},
+	{"dataBlockMoveItems", test_dataBlockMoveItems},
 	{NULL, NULL}
 };
 
@@ -9,9 +9,11 @@
 #include "src/util/arr.h"
 #include "src/util/rmalloc.h"
 #include "src/filter_tree/filter_tree.h"
+#include "src/filter_tree/ft_program.h"
 #include "src/ast/ast_build_filter_tree.h"
 #include "src/arithmetic/funcs.h"
 
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -630,6 +632,52 @@ void test_compact() {
 	AST_Free(ast);
 }
 
+void test_program() {
+	// record holding two scalars: a, b
+	rax *mapping = raxNew();
+	raxInsert(mapping, (unsigned char *)"a", 1, (void *)0, NULL);
+	raxInsert(mapping, (unsigned char *)"b", 1, (void *)1, NULL);
+	Record r = Record_New(mapping);
+
+	SIValue values[6] = {SI_LongVal(1), SI_LongVal(2), SI_DoubleVal(1.0),
+		SI_DoubleVal(NAN), SI_ConstStringVal("x"), SI_NullVal()};
+	AST_Operator ops[6] = {OP_EQUAL, OP_NEQUAL, OP_LT, OP_LE, OP_GT, OP_GE};
+	AST_Operator conds[4] = {OP_AND, OP_OR, OP_XOR, OP_XNOR};
+
+	for(int i = 0; i < 6; i++) {
+		for(int j = 0; j < 4; j++) {
+			// (a op b) cond NOT(a op 1)
+			FT_FilterNode *root = FilterTree_CreateConditionFilter(conds[j]);
+			FT_FilterNode *not = FilterTree_CreateConditionFilter(OP_NOT);
+			FilterTree_AppendLeftChild(root, FilterTree_CreatePredicateFilter(
+				ops[i], AR_EXP_NewVariableOperandNode("a"),
+				AR_EXP_NewVariableOperandNode("b")));
+			FilterTree_AppendLeftChild(not, FilterTree_CreatePredicateFilter(
+				ops[i], AR_EXP_NewVariableOperandNode("a"),
+				AR_EXP_NewConstOperandNode(SI_LongVal(1))));
+			FilterTree_AppendRightChild(root, not);
+
+			FT_Program *program = FT_Program_Compile(root);
+
+			// compiled program agrees with the filter tree on every input
+			for(int a = 0; a < 6; a++) {
+				for(int b = 0; b < 6; b++) {
+					Record_AddScalar(r, 0, values[a]);
+					Record_AddScalar(r, 1, values[b]);
+					FT_Result expected = FilterTree_applyFilters(root, r);
+					TEST_ASSERT(FT_Program_Apply(program, r) == expected);
+				}
+			}
+
+			FT_Program_Free(program);
+			FilterTree_Free(root);
+		}
+	}
+
+	Record_Free(r);
+	raxFree(mapping);
+}
+
 TEST_LIST = {
 	{"subTrees", test_subTrees},
 	{"collectModified", test_collectModified},
@@ -637,5 +685,6 @@ TEST_LIST = {
 	{"containsFunc", test_containsFunc},
 	{"clone", test_clone},
 	{"compact", test_compact},
+	{"program", test_program},
 	{NULL, NULL}
 };
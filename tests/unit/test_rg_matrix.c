@@ -1539,6 +1539,106 @@ void test_RGMatrix_resize() {
 	RG_Matrix_free(&A);
 }
 
+void test_RGMatrix_compact() {
+	GrB_Type    t                   =  GrB_BOOL;
+	RG_Matrix   A                   =  NULL;
+	GrB_Matrix  M                   =  NULL;
+	GrB_Matrix  DP                  =  NULL;
+	GrB_Matrix  DM                  =  NULL;
+	GrB_Matrix  N                   =  NULL;  // compacted matrix
+	GrB_Matrix  E                   =  NULL;  // expected matrix
+	GrB_Info    info                =  GrB_SUCCESS;
+	GrB_Index   nvals               =  0;
+	GrB_Index   nrows               =  100;
+	GrB_Index   ncols               =  100;
+	bool        applied             =  false;
+	RG_MatrixSnapshot S;
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// set elements and flush
+	info = RG_Matrix_setElement_BOOL(A, 0, 0);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_BOOL(A, 1, 1);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	RG_Matrix_wait(A, true);
+
+	// introduce pending changes
+	info = RG_Matrix_removeElement_BOOL(A, 0, 0);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_BOOL(A, 2, 2);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_pendingChanges(&nvals, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(nvals == 2);
+
+	// expected content
+	info = RG_Matrix_export(&E, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	//--------------------------------------------------------------------------
+	// compact, matrix modified in between, compaction discarded
+	//--------------------------------------------------------------------------
+
+	info = RG_Matrix_snapshot(&S, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_setElement_BOOL(A, 3, 3);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_removeElement_BOOL(A, 3, 3);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// compacting a snapshot doesn't modify the snapshotted matrix
+	info = RG_Matrix_compact(&N, &S);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(S.m == NULL);
+	ASSERT_GrB_Matrices_EQ(N, E);
+
+	info = RG_Matrix_pendingChanges(&nvals, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(nvals == 2);
+
+	applied = RG_Matrix_applyCompaction(A, &N, S.version);
+	TEST_ASSERT(!applied);
+	TEST_ASSERT(N == NULL);
+
+	//--------------------------------------------------------------------------
+	// compact and apply
+	//--------------------------------------------------------------------------
+
+	info = RG_Matrix_snapshot(&S, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_compact(&N, &S);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	applied = RG_Matrix_applyCompaction(A, &N, S.version);
+	TEST_ASSERT(applied);
+	TEST_ASSERT(N == NULL);
+
+	//--------------------------------------------------------------------------
+	// validation
+	//--------------------------------------------------------------------------
+
+	M  = RG_MATRIX_M(A);
+	DP = RG_MATRIX_DELTA_PLUS(A);
+	DM = RG_MATRIX_DELTA_MINUS(A);
+
+	// delta matrices should be empty
+	GrB_Matrix_nvals(&nvals, DP);
+	TEST_ASSERT(nvals == 0);
+	GrB_Matrix_nvals(&nvals, DM);
+	TEST_ASSERT(nvals == 0);
+
+	ASSERT_GrB_Matrices_EQ(M, E);
+
+	// clean up
+	GrB_Matrix_free(&E);
+	RG_Matrix_free(&A);
+	TEST_ASSERT(A == NULL);
+}
+
 TEST_LIST = {
 	{"RGMatrix_new", test_RGMatrix_new},
 	{"RGMatrix_simple_set", test_RGMatrix_simple_set},
@@ -1553,6 +1653,7 @@ TEST_LIST = {
 	{"RGMatrix_copy", test_RGMatrix_copy},
 	{"RGMatrix_mxm", test_RGMatrix_mxm},
 	{"RGMatrix_resize", test_RGMatrix_resize},
+	{"RGMatrix_compact", test_RGMatrix_compact},
 	{NULL, NULL}
 };
 
@@ -382,6 +382,72 @@ void test_RGMatrixTupleIter_iterate_range() {
 	TEST_ASSERT(iter.A == NULL);
 }
 
+// test RGMatrixTupleIter skips delta-minus lookups only when
+// there are no pending deletions
+void test_RGMatrixTupleIter_masked() {
+	RG_Matrix          A                   =  NULL;
+	GrB_Type           t                   =  GrB_BOOL;
+	GrB_Info           info                =  GrB_SUCCESS;
+	GrB_Index          row                 =  0;
+	GrB_Index          col                 =  0;
+	GrB_Index          nrows               =  100;
+	GrB_Index          ncols               =  100;
+	bool               sync                =  true;
+	RG_MatrixTupleIter iter;
+	memset(&iter, 0, sizeof(RG_MatrixTupleIter));
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// set elements at positions 0,1 and 0,2
+	info = RG_Matrix_setElement_BOOL(A, 0, 1);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_BOOL(A, 0, 2);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// flush matrix, delta-minus is empty
+	RG_Matrix_wait(A, sync);
+
+	info = RG_MatrixTupleIter_attach(&iter, A);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(!iter.m_masked);
+
+	info = RG_MatrixTupleIter_iterate_row(&iter, 0);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(!iter.m_masked);
+
+	for(GrB_Index j = 1; j <= 2; j++) {
+		info = RG_MatrixTupleIter_next_BOOL(&iter, &row, &col, NULL);
+		TEST_ASSERT(info == GrB_SUCCESS);
+		TEST_ASSERT(row == 0);
+		TEST_ASSERT(col == j);
+	}
+
+	info = RG_MatrixTupleIter_next_BOOL(&iter, &row, &col, NULL);
+	TEST_ASSERT(info == GxB_EXHAUSTED);
+
+	// remove element at position 0,1, introducing a pending deletion
+	info = RG_Matrix_removeElement_BOOL(A, 0, 1);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	info = RG_MatrixTupleIter_iterate_row(&iter, 0);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(iter.m_masked);
+
+	info = RG_MatrixTupleIter_next_BOOL(&iter, &row, &col, NULL);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(row == 0);
+	TEST_ASSERT(col == 2);
+
+	info = RG_MatrixTupleIter_next_BOOL(&iter, &row, &col, NULL);
+	TEST_ASSERT(info == GxB_EXHAUSTED);
+
+	RG_Matrix_free(&A);
+	TEST_ASSERT(A == NULL);
+	RG_MatrixTupleIter_detach(&iter);
+	TEST_ASSERT(iter.A == NULL);
+}
+
 TEST_LIST = {
 	{"RGMatrixTupleIter_attach", test_RGMatrixTupleIter_attach},
 	{"RGMatrixTupleIter_next", test_RGMatrixTupleIter_next},
@@ -389,5 +455,6 @@ TEST_LIST = {
 	{"RGMatrixTupleIter_reuse", test_RGMatrixTupleIter_reuse},
 	{"RGMatrixTupleIter_iterate_row", test_RGMatrixTupleIter_iterate_row},
 	{"RGMatrixTupleIter_iterate_range", test_RGMatrixTupleIter_iterate_range},
+	{"RGMatrixTupleIter_masked", test_RGMatrixTupleIter_masked},
 	{NULL, NULL}
 };
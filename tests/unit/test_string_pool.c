@@ -0,0 +1,123 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/rmalloc.h"
+#include "src/util/string_pool.h"
+
+#include <stdio.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+void test_stringPool_intern() {
+	StringPool pool = StringPool_New();
+
+	char buf[16];
+	strcpy(buf, "US");
+
+	char *a = StringPool_Intern(pool, "US");
+	char *b = StringPool_Intern(pool, buf);
+	char *c = StringPool_Intern(pool, "UK");
+
+	// equal strings share a single allocation
+	TEST_ASSERT(a == b);
+	TEST_ASSERT(a != c);
+	TEST_ASSERT(strcmp(a, "US") == 0);
+	TEST_ASSERT(strcmp(c, "UK") == 0);
+	TEST_ASSERT(StringPool_Size(pool) == 2);
+
+	// pool + 2 callers
+	TEST_ASSERT(StringPool_RefCount(a) == 3);
+	// pool + 1 caller
+	TEST_ASSERT(StringPool_RefCount(c) == 2);
+
+	StringPool_DecRef(a);
+	StringPool_DecRef(b);
+	StringPool_DecRef(c);
+
+	StringPool_Free(&pool);
+	TEST_ASSERT(pool == NULL);
+}
+
+void test_stringPool_vacuum() {
+	StringPool pool = StringPool_New();
+
+	char *kept = StringPool_Intern(pool, "kept");
+	char *dropped = StringPool_Intern(pool, "dropped");
+	StringPool_DecRef(dropped);
+
+	// only strings referenced solely by the pool are removed
+	TEST_ASSERT(StringPool_Vacuum(pool) == 1);
+	TEST_ASSERT(StringPool_Size(pool) == 1);
+	TEST_ASSERT(StringPool_RefCount(kept) == 2);
+
+	// interning a kept string returns the same allocation
+	char *again = StringPool_Intern(pool, "kept");
+	TEST_ASSERT(again == kept);
+	StringPool_DecRef(again);
+
+	// vacuum isn't required for small pools
+	TEST_ASSERT(!StringPool_RequiresVacuum(pool));
+
+	char buf[32];
+	for(int i = 0; i < 2048; i++) {
+		sprintf(buf, "%d", i);
+		StringPool_DecRef(StringPool_Intern(pool, buf));
+	}
+	TEST_ASSERT(StringPool_RequiresVacuum(pool));
+	TEST_ASSERT(StringPool_Vacuum(pool) == 2048);
+	TEST_ASSERT(!StringPool_RequiresVacuum(pool));
+
+	// string outlives the pool as long as it is referenced
+	StringPool_Free(&pool);
+	TEST_ASSERT(strcmp(kept, "kept") == 0);
+	StringPool_DecRef(kept);
+}
+
+void test_stringPool_SIValue() {
+	StringPool pool = StringPool_New();
+
+	SIValue a = SI_InternStringVal(pool, "status");
+	SIValue b = SI_InternStringVal(pool, "status");
+	TEST_ASSERT(a.allocation == M_INTERN);
+	TEST_ASSERT(a.stringval == b.stringval);
+	TEST_ASSERT(SIValue_Compare(a, b, NULL) == 0);
+
+	// cloning an interned string acquires a reference
+	SIValue clone = SI_CloneValue(a);
+	TEST_ASSERT(clone.allocation == M_INTERN);
+	TEST_ASSERT(clone.stringval == a.stringval);
+	TEST_ASSERT(StringPool_RefCount(a.stringval) == 4);
+
+	// shared values don't own a reference
+	SIValue shared = SI_ShareValue(a);
+	TEST_ASSERT(shared.allocation == M_VOLATILE);
+	SIValue_Free(shared);
+	TEST_ASSERT(StringPool_RefCount(a.stringval) == 4);
+
+	SIValue_Free(clone);
+	SIValue_Free(b);
+	TEST_ASSERT(StringPool_RefCount(a.stringval) == 2);
+
+	// interned and non interned strings compare by content
+	SIValue c = SI_ConstStringVal("status");
+	TEST_ASSERT(SIValue_Compare(a, c, NULL) == 0);
+
+	SIValue_Free(a);
+	StringPool_Free(&pool);
+}
+
+TEST_LIST = {
+	{"stringPool_intern", test_stringPool_intern},
+	{"stringPool_vacuum", test_stringPool_vacuum},
+	{"stringPool_SIValue", test_stringPool_SIValue},
+	{NULL, NULL}
+};
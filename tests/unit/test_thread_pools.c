@@ -12,6 +12,8 @@
 
 #define READER_COUNT 4
 #define WRITER_COUNT 1
+#define WORKER_COUNT READER_COUNT  // workers pool is sized as the readers pool
+#define THREAD_COUNT (READER_COUNT + WRITER_COUNT + WORKER_COUNT)
 
 void setup() {
 	Alloc_Reset();
@@ -28,10 +30,12 @@ static void get_thread_friendly_id(void *arg) {
 void test_threadPools_threadID() {
 	ThreadPools_CreatePools(READER_COUNT, WRITER_COUNT, UINT64_MAX);
 
-	// verify thread count equals to the number of reader and writer threads
-	TEST_ASSERT(READER_COUNT + WRITER_COUNT == ThreadPools_ThreadCount());
+	// verify thread count equals to the number of reader, writer
+	// and worker threads
+	TEST_ASSERT(THREAD_COUNT == ThreadPools_ThreadCount());
 
-	volatile int thread_ids[READER_COUNT + WRITER_COUNT + 1] = {-1, -1, -1, -1, -1, -1};
+	volatile int thread_ids[THREAD_COUNT + 1];
+	for(int i = 0; i < THREAD_COUNT + 1; i++) thread_ids[i] = -1;
 
 	// get main thread friendly id
 	thread_ids[0] = ThreadPools_GetThreadID();
@@ -52,8 +56,16 @@ void test_threadPools_threadID() {
 					(int*)(thread_ids + offset), 0));
 	}
 
+	// get worker threads friendly ids
+	for(int i = 0; i < WORKER_COUNT; i++) {
+		int offset = i + READER_COUNT + WRITER_COUNT + 1;
+		TEST_ASSERT(0 ==
+				ThreadPools_AddWorkWorker(get_thread_friendly_id,
+					(int*)(thread_ids + offset)));
+	}
+
 	// wait for all threads
-	for(int i = 0; i < READER_COUNT + WRITER_COUNT + 1; i++) {
+	for(int i = 0; i < THREAD_COUNT + 1; i++) {
 		while(thread_ids[i] == -1) { i = i; }
 	}
 
@@ -72,6 +84,13 @@ void test_threadPools_threadID() {
 		int offset = i + READER_COUNT + 1;
 		TEST_ASSERT(thread_ids[offset] >= thread_ids[1]);
 	}
+
+	// worker thread ids should follow writer thread ids
+	for(int i = 0; i < WORKER_COUNT; i++) {
+		int offset = i + READER_COUNT + WRITER_COUNT + 1;
+		TEST_ASSERT(thread_ids[offset] > READER_COUNT + WRITER_COUNT);
+		TEST_ASSERT(thread_ids[offset] <= THREAD_COUNT);
+	}
 }
 
 TEST_LIST = {